@@ -0,0 +1,111 @@
+#include "common/Atomic.hpp"
+#include "messages/Emote.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QString>
+
+#include <memory>
+#include <mutex>
+
+using namespace chatterino;
+
+namespace {
+
+// The mutex based cell Atomic<std::shared_ptr<T>> used to be
+template <typename T>
+class MutexCell
+{
+public:
+    explicit MutexCell(T val)
+        : value_(std::move(val))
+    {
+    }
+
+    T get() const
+    {
+        std::lock_guard<std::mutex> guard(this->mutex_);
+
+        return this->value_;
+    }
+
+    void set(const T &val)
+    {
+        std::lock_guard<std::mutex> guard(this->mutex_);
+
+        this->value_ = val;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    T value_;
+};
+
+std::shared_ptr<const EmoteMap> makeEmoteMap(int size)
+{
+    auto map = std::make_shared<EmoteMap>();
+    for (int i = 0; i < size; ++i)
+    {
+        EmoteName name{QString("emote%1").arg(i)};
+        (*map)[name] = std::make_shared<const Emote>(
+            Emote{name, ImageSet{}, Tooltip{}, Url{}, false});
+    }
+    return map;
+}
+
+// Maps the writer alternates between
+const std::shared_ptr<const EmoteMap> &firstMap()
+{
+    static auto map = makeEmoteMap(100);
+    return map;
+}
+
+const std::shared_ptr<const EmoteMap> &secondMap()
+{
+    static auto map = makeEmoteMap(100);
+    return map;
+}
+
+// The first thread replaces the map every 64 iterations like live updates
+// do (only far more often), all other threads read it like message builders
+template <typename Cell>
+void runReaders(benchmark::State &state, Cell &cell)
+{
+    EmoteName name{"emote42"};
+    bool writer = state.thread_index() == 0;
+    int64_t i = 0;
+
+    for (auto _ : state)
+    {
+        if (writer && (++i % 64) == 0)
+        {
+            cell.set((i / 64) % 2 == 0 ? firstMap() : secondMap());
+            continue;
+        }
+
+        auto map = cell.get();
+        benchmark::DoNotOptimize(map->find(name));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+// Baseline: every read takes a mutex
+static void BM_Atomic_MutexRead(benchmark::State &state)
+{
+    static MutexCell<std::shared_ptr<const EmoteMap>> cell(firstMap());
+
+    runReaders(state, cell);
+}
+
+static void BM_Atomic_Read(benchmark::State &state)
+{
+    static Atomic<std::shared_ptr<const EmoteMap>> cell{
+        std::shared_ptr<const EmoteMap>(firstMap())};
+
+    runReaders(state, cell);
+}
+
+BENCHMARK(BM_Atomic_MutexRead)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(BM_Atomic_Read)->ThreadRange(1, 16)->UseRealTime();
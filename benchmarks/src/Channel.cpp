@@ -0,0 +1,152 @@
+#include "common/Channel.hpp"
+#include "messages/Message.hpp"
+#include "singletons/Settings.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QString>
+
+#include <memory>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+QString idAt(int i)
+{
+    return QString("a3196c7e-be4c-4b49-9c5a-%1").arg(i, 12, 10, QChar('0'));
+}
+
+std::shared_ptr<Channel> makeFilledChannel(int numMessages)
+{
+    getSettings()->scrollbackSplitLimit.setValue(numMessages);
+    auto channel = std::make_shared<Channel>("test", Channel::Type::Misc);
+
+    for (int i = 0; i < numMessages; ++i)
+    {
+        auto message = std::make_shared<Message>();
+        message->id = idAt(i);
+        channel->addMessage(message, MessageFlags(MessageFlag::DoNotLog));
+    }
+
+    return channel;
+}
+
+}  // namespace
+
+// Looks up the oldest message, the worst case for a scan from the back
+void BM_Channel_FindMessage(benchmark::State &state)
+{
+    auto channel = makeFilledChannel(int(state.range(0)));
+    auto id = idAt(0);
+
+    for (auto _ : state)
+    {
+        auto message = channel->findMessage(id);
+        benchmark::DoNotOptimize(message);
+    }
+}
+
+// The linear scan findMessage used before messages were indexed by id
+void BM_Channel_FindMessage_LinearScan(benchmark::State &state)
+{
+    auto channel = makeFilledChannel(int(state.range(0)));
+    auto id = idAt(0);
+
+    for (auto _ : state)
+    {
+        MessagePtr message;
+        auto snapshot = channel->getMessageSnapshot();
+        for (auto it = snapshot.rbegin(); it != snapshot.rend(); ++it)
+        {
+            if ((*it)->id == id)
+            {
+                message = *it;
+                break;
+            }
+        }
+        benchmark::DoNotOptimize(message);
+    }
+}
+
+void BM_Channel_FindMessage_Missing(benchmark::State &state)
+{
+    auto channel = makeFilledChannel(int(state.range(0)));
+    QString id("not-in-the-channel");
+
+    for (auto _ : state)
+    {
+        auto message = channel->findMessage(id);
+        benchmark::DoNotOptimize(message);
+    }
+}
+
+BENCHMARK(BM_Channel_FindMessage)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK(BM_Channel_FindMessage_LinearScan)
+    ->RangeMultiplier(10)
+    ->Range(1000, 100000);
+BENCHMARK(BM_Channel_FindMessage_Missing)
+    ->RangeMultiplier(10)
+    ->Range(1000, 100000);
+
+namespace {
+
+std::vector<MessagePtr> makeBurst(int numMessages)
+{
+    std::vector<MessagePtr> messages;
+    messages.reserve(numMessages);
+    for (int i = 0; i < numMessages; ++i)
+    {
+        auto message = std::make_shared<Message>();
+        message->id = idAt(i);
+        message->loginName = QString("user%1").arg(i % 50);
+        messages.push_back(message);
+    }
+    return messages;
+}
+
+}  // namespace
+
+// Delivers a burst of state.range(0) messages one at a time to a listener
+void BM_Channel_AddMessage_Burst(benchmark::State &state)
+{
+    auto channel = makeFilledChannel(1000);
+    auto burst = makeBurst(int(state.range(0)));
+    size_t signals = 0;
+    auto connection = channel->messageAppended.connect(
+        [&signals](MessagePtr &, boost::optional<MessageFlags>) {
+            ++signals;
+        });
+
+    for (auto _ : state)
+    {
+        for (const auto &message : burst)
+        {
+            channel->addMessage(message, MessageFlags(MessageFlag::DoNotLog));
+        }
+    }
+
+    state.counters["signals"] = double(signals);
+}
+
+// Delivers the same burst as one batch
+void BM_Channel_AddMessages_Burst(benchmark::State &state)
+{
+    auto channel = makeFilledChannel(1000);
+    auto burst = makeBurst(int(state.range(0)));
+    size_t signals = 0;
+    auto connection = channel->messagesAppended.connect(
+        [&signals](std::vector<MessagePtr> &) {
+            ++signals;
+        });
+
+    for (auto _ : state)
+    {
+        channel->addMessages(burst, false);
+    }
+
+    state.counters["signals"] = double(signals);
+}
+
+BENCHMARK(BM_Channel_AddMessage_Burst)->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK(BM_Channel_AddMessages_Burst)->Arg(10)->Arg(100)->Arg(1000);
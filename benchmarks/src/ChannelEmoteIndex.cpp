@@ -0,0 +1,195 @@
+#include "common/Atomic.hpp"
+#include "messages/Emote.hpp"
+#include "providers/twitch/ChannelEmoteIndex.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QString>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace chatterino;
+using Source = ChannelEmoteIndex::Source;
+
+namespace {
+
+// Emotes per source, roughly what a big channel has enabled. The channel
+// sources add up to 2k emotes.
+const std::vector<std::pair<Source, int>> SOURCE_SIZES{
+    {Source::FfzChannel, 200},
+    {Source::BttvChannel, 500},
+    {Source::SeventvChannel, 1000},
+    {Source::HomiesChannel, 300},
+    {Source::FfzGlobal, 50},
+    {Source::BttvGlobal, 60},
+    {Source::SeventvGlobal, 60},
+    {Source::HomiesGlobal, 30},
+};
+
+constexpr int MESSAGE_COUNT = 1000;
+constexpr int WORDS_PER_MESSAGE = 12;
+
+QString emoteName(Source source, int i)
+{
+    return QString("emote%1x%2").arg(static_cast<int>(source)).arg(i);
+}
+
+struct Fixture {
+    ChannelEmoteIndex::Sources sources;
+    std::vector<std::unique_ptr<Atomic<std::shared_ptr<const EmoteMap>>>>
+        atomics;
+    std::vector<std::vector<EmoteName>> messages;
+
+    Fixture()
+    {
+        for (const auto &[source, size] : SOURCE_SIZES)
+        {
+            auto map = std::make_shared<EmoteMap>();
+            for (int i = 0; i < size; ++i)
+            {
+                EmoteName name{emoteName(source, i)};
+                (*map)[name] = std::make_shared<const Emote>(
+                    Emote{name, ImageSet{}, Tooltip{}, Url{}, false});
+            }
+            this->sources[static_cast<size_t>(source)] = map;
+        }
+        for (const auto &map : this->sources)
+        {
+            this->atomics.push_back(
+                std::make_unique<Atomic<std::shared_ptr<const EmoteMap>>>(
+                    std::shared_ptr<const EmoteMap>(map)));
+        }
+
+        // Two thirds of the words are emotes, mostly from the channel
+        std::mt19937 rng(42);
+        for (int m = 0; m < MESSAGE_COUNT; ++m)
+        {
+            std::vector<EmoteName> words;
+            for (int w = 0; w < WORDS_PER_MESSAGE; ++w)
+            {
+                auto kind = rng() % 6;
+                if (kind < 2)
+                {
+                    words.push_back({QString("word%1").arg(rng() % 500)});
+                    continue;
+                }
+
+                auto source = kind < 5 ? SOURCE_SIZES[rng() % 4]
+                                       : SOURCE_SIZES[4 + rng() % 4];
+                words.push_back(
+                    {emoteName(source.first, int(rng() % source.second))});
+            }
+            this->messages.push_back(std::move(words));
+        }
+    }
+};
+
+const Fixture &fixture()
+{
+    static Fixture instance;
+    return instance;
+}
+
+}  // namespace
+
+// Baseline: every word is looked up in every provider map by priority, each
+// map is taken from its Atomic like TwitchChannel used to do
+static void BM_ChannelEmoteIndex_PerProvider(benchmark::State &state)
+{
+    const auto &data = fixture();
+    int64_t words = 0;
+
+    for (auto _ : state)
+    {
+        int found = 0;
+        for (const auto &message : data.messages)
+        {
+            for (const auto &word : message)
+            {
+                for (const auto &atomic : data.atomics)
+                {
+                    auto map = atomic->get();
+                    auto it = map->find(word);
+                    if (it != map->end())
+                    {
+                        benchmark::DoNotOptimize(it->second);
+                        found++;
+                        break;
+                    }
+                }
+            }
+            words += WORDS_PER_MESSAGE;
+        }
+        benchmark::DoNotOptimize(found);
+    }
+
+    state.SetItemsProcessed(words);
+}
+
+// One probe into the merged index per word, the index is taken once per
+// message like TwitchMessageBuilder does
+static void BM_ChannelEmoteIndex_Merged(benchmark::State &state)
+{
+    const auto &data = fixture();
+    Atomic<std::shared_ptr<const ChannelEmoteIndex>> atomicIndex(
+        std::make_shared<const ChannelEmoteIndex>(data.sources));
+    int64_t words = 0;
+
+    for (auto _ : state)
+    {
+        int found = 0;
+        for (const auto &message : data.messages)
+        {
+            auto index = atomicIndex.get();
+            for (const auto &word : message)
+            {
+                if (const auto *entry = index->find(word))
+                {
+                    benchmark::DoNotOptimize(entry->emote);
+                    found++;
+                }
+            }
+            words += WORDS_PER_MESSAGE;
+        }
+        benchmark::DoNotOptimize(found);
+    }
+
+    state.SetItemsProcessed(words);
+}
+
+// Cost of a live update that adds one emote to the 7TV channel map
+static void BM_ChannelEmoteIndex_LiveUpdate(benchmark::State &state)
+{
+    const auto &data = fixture();
+    auto index = std::make_shared<const ChannelEmoteIndex>(data.sources);
+
+    auto withNewEmote = std::make_shared<EmoteMap>(
+        *data.sources[static_cast<size_t>(Source::SeventvChannel)]);
+    EmoteName name{"NewEmote"};
+    (*withNewEmote)[name] = std::make_shared<const Emote>(
+        Emote{name, ImageSet{}, Tooltip{}, Url{}, false});
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(
+            index->withSource(Source::SeventvChannel, withNewEmote));
+    }
+}
+
+// Cost of building the index from scratch
+static void BM_ChannelEmoteIndex_Build(benchmark::State &state)
+{
+    const auto &data = fixture();
+
+    for (auto _ : state)
+    {
+        ChannelEmoteIndex index(data.sources);
+        benchmark::DoNotOptimize(index.size());
+    }
+}
+
+BENCHMARK(BM_ChannelEmoteIndex_PerProvider);
+BENCHMARK(BM_ChannelEmoteIndex_Merged);
+BENCHMARK(BM_ChannelEmoteIndex_LiveUpdate);
+BENCHMARK(BM_ChannelEmoteIndex_Build);
@@ -1,9 +1,12 @@
 #include "providers/emoji/Emojis.hpp"
+#include "util/Qt.hpp"
 
 #include <benchmark/benchmark.h>
 #include <QDebug>
 #include <QString>
 
+#include <vector>
+
 using namespace chatterino;
 
 static void BM_ShortcodeParsing(benchmark::State &state)
@@ -55,3 +58,80 @@ static void BM_ShortcodeParsing(benchmark::State &state)
 }
 
 BENCHMARK(BM_ShortcodeParsing);
+
+namespace {
+
+struct LoadedEmojis {
+    Emojis emojis;
+
+    LoadedEmojis()
+    {
+        this->emojis.load();
+    }
+};
+
+void runEmojiParsing(benchmark::State &state,
+                     const std::vector<QString> &words)
+{
+    static LoadedEmojis loaded;
+    const auto &emojis = loaded.emojis;
+
+    for (auto _ : state)
+    {
+        for (const auto &word : words)
+        {
+            benchmark::DoNotOptimize(emojis.parse(word));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<int64_t>(words.size()));
+}
+
+std::vector<QString> splitWords(const QString &text)
+{
+    std::vector<QString> words;
+    for (const auto &word : text.split(' ', Qt::SkipEmptyParts))
+    {
+        words.push_back(word);
+    }
+    return words;
+}
+
+}  // namespace
+
+// Words of messages in English, which is most of chat
+static void BM_EmojiParsing_Ascii(benchmark::State &state)
+{
+    static const auto words = splitWords(
+        "forsenE what did he just say LULW no way this is actually happening "
+        "chat is this real https://twitch.tv/forsen 123 !commands @someone "
+        "hello hi: :) <3 #1 world record pace KEKW Pog gg wp 10/10 :D");
+
+    runEmojiParsing(state, words);
+}
+
+// Words in other languages, occasionally with emojis
+static void BM_EmojiParsing_MixedLanguage(benchmark::State &state)
+{
+    static const auto words = splitWords(
+        "привет всем как дела сегодня 😀 これは テスト です 今日は 良い 天気 "
+        "안녕하세요 여러분 schöne Grüße aus München ¿qué tal? ça va très bien "
+        "你好 世界 Ελληνικά γράμματα 🇩🇪 عربي نص مرحبا hello 👍");
+
+    runEmojiParsing(state, words);
+}
+
+// Words made of emojis: sequences, skin tones, flags and keycaps
+static void BM_EmojiParsing_EmojiHeavy(benchmark::State &state)
+{
+    static const auto words = splitWords(
+        "😂😂😂 👍🏽 ❤️ 🔥🔥 👨‍👩‍👧‍👦 👩🏻‍💻 🇺🇸 🇯🇵 #️⃣ 1️⃣ 🏳️‍🌈 "
+        "🤔 lol😂 😭😭😭😭 👀 ✨✨ 🧑🏿‍🚀 ☺️ 🙏🏼 ©️ 💯 🎉🎊 😳👉👈");
+
+    runEmojiParsing(state, words);
+}
+
+BENCHMARK(BM_EmojiParsing_Ascii);
+BENCHMARK(BM_EmojiParsing_MixedLanguage);
+BENCHMARK(BM_EmojiParsing_EmojiHeavy);
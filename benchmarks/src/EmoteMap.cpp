@@ -0,0 +1,96 @@
+#include "messages/Emote.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QString>
+
+#include <memory>
+#include <unordered_map>
+
+using namespace chatterino;
+
+namespace {
+
+EmotePtr makeEmote(const QString &name)
+{
+    return std::make_shared<const Emote>(
+        Emote{EmoteName{name}, ImageSet{}, Tooltip{}, Url{}, false});
+}
+
+template <typename Map>
+std::shared_ptr<const Map> makeChannelEmotes(int64_t size)
+{
+    Map map;
+    for (int64_t i = 0; i < size; ++i)
+    {
+        auto name = QString("emote%1").arg(i);
+        map[EmoteName{name}] = makeEmote(name);
+    }
+    return std::make_shared<const Map>(std::move(map));
+}
+
+// Applies one live update per iteration the way SeventvEmotes::addEmote and
+// removeEmote do: copy the current map, change the copy, publish the copy
+template <typename Map>
+void runLiveUpdates(benchmark::State &state)
+{
+    auto current = makeChannelEmotes<Map>(state.range(0));
+    auto added = makeEmote("NewEmote");
+    bool add = true;
+
+    for (auto _ : state)
+    {
+        Map updated = *current;
+        if (add)
+        {
+            updated[added->name] = added;
+        }
+        else
+        {
+            updated.erase(added->name);
+        }
+        add = !add;
+        current = std::make_shared<const Map>(std::move(updated));
+    }
+
+    benchmark::DoNotOptimize(current);
+}
+
+}  // namespace
+
+// Baseline: the map is copied entirely for every update
+static void BM_EmoteMap_LiveUpdate_UnorderedMap(benchmark::State &state)
+{
+    runLiveUpdates<std::unordered_map<EmoteName, EmotePtr>>(state);
+}
+
+static void BM_EmoteMap_LiveUpdate(benchmark::State &state)
+{
+    runLiveUpdates<EmoteMap>(state);
+}
+
+// Lookups in a map that has been live updated many times
+static void BM_EmoteMap_FindAfterUpdates(benchmark::State &state)
+{
+    auto current = makeChannelEmotes<EmoteMap>(state.range(0));
+    for (int i = 0; i < 20; ++i)
+    {
+        EmoteMap updated = *current;
+        auto name = QString("live%1").arg(i);
+        updated[EmoteName{name}] = makeEmote(name);
+        current = std::make_shared<const EmoteMap>(std::move(updated));
+    }
+
+    EmoteName hit{"emote1"};
+    EmoteName live{"live3"};
+    EmoteName miss{"NotAnEmote"};
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(current->find(hit));
+        benchmark::DoNotOptimize(current->find(live));
+        benchmark::DoNotOptimize(current->find(miss));
+    }
+}
+
+BENCHMARK(BM_EmoteMap_LiveUpdate_UnorderedMap)->Arg(100)->Arg(1000)->Arg(5000);
+BENCHMARK(BM_EmoteMap_LiveUpdate)->Arg(100)->Arg(1000)->Arg(5000);
+BENCHMARK(BM_EmoteMap_FindAfterUpdates)->Arg(1000);
@@ -0,0 +1,171 @@
+#include "controllers/filters/lang/Filter.hpp"
+#include "messages/Message.hpp"
+#include "providers/twitch/TwitchBadge.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QColor>
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+#include <vector>
+
+using namespace chatterino;
+using namespace chatterino::filters;
+
+namespace {
+
+const std::vector<QString> FILTERS{
+    R".(flags.highlighted).",
+    R".(!flags.system_message).",
+    R".(author.subbed && author.sub_length >= 6).",
+    R".(author.badges contains "moderator" || author.badges contains "vip").",
+    R".(message.length < 200).",
+    R".(!(message.content match r"^!\w+")).",
+    R".(message.content match ri"(discord|twitter)\.com").",
+    R".(author.name != "nightbot" && author.name != "streamelements").",
+    R".(channel.name == "forsen" || !flags.whisper).",
+    R".(!(message.content contains "spoiler") || flags.reply).",
+};
+
+std::vector<Filter> buildFilters()
+{
+    std::vector<Filter> filters;
+    for (const auto &text : FILTERS)
+    {
+        auto result = Filter::fromString(text);
+        filters.push_back(std::move(std::get<Filter>(result)));
+    }
+    return filters;
+}
+
+std::vector<std::shared_ptr<Message>> buildMessages(int count)
+{
+    const QStringList badges{"moderator", "vip", "subscriber", "premium"};
+
+    std::vector<std::shared_ptr<Message>> messages;
+    messages.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+        auto message = std::make_shared<Message>();
+        message->displayName = QString("user%1").arg(i % 997);
+        message->channelName = i % 3 == 0 ? "forsen" : "pajlada";
+        message->usernameColor = QColor::fromRgb(i * 2654435761U);
+        message->messageText =
+            i % 11 == 0 ? QString("!command%1 argument").arg(i)
+                        : QString("message number %1, see discord.com or "
+                                  "something else entirely")
+                              .arg(i);
+        message->badges.emplace_back(badges[i % badges.size()], "1");
+        message->badgeInfos["subscriber"] = QString::number(i % 36);
+        if (i % 7 == 0)
+        {
+            message->flags.set(MessageFlag::Highlighted);
+        }
+        messages.push_back(std::move(message));
+    }
+    return messages;
+}
+
+// How the values were given to filters before: all of them, for every message
+ContextMap buildEagerContextMap(const Message &m)
+{
+    QStringList badges;
+    badges.reserve(static_cast<int>(m.badges.size()));
+    for (const auto &e : m.badges)
+    {
+        badges << e.key_;
+    }
+
+    bool subscribed = false;
+    int subLength = 0;
+    for (const auto *subBadge : {"subscriber", "founder"})
+    {
+        if (!badges.contains(subBadge))
+        {
+            continue;
+        }
+        subscribed = true;
+        if (m.badgeInfos.find(subBadge) != m.badgeInfos.end())
+        {
+            subLength = m.badgeInfos.at(subBadge).toInt();
+        }
+    }
+
+    // channel.watching needs the application, it's left out
+    return {
+        {"author.badges", std::move(badges)},
+        {"author.color", m.usernameColor},
+        {"author.name", m.displayName},
+        {"author.no_color", !m.usernameColor.isValid()},
+        {"author.subbed", subscribed},
+        {"author.sub_length", subLength},
+
+        {"channel.name", m.channelName},
+        {"channel.live", false},
+
+        {"flags.highlighted", m.flags.has(MessageFlag::Highlighted)},
+        {"flags.points_redeemed", m.flags.has(MessageFlag::RedeemedHighlight)},
+        {"flags.sub_message", m.flags.has(MessageFlag::Subscription)},
+        {"flags.system_message", m.flags.has(MessageFlag::System)},
+        {"flags.reward_message",
+         m.flags.has(MessageFlag::RedeemedChannelPointReward)},
+        {"flags.first_message", m.flags.has(MessageFlag::FirstMessage)},
+        {"flags.elevated_message", m.flags.has(MessageFlag::ElevatedMessage)},
+        {"flags.cheer_message", m.flags.has(MessageFlag::CheerMessage)},
+        {"flags.whisper", m.flags.has(MessageFlag::Whisper)},
+        {"flags.reply", m.flags.has(MessageFlag::ReplyMessage)},
+        {"flags.automod", m.flags.has(MessageFlag::AutoMod)},
+
+        {"message.content", m.messageText},
+        {"message.length", m.messageText.length()},
+    };
+}
+
+}  // namespace
+
+static void BM_Filters_Interpreted(benchmark::State &state)
+{
+    const auto filters = buildFilters();
+    const auto messages = buildMessages(static_cast<int>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        for (const auto &message : messages)
+        {
+            auto context = buildEagerContextMap(*message);
+            for (const auto &filter : filters)
+            {
+                benchmark::DoNotOptimize(filter.execute(context).toBool());
+            }
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<int64_t>(messages.size()));
+}
+
+static void BM_Filters_Compiled(benchmark::State &state)
+{
+    const auto filters = buildFilters();
+    const auto messages = buildMessages(static_cast<int>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        for (const auto &message : messages)
+        {
+            MessageContext context(*message, nullptr);
+            for (const auto &filter : filters)
+            {
+                benchmark::DoNotOptimize(filter.execute(context).toBool());
+            }
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<int64_t>(messages.size()));
+}
+
+// 10 filters checking 100k messages
+BENCHMARK(BM_Filters_Interpreted)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Filters_Compiled)->Arg(100000)->Unit(benchmark::kMillisecond);
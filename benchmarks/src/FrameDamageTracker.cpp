@@ -0,0 +1,116 @@
+#include "messages/layouts/FrameDamageTracker.hpp"
+#include "singletons/helper/GifTimer.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QRegion>
+
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+constexpr int VIEW_WIDTH = 400;
+constexpr int VIEW_HEIGHT = 800;
+constexpr int LINE_HEIGHT = 28;
+constexpr int EMOTE_SIZE = 28;
+
+struct AnimatedEmote {
+    QRect rect;
+    // Duration of every frame, GIFs commonly use 20 to 100ms
+    long unsigned frameLength;
+    long unsigned deadline;
+};
+
+// One line of chat per LINE_HEIGHT pixels with emotesPerLine animated emotes
+// in each line
+std::vector<AnimatedEmote> makeChat(int emotesPerLine)
+{
+    std::vector<AnimatedEmote> emotes;
+    for (int y = 0; y + LINE_HEIGHT <= VIEW_HEIGHT; y += LINE_HEIGHT)
+    {
+        for (int i = 0; i < emotesPerLine; ++i)
+        {
+            auto frameLength =
+                GIF_FRAME_LENGTH *
+                (1 + static_cast<long unsigned>(emotes.size() % 5));
+            emotes.push_back({
+                QRect(100 + i * (EMOTE_SIZE + 4), y, EMOTE_SIZE, EMOTE_SIZE),
+                frameLength,
+                frameLength,
+            });
+        }
+    }
+    return emotes;
+}
+
+int64_t areaOf(const QRegion &region)
+{
+    int64_t area = 0;
+    for (const auto &rect : region)
+    {
+        area += int64_t(rect.width()) * rect.height();
+    }
+    return area;
+}
+
+// Runs one GIF timer tick per iteration like ChannelView does: the due
+// elements are repainted, which registers them again with their next deadline
+void runTicks(benchmark::State &state, int emotesPerLine)
+{
+    auto emotes = makeChat(emotesPerLine);
+    FrameDamageTracker tracker;
+    for (const auto &emote : emotes)
+    {
+        tracker.add(emote.rect, emote.deadline);
+    }
+
+    long unsigned position = 0;
+    int64_t repaintedArea = 0;
+
+    for (auto _ : state)
+    {
+        position += GIF_FRAME_LENGTH;
+
+        auto damage = tracker.takeDue(position);
+        if (damage.isEmpty())
+        {
+            continue;
+        }
+        repaintedArea += areaOf(damage);
+
+        // paintEvent
+        tracker.clear();
+        for (auto &emote : emotes)
+        {
+            if (emote.deadline <= position)
+            {
+                emote.deadline += emote.frameLength;
+            }
+            tracker.add(emote.rect, emote.deadline);
+        }
+    }
+
+    // Before, every tick repainted the whole view
+    state.counters["repainted"] = benchmark::Counter(
+        double(repaintedArea) /
+        (double(state.iterations()) * VIEW_WIDTH * VIEW_HEIGHT));
+}
+
+}  // namespace
+
+// No animated emote on screen. Ticks don't repaint anything, and the GIF timer
+// goes to sleep after the first one
+void BM_FrameDamage_StaticChat(benchmark::State &state)
+{
+    runTicks(state, 0);
+}
+
+// state.range(0) animated emotes in every line
+void BM_FrameDamage_EmoteHeavyChat(benchmark::State &state)
+{
+    runTicks(state, int(state.range(0)));
+}
+
+BENCHMARK(BM_FrameDamage_StaticChat);
+BENCHMARK(BM_FrameDamage_EmoteHeavyChat)->Arg(1)->Arg(4)->Arg(8);
@@ -6,11 +6,17 @@
 #include "messages/Message.hpp"
 #include "messages/SharedMessageBuilder.hpp"
 #include "mocks/EmptyApplication.hpp"
+#include "singletons/Paths.hpp"
 #include "singletons/Settings.hpp"
 #include "util/Helpers.hpp"
 
 #include <benchmark/benchmark.h>
 #include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QString>
 
 using namespace chatterino;
@@ -63,10 +69,53 @@ public:
     // TODO: Figure this out
 };
 
+namespace {
+
+const QString SETTINGS_DIRECTORY = "/tmp/c2-highlights-mock";
+
+/**
+ * Writes settings with the given number of highlight phrases. Every tenth
+ * phrase is a regex and half of them are case sensitive.
+ */
+void writeHighlightSettings(int phraseCount)
+{
+    QJsonArray highlights;
+    for (int i = 0; i < phraseCount; ++i)
+    {
+        bool isRegex = i % 10 == 9;
+        highlights.append(QJsonObject{
+            {"pattern", isRegex ? QString("^!cmd%1\\b").arg(i)
+                                : QString("phrase%1").arg(i)},
+            {"showInMentions", true},
+            {"alert", false},
+            {"sound", false},
+            {"regex", isRegex},
+            {"case", i % 2 == 0},
+            {"soundUrl", ""},
+            {"color", "#7f7f3f49"},
+        });
+    }
+
+    QJsonObject root{
+        {"highlighting", QJsonObject{{"highlights", highlights}}},
+    };
+
+    QDir().mkpath(SETTINGS_DIRECTORY);
+    QFile settingsFile(SETTINGS_DIRECTORY + "/settings.json");
+    settingsFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    settingsFile.write(QJsonDocument(root).toJson());
+}
+
+}  // namespace
+
 static void BM_HighlightTest(benchmark::State &state)
 {
+    writeHighlightSettings(static_cast<int>(state.range(0)));
+
+    Settings settings(SETTINGS_DIRECTORY);
+    Paths paths;
     MockApplication mockApplication;
-    Settings settings("/tmp/c2-mock");
+    mockApplication.highlights.initialize(settings, paths);
 
     std::string message =
         R"(@badge-info=subscriber/34;badges=moderator/1,subscriber/24;color=#FF0000;display-name=테스트계정420;emotes=41:6-13,15-22;flags=;id=a3196c7e-be4c-4b49-9c5a-8b8302b50c2a;mod=1;room-id=11148817;subscriber=1;tmi-sent-ts=1590922213730;turbo=0;user-id=117166826;user-type=mod :testaccount_420!testaccount_420@testaccount_420.tmi.twitch.tv PRIVMSG #pajlada :-tags Kreygasm,Kreygasm (no space))";
@@ -86,6 +135,8 @@ static void BM_HighlightTest(benchmark::State &state)
 
         b.bench();
     }
+
+    QDir(SETTINGS_DIRECTORY).removeRecursively();
 }
 
-BENCHMARK(BM_HighlightTest);
+BENCHMARK(BM_HighlightTest)->Arg(1)->Arg(10)->Arg(100)->Arg(1000);
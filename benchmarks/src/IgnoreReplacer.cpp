@@ -0,0 +1,116 @@
+#include "controllers/ignores/IgnoreReplacer.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QString>
+
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+// Every 10th phrase is a regex, half of them are case sensitive
+std::vector<IgnorePhrase> buildPhrases(int count)
+{
+    std::vector<IgnorePhrase> phrases;
+    for (int i = 0; i < count; ++i)
+    {
+        if (i % 10 == 0)
+        {
+            phrases.emplace_back(QString("\\bspam%1[a-z]*\\b").arg(i), true,
+                                 false, "", i % 2 == 0);
+        }
+        else
+        {
+            phrases.emplace_back(QString("badword%1").arg(i), false, false,
+                                 "***", i % 2 == 0);
+        }
+    }
+    return phrases;
+}
+
+const std::vector<QString> MESSAGES{
+    "hello chat, how is everyone doing today?",
+    "forsenE forsenE forsenE forsenE forsenE",
+    "this message contains badword17 and BADWORD18 somewhere",
+    "spam20abc spam40 spam60xyz are all removed",
+    "a very long message without any of the ignored phrases in it, just "
+    "people talking about the stream and what happened in the last game",
+};
+
+// How the phrases used to be applied: one after another, each searching the
+// whole message
+void replaceSequentially(const std::vector<IgnorePhrase> &phrases,
+                         QString &message)
+{
+    for (const auto &phrase : phrases)
+    {
+        if (phrase.isRegex())
+        {
+            const auto &regex = phrase.getRegex();
+            QRegularExpressionMatch match;
+            int from = 0;
+            while ((from = message.indexOf(regex, from, &match)) != -1)
+            {
+                int len = match.capturedLength();
+                auto mid = message.mid(from, len);
+                mid.replace(regex, phrase.getReplace());
+                message.replace(from, len, mid);
+                from += mid.size();
+            }
+        }
+        else
+        {
+            int from = 0;
+            while ((from = message.indexOf(phrase.getPattern(), from,
+                                           phrase.caseSensitivity())) != -1)
+            {
+                message.replace(from, phrase.getPattern().size(),
+                                phrase.getReplace());
+                from += phrase.getReplace().size();
+            }
+        }
+    }
+}
+
+}  // namespace
+
+static void BM_IgnoreReplaces_Sequential(benchmark::State &state)
+{
+    const auto phrases = buildPhrases(static_cast<int>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        for (const auto &original : MESSAGES)
+        {
+            auto message = original;
+            replaceSequentially(phrases, message);
+            benchmark::DoNotOptimize(message);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<int64_t>(MESSAGES.size()));
+}
+
+static void BM_IgnoreReplaces_Replacer(benchmark::State &state)
+{
+    const IgnoreReplacer replacer(
+        buildPhrases(static_cast<int>(state.range(0))));
+
+    for (auto _ : state)
+    {
+        for (const auto &original : MESSAGES)
+        {
+            auto message = original;
+            benchmark::DoNotOptimize(replacer.replace(message));
+            benchmark::DoNotOptimize(message);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<int64_t>(MESSAGES.size()));
+}
+
+BENCHMARK(BM_IgnoreReplaces_Sequential)->Arg(20)->Arg(200);
+BENCHMARK(BM_IgnoreReplaces_Replacer)->Arg(20)->Arg(200);
@@ -0,0 +1,161 @@
+#include "messages/layouts/MessageLayoutElement.hpp"
+#include "messages/MessageElement.hpp"
+#include "singletons/Fonts.hpp"
+#include "util/DebugCount.hpp"
+#include "util/ObjectArena.hpp"
+#include "util/Qt.hpp"
+#include "util/SampleData.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QColor>
+#include <QPoint>
+#include <QSize>
+#include <QStringList>
+
+#include <memory>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+// Number of messages laid out per iteration
+constexpr int MESSAGE_COUNT = 10000;
+
+// The words of MESSAGE_COUNT sample messages
+std::vector<std::vector<QString>> sampleMessages()
+{
+    QStringList messages;
+    messages << getSampleMiscMessages() << getSampleCheerMessages()
+             << getSampleSubMessages() << getSampleEmoteTestMessages()
+             << getSampleLinkMessages();
+
+    std::vector<std::vector<QString>> result;
+    for (int i = 0; i < MESSAGE_COUNT; ++i)
+    {
+        // Only the text after the tags and the command
+        auto text = messages[i % messages.size()];
+        if (text.startsWith('@'))
+        {
+            text = text.mid(text.indexOf(' ') + 1);
+        }
+        auto textStart = text.indexOf(" :");
+        if (textStart != -1)
+        {
+            text = text.mid(textStart + 2);
+        }
+
+        auto &words = result.emplace_back();
+        for (const auto &word : text.split(' ', Qt::SkipEmptyParts))
+        {
+            words.push_back(word);
+        }
+    }
+    return result;
+}
+
+// Roughly where the elements of a message end up: 10px per character,
+// 20px high lines, wrapped at 400px
+QPoint nextPosition(QPoint position, const QString &word)
+{
+    auto x = position.x() + word.size() * 10 + 4;
+    if (x > 400)
+    {
+        return {0, position.y() + 20};
+    }
+    return {x, position.y()};
+}
+
+}  // namespace
+
+// How layout elements were allocated before: one by one, counted one by one
+void BM_LayoutElements_Heap(benchmark::State &state)
+{
+    auto messages = sampleMessages();
+    TextElement creator("", MessageElementFlag::Text);
+
+    for (auto _ : state)
+    {
+        int hits = 0;
+        for (const auto &words : messages)
+        {
+            std::vector<std::unique_ptr<MessageLayoutElement>> elements;
+            QPoint position;
+            for (auto word : words)
+            {
+                auto element = std::make_unique<TextLayoutElement>(
+                    creator, word, QSize(word.size() * 10, 20), QColor(),
+                    FontStyle::ChatMedium, 1.F);
+                element->setPosition(position);
+                position = nextPosition(position, word);
+                elements.push_back(std::move(element));
+                DebugCount::increase("message layout elements");
+            }
+
+            // A hit test in the middle of the message
+            for (const auto &element : elements)
+            {
+                if (element->getRect().contains(QPoint(200, 10)))
+                {
+                    hits++;
+                    break;
+                }
+            }
+
+            for (size_t i = 0; i < elements.size(); ++i)
+            {
+                DebugCount::decrease("message layout elements");
+            }
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+
+    state.counters["messages"] = double(messages.size());
+}
+
+// Elements allocated from the container's arena, counted once per message
+void BM_LayoutElements_Arena(benchmark::State &state)
+{
+    auto messages = sampleMessages();
+    TextElement creator("", MessageElementFlag::Text);
+
+    for (auto _ : state)
+    {
+        int hits = 0;
+        for (const auto &words : messages)
+        {
+            ObjectArena arena;
+            std::vector<MessageLayoutElement *> elements;
+            QPoint position;
+            for (auto word : words)
+            {
+                auto *element = arena.make<TextLayoutElement>(
+                    creator, word, QSize(word.size() * 10, 20), QColor(),
+                    FontStyle::ChatMedium, 1.F);
+                element->setPosition(position);
+                position = nextPosition(position, word);
+                elements.push_back(element);
+            }
+            DebugCount::increase("message layout elements",
+                                 int64_t(elements.size()));
+
+            for (const auto *element : elements)
+            {
+                if (element->getRect().contains(QPoint(200, 10)))
+                {
+                    hits++;
+                    break;
+                }
+            }
+
+            DebugCount::decrease("message layout elements",
+                                 int64_t(elements.size()));
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+
+    state.counters["messages"] = double(messages.size());
+}
+
+BENCHMARK(BM_LayoutElements_Heap)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LayoutElements_Arena)->Unit(benchmark::kMillisecond);
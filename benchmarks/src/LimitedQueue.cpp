@@ -90,6 +90,44 @@ void BM_LimitedQueue_Snapshot_ExpensiveCopy(benchmark::State &state)
     }
 }
 
+// Snapshots share the queue's chunks, so their cost must not depend on the
+// limit of the queue
+void BM_LimitedQueue_Snapshot_Scaling(benchmark::State &state)
+{
+    const auto limit = size_t(state.range(0));
+    LimitedQueue<std::shared_ptr<int>> queue(limit);
+    for (size_t i = 0; i < limit; ++i)
+    {
+        queue.pushBack(std::make_shared<int>(int(i)));
+    }
+
+    for (auto _ : state)
+    {
+        auto snapshot = queue.getSnapshot();
+        benchmark::DoNotOptimize(snapshot);
+    }
+}
+
+// Appending while a snapshot is alive, like a ChannelView does between
+// paints
+void BM_LimitedQueue_PushBack_WithSnapshot(benchmark::State &state)
+{
+    const auto limit = size_t(state.range(0));
+    LimitedQueue<std::shared_ptr<int>> queue(limit);
+    for (size_t i = 0; i < limit; ++i)
+    {
+        queue.pushBack(std::make_shared<int>(int(i)));
+    }
+    auto item = std::make_shared<int>(0);
+
+    for (auto _ : state)
+    {
+        auto snapshot = queue.getSnapshot();
+        queue.pushBack(item);
+        benchmark::DoNotOptimize(snapshot);
+    }
+}
+
 void BM_LimitedQueue_Find(benchmark::State &state)
 {
     LimitedQueue<int> queue(1000);
@@ -113,4 +151,10 @@ BENCHMARK(BM_LimitedQueue_PushFront_Many);
 BENCHMARK(BM_LimitedQueue_Replace);
 BENCHMARK(BM_LimitedQueue_Snapshot);
 BENCHMARK(BM_LimitedQueue_Snapshot_ExpensiveCopy);
+BENCHMARK(BM_LimitedQueue_Snapshot_Scaling)
+    ->RangeMultiplier(10)
+    ->Range(1000, 100000);
+BENCHMARK(BM_LimitedQueue_PushBack_WithSnapshot)
+    ->RangeMultiplier(10)
+    ->Range(1000, 100000);
 BENCHMARK(BM_LimitedQueue_Find);
@@ -0,0 +1,133 @@
+#include "common/Channel.hpp"
+#include "MessageBuilderApplication.hpp"
+#include "messages/Message.hpp"
+#include "providers/twitch/TwitchMessageBuilder.hpp"
+#include "util/OrderedWorkQueue.hpp"
+
+#include <benchmark/benchmark.h>
+#include <IrcMessage>
+#include <QCoreApplication>
+#include <QString>
+#include <QThread>
+
+#include <future>
+#include <memory>
+
+using namespace chatterino;
+
+namespace {
+
+const char *const PRIVMSG =
+    R"(@badge-info=subscriber/34;badges=moderator/1,subscriber/24;color=#FF0000;display-name=testaccount_420;emotes=41:6-13,15-22;flags=;id=a3196c7e-be4c-4b49-9c5a-8b8302b50c2a;mod=1;room-id=11148817;subscriber=1;tmi-sent-ts=1590922213730;turbo=0;user-id=117166826;user-type=mod :testaccount_420!testaccount_420@testaccount_420.tmi.twitch.tv PRIVMSG #pajlada :-tags Kreygasm,Kreygasm (no space))";
+
+// Number of messages built per iteration
+constexpr int BATCH_SIZE = 1000;
+
+/// A received message and its builder, made on the GUI thread like
+/// IrcMessageHandler does
+struct PendingMessage {
+    std::shared_ptr<Communi::IrcPrivateMessage> ircMessage;
+    std::shared_ptr<TwitchMessageBuilder> builder;
+
+    PendingMessage(Channel *channel, const MessageParseArgs &args)
+        : ircMessage(static_cast<Communi::IrcPrivateMessage *>(
+              Communi::IrcMessage::fromData(PRIVMSG, nullptr)))
+        , builder(std::make_shared<TwitchMessageBuilder>(
+              channel, ircMessage.get(), args))
+    {
+    }
+
+    MessagePtr build() const
+    {
+        if (this->builder->isIgnored())
+        {
+            return nullptr;
+        }
+        return this->builder->build();
+    }
+
+    void commit(const MessagePtr &message) const
+    {
+        if (message)
+        {
+            this->builder->applyBuildResults(message);
+        }
+    }
+};
+
+/// Runs func on the GUI thread and waits for it
+template <typename Func>
+void runInGuiThread(Func func)
+{
+    QMetaObject::invokeMethod(QCoreApplication::instance(), func,
+                              Qt::BlockingQueuedConnection);
+}
+
+}  // namespace
+
+// Baseline: every message is built on the GUI thread where it's received
+void BM_MessageBuild_Inline(benchmark::State &state)
+{
+    MessageBuilderApplication app;
+    auto channel = Channel::getEmpty();
+    MessageParseArgs args;
+
+    for (auto _ : state)
+    {
+        runInGuiThread([&] {
+            for (int i = 0; i < BATCH_SIZE; ++i)
+            {
+                PendingMessage pending(channel.get(), args);
+                auto msg = pending.build();
+                pending.commit(msg);
+                benchmark::DoNotOptimize(msg);
+            }
+        });
+    }
+
+    state.SetItemsProcessed(state.iterations() * BATCH_SIZE);
+}
+
+// Messages are built on the pool and committed in order on the GUI thread,
+// spread over state.range(0) channels
+void BM_MessageBuild_OrderedWorkQueue(benchmark::State &state)
+{
+    MessageBuilderApplication app;
+    auto channel = Channel::getEmpty();
+    MessageParseArgs args;
+    auto numLanes = int(state.range(0));
+
+    OrderedWorkQueue queue(QThread::idealThreadCount() - 1);
+
+    for (auto _ : state)
+    {
+        std::promise<void> done;
+        auto committed = std::make_shared<int>(0);
+
+        runInGuiThread([&] {
+            for (int i = 0; i < BATCH_SIZE; ++i)
+            {
+                auto lane = QString("#channel%1").arg(i % numLanes);
+                PendingMessage pending(channel.get(), args);
+                queue.submit(lane, [&, committed, pending] {
+                    auto msg = pending.build();
+                    return [&, committed, pending, msg] {
+                        pending.commit(msg);
+                        benchmark::DoNotOptimize(msg);
+                        if (++*committed == BATCH_SIZE)
+                        {
+                            done.set_value();
+                        }
+                    };
+                });
+            }
+        });
+
+        done.get_future().wait();
+    }
+
+    state.SetItemsProcessed(state.iterations() * BATCH_SIZE);
+}
+
+BENCHMARK(BM_MessageBuild_Inline);
+BENCHMARK(BM_MessageBuild_OrderedWorkQueue)->Arg(1)->Arg(10)->Arg(100);
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Application.hpp"
+#include "controllers/accounts/AccountController.hpp"
+#include "controllers/highlights/HighlightController.hpp"
+#include "mocks/EmptyApplication.hpp"
+#include "mocks/UserData.hpp"
+#include "providers/bttv/BttvEmotes.hpp"
+#include "providers/chatterino/ChatterinoBadges.hpp"
+#include "providers/ffz/FfzBadges.hpp"
+#include "providers/ffz/FfzEmotes.hpp"
+#include "providers/homies/HomiesBadges.hpp"
+#include "providers/homies/HomiesEmotes.hpp"
+#include "providers/seventv/SeventvBadges.hpp"
+#include "providers/seventv/SeventvEmotes.hpp"
+#include "providers/twitch/TwitchIrcServer.hpp"
+#include "singletons/Emotes.hpp"
+#include "singletons/Paths.hpp"
+#include "singletons/Settings.hpp"
+
+namespace chatterino {
+
+class MockTwitchIrcServer : public ITwitchIrcServer
+{
+public:
+    const BttvEmotes &getBttvEmotes() const override
+    {
+        return this->bttv;
+    }
+
+    const FfzEmotes &getFfzEmotes() const override
+    {
+        return this->ffz;
+    }
+
+    const SeventvEmotes &getSeventvEmotes() const override
+    {
+        return this->seventv;
+    }
+
+    const HomiesEmotes &getHomiesEmotes() const override
+    {
+        return this->homies;
+    }
+
+    BttvEmotes bttv;
+    FfzEmotes ffz;
+    SeventvEmotes seventv;
+    HomiesEmotes homies;
+};
+
+/// Everything TwitchMessageBuilder::build looks up through getIApp(). The
+/// global emotes are empty.
+class MessageBuilderApplication : mock::EmptyApplication
+{
+public:
+    MessageBuilderApplication()
+    {
+        // The default checks, like the self highlight
+        this->highlights.initialize(*getSettings(), this->paths);
+    }
+
+    IEmotes *getEmotes() override
+    {
+        return &this->emotes;
+    }
+
+    AccountController *getAccounts() override
+    {
+        return &this->accounts;
+    }
+
+    HighlightController *getHighlights() override
+    {
+        return &this->highlights;
+    }
+
+    IUserDataController *getUserData() override
+    {
+        return &this->userData;
+    }
+
+    ITwitchIrcServer *getTwitch() override
+    {
+        return &this->twitch;
+    }
+
+    ChatterinoBadges *getChatterinoBadges() override
+    {
+        return &this->chatterinoBadges;
+    }
+
+    FfzBadges *getFfzBadges() override
+    {
+        return &this->ffzBadges;
+    }
+
+    HomiesBadges *getHomiesBadges() override
+    {
+        return &this->homiesBadges;
+    }
+
+    SeventvBadges *getSeventvBadges() override
+    {
+        return &this->seventvBadges;
+    }
+
+    // Only passed to HighlightController::initialize
+    Paths paths;
+    Emotes emotes;
+    AccountController accounts;
+    HighlightController highlights;
+    mock::UserDataController userData;
+    MockTwitchIrcServer twitch;
+    ChatterinoBadges chatterinoBadges;
+    FfzBadges ffzBadges;
+    HomiesBadges homiesBadges;
+    SeventvBadges seventvBadges;
+};
+
+}  // namespace chatterino
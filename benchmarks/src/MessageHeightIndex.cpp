@@ -0,0 +1,90 @@
+#include "widgets/helper/MessageHeightIndex.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+int heightAt(size_t i)
+{
+    return 20 + int(i % 7) * 18;
+}
+
+}  // namespace
+
+// Converts a pixel offset in the middle of the scrollback to a scroll value
+void BM_MessageHeightIndex_ValueAt(benchmark::State &state)
+{
+    auto size = size_t(state.range(0));
+    MessageHeightIndex index(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        index.pushBack(heightAt(i));
+    }
+    auto offset = double(index.totalHeight()) / 2;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(index.valueAt(offset));
+    }
+}
+
+// The same conversion by summing up the heights
+void BM_MessageHeightIndex_ValueAt_LinearScan(benchmark::State &state)
+{
+    auto size = size_t(state.range(0));
+    std::vector<int> heights;
+    int64_t total = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        heights.push_back(heightAt(i));
+        total += heights.back();
+    }
+    auto offset = double(total) / 2;
+
+    for (auto _ : state)
+    {
+        double y = 0;
+        double value = 0;
+        for (size_t i = 0; i < heights.size(); ++i)
+        {
+            if (y + heights[i] > offset)
+            {
+                value = double(i) + (offset - y) / heights[i];
+                break;
+            }
+            y += heights[i];
+        }
+        benchmark::DoNotOptimize(value);
+    }
+}
+
+// Appending to a full index, which evicts the first message
+void BM_MessageHeightIndex_PushBack(benchmark::State &state)
+{
+    auto size = size_t(state.range(0));
+    MessageHeightIndex index(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        index.pushBack(heightAt(i));
+    }
+
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        index.pushBack(heightAt(i++));
+    }
+}
+
+BENCHMARK(BM_MessageHeightIndex_ValueAt)
+    ->RangeMultiplier(10)
+    ->Range(1000, 100000);
+BENCHMARK(BM_MessageHeightIndex_ValueAt_LinearScan)
+    ->RangeMultiplier(10)
+    ->Range(1000, 100000);
+BENCHMARK(BM_MessageHeightIndex_PushBack)
+    ->RangeMultiplier(10)
+    ->Range(1000, 100000);
@@ -0,0 +1,189 @@
+#include "messages/layouts/MessageLayoutCache.hpp"
+
+#include "Application.hpp"
+#include "messages/layouts/MessageLayout.hpp"
+#include "messages/layouts/MessageLayoutContainer.hpp"
+#include "messages/Message.hpp"
+#include "messages/MessageElement.hpp"
+#include "mocks/EmptyApplication.hpp"
+#include "singletons/Fonts.hpp"
+#include "singletons/Paths.hpp"
+#include "singletons/Theme.hpp"
+#include "singletons/WindowManager.hpp"
+#include "util/Qt.hpp"
+#include "util/SampleData.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QStringList>
+
+#include <array>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+// Number of messages in the channel
+constexpr int MESSAGE_COUNT = 1000;
+
+// Number of splits showing the channel
+constexpr size_t VIEW_COUNT = 3;
+
+constexpr int LAYOUT_WIDTH = 400;
+
+class MockApplication : mock::EmptyApplication
+{
+public:
+    Theme *getThemes() override
+    {
+        return &this->theme;
+    }
+
+    Fonts *getFonts() override
+    {
+        return &this->fonts;
+    }
+
+    WindowManager *getWindows() override
+    {
+        return &this->windows;
+    }
+
+    Theme theme;
+    Fonts fonts;
+    // The window manager looks up its layout file in the paths
+    Paths paths;
+    WindowManager windows;
+};
+
+using Layouts = std::vector<std::unique_ptr<MessageLayout>>;
+
+std::vector<MessagePtr> sampleMessages()
+{
+    QStringList texts;
+    texts << getSampleMiscMessages() << getSampleCheerMessages()
+          << getSampleSubMessages() << getSampleLinkMessages();
+
+    std::vector<MessagePtr> messages;
+    for (int i = 0; i < MESSAGE_COUNT; ++i)
+    {
+        // Only the text after the tags and the command
+        auto text = texts[i % texts.size()];
+        if (text.startsWith('@'))
+        {
+            text = text.mid(text.indexOf(' ') + 1);
+        }
+        auto textStart = text.indexOf(" :");
+        if (textStart != -1)
+        {
+            text = text.mid(textStart + 2);
+        }
+
+        auto message = std::make_shared<Message>();
+        message->elements.push_back(std::make_unique<TextElement>(
+            QString("user%1:").arg(i % 50), MessageElementFlag::Username,
+            MessageColor::Text, FontStyle::ChatMediumBold));
+        message->elements.push_back(
+            std::make_unique<TextElement>(text, MessageElementFlag::Text));
+        messages.push_back(std::move(message));
+    }
+    return messages;
+}
+
+// Bytes held by the containers of all views, shared containers are only
+// counted once
+size_t containerBytes(const std::array<Layouts, VIEW_COUNT> &views)
+{
+    std::unordered_set<const MessageLayoutContainer *> containers;
+    size_t bytes = 0;
+    for (const auto &view : views)
+    {
+        for (const auto &layout : view)
+        {
+            const auto *container = layout->getContainer();
+            if (containers.insert(container).second)
+            {
+                bytes += container->memoryUsage();
+            }
+        }
+    }
+    return bytes;
+}
+
+// Every view lays out all messages of the channel, like three splits of the
+// same channel do after a relayout. Without sharing, the cache is cleared
+// before each view, so every view builds its own containers.
+void layoutViews(benchmark::State &state, bool shareLayouts)
+{
+    MockApplication mockApplication;
+    auto messages = sampleMessages();
+    auto &cache = MessageLayoutCache::instance();
+    MessageElementFlags flags{MessageElementFlag::Username,
+                              MessageElementFlag::Text};
+
+    // The words remember their widths, measure them once up front so both
+    // variants only differ in the layouts
+    for (const auto &message : messages)
+    {
+        MessageLayout(message).layout(LAYOUT_WIDTH, 1.F, flags);
+    }
+    cache.clear();
+
+    size_t bytes = 0;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        std::array<Layouts, VIEW_COUNT> views;
+        for (auto &view : views)
+        {
+            for (const auto &message : messages)
+            {
+                view.push_back(std::make_unique<MessageLayout>(message));
+            }
+        }
+        state.ResumeTiming();
+
+        for (auto &view : views)
+        {
+            if (!shareLayouts)
+            {
+                state.PauseTiming();
+                cache.clear();
+                state.ResumeTiming();
+            }
+
+            for (auto &layout : view)
+            {
+                layout->layout(LAYOUT_WIDTH, 1.F, flags);
+            }
+        }
+
+        state.PauseTiming();
+        bytes = containerBytes(views);
+        views = {};
+        cache.clear();
+        state.ResumeTiming();
+    }
+
+    state.counters["container bytes"] =
+        benchmark::Counter(static_cast<double>(bytes),
+                           benchmark::Counter::kDefaults,
+                           benchmark::Counter::kIs1024);
+}
+
+}  // namespace
+
+static void BM_LayoutViews_Uncached(benchmark::State &state)
+{
+    layoutViews(state, false);
+}
+
+static void BM_LayoutViews_Cached(benchmark::State &state)
+{
+    layoutViews(state, true);
+}
+
+BENCHMARK(BM_LayoutViews_Uncached)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LayoutViews_Cached)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,237 @@
+#include "messages/layouts/MessageLayoutContainer.hpp"
+
+#include "Application.hpp"
+#include "messages/layouts/MessageLayoutElement.hpp"
+#include "messages/Message.hpp"
+#include "messages/MessageElement.hpp"
+#include "mocks/EmptyApplication.hpp"
+#include "singletons/Fonts.hpp"
+#include "util/Qt.hpp"
+#include "util/SampleData.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QColor>
+#include <QImage>
+#include <QPainter>
+#include <QPoint>
+#include <QSize>
+#include <QStringList>
+#include <QTextOption>
+
+#include <memory>
+#include <vector>
+
+using namespace chatterino;
+
+class MockApplication : mock::EmptyApplication
+{
+public:
+    Fonts *getFonts() override
+    {
+        return &this->fonts;
+    }
+
+    Fonts fonts;
+};
+
+namespace {
+
+// Number of messages the mouse is dragged over
+constexpr int MESSAGE_COUNT = 500;
+
+// Number of messages laid out and painted for the throughput benchmarks
+constexpr int THROUGHPUT_MESSAGE_COUNT = 10000;
+
+struct LaidOutMessages {
+    std::vector<std::unique_ptr<MessageLayoutContainer>> containers;
+    // The elements of each container in the order they were added
+    std::vector<std::vector<TextLayoutElement *>> elements;
+};
+
+// The text of count sample messages, without tags and commands
+QStringList sampleTexts(int count)
+{
+    QStringList messages;
+    messages << getSampleMiscMessages() << getSampleCheerMessages()
+             << getSampleSubMessages() << getSampleLinkMessages();
+
+    QStringList texts;
+    for (int i = 0; i < count; ++i)
+    {
+        auto text = messages[i % messages.size()];
+        if (text.startsWith('@'))
+        {
+            text = text.mid(text.indexOf(' ') + 1);
+        }
+        auto textStart = text.indexOf(" :");
+        if (textStart != -1)
+        {
+            text = text.mid(textStart + 2);
+        }
+        texts.append(text);
+    }
+    return texts;
+}
+
+// Lays out the texts, each one repeated repeat times. The words alternate
+// between two colors, like the names and messages in chat.
+LaidOutMessages layoutMessages(TextElement &creator, Fonts &fonts,
+                               const QStringList &texts, int repeat)
+{
+    auto height = fonts.getFontMetrics(FontStyle::ChatMedium, 1.F).height();
+    const QColor colors[] = {QColor("#ffffff"), QColor("#8a2be2")};
+
+    LaidOutMessages result;
+    for (const auto &text : texts)
+    {
+        auto &container = result.containers.emplace_back(
+            std::make_unique<MessageLayoutContainer>());
+        auto &elements = result.elements.emplace_back();
+        auto words = text.split(' ', Qt::SkipEmptyParts);
+
+        container->begin(400, 1.F, MessageFlags());
+        container->reserve(size_t(words.size() * repeat));
+        for (int j = 0; j < repeat; ++j)
+        {
+            for (int k = 0; k < words.size(); ++k)
+            {
+                auto word = words[k];
+                auto width =
+                    fonts.getTextWidth(FontStyle::ChatMedium, 1.F, word);
+                auto *element = container->makeElement<TextLayoutElement>(
+                    creator, word, QSize(width, height), colors[k % 2],
+                    FontStyle::ChatMedium, 1.F);
+                container->addElement(element);
+                elements.push_back(element);
+            }
+        }
+        container->end();
+    }
+    return result;
+}
+
+std::vector<std::unique_ptr<MessageLayoutContainer>> layoutMessages(
+    TextElement &creator, Fonts &fonts, int repeat)
+{
+    return layoutMessages(creator, fonts, sampleTexts(MESSAGE_COUNT), repeat)
+        .containers;
+}
+
+}  // namespace
+
+// Mouse moves of a drag selection over every line of every message, each one
+// looks up the hovered element and the selection index
+static void BM_DragSelection(benchmark::State &state)
+{
+    MockApplication mockApplication;
+    TextElement creator("", MessageElementFlag::Text);
+    auto containers = layoutMessages(creator, mockApplication.fonts,
+                                     int(state.range(0)));
+
+    int moves = 0;
+    for (auto _ : state)
+    {
+        moves = 0;
+        for (const auto &container : containers)
+        {
+            for (int y = 0; y < container->getHeight(); y += 4)
+            {
+                for (int x = 0; x < 400; x += 20)
+                {
+                    QPoint point(x, y);
+                    benchmark::DoNotOptimize(container->getElementAt(point));
+                    benchmark::DoNotOptimize(
+                        container->getSelectionIndex(point));
+                    moves++;
+                }
+            }
+        }
+    }
+
+    state.counters["moves"] = moves;
+}
+
+// Short chat messages and copypastas that are 10 and 50 times as long
+BENCHMARK(BM_DragSelection)->Arg(1)->Arg(10)->Arg(50);
+
+// Lays out THROUGHPUT_MESSAGE_COUNT sample messages: making the elements,
+// breaking lines and building the flat arrays that are painted
+static void BM_LayoutMessages(benchmark::State &state)
+{
+    MockApplication mockApplication;
+    TextElement creator("", MessageElementFlag::Text);
+    auto texts = sampleTexts(THROUGHPUT_MESSAGE_COUNT);
+
+    for (auto _ : state)
+    {
+        auto messages =
+            layoutMessages(creator, mockApplication.fonts, texts, 1);
+        benchmark::DoNotOptimize(messages.containers.back()->getHeight());
+    }
+
+    state.counters["messages"] = benchmark::Counter(
+        double(THROUGHPUT_MESSAGE_COUNT) * double(state.iterations()),
+        benchmark::Counter::kIsRate);
+}
+
+// Paints THROUGHPUT_MESSAGE_COUNT laid out messages into a message buffer
+static void BM_PaintMessages(benchmark::State &state)
+{
+    MockApplication mockApplication;
+    TextElement creator("", MessageElementFlag::Text);
+    auto messages = layoutMessages(creator, mockApplication.fonts,
+                                   sampleTexts(THROUGHPUT_MESSAGE_COUNT), 1);
+    QImage buffer(400, 200, QImage::Format_ARGB32_Premultiplied);
+
+    for (auto _ : state)
+    {
+        for (const auto &container : messages.containers)
+        {
+            QPainter painter(&buffer);
+            container->paintElements(painter);
+        }
+    }
+
+    state.counters["messages"] = benchmark::Counter(
+        double(THROUGHPUT_MESSAGE_COUNT) * double(state.iterations()),
+        benchmark::Counter::kIsRate);
+}
+
+// The same messages painted the way every text element painted itself:
+// setting the pen and font and laying out the text in a rect for every word
+static void BM_PaintMessages_PerElement(benchmark::State &state)
+{
+    MockApplication mockApplication;
+    TextElement creator("", MessageElementFlag::Text);
+    auto messages = layoutMessages(creator, mockApplication.fonts,
+                                   sampleTexts(THROUGHPUT_MESSAGE_COUNT), 1);
+    QImage buffer(400, 200, QImage::Format_ARGB32_Premultiplied);
+
+    for (auto _ : state)
+    {
+        for (const auto &elements : messages.elements)
+        {
+            QPainter painter(&buffer);
+            for (const auto *element : elements)
+            {
+                // The direction was checked on every paint
+                benchmark::DoNotOptimize(element->getText().isRightToLeft());
+                painter.setPen(element->getColor());
+                painter.setFont(mockApplication.fonts.getFont(
+                    element->getStyle(), element->getScale()));
+                painter.drawText(QRectF(element->getRect().x(),
+                                        element->getRect().y(), 10000, 10000),
+                                 element->getText(),
+                                 QTextOption(Qt::AlignLeft | Qt::AlignTop));
+            }
+        }
+    }
+
+    state.counters["messages"] = benchmark::Counter(
+        double(THROUGHPUT_MESSAGE_COUNT) * double(state.iterations()),
+        benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_LayoutMessages)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PaintMessages)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PaintMessages_PerElement)->Unit(benchmark::kMillisecond);
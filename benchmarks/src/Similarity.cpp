@@ -0,0 +1,136 @@
+#include "util/Similarity.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QString>
+#include <QTime>
+
+#include <algorithm>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+const QString COPYPASTA =
+    "I'm so tired of people in chat spamming the same copypasta over and over "
+    "again, it's not funny anymore and it makes it really hard to follow the "
+    "actual conversation. Can the mods please do something about this? Every "
+    "single stream it's the same thing, somebody posts a wall of text and "
+    "then hundreds of people copy it with a couple of characters changed so "
+    "the filters don't catch it. forsenE forsenE forsenE";
+
+// A spam wave: the same copypasta with small edits, mixed with some
+// unrelated messages
+std::vector<QString> spamWave()
+{
+    std::vector<QString> messages;
+    for (int i = 0; i < 256; ++i)
+    {
+        if (i % 8 == 7)
+        {
+            messages.push_back(
+                QString("unrelated message number %1 LUL").arg(i));
+            continue;
+        }
+
+        auto message = COPYPASTA;
+        message.insert((i * 37) % message.size(), QString::number(i));
+        if (i % 2 == 0)
+        {
+            message.append(" ");
+            message.append(QString::number(i * 7));
+        }
+        messages.push_back(message);
+    }
+    return messages;
+}
+
+// The table based implementation similarity used to be computed with
+float tableSimilarity(const QString &str1, const QString &str2)
+{
+    std::vector<std::vector<int>> tree(str1.size(),
+                                       std::vector<int>(str2.size(), 0));
+    int z = 0;
+
+    for (int i = 0; i < str1.size(); ++i)
+    {
+        for (int j = 0; j < str2.size(); ++j)
+        {
+            if (str1[i] == str2[j])
+            {
+                if (i == 0 || j == 0)
+                {
+                    tree[i][j] = 1;
+                }
+                else
+                {
+                    tree[i][j] = tree[i - 1][j - 1] + 1;
+                }
+                if (tree[i][j] > z)
+                {
+                    z = tree[i][j];
+                }
+            }
+            else
+            {
+                tree[i][j] = 0;
+            }
+        }
+    }
+
+    return z == 0 ? 0.F
+                  : static_cast<float>(z) /
+                        static_cast<float>(std::max(str1.size(), str2.size()));
+}
+
+}  // namespace
+
+// Baseline: every message is compared to the previous ones with the table
+// based implementation, like it was done on a snapshot of the channel
+static void BM_Similarity_SpamWave_Table(benchmark::State &state)
+{
+    const auto messages = spamWave();
+    const auto maxMessages = static_cast<size_t>(state.range(0));
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < messages.size(); ++i)
+        {
+            float similarity = 0.F;
+            for (size_t j = 1; j <= std::min(i, maxMessages); ++j)
+            {
+                similarity = std::max(
+                    similarity, tableSimilarity(messages[i], messages[i - j]));
+            }
+            benchmark::DoNotOptimize(similarity);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<int64_t>(messages.size()));
+}
+
+static void BM_Similarity_SpamWave_History(benchmark::State &state)
+{
+    const auto messages = spamWave();
+    const auto maxMessages = static_cast<int>(state.range(0));
+    const QTime now(12, 0, 0);
+
+    for (auto _ : state)
+    {
+        SimilarityHistory history;
+        for (const auto &message : messages)
+        {
+            benchmark::DoNotOptimize(history.similarity(
+                message, "forsen", now, maxMessages, 60, false));
+            history.add(message, "forsen", now);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<int64_t>(messages.size()));
+}
+
+// 3 is the default number of messages to check
+BENCHMARK(BM_Similarity_SpamWave_Table)->Arg(3)->Arg(20);
+BENCHMARK(BM_Similarity_SpamWave_History)->Arg(3)->Arg(20);
@@ -0,0 +1,225 @@
+#include "singletons/helper/TextWidthCache.hpp"
+
+#include "Application.hpp"
+#include "messages/layouts/MessageLayoutContainer.hpp"
+#include "messages/Message.hpp"
+#include "messages/MessageElement.hpp"
+#include "mocks/EmptyApplication.hpp"
+#include "singletons/Fonts.hpp"
+#include "singletons/Theme.hpp"
+#include "util/Qt.hpp"
+#include "util/SampleData.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QFont>
+#include <QFontMetrics>
+#include <QStringList>
+
+#include <memory>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+// Number of messages laid out per iteration
+constexpr int MESSAGE_COUNT = 10000;
+
+// Width of the split the messages are laid out in
+constexpr int LAYOUT_WIDTH = 400;
+
+class MockApplication : mock::EmptyApplication
+{
+public:
+    Theme *getThemes() override
+    {
+        return &this->theme;
+    }
+
+    Fonts *getFonts() override
+    {
+        return this->fonts.get();
+    }
+
+    Theme theme;
+    std::unique_ptr<Fonts> fonts = std::make_unique<Fonts>();
+};
+
+// The text of MESSAGE_COUNT sample messages, without tags and commands
+QStringList sampleTexts()
+{
+    QStringList messages;
+    messages << getSampleMiscMessages() << getSampleCheerMessages()
+             << getSampleSubMessages() << getSampleEmoteTestMessages()
+             << getSampleLinkMessages();
+
+    QStringList texts;
+    for (int i = 0; i < MESSAGE_COUNT; ++i)
+    {
+        auto text = messages[i % messages.size()];
+        if (text.startsWith('@'))
+        {
+            text = text.mid(text.indexOf(' ') + 1);
+        }
+        auto textStart = text.indexOf(" :");
+        if (textStart != -1)
+        {
+            text = text.mid(textStart + 2);
+        }
+        texts.append(text);
+    }
+    return texts;
+}
+
+// The words of MESSAGE_COUNT sample messages
+std::vector<QString> sampleWords()
+{
+    std::vector<QString> words;
+    for (const auto &text : sampleTexts())
+    {
+        for (const auto &word : text.split(' ', Qt::SkipEmptyParts))
+        {
+            words.push_back(word);
+        }
+    }
+    return words;
+}
+
+std::vector<std::unique_ptr<TextElement>> sampleElements()
+{
+    std::vector<std::unique_ptr<TextElement>> elements;
+    for (const auto &text : sampleTexts())
+    {
+        elements.push_back(
+            std::make_unique<TextElement>(text, MessageElementFlag::Text));
+    }
+    return elements;
+}
+
+// Lays out every element as its own message, like the views do on a relayout
+void layoutElements(const std::vector<std::unique_ptr<TextElement>> &elements)
+{
+    for (const auto &element : elements)
+    {
+        MessageLayoutContainer container;
+        container.begin(LAYOUT_WIDTH, 1.F, MessageFlags());
+        element->addToContainer(container, MessageElementFlag::Text);
+        container.end();
+        benchmark::DoNotOptimize(container.getHeight());
+    }
+}
+
+QFont chatFont()
+{
+    return QFont("Arial", 11);
+}
+
+}  // namespace
+
+// Measures every word like TextElement::addToContainer did on every layout
+void BM_TextWidth_Uncached(benchmark::State &state)
+{
+    auto words = sampleWords();
+    QFontMetrics metrics(chatFont());
+
+    for (auto _ : state)
+    {
+        for (const auto &word : words)
+        {
+            benchmark::DoNotOptimize(metrics.horizontalAdvance(word));
+        }
+    }
+
+    state.counters["words"] = double(words.size());
+}
+
+// Laying the same messages out again, e.g. after resizing a split
+void BM_TextWidth_Cached(benchmark::State &state)
+{
+    auto words = sampleWords();
+    TextWidthCache cache{QFontMetrics(chatFont())};
+    for (const auto &word : words)
+    {
+        cache.width(word);
+    }
+
+    for (auto _ : state)
+    {
+        for (const auto &word : words)
+        {
+            benchmark::DoNotOptimize(cache.width(word));
+        }
+    }
+
+    state.counters["words"] = double(words.size());
+    state.counters["unique words"] = double(cache.size());
+}
+
+// The first layout of new messages with a cache that has seen chat before
+void BM_TextWidth_CachedCold(benchmark::State &state)
+{
+    auto words = sampleWords();
+    QFontMetrics metrics(chatFont());
+
+    for (auto _ : state)
+    {
+        TextWidthCache cache(metrics);
+        for (const auto &word : words)
+        {
+            benchmark::DoNotOptimize(cache.width(word));
+        }
+    }
+
+    state.counters["words"] = double(words.size());
+}
+
+BENCHMARK(BM_TextWidth_Uncached);
+BENCHMARK(BM_TextWidth_Cached);
+BENCHMARK(BM_TextWidth_CachedCold);
+
+// Relayouts of MESSAGE_COUNT messages where every word is measured again, like
+// every relayout before the widths were cached. The fonts and the messages
+// are new in every iteration, so this also includes filling the caches.
+void BM_Relayout_Uncached(benchmark::State &state)
+{
+    MockApplication mockApplication;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        mockApplication.fonts = std::make_unique<Fonts>();
+        auto elements = sampleElements();
+        state.ResumeTiming();
+
+        layoutElements(elements);
+
+        state.PauseTiming();
+        elements.clear();
+        state.ResumeTiming();
+    }
+
+    state.counters["messages"] = benchmark::Counter(
+        double(MESSAGE_COUNT) * double(state.iterations()),
+        benchmark::Counter::kIsRate);
+}
+
+// Relayouts of the same MESSAGE_COUNT messages, e.g. after resizing a split.
+// The words remember their widths from the previous layout.
+void BM_Relayout_Cached(benchmark::State &state)
+{
+    MockApplication mockApplication;
+    auto elements = sampleElements();
+    layoutElements(elements);
+
+    for (auto _ : state)
+    {
+        layoutElements(elements);
+    }
+
+    state.counters["messages"] = benchmark::Counter(
+        double(MESSAGE_COUNT) * double(state.iterations()),
+        benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_Relayout_Uncached)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Relayout_Cached)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,229 @@
+#include "providers/twitch/TwitchMessageBuilder.hpp"
+
+#include "common/Channel.hpp"
+#include "MessageBuilderApplication.hpp"
+#include "messages/Message.hpp"
+#include "providers/twitch/TwitchEmotes.hpp"
+#include "singletons/Emotes.hpp"
+
+#include <benchmark/benchmark.h>
+#include <IrcMessage>
+#include <QString>
+#include <QStringList>
+
+#include <cstdint>
+#include <memory>
+
+using namespace chatterino;
+
+// Allocations are counted by wrapping glibc's malloc, which operator new
+// calls too. Qt allocates the data of QStrings and its containers with malloc,
+// so replacing operator new alone would miss them. Sanitizers wrap malloc
+// themselves.
+#if defined(__has_feature)
+#    if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer)
+#        define C2_SANITIZED
+#    endif
+#endif
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#    define C2_SANITIZED
+#endif
+
+#if defined(__GLIBC__) && !defined(C2_SANITIZED)
+#    define C2_COUNT_ALLOCATIONS
+#endif
+
+namespace {
+
+// Allocations are only counted on a thread while it has an AllocationCounter,
+// the other benchmarks and Qt's threads aren't affected
+thread_local bool countAllocations = false;
+thread_local int64_t allocationCount = 0;
+
+class AllocationCounter
+{
+public:
+    AllocationCounter()
+        : start_(allocationCount)
+    {
+        countAllocations = true;
+    }
+
+    ~AllocationCounter()
+    {
+        countAllocations = false;
+    }
+
+    AllocationCounter(const AllocationCounter &) = delete;
+    AllocationCounter &operator=(const AllocationCounter &) = delete;
+
+    int64_t count() const
+    {
+        return allocationCount - this->start_;
+    }
+
+private:
+    int64_t start_;
+};
+
+}  // namespace
+
+#ifdef C2_COUNT_ALLOCATIONS
+extern "C" {
+
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size) noexcept
+{
+    if (countAllocations)
+    {
+        allocationCount++;
+    }
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) noexcept
+{
+    if (countAllocations)
+    {
+        allocationCount++;
+    }
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) noexcept
+{
+    if (countAllocations)
+    {
+        allocationCount++;
+    }
+    return __libc_realloc(ptr, size);
+}
+
+}  // extern "C"
+#endif
+
+namespace {
+
+const QByteArray PRIVMSG =
+    R"(@badge-info=subscriber/80;badges=broadcaster/1,subscriber/3072,partner/1;color=#CC44FF;display-name=pajlada;emotes=25:0-4,62-66/1902:29-33/305954156:40-47,87-94;first-msg=0;flags=;id=44f85d39-b5fb-475d-8555-f4244f2f7e82;mod=0;returning-chatter=0;room-id=11148817;subscriber=1;tmi-sent-ts=1662204423418;turbo=0;user-id=11148817;user-type= :pajlada!pajlada@pajlada.tmi.twitch.tv PRIVMSG #pajlada :Kappa this is a message with Keepo some PogChamp emotes in it Kappa and quite a lot of PogChamp text https://chatterino.com @forsen)";
+
+struct Fixture {
+    MessageBuilderApplication app;
+    std::unique_ptr<Communi::IrcPrivateMessage> message;
+    QString content;
+
+    Fixture()
+        : message(static_cast<Communi::IrcPrivateMessage *>(
+              Communi::IrcPrivateMessage::fromData(PRIVMSG, nullptr)))
+        , content(message->content())
+    {
+    }
+};
+
+void reportAllocations(benchmark::State &state, int64_t allocations)
+{
+#ifdef C2_COUNT_ALLOCATIONS
+    state.counters["allocs/msg"] = benchmark::Counter(
+        static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+#else
+    (void)state;
+    (void)allocations;
+#endif
+}
+
+}  // namespace
+
+// Builds the whole message, from parsing the tags to the reply button. The
+// channel isn't a Twitch channel, so emotes are looked up in the global ones.
+static void BM_TwitchMessageBuilder_Build(benchmark::State &state)
+{
+    Fixture data;
+    auto channel = Channel::getEmpty();
+    MessageParseArgs args;
+    int64_t allocations = 0;
+
+    for (auto _ : state)
+    {
+        AllocationCounter counter;
+
+        TwitchMessageBuilder builder(channel.get(), data.message.get(), args);
+        benchmark::DoNotOptimize(builder.build());
+
+        allocations += counter.count();
+    }
+
+    reportAllocations(state, allocations);
+}
+
+// Baseline: the emotes tag and the message are split into QStringLists like
+// the builder used to do
+static void BM_TwitchMessageBuilder_SplitWords(benchmark::State &state)
+{
+    Fixture data;
+    auto *twitchEmotes = data.app.getEmotes()->getTwitchEmotes();
+    int64_t allocations = 0;
+
+    for (auto _ : state)
+    {
+        AllocationCounter counter;
+
+        auto emotesTag = data.message->tags().value("emotes").toString();
+        for (const auto &emote : emotesTag.split('/'))
+        {
+            auto parameters = emote.split(':');
+            auto id = EmoteId{parameters.at(0)};
+            for (const auto &occurrence : parameters.at(1).split(','))
+            {
+                auto coords = occurrence.split('-');
+                auto start = coords.at(0).toInt();
+                auto end = coords.at(1).toInt();
+                auto name =
+                    EmoteName{data.content.mid(start, end - start + 1)};
+                benchmark::DoNotOptimize(
+                    twitchEmotes->getOrCreateEmote(id, name));
+            }
+        }
+
+        benchmark::DoNotOptimize(data.content.split(' '));
+
+        allocations += counter.count();
+    }
+
+    reportAllocations(state, allocations);
+}
+
+// Emotes are parsed and the message is tokenized without splitting, only
+// text tokens are copied into QStrings
+static void BM_TwitchMessageBuilder_Tokenize(benchmark::State &state)
+{
+    Fixture data;
+    int64_t allocations = 0;
+
+    for (auto _ : state)
+    {
+        AllocationCounter counter;
+
+        auto emotes = TwitchMessageBuilder::parseTwitchEmotes(
+            data.message->tags(), data.content, 0);
+        auto tokens =
+            TwitchMessageBuilder::tokenizeMessage(data.content, emotes);
+        for (const auto &token : tokens)
+        {
+            if (token.twitchEmote == nullptr)
+            {
+                benchmark::DoNotOptimize(token.text.toString());
+            }
+        }
+
+        allocations += counter.count();
+    }
+
+    reportAllocations(state, allocations);
+}
+
+BENCHMARK(BM_TwitchMessageBuilder_Build);
+BENCHMARK(BM_TwitchMessageBuilder_SplitWords);
+BENCHMARK(BM_TwitchMessageBuilder_Tokenize);
@@ -1,3 +1,4 @@
+#include "singletons/Resources.hpp"
 #include "singletons/Settings.hpp"
 
 #include <benchmark/benchmark.h>
@@ -15,6 +16,9 @@ int main(int argc, char **argv)
     // Ensure settings are initialized before any tests are run
     chatterino::Settings settings("/tmp/c2-empty-mock");
 
+    // Message builders add resource images, like the reply button
+    initResources();
+
     QtConcurrent::run([&app] {
         ::benchmark::RunSpecifiedBenchmarks();
 
@@ -72,6 +72,21 @@ public:
         return nullptr;
     }
 
+    HomiesBadges *getHomiesBadges() override
+    {
+        return nullptr;
+    }
+
+    SeventvBadges *getSeventvBadges() override
+    {
+        return nullptr;
+    }
+
+    SeventvPersonalEmotes *getSeventvPersonalEmotes() override
+    {
+        return nullptr;
+    }
+
     IUserDataController *getUserData() override
     {
         return nullptr;
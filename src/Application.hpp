@@ -64,6 +64,8 @@ public:
     virtual ChatterinoBadges *getChatterinoBadges() = 0;
     virtual FfzBadges *getFfzBadges() = 0;
     virtual HomiesBadges *getHomiesBadges() = 0;
+    virtual SeventvBadges *getSeventvBadges() = 0;
+    virtual SeventvPersonalEmotes *getSeventvPersonalEmotes() = 0;
     virtual IUserDataController *getUserData() = 0;
 };
 
@@ -163,6 +165,14 @@ public:
     {
         return this->homiesBadges;
     }
+    SeventvBadges *getSeventvBadges() override
+    {
+        return this->seventvBadges;
+    }
+    SeventvPersonalEmotes *getSeventvPersonalEmotes() override
+    {
+        return this->seventvPersonalEmotes;
+    }
     IUserDataController *getUserData() override;
 
 private:
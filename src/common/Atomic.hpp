@@ -2,6 +2,8 @@
 
 #include <boost/noncopyable.hpp>
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 
 namespace chatterino {
@@ -45,4 +47,50 @@ private:
     T value_;
 };
 
+#if defined(__cpp_lib_atomic_shared_ptr)
+
+/**
+ * @brief Atomic holding a shared_ptr, readers don't take a mutex
+ *
+ * Emote maps and similar snapshots are read for every message but only
+ * replaced on (live) updates. Readers load the pointer atomically and share
+ * ownership of the snapshot, so builder threads don't wait on each other.
+ *
+ * Standard libraries without std::atomic<std::shared_ptr> use the mutex
+ * based Atomic above.
+ */
+template <typename T>
+class Atomic<std::shared_ptr<T>> : boost::noncopyable
+{
+public:
+    Atomic()
+    {
+    }
+
+    Atomic(std::shared_ptr<T> &&val)
+        : value_(std::move(val))
+    {
+    }
+
+    std::shared_ptr<T> get() const
+    {
+        return this->value_.load(std::memory_order_acquire);
+    }
+
+    void set(const std::shared_ptr<T> &val)
+    {
+        this->value_.store(val, std::memory_order_release);
+    }
+
+    void set(std::shared_ptr<T> &&val)
+    {
+        this->value_.store(std::move(val), std::memory_order_release);
+    }
+
+private:
+    std::atomic<std::shared_ptr<T>> value_;
+};
+
+#endif
+
 }  // namespace chatterino
@@ -19,8 +19,45 @@
 #include <QNetworkReply>
 #include <QNetworkRequest>
 
+#include <algorithm>
+
 namespace chatterino {
 
+namespace {
+
+/// Returns the lowercase names of the users a message belongs to, i.e. the
+/// sender, the target of a moderation action and the subscriber of a
+/// subscription message.
+std::vector<QString> userIndexKeys(const Message &message)
+{
+    std::vector<QString> keys;
+
+    auto addKey = [&keys](const QString &name) {
+        if (name.isEmpty())
+        {
+            return;
+        }
+
+        auto key = name.toLower();
+        if (std::find(keys.begin(), keys.end(), key) == keys.end())
+        {
+            keys.push_back(std::move(key));
+        }
+    };
+
+    addKey(message.loginName);
+    addKey(message.timeoutUser);
+    if (message.flags.has(MessageFlag::Subscription) &&
+        message.loginName.isEmpty())
+    {
+        addKey(message.messageText.section(' ', 0, 0));
+    }
+
+    return keys;
+}
+
+}  // namespace
+
 //
 // Channel
 //
@@ -31,6 +68,12 @@ Channel::Channel(const QString &name, Type type)
     , messages_(getSettings()->scrollbackSplitLimit)
     , type_(type)
 {
+    QObject::connect(&this->flushQueuedMessagesTimer_, &QTimer::timeout,
+                     [this] {
+                         this->flushQueuedMessages();
+                     });
+    this->flushQueuedMessagesTimer_.setInterval(0);
+    this->flushQueuedMessagesTimer_.setSingleShot(true);
 }
 
 Channel::~Channel()
@@ -70,40 +113,43 @@ bool Channel::isEmpty() const
 
 bool Channel::hasMessages() const
 {
-    return !this->messages_.empty();
+    return !this->messages_.empty() || !this->queuedMessages_.empty();
 }
 
 LimitedQueueSnapshot<MessagePtr> Channel::getMessageSnapshot()
 {
+    this->flushQueuedMessages();
+
     return this->messages_.getSnapshot();
 }
 
 void Channel::addMessage(MessagePtr message,
                          boost::optional<MessageFlags> overridingFlags)
 {
-    auto app = getApp();
+    this->flushQueuedMessages();
+
     MessagePtr deleted;
 
     if (!overridingFlags || !overridingFlags->has(MessageFlag::DoNotLog))
     {
-        QString channelPlatform("other");
-        if (this->type_ == Type::Irc)
-        {
-            auto *irc = dynamic_cast<IrcChannel *>(this);
-            if (irc != nullptr)
-            {
-                channelPlatform = QString("irc-%1").arg(
-                    irc->server()->userFriendlyIdentifier());
-            }
-        }
-        else if (this->isTwitchChannel())
+        getApp()->logging->addMessage(this->name_, message,
+                                      this->loggingPlatform());
+    }
+
+    bool removed = false;
+    {
+        std::lock_guard lock(this->indexMutex_);
+
+        removed = this->messages_.pushBack(message, deleted);
+        if (removed)
         {
-            channelPlatform = "twitch";
+            this->unindexMessage(deleted);
+            ++this->firstSequence_;
         }
-        app->logging->addMessage(this->name_, message, channelPlatform);
+        this->indexMessage(message, this->nextSequence_++, true);
     }
 
-    if (this->messages_.pushBack(message, deleted))
+    if (removed)
     {
         this->messageRemovedFromStart.invoke(deleted);
     }
@@ -111,8 +157,91 @@ void Channel::addMessage(MessagePtr message,
     this->messageAppended.invoke(message, overridingFlags);
 }
 
+void Channel::addMessages(std::vector<MessagePtr> messages, bool log)
+{
+    this->flushQueuedMessages();
+
+    if (messages.empty())
+    {
+        return;
+    }
+
+    if (log)
+    {
+        getApp()->logging->addMessages(this->name_, messages,
+                                       this->loggingPlatform());
+    }
+
+    std::vector<MessagePtr> deleted;
+    {
+        std::lock_guard lock(this->indexMutex_);
+
+        this->messages_.pushBackItems(messages, deleted);
+        for (const auto &message : deleted)
+        {
+            this->unindexMessage(message);
+            ++this->firstSequence_;
+        }
+        for (const auto &message : messages)
+        {
+            this->indexMessage(message, this->nextSequence_++, true);
+        }
+    }
+
+    for (auto &message : deleted)
+    {
+        this->messageRemovedFromStart.invoke(message);
+    }
+
+    this->messagesAppended.invoke(messages);
+}
+
+void Channel::queueMessage(MessagePtr message)
+{
+    this->queuedMessages_.push_back(std::move(message));
+    if (!this->flushQueuedMessagesTimer_.isActive())
+    {
+        this->flushQueuedMessagesTimer_.start();
+    }
+}
+
+void Channel::flushQueuedMessages()
+{
+    if (this->queuedMessages_.empty())
+    {
+        return;
+    }
+
+    this->flushQueuedMessagesTimer_.stop();
+
+    std::vector<MessagePtr> messages;
+    messages.swap(this->queuedMessages_);
+    this->addMessages(std::move(messages));
+}
+
+QString Channel::loggingPlatform()
+{
+    if (this->type_ == Type::Irc)
+    {
+        auto *irc = dynamic_cast<IrcChannel *>(this);
+        if (irc != nullptr)
+        {
+            return QString("irc-%1").arg(
+                irc->server()->userFriendlyIdentifier());
+        }
+    }
+    else if (this->isTwitchChannel())
+    {
+        return "twitch";
+    }
+
+    return "other";
+}
+
 void Channel::addOrReplaceTimeout(MessagePtr message)
 {
+    this->flushQueuedMessages();
+
     LimitedQueueSnapshot<MessagePtr> snapshot = this->getMessageSnapshot();
     int snapshotLength = snapshot.size();
 
@@ -185,9 +314,8 @@ void Channel::addOrReplaceTimeout(MessagePtr message)
     }
 
     // disable the messages from the user
-    for (int i = 0; i < snapshotLength; i++)
+    for (const auto &s : this->getUserMessages(message->timeoutUser))
     {
-        auto &s = snapshot[i];
         if (s->loginName == message->timeoutUser &&
             s->flags.hasNone({MessageFlag::Timeout, MessageFlag::Untimeout,
                               MessageFlag::Whisper}))
@@ -209,6 +337,8 @@ void Channel::addOrReplaceTimeout(MessagePtr message)
 
 void Channel::disableAllMessages()
 {
+    this->flushQueuedMessages();
+
     LimitedQueueSnapshot<MessagePtr> snapshot = this->getMessageSnapshot();
     int snapshotLength = snapshot.size();
     for (int i = 0; i < snapshotLength; i++)
@@ -227,8 +357,22 @@ void Channel::disableAllMessages()
 
 void Channel::addMessagesAtStart(const std::vector<MessagePtr> &_messages)
 {
-    std::vector<MessagePtr> addedMessages =
-        this->messages_.pushFront(_messages);
+    this->flushQueuedMessages();
+
+    std::vector<MessagePtr> addedMessages;
+    {
+        std::lock_guard lock(this->indexMutex_);
+
+        addedMessages = this->messages_.pushFront(_messages);
+        this->firstSequence_ -= int64_t(addedMessages.size());
+
+        // Messages added at the start are older than the ones we already have
+        for (size_t i = 0; i < addedMessages.size(); ++i)
+        {
+            this->indexMessage(addedMessages[i],
+                               this->firstSequence_ + int64_t(i), false);
+        }
+    }
 
     if (addedMessages.size() != 0)
     {
@@ -238,6 +382,8 @@ void Channel::addMessagesAtStart(const std::vector<MessagePtr> &_messages)
 
 void Channel::fillInMissingMessages(const std::vector<MessagePtr> &messages)
 {
+    this->flushQueuedMessages();
+
     if (messages.empty())
     {
         return;
@@ -249,6 +395,7 @@ void Channel::fillInMissingMessages(const std::vector<MessagePtr> &messages)
         // There are no messages in this channel yet so we can just insert them
         // at the front in order
         this->messages_.pushFront(messages);
+        this->rebuildMessageIndex();
         this->filledInMessages.invoke(messages);
         return;
     }
@@ -317,6 +464,10 @@ void Channel::fillInMissingMessages(const std::vector<MessagePtr> &messages)
 
     if (anyInserted)
     {
+        // Inserting into a full channel silently drops messages from the start
+        // and insertions can happen anywhere, so the index is rebuilt once.
+        this->rebuildMessageIndex();
+
         // We only invoke a signal once at the end of filling all messages to
         // prevent doing any unnecessary repaints.
         this->filledInMessages.invoke(messages);
@@ -325,7 +476,19 @@ void Channel::fillInMissingMessages(const std::vector<MessagePtr> &messages)
 
 void Channel::replaceMessage(MessagePtr message, MessagePtr replacement)
 {
-    int index = this->messages_.replaceItem(message, replacement);
+    this->flushQueuedMessages();
+
+    int index = -1;
+    {
+        std::lock_guard lock(this->indexMutex_);
+
+        index = this->messages_.replaceItem(message, replacement);
+        if (index >= 0)
+        {
+            this->unindexMessage(message);
+            this->indexMessage(replacement, this->firstSequence_ + index, true);
+        }
+    }
 
     if (index >= 0)
     {
@@ -335,7 +498,23 @@ void Channel::replaceMessage(MessagePtr message, MessagePtr replacement)
 
 void Channel::replaceMessage(size_t index, MessagePtr replacement)
 {
-    if (this->messages_.replaceItem(index, replacement))
+    this->flushQueuedMessages();
+
+    bool replaced = false;
+    {
+        std::lock_guard lock(this->indexMutex_);
+
+        auto message = this->messages_.get(index);
+        replaced = this->messages_.replaceItem(index, replacement);
+        if (replaced)
+        {
+            this->unindexMessage(*message);
+            this->indexMessage(replacement,
+                               this->firstSequence_ + int64_t(index), true);
+        }
+    }
+
+    if (replaced)
     {
         this->messageReplaced.invoke(index, replacement);
     }
@@ -343,6 +522,8 @@ void Channel::replaceMessage(size_t index, MessagePtr replacement)
 
 void Channel::deleteMessage(QString messageID)
 {
+    this->flushQueuedMessages();
+
     auto msg = this->findMessage(messageID);
     if (msg != nullptr)
     {
@@ -352,17 +533,162 @@ void Channel::deleteMessage(QString messageID)
 
 MessagePtr Channel::findMessage(QString messageID)
 {
-    MessagePtr res;
+    this->flushQueuedMessages();
+
+    if (messageID.isEmpty())
+    {
+        return nullptr;
+    }
+
+    std::lock_guard lock(this->indexMutex_);
+
+    auto it = this->messagesById_.find(messageID);
+    if (it == this->messagesById_.end())
+    {
+        return nullptr;
+    }
+
+    return it->second;
+}
+
+std::vector<MessagePtr> Channel::getUserMessages(const QString &userLogin,
+                                                 size_t lookback)
+{
+    this->flushQueuedMessages();
+
+    std::vector<MessagePtr> messages;
+
+    std::lock_guard lock(this->indexMutex_);
+
+    auto it = this->messagesByUser_.find(userLogin.toLower());
+    if (it == this->messagesByUser_.end())
+    {
+        return messages;
+    }
+
+    const auto &entries = it->second;
+    auto available = this->nextSequence_ - this->firstSequence_;
+    auto minSequence = lookback >= size_t(available)
+                           ? this->firstSequence_
+                           : this->nextSequence_ - int64_t(lookback);
+
+    auto first = std::lower_bound(entries.begin(), entries.end(), minSequence,
+                                  [](const UserMessage &entry, int64_t seq) {
+                                      return entry.sequence < seq;
+                                  });
+    messages.reserve(std::distance(first, entries.end()));
+    for (; first != entries.end(); ++first)
+    {
+        messages.push_back(first->message);
+    }
+
+    return messages;
+}
+
+void Channel::indexMessage(const MessagePtr &message, int64_t sequence,
+                           bool overwriteId)
+{
+    if (message == nullptr)
+    {
+        return;
+    }
+
+    if (!message->id.isEmpty())
+    {
+        if (overwriteId)
+        {
+            this->messagesById_[message->id] = message;
+        }
+        else
+        {
+            this->messagesById_.try_emplace(message->id, message);
+        }
+    }
+
+    for (const auto &key : userIndexKeys(*message))
+    {
+        auto &entries = this->messagesByUser_[key];
+        UserMessage entry{sequence, message};
+
+        // Appends and pushes to the front are the common cases
+        if (entries.empty() || entries.back().sequence < sequence)
+        {
+            entries.push_back(std::move(entry));
+        }
+        else if (entries.front().sequence > sequence)
+        {
+            entries.push_front(std::move(entry));
+        }
+        else
+        {
+            auto it = std::lower_bound(
+                entries.begin(), entries.end(), sequence,
+                [](const UserMessage &e, int64_t seq) {
+                    return e.sequence < seq;
+                });
+            entries.insert(it, std::move(entry));
+        }
+    }
+}
+
+void Channel::unindexMessage(const MessagePtr &message)
+{
+    if (message == nullptr)
+    {
+        return;
+    }
 
-    if (auto msg = this->messages_.rfind([&messageID](const MessagePtr &msg) {
-            return msg->id == messageID;
-        });
-        msg)
+    if (!message->id.isEmpty())
     {
-        res = *msg;
+        auto it = this->messagesById_.find(message->id);
+        if (it != this->messagesById_.end() && it->second == message)
+        {
+            this->messagesById_.erase(it);
+        }
     }
 
-    return res;
+    for (const auto &key : userIndexKeys(*message))
+    {
+        auto it = this->messagesByUser_.find(key);
+        if (it == this->messagesByUser_.end())
+        {
+            continue;
+        }
+
+        auto &entries = it->second;
+        auto entryIt = std::find_if(entries.begin(), entries.end(),
+                                    [&](const UserMessage &entry) {
+                                        return entry.message == message;
+                                    });
+        if (entryIt != entries.end())
+        {
+            entries.erase(entryIt);
+        }
+        if (entries.empty())
+        {
+            this->messagesByUser_.erase(it);
+        }
+    }
+}
+
+void Channel::rebuildMessageIndex()
+{
+    std::lock_guard lock(this->indexMutex_);
+
+    auto snapshot = this->messages_.getSnapshot();
+
+    this->messagesById_.clear();
+    this->messagesById_.reserve(snapshot.size());
+    this->messagesByUser_.clear();
+
+    // Keep the end anchored, so sequence numbers handed out by addMessage
+    // stay increasing
+    this->firstSequence_ = this->nextSequence_ - int64_t(snapshot.size());
+    for (size_t i = 0; i < snapshot.size(); ++i)
+    {
+        this->indexMessage(snapshot[i], this->firstSequence_ + int64_t(i),
+                           true);
+    }
 }
 
 bool Channel::canSendMessage() const
@@ -3,6 +3,8 @@
 #include "common/CompletionModel.hpp"
 #include "common/FlagsEnum.hpp"
 #include "messages/LimitedQueue.hpp"
+#include "util/QStringHash.hpp"
+#include "util/Similarity.hpp"
 
 #include <boost/optional.hpp>
 #include <pajlada/signals/signal.hpp>
@@ -10,7 +12,12 @@
 #include <QString>
 #include <QTimer>
 
+#include <cstdint>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace chatterino {
 
@@ -55,6 +62,8 @@ public:
     pajlada::Signals::Signal<MessagePtr &> messageRemovedFromStart;
     pajlada::Signals::Signal<MessagePtr &, boost::optional<MessageFlags>>
         messageAppended;
+    /// Invoked once for a batch of messages added through addMessages
+    pajlada::Signals::Signal<std::vector<MessagePtr> &> messagesAppended;
     pajlada::Signals::Signal<std::vector<MessagePtr> &> messagesAddedAtStart;
     pajlada::Signals::Signal<size_t, MessagePtr &> messageReplaced;
     /// Invoked when some number of messages were filled in using time received
@@ -79,6 +88,27 @@ public:
     void addMessage(
         MessagePtr message,
         boost::optional<MessageFlags> overridingFlags = boost::none);
+
+    /**
+     * @brief Adds the messages to the end of the channel as one batch
+     *
+     * The messages' own flags are used. Listeners of messagesAppended are
+     * invoked once for the whole batch, messageAppended isn't invoked.
+     *
+     * @param log whether the messages should be written to the logs
+     */
+    void addMessages(std::vector<MessagePtr> messages, bool log = true);
+
+    /**
+     * @brief Queues the message to be added with the next batch
+     *
+     * All messages queued during one iteration of the event loop are added
+     * with a single addMessages call. Any other access to this channel's
+     * messages adds the queued messages first, so they're never observed out
+     * of order.
+     */
+    void queueMessage(MessagePtr message);
+
     void addMessagesAtStart(const std::vector<MessagePtr> &messages_);
 
     /// Inserts the given messages in order by Message::serverReceivedTime.
@@ -90,8 +120,25 @@ public:
     void replaceMessage(size_t index, MessagePtr replacement);
     void deleteMessage(QString messageID);
 
+    /// Returns the most recent message with the given id, or nullptr if it
+    /// isn't in this channel. This is a hash lookup.
     MessagePtr findMessage(QString messageID);
 
+    /**
+     * @brief Returns the messages belonging to a user, oldest first
+     *
+     * A message belongs to a user if they sent it, if it's a moderation
+     * action targeting them, or if it's their subscription message. The
+     * comparison is case-insensitive. This is an index lookup, the scrollback
+     * isn't scanned.
+     *
+     * @param userLogin the login name of the user
+     * @param lookback only return messages among the last `lookback` messages
+     *                 of this channel
+     */
+    std::vector<MessagePtr> getUserMessages(const QString &userLogin,
+                                            size_t lookback = SIZE_MAX);
+
     bool hasMessages() const;
 
     // CHANNEL INFO
@@ -110,16 +157,52 @@ public:
     static std::shared_ptr<Channel> getEmpty();
 
     CompletionModel completionModel;
+    /// Recent messages which new messages are checked for similarity against
+    SimilarityHistory similarityHistory;
     QDate lastDate_;
 
 protected:
     virtual void onConnected();
 
 private:
+    struct UserMessage {
+        int64_t sequence;
+        MessagePtr message;
+    };
+
+    // The index helpers below must be called with indexMutex_ held
+
+    /// Adds the message to the indexes. If overwriteId is false, an already
+    /// indexed message with the same id is kept.
+    void indexMessage(const MessagePtr &message, int64_t sequence,
+                      bool overwriteId);
+    /// Removes the message from the indexes
+    void unindexMessage(const MessagePtr &message);
+    /// Rebuilds the indexes from the current messages, takes indexMutex_
+    void rebuildMessageIndex();
+
+    /// Adds all queued messages
+    void flushQueuedMessages();
+    QString loggingPlatform();
+
     const QString name_;
     LimitedQueue<MessagePtr> messages_;
     Type type_;
     QTimer clearCompletionModelTimer_;
+
+    /// Maps message ids to the most recent message in messages_ with that id
+    std::unordered_map<QString, MessagePtr> messagesById_;
+    /// Maps lowercase user names to their messages, sorted by sequence
+    std::unordered_map<QString, std::deque<UserMessage>> messagesByUser_;
+    /// Messages are numbered in order of their position in messages_. These
+    /// numbers stay the same when messages are added or removed at the ends.
+    int64_t firstSequence_ = 0;
+    int64_t nextSequence_ = 0;
+    std::mutex indexMutex_;
+
+    /// Messages queued with queueMessage that haven't been added yet
+    std::vector<MessagePtr> queuedMessages_;
+    QTimer flushQueuedMessagesTimer_;
 };
 
 using ChannelPtr = std::shared_ptr<Channel>;
@@ -38,7 +38,7 @@ bool FilterSet::filter(const MessagePtr &m, ChannelPtr channel) const
     if (this->filters_.size() == 0)
         return true;
 
-    filters::ContextMap context = filters::buildContextMap(m, channel.get());
+    filters::MessageContext context(*m, channel.get());
     for (const auto &f : this->filters_.values())
     {
         if (!f->valid() || !f->filter(context))
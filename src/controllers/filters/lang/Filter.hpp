@@ -1,6 +1,7 @@
 #pragma once
 
 #include "controllers/filters/lang/expressions/Expression.hpp"
+#include "controllers/filters/lang/MessageContext.hpp"
 #include "controllers/filters/lang/Types.hpp"
 
 #include <QString>
@@ -8,14 +9,6 @@
 #include <memory>
 #include <variant>
 
-namespace chatterino {
-
-class Channel;
-struct Message;
-using MessagePtr = std::shared_ptr<const Message>;
-
-}  // namespace chatterino
-
 namespace chatterino::filters {
 
 // MESSAGE_TYPING_CONTEXT maps filter variables to their expected type at evaluation.
@@ -47,8 +40,6 @@ static const QMap<QString, Type> MESSAGE_TYPING_CONTEXT = {
     {"message.length", Type::Int},
 };
 
-ContextMap buildContextMap(const MessagePtr &m, chatterino::Channel *channel);
-
 class Filter;
 struct FilterError {
     QString message;
@@ -62,6 +53,12 @@ public:
     static FilterResult fromString(const QString &str);
 
     Type returnType() const;
+
+    /// Evaluates the compiled filter, only the identifiers it uses are
+    /// resolved
+    QVariant execute(const MessageContext &context) const;
+
+    /// Interprets the expression tree with all identifiers given upfront
     QVariant execute(const ContextMap &context) const;
 
     QString filterString() const;
@@ -72,6 +69,7 @@ private:
 
     ExpressionPtr expression_;
     Type returnType_;
+    CompiledExpression compiled_;
 };
 
 }  // namespace chatterino::filters
@@ -0,0 +1,196 @@
+#include "controllers/filters/lang/MessageContext.hpp"
+
+#include "Application.hpp"
+#include "common/Channel.hpp"
+#include "messages/Message.hpp"
+#include "providers/twitch/TwitchBadge.hpp"
+#include "providers/twitch/TwitchChannel.hpp"
+#include "providers/twitch/TwitchIrcServer.hpp"
+
+#include <algorithm>
+
+namespace {
+
+using namespace chatterino::filters;
+
+// In the order of Identifier
+const std::array<QString, IDENTIFIER_COUNT> IDENTIFIER_NAMES{
+    "author.badges",
+    "author.color",
+    "author.name",
+    "author.no_color",
+    "author.subbed",
+    "author.sub_length",
+
+    "channel.name",
+    "channel.watching",
+    "channel.live",
+
+    "flags.highlighted",
+    "flags.points_redeemed",
+    "flags.sub_message",
+    "flags.system_message",
+    "flags.reward_message",
+    "flags.first_message",
+    "flags.elevated_message",
+    "flags.cheer_message",
+    "flags.whisper",
+    "flags.reply",
+    "flags.automod",
+
+    "message.content",
+    "message.length",
+};
+
+bool hasBadge(const chatterino::Message &message, const QString &key)
+{
+    return std::any_of(message.badges.begin(), message.badges.end(),
+                       [&key](const auto &badge) {
+                           return badge.key_ == key;
+                       });
+}
+
+}  // namespace
+
+namespace chatterino::filters {
+
+const QString &identifierName(Identifier identifier)
+{
+    return IDENTIFIER_NAMES[static_cast<size_t>(identifier)];
+}
+
+std::optional<Identifier> identifierFromName(const QString &name)
+{
+    auto it =
+        std::find(IDENTIFIER_NAMES.begin(), IDENTIFIER_NAMES.end(), name);
+    if (it == IDENTIFIER_NAMES.end())
+    {
+        return std::nullopt;
+    }
+
+    return static_cast<Identifier>(it - IDENTIFIER_NAMES.begin());
+}
+
+MessageContext::MessageContext(const Message &message, Channel *channel)
+    : message_(&message)
+    , channel_(channel)
+{
+}
+
+MessageContext::MessageContext(const ContextMap &map)
+    : map_(&map)
+{
+}
+
+const QVariant &MessageContext::value(Identifier identifier) const
+{
+    auto index = static_cast<size_t>(identifier);
+    if (!this->resolved_.test(index))
+    {
+        this->values_[index] = this->resolve(identifier);
+        this->resolved_.set(index);
+    }
+
+    return this->values_[index];
+}
+
+bool MessageContext::isComplete() const
+{
+    return this->map_ == nullptr;
+}
+
+QVariant MessageContext::resolve(Identifier identifier) const
+{
+    if (this->map_ != nullptr)
+    {
+        return this->map_->value(identifierName(identifier));
+    }
+
+    using MessageFlag = chatterino::MessageFlag;
+    const auto &m = *this->message_;
+
+    switch (identifier)
+    {
+        case Identifier::AuthorBadges: {
+            QStringList badges;
+            badges.reserve(static_cast<int>(m.badges.size()));
+            for (const auto &e : m.badges)
+            {
+                badges << e.key_;
+            }
+            return badges;
+        }
+        case Identifier::AuthorColor:
+            return m.usernameColor;
+        case Identifier::AuthorName:
+            return m.displayName;
+        case Identifier::AuthorNoColor:
+            return !m.usernameColor.isValid();
+        case Identifier::AuthorSubbed:
+            return hasBadge(m, "subscriber") || hasBadge(m, "founder");
+        case Identifier::AuthorSubLength: {
+            // The founder badge wins if the message has both
+            int subLength = 0;
+            for (const auto *subBadge : {"subscriber", "founder"})
+            {
+                if (!hasBadge(m, subBadge))
+                {
+                    continue;
+                }
+                auto it = m.badgeInfos.find(subBadge);
+                if (it != m.badgeInfos.end())
+                {
+                    subLength = it->second.toInt();
+                }
+            }
+            return subLength;
+        }
+
+        case Identifier::ChannelName:
+            return m.channelName;
+        case Identifier::ChannelWatching: {
+            auto watchingChannel =
+                chatterino::getApp()->twitch->watchingChannel.get();
+            return !watchingChannel->getName().isEmpty() &&
+                   watchingChannel->getName().compare(
+                       m.channelName, Qt::CaseInsensitive) == 0;
+        }
+        case Identifier::ChannelLive: {
+            auto *tc = dynamic_cast<TwitchChannel *>(this->channel_);
+            return this->channel_ && !this->channel_->isEmpty() && tc &&
+                   tc->isLive();
+        }
+
+        case Identifier::FlagsHighlighted:
+            return m.flags.has(MessageFlag::Highlighted);
+        case Identifier::FlagsPointsRedeemed:
+            return m.flags.has(MessageFlag::RedeemedHighlight);
+        case Identifier::FlagsSubMessage:
+            return m.flags.has(MessageFlag::Subscription);
+        case Identifier::FlagsSystemMessage:
+            return m.flags.has(MessageFlag::System);
+        case Identifier::FlagsRewardMessage:
+            return m.flags.has(MessageFlag::RedeemedChannelPointReward);
+        case Identifier::FlagsFirstMessage:
+            return m.flags.has(MessageFlag::FirstMessage);
+        case Identifier::FlagsElevatedMessage:
+            return m.flags.has(MessageFlag::ElevatedMessage);
+        case Identifier::FlagsCheerMessage:
+            return m.flags.has(MessageFlag::CheerMessage);
+        case Identifier::FlagsWhisper:
+            return m.flags.has(MessageFlag::Whisper);
+        case Identifier::FlagsReply:
+            return m.flags.has(MessageFlag::ReplyMessage);
+        case Identifier::FlagsAutomod:
+            return m.flags.has(MessageFlag::AutoMod);
+
+        case Identifier::MessageContent:
+            return m.messageText;
+        case Identifier::MessageLength:
+            return m.messageText.length();
+    }
+
+    return {};
+}
+
+}  // namespace chatterino::filters
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "controllers/filters/lang/Types.hpp"
+
+#include <QString>
+#include <QVariant>
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <optional>
+
+namespace chatterino {
+
+class Channel;
+struct Message;
+
+}  // namespace chatterino
+
+namespace chatterino::filters {
+
+/*
+ * Looking to add a new identifier to filters? Here's what to do:
+ *  1. Update validIdentifiersMap in Tokenizer.hpp
+ *  2. Add the identifier to the enum below and its name to IDENTIFIER_NAMES
+ *     in MessageContext.cpp
+ *  3. Add the type of the identifier to MESSAGE_TYPING_CONTEXT in Filter.hpp
+ *  4. Add the value for the identifier to MessageContext::resolve
+ */
+enum class Identifier {
+    AuthorBadges,
+    AuthorColor,
+    AuthorName,
+    AuthorNoColor,
+    AuthorSubbed,
+    AuthorSubLength,
+
+    ChannelName,
+    ChannelWatching,
+    ChannelLive,
+
+    FlagsHighlighted,
+    FlagsPointsRedeemed,
+    FlagsSubMessage,
+    FlagsSystemMessage,
+    FlagsRewardMessage,
+    FlagsFirstMessage,
+    FlagsElevatedMessage,
+    FlagsCheerMessage,
+    FlagsWhisper,
+    FlagsReply,
+    FlagsAutomod,
+
+    MessageContent,
+    MessageLength,
+};
+
+inline constexpr size_t IDENTIFIER_COUNT =
+    static_cast<size_t>(Identifier::MessageLength) + 1;
+
+/// Returns the name of identifier in filters, for example "author.name"
+const QString &identifierName(Identifier identifier);
+
+std::optional<Identifier> identifierFromName(const QString &name);
+
+/**
+ * @brief The values of the identifiers for one message
+ *
+ * Values are only resolved once a filter uses them and are then kept, so
+ * several filters checking the same message share them.
+ */
+class MessageContext
+{
+public:
+    MessageContext(const Message &message, Channel *channel);
+
+    /// Takes the values from map, identifiers missing in it are invalid
+    explicit MessageContext(const ContextMap &map);
+
+    const QVariant &value(Identifier identifier) const;
+
+    /// Whether every identifier has a value of its type, which is only
+    /// guaranteed for messages
+    bool isComplete() const;
+
+private:
+    QVariant resolve(Identifier identifier) const;
+
+    const Message *message_{};
+    Channel *channel_{};
+    const ContextMap *map_{};
+
+    mutable std::array<QVariant, IDENTIFIER_COUNT> values_;
+    mutable std::bitset<IDENTIFIER_COUNT> resolved_;
+};
+
+}  // namespace chatterino::filters
@@ -2,21 +2,13 @@
 
 #include <QRegularExpression>
 
-namespace chatterino::filters {
+namespace {
 
-BinaryOperation::BinaryOperation(TokenType op, ExpressionPtr left,
-                                 ExpressionPtr right)
-    : op_(op)
-    , left_(std::move(left))
-    , right_(std::move(right))
-{
-}
+using namespace chatterino::filters;
 
-QVariant BinaryOperation::execute(const ContextMap &context) const
+QVariant applyOperator(TokenType op, QVariant left, QVariant right)
 {
-    auto left = this->left_->execute(context);
-    auto right = this->right_->execute(context);
-    switch (this->op_)
+    switch (op)
     {
         case PLUS:
             if (static_cast<QMetaType::Type>(left.type()) ==
@@ -204,6 +196,130 @@ QVariant BinaryOperation::execute(const ContextMap &context) const
     }
 }
 
+// Matches with a regex which is known when compiling
+CompiledExpression compileMatch(CompiledExpression left, const QVariant &right)
+{
+    QRegularExpression regex;
+    std::optional<int> group;
+    if (variantIs(right, QMetaType::QRegularExpression))
+    {
+        regex = right.toRegularExpression();
+    }
+    else if (variantIs(right, QMetaType::QVariantList))
+    {
+        auto list = right.toList();
+        if (list.size() != 2 ||
+            variantIsNot(list.at(0), QMetaType::QRegularExpression) ||
+            variantIsNot(list.at(1), QMetaType::Int))
+        {
+            return CompiledExpression::fromConstant(false);
+        }
+        regex = list.at(0).toRegularExpression();
+        group = list.at(1).toInt();
+    }
+    else
+    {
+        return CompiledExpression::fromConstant(false);
+    }
+
+    return {[left = std::move(left), regex,
+             group](const MessageContext &context) -> QVariant {
+                auto matching = left(context);
+                if (!matching.canConvert(QMetaType::QString))
+                {
+                    return false;
+                }
+
+                auto match = regex.match(matching.toString());
+                if (!group)
+                {
+                    return match.hasMatch();
+                }
+
+                // if matched, return nth capture group. Otherwise, return ""
+                if (match.hasMatch())
+                {
+                    return match.captured(*group);
+                }
+                return "";
+            },
+            std::nullopt};
+}
+
+}  // namespace
+
+namespace chatterino::filters {
+
+BinaryOperation::BinaryOperation(TokenType op, ExpressionPtr left,
+                                 ExpressionPtr right)
+    : op_(op)
+    , left_(std::move(left))
+    , right_(std::move(right))
+{
+}
+
+QVariant BinaryOperation::execute(const ContextMap &context) const
+{
+    return applyOperator(this->op_, this->left_->execute(context),
+                         this->right_->execute(context));
+}
+
+CompiledExpression BinaryOperation::compile() const
+{
+    auto left = this->left_->compile();
+    auto right = this->right_->compile();
+    if (left.isConstant() && right.isConstant())
+    {
+        return CompiledExpression::fromConstant(this->execute({}));
+    }
+
+    switch (this->op_)
+    {
+        case AND:
+            return {[left, right](const MessageContext &context) {
+                        auto l = left(context);
+                        if (!l.convert(QMetaType::Bool) || !l.toBool())
+                        {
+                            return false;
+                        }
+                        auto r = right(context);
+                        return r.convert(QMetaType::Bool) && r.toBool();
+                    },
+                    std::nullopt};
+        case OR:
+            return {[left, right](const MessageContext &context) {
+                        auto l = left(context);
+                        if (!l.convert(QMetaType::Bool))
+                        {
+                            return false;
+                        }
+                        if (l.toBool() && context.isComplete())
+                        {
+                            // The right side is a Bool as well, there's no
+                            // need to check it converts
+                            return true;
+                        }
+                        auto r = right(context);
+                        return r.convert(QMetaType::Bool) &&
+                               (l.toBool() || r.toBool());
+                    },
+                    std::nullopt};
+        case MATCH:
+            if (right.isConstant())
+            {
+                return compileMatch(std::move(left), *right.constant);
+            }
+            break;
+        default:
+            break;
+    }
+
+    return {[op = this->op_, left, right](const MessageContext &context) {
+                return applyOperator(op, left(context), right(context));
+            },
+            std::nullopt};
+}
+
 PossibleType BinaryOperation::synthesizeType(const TypingContext &context) const
 {
     auto leftSyn = this->left_->synthesizeType(context);
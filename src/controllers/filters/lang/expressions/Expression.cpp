@@ -2,11 +2,37 @@
 
 namespace chatterino::filters {
 
+CompiledExpression CompiledExpression::fromConstant(QVariant value)
+{
+    CompiledExpression compiled;
+    compiled.constant = std::move(value);
+    return compiled;
+}
+
+bool CompiledExpression::isConstant() const
+{
+    return this->constant.has_value();
+}
+
+QVariant CompiledExpression::operator()(const MessageContext &context) const
+{
+    if (this->constant)
+    {
+        return *this->constant;
+    }
+    return this->evaluate(context);
+}
+
 QVariant Expression::execute(const ContextMap & /*context*/) const
 {
     return false;
 }
 
+CompiledExpression Expression::compile() const
+{
+    return CompiledExpression::fromConstant(false);
+}
+
 PossibleType Expression::synthesizeType(const TypingContext & /*context*/) const
 {
     return IllTyped{this, "Not implemented"};
@@ -1,22 +1,42 @@
 #pragma once
 
+#include "controllers/filters/lang/MessageContext.hpp"
 #include "controllers/filters/lang/Tokenizer.hpp"
 #include "controllers/filters/lang/Types.hpp"
 
 #include <QString>
 #include <QVariant>
 
+#include <functional>
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace chatterino::filters {
 
+/**
+ * @brief An expression compiled into closures
+ *
+ * The closures don't refer to the expression they were compiled from.
+ * Expressions which don't use identifiers are folded into a constant.
+ */
+struct CompiledExpression {
+    std::function<QVariant(const MessageContext &context)> evaluate;
+    std::optional<QVariant> constant;
+
+    static CompiledExpression fromConstant(QVariant value);
+
+    bool isConstant() const;
+    QVariant operator()(const MessageContext &context) const;
+};
+
 class Expression
 {
 public:
     virtual ~Expression() = default;
 
     virtual QVariant execute(const ContextMap &context) const;
+    virtual CompiledExpression compile() const;
     virtual PossibleType synthesizeType(const TypingContext &context) const;
     virtual QString debug(const TypingContext &context) const;
     virtual QString filterString() const;
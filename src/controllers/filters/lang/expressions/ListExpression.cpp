@@ -1,22 +1,19 @@
 #include "controllers/filters/lang/expressions/ListExpression.hpp"
 
-namespace chatterino::filters {
+namespace {
 
-ListExpression::ListExpression(ExpressionList &&list)
-    : list_(std::move(list)){};
+using namespace chatterino::filters;
 
-QVariant ListExpression::execute(const ContextMap &context) const
+QVariant listValue(const QList<QVariant> &results)
 {
-    QList<QVariant> results;
     bool allStrings = true;
-    for (const auto &exp : this->list_)
+    for (const auto &res : results)
     {
-        auto res = exp->execute(context);
-        if (allStrings && variantIsNot(res.type(), QMetaType::QString))
+        if (variantIsNot(res.type(), QMetaType::QString))
         {
             allStrings = false;
+            break;
         }
-        results.append(res);
     }
 
     // if everything is a string return a QStringList for case-insensitive comparison
@@ -34,6 +31,51 @@ QVariant ListExpression::execute(const ContextMap &context) const
     return results;
 }
 
+}  // namespace
+
+namespace chatterino::filters {
+
+ListExpression::ListExpression(ExpressionList &&list)
+    : list_(std::move(list)){};
+
+QVariant ListExpression::execute(const ContextMap &context) const
+{
+    QList<QVariant> results;
+    for (const auto &exp : this->list_)
+    {
+        results.append(exp->execute(context));
+    }
+
+    return listValue(results);
+}
+
+CompiledExpression ListExpression::compile() const
+{
+    std::vector<CompiledExpression> items;
+    bool allConstant = true;
+    for (const auto &exp : this->list_)
+    {
+        items.push_back(exp->compile());
+        allConstant = allConstant && items.back().isConstant();
+    }
+
+    if (allConstant)
+    {
+        return CompiledExpression::fromConstant(this->execute({}));
+    }
+
+    return {[items = std::move(items)](const MessageContext &context) {
+                QList<QVariant> results;
+                results.reserve(static_cast<int>(items.size()));
+                for (const auto &item : items)
+                {
+                    results.append(item(context));
+                }
+                return listValue(results);
+            },
+            std::nullopt};
+}
+
 PossibleType ListExpression::synthesizeType(const TypingContext &context) const
 {
     std::vector<TypeClass> types;
@@ -7,13 +7,22 @@ RegexExpression::RegexExpression(const QString &regex, bool caseInsensitive)
     , caseInsensitive_(caseInsensitive)
     , regex_(QRegularExpression(
           regex, caseInsensitive ? QRegularExpression::CaseInsensitiveOption
-                                 : QRegularExpression::NoPatternOption)){};
+                                 : QRegularExpression::NoPatternOption))
+{
+    // Compiles the regex right away, it's matched against every message
+    this->regex_.optimize();
+}
 
 QVariant RegexExpression::execute(const ContextMap & /*context*/) const
 {
     return this->regex_;
 }
 
+CompiledExpression RegexExpression::compile() const
+{
+    return CompiledExpression::fromConstant(this->regex_);
+}
+
 PossibleType RegexExpression::synthesizeType(
     const TypingContext & /*context*/) const
 {
@@ -20,6 +20,21 @@ QVariant UnaryOperation::execute(const ContextMap &context) const
     }
 }
 
+CompiledExpression UnaryOperation::compile() const
+{
+    auto right = this->right_->compile();
+    if (right.isConstant() || this->op_ != NOT)
+    {
+        return CompiledExpression::fromConstant(this->execute({}));
+    }
+
+    return {[right = std::move(right.evaluate)](const MessageContext &context) {
+                auto value = right(context);
+                return value.canConvert<bool>() && !value.toBool();
+            },
+            std::nullopt};
+}
+
 PossibleType UnaryOperation::synthesizeType(const TypingContext &context) const
 {
     auto rightSyn = this->right_->synthesizeType(context);
@@ -19,6 +19,26 @@ QVariant ValueExpression::execute(const ContextMap &context) const
     return this->value_;
 }
 
+CompiledExpression ValueExpression::compile() const
+{
+    if (this->type_ != TokenType::IDENTIFIER)
+    {
+        return CompiledExpression::fromConstant(this->value_);
+    }
+
+    auto identifier = identifierFromName(this->value_.toString());
+    if (!identifier)
+    {
+        // Same as a missing entry in the context
+        return CompiledExpression::fromConstant(QVariant());
+    }
+
+    return {[identifier = *identifier](const MessageContext &context) {
+                return context.value(identifier);
+            },
+            std::nullopt};
+}
+
 PossibleType ValueExpression::synthesizeType(const TypingContext &context) const
 {
     switch (this->type_)
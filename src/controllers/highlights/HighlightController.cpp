@@ -4,6 +4,7 @@
 #include "common/QLogging.hpp"
 #include "controllers/accounts/AccountController.hpp"
 #include "controllers/highlights/HighlightBadge.hpp"
+#include "controllers/highlights/HighlightMatcher.hpp"
 #include "controllers/highlights/HighlightPhrase.hpp"
 #include "messages/Message.hpp"
 #include "messages/MessageBuilder.hpp"
@@ -17,65 +18,132 @@ namespace {
 
 using namespace chatterino;
 
-auto highlightPhraseCheck(const HighlightPhrase &highlight) -> HighlightCheck
+/**
+ * @brief Returns the result of a phrase which matched, or none if the phrase
+ *        doesn't apply to the channel
+ */
+boost::optional<HighlightResult> highlightPhraseResult(
+    const HighlightPhrase &highlight, const QString &channel)
 {
-    return HighlightCheck{
-        [highlight](const auto &args, const auto &badges,
-                    const auto &senderName, const auto &originalMessage,
-                    const auto &flags, const auto self,
-                    const auto &channel) -> boost::optional<HighlightResult> {
-            (void)args;        // unused
-            (void)badges;      // unused
-            (void)senderName;  // unused
-            (void)flags;       // unused
+    // Check if the highlight is in the correct channel
+    const std::vector<std::string> &channels = highlight.getChannels();
+    const std::vector<std::string> &ExcludedChannels =
+        highlight.getExcludedChannels();
+    std::string currentChannel = channel.toStdString();
 
-            if (self)
-            {
-                // Phrase checks should ignore highlights from the user
-                return boost::none;
-            }
+    const auto it = std::find_if(std::begin(channels), std::end(channels),
+                                 [&currentChannel](const auto &str) {
+                                     return boost::iequals(currentChannel, str);
+                                 });
 
-            if (!highlight.isMatch(originalMessage))
-            {
-                return boost::none;
-            }
+    const auto it2 = std::find_if(
+        std::begin(ExcludedChannels), std::end(ExcludedChannels),
+        [&currentChannel](const auto &str) {
+            return boost::iequals(currentChannel, str);
+        });
 
-            // Check if the highlight is in the correct channel
-            std::vector<std::string> channels = highlight.getChannels();
-            std::vector<std::string> ExcludedChannels =
-                highlight.getExcludedChannels();
-            std::string currentChannel = channel.toStdString();
-
-            const auto it =
-                std::find_if(std::begin(channels), std::end(channels),
-                             [&currentChannel](const auto &str) {
-                                 return boost::iequals(currentChannel, str);
-                             });
-
-            const auto it2 = std::find_if(
-                std::begin(ExcludedChannels), std::end(ExcludedChannels),
-                [&currentChannel](const auto &str) {
-                    return boost::iequals(currentChannel, str);
-                });
+    if (!((highlight.isGlobalHighlight() || it != std::end(channels)) &&
+          it2 == std::end(ExcludedChannels)))
+    {
+        return boost::none;
+    }
 
-            if (!((highlight.isGlobalHighlight() || it != std::end(channels)) &&
-                  it2 == std::end(ExcludedChannels)))
-            {
-                return boost::none;
-            }
+    boost::optional<QUrl> highlightSoundUrl;
+    if (highlight.hasCustomSound())
+    {
+        highlightSoundUrl = highlight.getSoundUrl();
+    }
 
-            boost::optional<QUrl> highlightSoundUrl;
-            if (highlight.hasCustomSound())
-            {
-                highlightSoundUrl = highlight.getSoundUrl();
-            }
+    return HighlightResult{
+        highlight.hasAlert(),       highlight.hasSound(),
+        highlightSoundUrl,          highlight.getColor(),
+        highlight.showInMentions(),
+    };
+}
 
-            return HighlightResult{
-                highlight.hasAlert(),       highlight.hasSound(),
-                highlightSoundUrl,          highlight.getColor(),
-                highlight.showInMentions(),
-            };
-        }};
+/**
+ * @brief Adds the side-effects of checkResult which aren't set in result yet
+ *
+ * Merging is associative, so the results of a block of checks can be merged
+ * first and then be merged like the result of a single check.
+ */
+void mergeHighlightResult(HighlightResult &result,
+                          const HighlightResult &checkResult)
+{
+    if (checkResult.alert)
+    {
+        if (!result.alert)
+        {
+            result.alert = checkResult.alert;
+        }
+    }
+
+    if (checkResult.playSound)
+    {
+        if (!result.playSound)
+        {
+            result.playSound = checkResult.playSound;
+        }
+    }
+
+    if (checkResult.customSoundUrl)
+    {
+        if (!result.customSoundUrl)
+        {
+            result.customSoundUrl = checkResult.customSoundUrl;
+        }
+    }
+
+    if (checkResult.color)
+    {
+        if (!result.color)
+        {
+            result.color = checkResult.color;
+        }
+    }
+
+    if (checkResult.showInMentions)
+    {
+        if (!result.showInMentions)
+        {
+            result.showInMentions = checkResult.showInMentions;
+        }
+    }
+}
+
+/**
+ * @brief Merges the results of the matched highlights in the given order,
+ *        returns none if none of them applies
+ */
+template <typename TItems, typename TResultOf>
+boost::optional<HighlightResult> mergeMatches(
+    const std::vector<size_t> &matches, const TItems &items,
+    TResultOf &&resultOf)
+{
+    boost::optional<HighlightResult> merged;
+    for (auto index : matches)
+    {
+        auto result = resultOf(items[index]);
+        if (!result)
+        {
+            continue;
+        }
+
+        if (!merged)
+        {
+            merged = std::move(result);
+        }
+        else
+        {
+            mergeHighlightResult(*merged, *result);
+        }
+
+        if (merged->full())
+        {
+            break;
+        }
+    }
+    return merged;
 }
 
 void rebuildSubscriptionHighlights(Settings &settings,
@@ -212,23 +280,48 @@ void rebuildMessageHighlights(Settings &settings,
     auto currentUser = getIApp()->getAccounts()->twitch.getCurrent();
     QString currentUsername = currentUser->getUserName();
 
+    std::vector<HighlightPhrase> phrases;
+
     if (settings.enableSelfHighlight && !currentUsername.isEmpty())
     {
-        HighlightPhrase highlight(
+        phrases.emplace_back(
             currentUsername, settings.showSelfHighlightInMentions,
             settings.enableSelfHighlightTaskbar,
             settings.enableSelfHighlightSound, false, false,
             settings.selfHighlightSoundUrl.getValue(),
             ColorProvider::instance().color(ColorType::SelfHighlight));
-
-        checks.emplace_back(highlightPhraseCheck(highlight));
     }
 
     auto messageHighlights = settings.highlightedMessages.readOnly();
-    for (const auto &highlight : *messageHighlights)
+    phrases.insert(phrases.end(), messageHighlights->begin(),
+                   messageHighlights->end());
+
+    if (phrases.empty())
     {
-        checks.emplace_back(highlightPhraseCheck(highlight));
+        return;
     }
+
+    // All phrases are matched at once, their results are merged in order
+    auto matcher =
+        std::make_shared<const HighlightPhraseMatcher>(std::move(phrases));
+    checks.emplace_back(HighlightCheck{
+        [matcher](const auto & /*args*/, const auto & /*badges*/,
+                  const auto & /*senderName*/, const auto &originalMessage,
+                  const auto & /*flags*/, const auto self,
+                  const auto &channel) -> boost::optional<HighlightResult> {
+            if (self)
+            {
+                // Phrase checks should ignore highlights from the user
+                return boost::none;
+            }
+
+            return mergeMatches(matcher->match(originalMessage),
+                                matcher->phrases(),
+                                [&channel](const HighlightPhrase &highlight) {
+                                    return highlightPhraseResult(highlight,
+                                                                 channel);
+                                });
+        }});
 }
 
 void rebuildUserHighlights(Settings &settings,
@@ -266,65 +359,24 @@ void rebuildUserHighlights(Settings &settings,
             }});
     }
 
-    for (const auto &highlight : *userHighlights)
+    if (userHighlights->empty())
     {
-        checks.emplace_back(HighlightCheck{
-            [highlight](
-                const auto &args, const auto &badges, const auto &senderName,
-                const auto &originalMessage, const auto &flags, const auto self,
-                const auto &channel) -> boost::optional<HighlightResult> {
-                (void)args;             // unused
-                (void)badges;           // unused
-                (void)originalMessage;  // unused
-                (void)flags;            // unused
-                (void)self;             // unused
-                (void)channel;          // unused
-
-                if (!highlight.isMatch(senderName))
-                {
-                    return boost::none;
-                }
-
-                // Check if the highlight is in the correct channel
-                std::vector<std::string> channels = highlight.getChannels();
-                std::vector<std::string> ExcludedChannels =
-                    highlight.getExcludedChannels();
-                std::string currentChannel = channel.toStdString();
-
-                const auto it =
-                    std::find_if(std::begin(channels), std::end(channels),
-                                 [&currentChannel](const auto &str) {
-                                     return boost::iequals(currentChannel, str);
-                                 });
-
-                const auto it2 = std::find_if(
-                    std::begin(ExcludedChannels), std::end(ExcludedChannels),
-                    [&currentChannel](const auto &str) {
-                        return boost::iequals(currentChannel, str);
-                    });
-
-                if (!((highlight.isGlobalHighlight() ||
-                       it != std::end(channels)) &&
-                      it2 == std::end(ExcludedChannels)))
-                {
-                    return boost::none;
-                }
-
-                boost::optional<QUrl> highlightSoundUrl;
-                if (highlight.hasCustomSound())
-                {
-                    highlightSoundUrl = highlight.getSoundUrl();
-                }
-
-                return HighlightResult{
-                    highlight.hasAlert(),        //
-                    highlight.hasSound(),        //
-                    highlightSoundUrl,           //
-                    highlight.getColor(),        //
-                    highlight.showInMentions(),  //
-                };
-            }});
+        return;
     }
+
+    auto matcher =
+        std::make_shared<const HighlightUserMatcher>(*userHighlights);
+    checks.emplace_back(HighlightCheck{
+        [matcher](const auto & /*args*/, const auto & /*badges*/,
+                  const auto &senderName, const auto & /*originalMessage*/,
+                  const auto & /*flags*/, const auto /*self*/,
+                  const auto &channel) -> boost::optional<HighlightResult> {
+            return mergeMatches(matcher->match(senderName), matcher->phrases(),
+                                [&channel](const HighlightPhrase &highlight) {
+                                    return highlightPhraseResult(highlight,
+                                                                 channel);
+                                });
+        }});
 }
 
 void rebuildBadgeHighlights(Settings &settings,
@@ -332,43 +384,38 @@ void rebuildBadgeHighlights(Settings &settings,
 {
     auto badgeHighlights = settings.highlightedBadges.readOnly();
 
-    for (const auto &highlight : *badgeHighlights)
+    if (badgeHighlights->empty())
     {
-        checks.emplace_back(HighlightCheck{
-            [highlight](
-                const auto &args, const auto &badges, const auto &senderName,
-                const auto &originalMessage, const auto &flags, const auto self,
-                const auto &channel) -> boost::optional<HighlightResult> {
-                (void)args;             // unused
-                (void)senderName;       // unused
-                (void)originalMessage;  // unused
-                (void)flags;            // unused
-                (void)self;             // unused
-                (void)channel;          // unused
+        return;
+    }
 
-                for (const Badge &badge : badges)
-                {
-                    if (highlight.isMatch(badge))
+    auto matcher =
+        std::make_shared<const HighlightBadgeMatcher>(*badgeHighlights);
+    checks.emplace_back(HighlightCheck{
+        [matcher](const auto & /*args*/, const auto &badges,
+                  const auto & /*senderName*/, const auto & /*originalMessage*/,
+                  const auto & /*flags*/, const auto /*self*/,
+                  const auto & /*channel*/)
+            -> boost::optional<HighlightResult> {
+            return mergeMatches(
+                matcher->match(badges), matcher->highlights(),
+                [](const HighlightBadge &highlight)
+                    -> boost::optional<HighlightResult> {
+                    boost::optional<QUrl> highlightSoundUrl;
+                    if (highlight.hasCustomSound())
                     {
-                        boost::optional<QUrl> highlightSoundUrl;
-                        if (highlight.hasCustomSound())
-                        {
-                            highlightSoundUrl = highlight.getSoundUrl();
-                        }
-
-                        return HighlightResult{
-                            highlight.hasAlert(),        //
-                            highlight.hasSound(),        //
-                            highlightSoundUrl,           //
-                            highlight.getColor(),        //
-                            highlight.showInMentions(),  //
-                        };
+                        highlightSoundUrl = highlight.getSoundUrl();
                     }
-                }
 
-                return boost::none;
-            }});
-    }
+                    return HighlightResult{
+                        highlight.hasAlert(),        //
+                        highlight.hasSound(),        //
+                        highlightSoundUrl,           //
+                        highlight.getColor(),        //
+                        highlight.showInMentions(),  //
+                    };
+                });
+        }});
 }
 
 }  // namespace
@@ -529,23 +576,26 @@ void HighlightController::initialize(Settings &settings, Paths & /*paths*/)
 void HighlightController::rebuildChecks(Settings &settings)
 {
     // Access checks for modification
-    auto checks = this->checks_.access();
-    checks->clear();
+    auto access = this->checks_.access();
+    auto &checks = access->checks;
+    checks.clear();
+    access->currentUsername =
+        getIApp()->getAccounts()->twitch.getCurrent()->getUserName();
 
     // CURRENT ORDER:
     // Subscription -> Whisper -> Message -> User -> Reply Threads -> Badge
 
-    rebuildSubscriptionHighlights(settings, *checks);
+    rebuildSubscriptionHighlights(settings, checks);
 
-    rebuildWhisperHighlights(settings, *checks);
+    rebuildWhisperHighlights(settings, checks);
 
-    rebuildMessageHighlights(settings, *checks);
+    rebuildMessageHighlights(settings, checks);
 
-    rebuildUserHighlights(settings, *checks);
+    rebuildUserHighlights(settings, checks);
 
-    rebuildReplyThreadHighlight(settings, *checks);
+    rebuildReplyThreadHighlight(settings, checks);
 
-    rebuildBadgeHighlights(settings, *checks);
+    rebuildBadgeHighlights(settings, checks);
 }
 
 std::pair<bool, HighlightResult> HighlightController::check(
@@ -557,12 +607,11 @@ std::pair<bool, HighlightResult> HighlightController::check(
     auto result = HighlightResult::emptyResult();
 
     // Access for checking
-    const auto checks = this->checks_.accessConst();
+    const auto access = this->checks_.accessConst();
 
-    auto currentUser = getIApp()->getAccounts()->twitch.getCurrent();
-    auto self = (senderName == currentUser->getUserName());
+    auto self = (senderName == access->currentUsername);
 
-    for (const auto &check : *checks)
+    for (const auto &check : access->checks)
     {
         if (auto checkResult =
                 check.cb(args, badges, senderName, originalMessage,
@@ -571,45 +620,7 @@ std::pair<bool, HighlightResult> HighlightController::check(
         {
             highlighted = true;
 
-            if (checkResult->alert)
-            {
-                if (!result.alert)
-                {
-                    result.alert = checkResult->alert;
-                }
-            }
-
-            if (checkResult->playSound)
-            {
-                if (!result.playSound)
-                {
-                    result.playSound = checkResult->playSound;
-                }
-            }
-
-            if (checkResult->customSoundUrl)
-            {
-                if (!result.customSoundUrl)
-                {
-                    result.customSoundUrl = checkResult->customSoundUrl;
-                }
-            }
-
-            if (checkResult->color)
-            {
-                if (!result.color)
-                {
-                    result.color = checkResult->color;
-                }
-            }
-
-            if (checkResult->showInMentions)
-            {
-                if (!result.showInMentions)
-                {
-                    result.showInMentions = checkResult->showInMentions;
-                }
-            }
+            mergeHighlightResult(result, *checkResult);
 
             if (result.full())
             {
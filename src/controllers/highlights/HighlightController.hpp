@@ -106,7 +106,13 @@ private:
      **/
     void rebuildChecks(Settings &settings);
 
-    UniqueAccess<std::vector<HighlightCheck>> checks_;
+    struct Checks {
+        std::vector<HighlightCheck> checks;
+        // Name of the current user when the checks were built, so check
+        // doesn't need the account controller off the GUI thread
+        QString currentUsername;
+    };
+    UniqueAccess<Checks> checks_;
 
     pajlada::SettingListener rebuildListener_;
     pajlada::Signals::SignalHolder signalHolder_;
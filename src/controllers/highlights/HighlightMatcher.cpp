@@ -0,0 +1,356 @@
+#include "controllers/highlights/HighlightMatcher.hpp"
+
+#include "messages/SharedMessageBuilder.hpp"
+#include "providers/twitch/TwitchBadge.hpp"
+
+#include <algorithm>
+
+namespace {
+
+using namespace chatterino;
+
+void sortUnique(std::vector<size_t> &indices)
+{
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+}
+
+void appendAll(std::vector<size_t> &indices,
+               const std::unordered_map<QString, std::vector<size_t>> &map,
+               const QString &key)
+{
+    auto it = map.find(key);
+    if (it != map.end())
+    {
+        indices.insert(indices.end(), it->second.begin(), it->second.end());
+    }
+}
+
+bool hasSurrogates(const QString &text)
+{
+    return std::any_of(text.begin(), text.end(), [](QChar c) {
+        return c.isSurrogate();
+    });
+}
+
+// Twitch login names only consist of these
+bool isPlainName(const QString &name)
+{
+    if (name.isEmpty())
+    {
+        return false;
+    }
+
+    return std::all_of(name.begin(), name.end(), [](QChar c) {
+        auto u = c.unicode();
+        return (u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z') ||
+               (u >= '0' && u <= '9') || u == '_';
+    });
+}
+
+/**
+ * A phrase which isn't a regex and only consists of word characters matches
+ * a plain name if and only if it is that name. A match anywhere else would
+ * need a word boundary or space between two word characters.
+ */
+bool isNamePhrase(const HighlightPhrase &phrase)
+{
+    return !phrase.isRegex() && phrase.isValid() &&
+           isPlainName(phrase.getPattern());
+}
+
+std::vector<size_t> otherPhraseIndices(
+    const std::vector<HighlightPhrase> &phrases)
+{
+    std::vector<size_t> indices;
+    for (size_t i = 0; i < phrases.size(); ++i)
+    {
+        if (!isNamePhrase(phrases[i]))
+        {
+            indices.push_back(i);
+        }
+    }
+    return indices;
+}
+
+std::vector<HighlightPhrase> selectPhrases(
+    const std::vector<HighlightPhrase> &phrases,
+    const std::vector<size_t> &indices)
+{
+    std::vector<HighlightPhrase> selected;
+    selected.reserve(indices.size());
+    for (auto index : indices)
+    {
+        selected.push_back(phrases[index]);
+    }
+    return selected;
+}
+
+}  // namespace
+
+namespace chatterino {
+
+HighlightPhraseMatcher::HighlightPhraseMatcher(
+    std::vector<HighlightPhrase> phrases)
+    : phrases_(std::move(phrases))
+{
+    std::vector<size_t> caseSensitiveRegexes;
+    std::vector<size_t> caseInsensitiveRegexes;
+
+    for (size_t i = 0; i < this->phrases_.size(); ++i)
+    {
+        const auto &phrase = this->phrases_[i];
+        if (!phrase.isValid())
+        {
+            // Invalid phrases never match
+            continue;
+        }
+
+        if (phrase.isRegex())
+        {
+            if (!RegexAlternation::canCombine(phrase.getPattern()))
+            {
+                this->others_.push_back(i);
+            }
+            else if (phrase.isCaseSensitive())
+            {
+                caseSensitiveRegexes.push_back(i);
+            }
+            else
+            {
+                caseInsensitiveRegexes.push_back(i);
+            }
+        }
+        else if (phrase.isCaseSensitive())
+        {
+            this->caseSensitiveLiterals_.add(phrase.getPattern(), i);
+        }
+        else if (!hasSurrogates(phrase.getPattern()))
+        {
+            this->caseInsensitiveLiterals_.add(phrase.getPattern(), i);
+        }
+        else
+        {
+            // Case folding characters outside the BMP needs both halves of
+            // the surrogate pair, which the automaton doesn't do
+            this->others_.push_back(i);
+        }
+    }
+
+    this->caseSensitiveLiterals_.build();
+    this->caseInsensitiveLiterals_.build();
+
+    this->combineRegexes(caseSensitiveRegexes, true);
+    this->combineRegexes(caseInsensitiveRegexes, false);
+}
+
+void HighlightPhraseMatcher::combineRegexes(const std::vector<size_t> &phrases,
+                                            bool caseSensitive)
+{
+    if (phrases.size() < 2)
+    {
+        this->others_.insert(this->others_.end(), phrases.begin(),
+                             phrases.end());
+        return;
+    }
+
+    std::vector<QString> patterns;
+    for (auto index : phrases)
+    {
+        patterns.push_back(this->phrases_[index].getPattern());
+    }
+
+    // Same options as HighlightPhrase
+    auto options = QRegularExpression::UseUnicodePropertiesOption |
+                   (caseSensitive ? QRegularExpression::NoPatternOption
+                                  : QRegularExpression::CaseInsensitiveOption);
+    CombinedRegex combined{RegexAlternation(patterns, options), phrases};
+    if (!combined.alternation.isValid())
+    {
+        this->others_.insert(this->others_.end(), phrases.begin(),
+                             phrases.end());
+        return;
+    }
+
+    this->combinedRegexes_.push_back(std::move(combined));
+}
+
+const std::vector<HighlightPhrase> &HighlightPhraseMatcher::phrases() const
+{
+    return this->phrases_;
+}
+
+std::vector<size_t> HighlightPhraseMatcher::match(const QString &subject) const
+{
+    std::vector<size_t> matches;
+
+    // The automatons find where the phrases occur, the word boundaries
+    // around them are checked by the regex of the phrase
+    std::vector<size_t> candidates;
+    auto addCandidate = [&candidates](size_t index, qsizetype /*end*/) {
+        candidates.push_back(index);
+    };
+    this->caseSensitiveLiterals_.find(subject, addCandidate);
+    this->caseInsensitiveLiterals_.find(subject, addCandidate);
+    sortUnique(candidates);
+    for (auto index : candidates)
+    {
+        if (this->phrases_[index].isMatch(subject))
+        {
+            matches.push_back(index);
+        }
+    }
+
+    for (const auto &combined : this->combinedRegexes_)
+    {
+        auto match = combined.alternation.regex().match(subject);
+        if (!match.hasMatch())
+        {
+            // None of the phrases match
+            continue;
+        }
+
+        // The alternation only tells the first phrase that matched, the
+        // others might match elsewhere
+        auto matched = combined.alternation.matchedPattern(match);
+        for (size_t i = 0; i < combined.phrases.size(); ++i)
+        {
+            auto index = combined.phrases[i];
+            if (i == matched || this->phrases_[index].isMatch(subject))
+            {
+                matches.push_back(index);
+            }
+        }
+    }
+
+    for (auto index : this->others_)
+    {
+        if (this->phrases_[index].isMatch(subject))
+        {
+            matches.push_back(index);
+        }
+    }
+
+    std::sort(matches.begin(), matches.end());
+    return matches;
+}
+
+HighlightUserMatcher::HighlightUserMatcher(
+    std::vector<HighlightPhrase> phrases)
+    : phrases_(std::move(phrases))
+    , otherIndices_(otherPhraseIndices(this->phrases_))
+    , others_(selectPhrases(this->phrases_, this->otherIndices_))
+{
+    for (size_t i = 0; i < this->phrases_.size(); ++i)
+    {
+        const auto &phrase = this->phrases_[i];
+        if (!isNamePhrase(phrase))
+        {
+            continue;
+        }
+
+        this->namePhrases_.push_back(i);
+        if (phrase.isCaseSensitive())
+        {
+            this->caseSensitiveNames_[phrase.getPattern()].push_back(i);
+        }
+        else
+        {
+            this->caseInsensitiveNames_[phrase.getPattern().toLower()]
+                .push_back(i);
+        }
+    }
+}
+
+const std::vector<HighlightPhrase> &HighlightUserMatcher::phrases() const
+{
+    return this->phrases_;
+}
+
+std::vector<size_t> HighlightUserMatcher::match(const QString &userName) const
+{
+    std::vector<size_t> matches;
+
+    if (isPlainName(userName))
+    {
+        appendAll(matches, this->caseSensitiveNames_, userName);
+        appendAll(matches, this->caseInsensitiveNames_, userName.toLower());
+    }
+    else
+    {
+        // Other names can contain a phrase, for example "a-b" contains "a"
+        for (auto index : this->namePhrases_)
+        {
+            if (this->phrases_[index].isMatch(userName))
+            {
+                matches.push_back(index);
+            }
+        }
+    }
+
+    for (auto index : this->others_.match(userName))
+    {
+        matches.push_back(this->otherIndices_[index]);
+    }
+
+    std::sort(matches.begin(), matches.end());
+    return matches;
+}
+
+HighlightBadgeMatcher::HighlightBadgeMatcher(
+    std::vector<HighlightBadge> highlights)
+    : highlights_(std::move(highlights))
+{
+    // Mirrors HighlightBadge::isMatch
+    for (size_t i = 0; i < this->highlights_.size(); ++i)
+    {
+        const auto &badgeName = this->highlights_[i].badgeName();
+        bool hasVersions = badgeName.contains('/');
+        auto ids = badgeName.contains(',') ? badgeName.split(',')
+                                           : QStringList{badgeName};
+
+        for (const auto &id : ids)
+        {
+            if (hasVersions)
+            {
+                auto parts = SharedMessageBuilder::slashKeyValue(id);
+                this->byNameAndVersion_[parts.first.toCaseFolded() + '/' +
+                                        parts.second.toCaseFolded()]
+                    .push_back(i);
+            }
+            else
+            {
+                this->byName_[id.toCaseFolded()].push_back(i);
+            }
+        }
+    }
+}
+
+const std::vector<HighlightBadge> &HighlightBadgeMatcher::highlights() const
+{
+    return this->highlights_;
+}
+
+std::vector<size_t> HighlightBadgeMatcher::match(
+    const std::vector<Badge> &badges) const
+{
+    std::vector<size_t> matches;
+
+    for (const auto &badge : badges)
+    {
+        auto name = badge.key_.toCaseFolded();
+        appendAll(matches, this->byName_, name);
+
+        // Names of highlights never contain a slash
+        if (!this->byNameAndVersion_.empty() && !name.contains('/'))
+        {
+            appendAll(matches, this->byNameAndVersion_,
+                      name + '/' + badge.value_.toCaseFolded());
+        }
+    }
+
+    sortUnique(matches);
+    return matches;
+}
+
+}  // namespace chatterino
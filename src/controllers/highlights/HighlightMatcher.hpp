@@ -0,0 +1,110 @@
+#pragma once
+
+#include "controllers/highlights/HighlightBadge.hpp"
+#include "controllers/highlights/HighlightPhrase.hpp"
+#include "util/AhoCorasick.hpp"
+#include "util/QStringHash.hpp"
+#include "util/RegexAlternation.hpp"
+
+#include <QString>
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace chatterino {
+
+class Badge;
+
+/**
+ * @brief Finds which of many highlight phrases match a text
+ *
+ * Phrases which aren't regexes are searched for all at once with an
+ * Aho-Corasick automaton, only the phrases found that way are matched with
+ * their regex to check the word boundaries. Regexes which can be combined
+ * are joined into one alternation per case sensitivity, so a text which
+ * matches none of them is only searched once.
+ */
+class HighlightPhraseMatcher
+{
+public:
+    explicit HighlightPhraseMatcher(std::vector<HighlightPhrase> phrases);
+
+    const std::vector<HighlightPhrase> &phrases() const;
+
+    /// Returns the indices of the phrases matching subject in ascending order
+    std::vector<size_t> match(const QString &subject) const;
+
+private:
+    struct CombinedRegex {
+        RegexAlternation alternation;
+        // Phrase of each pattern in the alternation
+        std::vector<size_t> phrases;
+    };
+
+    void combineRegexes(const std::vector<size_t> &phrases,
+                        bool caseSensitive);
+
+    std::vector<HighlightPhrase> phrases_;
+
+    AhoCorasick caseSensitiveLiterals_{false};
+    AhoCorasick caseInsensitiveLiterals_{true};
+    std::vector<CombinedRegex> combinedRegexes_;
+
+    // Phrases which are matched one by one
+    std::vector<size_t> others_;
+};
+
+/**
+ * @brief Finds which of many user highlights match a user name
+ *
+ * Phrases for plain user names are looked up by the name, the others are
+ * matched with a HighlightPhraseMatcher.
+ */
+class HighlightUserMatcher
+{
+public:
+    explicit HighlightUserMatcher(std::vector<HighlightPhrase> phrases);
+
+    const std::vector<HighlightPhrase> &phrases() const;
+
+    /// Returns the indices of the phrases matching userName in ascending order
+    std::vector<size_t> match(const QString &userName) const;
+
+private:
+    std::vector<HighlightPhrase> phrases_;
+
+    // Phrases by their exact and lowercase pattern
+    std::unordered_map<QString, std::vector<size_t>> caseSensitiveNames_;
+    std::unordered_map<QString, std::vector<size_t>> caseInsensitiveNames_;
+    std::vector<size_t> namePhrases_;
+
+    // Remaining phrases, by their index in phrases_
+    std::vector<size_t> otherIndices_;
+    HighlightPhraseMatcher others_;
+};
+
+/**
+ * @brief Finds which of many badge highlights match the badges of a message
+ */
+class HighlightBadgeMatcher
+{
+public:
+    explicit HighlightBadgeMatcher(std::vector<HighlightBadge> highlights);
+
+    const std::vector<HighlightBadge> &highlights() const;
+
+    /// Returns the indices of the highlights matching one of badges in
+    /// ascending order
+    std::vector<size_t> match(const std::vector<Badge> &badges) const;
+
+private:
+    std::vector<HighlightBadge> highlights_;
+
+    // Highlights by the case folded badge name ("subscriber") and by the
+    // case folded badge name and version ("subscriber/12")
+    std::unordered_map<QString, std::vector<size_t>> byName_;
+    std::unordered_map<QString, std::vector<size_t>> byNameAndVersion_;
+};
+
+}  // namespace chatterino
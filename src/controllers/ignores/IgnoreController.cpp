@@ -4,12 +4,23 @@
 #include "common/QLogging.hpp"
 #include "controllers/accounts/AccountController.hpp"
 #include "controllers/ignores/IgnorePhrase.hpp"
+#include "controllers/ignores/IgnoreReplacer.hpp"
 #include "providers/twitch/TwitchAccount.hpp"
 #include "singletons/Settings.hpp"
 
+#include <mutex>
+#include <utility>
+
 namespace chatterino {
 
 bool isIgnoredMessage(IgnoredMessageParameters &&params)
+{
+    return isIgnoredMessage(std::move(params),
+                            *getIApp()->getAccounts()->twitch.getCurrent());
+}
+
+bool isIgnoredMessage(IgnoredMessageParameters &&params,
+                      const TwitchAccount &currentUser)
 {
     if (!params.message.isEmpty())
     {
@@ -32,8 +43,7 @@ bool isIgnoredMessage(IgnoredMessageParameters &&params)
     {
         auto sourceUserID = params.twitchUserID;
 
-        auto blocks =
-            getApp()->accounts->twitch.getCurrent()->accessBlockedUserIds();
+        auto blocks = currentUser.accessBlockedUserIds();
 
         if (auto it = blocks->find(sourceUserID); it != blocks->end())
         {
@@ -63,4 +73,23 @@ bool isIgnoredMessage(IgnoredMessageParameters &&params)
     return false;
 }
 
+std::shared_ptr<const IgnoreReplacer> ignoreReplacer()
+{
+    static std::mutex mutex;
+    static std::shared_ptr<const std::vector<IgnorePhrase>> compiledPhrases;
+    static std::shared_ptr<const IgnoreReplacer> replacer;
+
+    // The settings hand out a new vector whenever the phrases change
+    auto phrases = getCSettings().ignoredMessages.readOnly();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!replacer || phrases != compiledPhrases)
+    {
+        replacer = std::make_shared<const IgnoreReplacer>(*phrases);
+        compiledPhrases = std::move(phrases);
+    }
+
+    return replacer;
+}
+
 }  // namespace chatterino
@@ -2,6 +2,8 @@
 
 #include <QString>
 
+#include <memory>
+
 namespace chatterino {
 
 enum class ShowIgnoredUsersMessages { Never, IfModerator, IfBroadcaster };
@@ -14,6 +16,19 @@ struct IgnoredMessageParameters {
     bool isBroadcaster;
 };
 
+class TwitchAccount;
+
 bool isIgnoredMessage(IgnoredMessageParameters &&params);
 
+/// Like isIgnoredMessage, but with the users blocked by currentUser instead
+/// of the current account. Can be used off the GUI thread.
+bool isIgnoredMessage(IgnoredMessageParameters &&params,
+                      const TwitchAccount &currentUser);
+
+class IgnoreReplacer;
+
+/// Returns the replacer for the current ignored phrases, it is compiled again
+/// when they change
+std::shared_ptr<const IgnoreReplacer> ignoreReplacer();
+
 }  // namespace chatterino
@@ -0,0 +1,328 @@
+#include "controllers/ignores/IgnoreReplacer.hpp"
+
+#include <QRegularExpressionMatch>
+
+#include <algorithm>
+
+namespace {
+
+bool hasSurrogates(const QString &text)
+{
+    return std::any_of(text.begin(), text.end(), [](QChar c) {
+        return c.isSurrogate();
+    });
+}
+
+// Replaces \1 to \99 in replace with the groups of match, like
+// QString::replace does with a regex
+QString expandReferences(const QString &replace,
+                         const QRegularExpressionMatch &match, int groupCount)
+{
+    QString expanded;
+    expanded.reserve(replace.size());
+
+    for (qsizetype i = 0; i < replace.size(); ++i)
+    {
+        if (replace[i] == '\\' && i + 1 < replace.size())
+        {
+            auto group = replace[i + 1].digitValue();
+            if (group > 0 && group <= groupCount)
+            {
+                ++i;
+
+                // Two digits if there are that many groups
+                if (i + 1 < replace.size())
+                {
+                    auto second = replace[i + 1].digitValue();
+                    if (second != -1 && group * 10 + second <= groupCount)
+                    {
+                        group = group * 10 + second;
+                        ++i;
+                    }
+                }
+
+                expanded += match.captured(group);
+                continue;
+            }
+        }
+
+        expanded += replace[i];
+    }
+
+    return expanded;
+}
+
+}  // namespace
+
+namespace chatterino {
+
+IgnoreReplacer::IgnoreReplacer(std::vector<IgnorePhrase> phrases)
+{
+    for (auto &phrase : phrases)
+    {
+        if (phrase.isBlock() || phrase.getPattern().isEmpty() ||
+            (phrase.isRegex() && !phrase.isRegexValid()))
+        {
+            // These never replace anything
+            continue;
+        }
+        this->phrases_.push_back(std::move(phrase));
+    }
+
+    std::vector<size_t> caseSensitiveRegexes;
+    std::vector<QString> caseSensitivePatterns;
+    std::vector<size_t> caseInsensitiveRegexes;
+    std::vector<QString> caseInsensitivePatterns;
+
+    for (size_t i = 0; i < this->phrases_.size(); ++i)
+    {
+        const auto &phrase = this->phrases_[i];
+        const auto &pattern = phrase.getPattern();
+
+        if (phrase.isRegex())
+        {
+            if (!RegexAlternation::canCombine(pattern))
+            {
+                this->searchers_.push_back({std::nullopt, {i}});
+            }
+            else if (phrase.isCaseSensitive())
+            {
+                caseSensitiveRegexes.push_back(i);
+                caseSensitivePatterns.push_back(pattern);
+            }
+            else
+            {
+                caseInsensitiveRegexes.push_back(i);
+                caseInsensitivePatterns.push_back(pattern);
+            }
+        }
+        else if (phrase.isCaseSensitive())
+        {
+            this->caseSensitiveLiterals_.add(pattern, i);
+        }
+        else if (!hasSurrogates(pattern))
+        {
+            this->caseInsensitiveLiterals_.add(pattern, i);
+        }
+        else
+        {
+            // Case folding characters outside the BMP needs both halves of
+            // the surrogate pair, which the automaton doesn't do
+            caseInsensitiveRegexes.push_back(i);
+            caseInsensitivePatterns.push_back(
+                QRegularExpression::escape(pattern));
+        }
+    }
+
+    this->caseSensitiveLiterals_.build();
+    this->caseInsensitiveLiterals_.build();
+
+    this->addSearcher(caseSensitiveRegexes, caseSensitivePatterns, true);
+    this->addSearcher(caseInsensitiveRegexes, caseInsensitivePatterns, false);
+}
+
+void IgnoreReplacer::addSearcher(const std::vector<size_t> &phrases,
+                                 const std::vector<QString> &patterns,
+                                 bool caseSensitive)
+{
+    if (phrases.empty())
+    {
+        return;
+    }
+
+    // Same options as IgnorePhrase
+    auto options = QRegularExpression::UseUnicodePropertiesOption |
+                   (caseSensitive ? QRegularExpression::NoPatternOption
+                                  : QRegularExpression::CaseInsensitiveOption);
+    RegexAlternation alternation(patterns, options);
+    if (alternation.isValid())
+    {
+        this->searchers_.push_back({std::move(alternation), phrases});
+        return;
+    }
+
+    // One of the patterns only compiles on its own
+    for (size_t i = 0; i < phrases.size(); ++i)
+    {
+        RegexAlternation single({patterns[i]}, options);
+        if (single.isValid())
+        {
+            this->searchers_.push_back({std::move(single), {phrases[i]}});
+        }
+    }
+}
+
+bool IgnoreReplacer::empty() const
+{
+    return this->phrases_.empty();
+}
+
+bool IgnoreReplacer::search(const Searcher &searcher, const QString &message,
+                            qsizetype from, Match &match) const
+{
+    const auto &regex = searcher.alternation
+                            ? searcher.alternation->regex()
+                            : this->phrases_[searcher.phrases[0]].getRegex();
+
+    while (from <= message.size())
+    {
+        auto result = regex.match(message, from);
+        if (!result.hasMatch())
+        {
+            return false;
+        }
+
+        if (result.capturedLength() == 0)
+        {
+            // Replacing nothing would insert the replacement everywhere
+            from = result.capturedStart() + 1;
+            continue;
+        }
+
+        match.start = result.capturedStart();
+        match.length = result.capturedLength();
+        match.phrase =
+            searcher.alternation
+                ? searcher.phrases[searcher.alternation->matchedPattern(result)]
+                : searcher.phrases[0];
+        return true;
+    }
+
+    return false;
+}
+
+QString IgnoreReplacer::replacement(const Match &match,
+                                    const QString &message) const
+{
+    const auto &phrase = this->phrases_[match.phrase];
+    if (!phrase.isRegex())
+    {
+        return phrase.getReplace();
+    }
+
+    // The groups of the regex come from matching it again where it matched
+    // before, in the whole message, so lookarounds, \b, ^ and $ see the
+    // same text as when searching
+    const auto &regex = phrase.getRegex();
+    auto result = regex.match(message, match.start,
+                              QRegularExpression::NormalMatch,
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+                              QRegularExpression::AnchorAtOffsetMatchOption
+#else
+                              QRegularExpression::AnchoredMatchOption
+#endif
+    );
+    if (!result.hasMatch())
+    {
+        return phrase.getReplace();
+    }
+
+    return expandReferences(phrase.getReplace(), result, regex.captureCount());
+}
+
+std::vector<IgnoreReplacement> IgnoreReplacer::replace(QString &message) const
+{
+    std::vector<IgnoreReplacement> replacements;
+    if (this->phrases_.empty())
+    {
+        return replacements;
+    }
+
+    std::vector<Match> literals;
+    auto addLiteral = [this, &literals](size_t index, qsizetype end) {
+        auto length = this->phrases_[index].getPattern().size();
+        literals.push_back({end - length, length, index});
+    };
+    this->caseSensitiveLiterals_.find(message, addLiteral);
+    this->caseInsensitiveLiterals_.find(message, addLiteral);
+    std::sort(literals.begin(), literals.end());
+
+    // Next match of each searcher, searched again once a replacement
+    // covers its start
+    std::vector<std::optional<Match>> next(this->searchers_.size());
+    for (size_t i = 0; i < this->searchers_.size(); ++i)
+    {
+        Match match{};
+        if (this->search(this->searchers_[i], message, 0, match))
+        {
+            next[i] = match;
+        }
+    }
+
+    QString result;
+    qsizetype from = 0;
+    auto literal = literals.begin();
+
+    while (true)
+    {
+        while (literal != literals.end() && literal->start < from)
+        {
+            ++literal;
+        }
+
+        std::optional<Match> best;
+        if (literal != literals.end())
+        {
+            best = *literal;
+        }
+
+        for (size_t i = 0; i < this->searchers_.size(); ++i)
+        {
+            auto &match = next[i];
+            if (match && match->start < from)
+            {
+                Match again{};
+                if (this->search(this->searchers_[i], message, from, again))
+                {
+                    match = again;
+                }
+                else
+                {
+                    match.reset();
+                }
+            }
+
+            if (match && (!best || *match < *best))
+            {
+                best = match;
+            }
+        }
+
+        if (!best)
+        {
+            break;
+        }
+
+        if (replacements.empty())
+        {
+            result.reserve(message.size());
+        }
+
+        auto replaced = this->replacement(*best, message);
+        result.append(message.constData() + from,
+                      static_cast<int>(best->start - from));
+        replacements.push_back({
+            static_cast<int>(best->start),
+            static_cast<int>(best->length),
+            static_cast<int>(result.size()),
+            static_cast<int>(replaced.size()),
+            &this->phrases_[best->phrase],
+        });
+        result.append(replaced);
+
+        from = best->start + best->length;
+    }
+
+    if (replacements.empty())
+    {
+        return replacements;
+    }
+
+    result.append(message.constData() + from,
+                  static_cast<int>(message.size() - from));
+    message = std::move(result);
+
+    return replacements;
+}
+
+}  // namespace chatterino
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "controllers/ignores/IgnorePhrase.hpp"
+#include "util/AhoCorasick.hpp"
+#include "util/RegexAlternation.hpp"
+
+#include <QString>
+
+#include <cstddef>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+namespace chatterino {
+
+struct IgnoreReplacement {
+    // Replaced text in the original message
+    int start;
+    int length;
+
+    // Replacement in the new message
+    int newStart;
+    int newLength;
+
+    const IgnorePhrase *phrase;
+};
+
+/**
+ * @brief Applies the replacements of many ignored phrases in a single pass
+ *
+ * The phrases are compiled once: phrases which aren't regexes are searched
+ * for with Aho-Corasick automatons, regexes are joined into alternations
+ * where possible. The message is scanned from left to right and the leftmost
+ * match is replaced, if several phrases match there the first one wins.
+ * Scanning continues after the replaced text, so replacements are never
+ * replaced again.
+ */
+class IgnoreReplacer
+{
+public:
+    /// Phrases which block messages or can never match are skipped
+    explicit IgnoreReplacer(std::vector<IgnorePhrase> phrases);
+
+    /// Whether there are no phrases with replacements
+    bool empty() const;
+
+    /**
+     * @brief Replaces the matches of the phrases in message
+     *
+     * @return the replacements from left to right
+     */
+    std::vector<IgnoreReplacement> replace(QString &message) const;
+
+private:
+    struct Match {
+        qsizetype start;
+        qsizetype length;
+        size_t phrase;
+
+        bool operator<(const Match &other) const
+        {
+            return std::tie(this->start, this->phrase) <
+                   std::tie(other.start, other.phrase);
+        }
+    };
+
+    struct Searcher {
+        // Unset for a regex which can't be combined, that one is searched
+        // with the regex of its phrase
+        std::optional<RegexAlternation> alternation;
+        // Phrase of each pattern in the alternation
+        std::vector<size_t> phrases;
+    };
+
+    void addSearcher(const std::vector<size_t> &phrases,
+                     const std::vector<QString> &patterns, bool caseSensitive);
+
+    /// Finds the leftmost non-empty match of searcher at or after from
+    bool search(const Searcher &searcher, const QString &message,
+                qsizetype from, Match &match) const;
+
+    QString replacement(const Match &match, const QString &message) const;
+
+    std::vector<IgnorePhrase> phrases_;
+
+    AhoCorasick caseSensitiveLiterals_{false};
+    AhoCorasick caseInsensitiveLiterals_{true};
+    std::vector<Searcher> searchers_;
+};
+
+}  // namespace chatterino
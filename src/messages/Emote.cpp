@@ -1,6 +1,16 @@
 #include "Emote.hpp"
 
 #include <unordered_map>
+#include <utility>
+
+namespace {
+
+// Overlays with fewer emotes are never merged into the base
+constexpr size_t MIN_MERGED_OVERLAY = 32;
+// Overlays are merged once they have an eighth as many emotes as the base
+constexpr size_t OVERLAY_RATIO = 8;
+
+}  // namespace
 
 namespace chatterino {
 
@@ -25,25 +35,310 @@ EmotePtr cachedOrMakeEmotePtr(Emote &&emote, const EmoteMap &cache)
     return std::make_shared<Emote>(std::move(emote));
 }
 
-EmotePtr cachedOrMakeEmotePtr(
-    Emote &&emote,
-    std::unordered_map<EmoteId, std::weak_ptr<const Emote>> &cache,
-    std::mutex &mutex, const EmoteId &id)
+EmotePtr cachedOrMakeEmotePtr(Emote &&emote,
+                              WeakCache<EmoteId, const Emote> &cache,
+                              const EmoteId &id)
+{
+    // reuse old shared_ptr if nothing changed
+    return cache.getOrCreate(
+        id,
+        [&] {
+            return std::make_shared<const Emote>(std::move(emote));
+        },
+        [&](const Emote &cached) {
+            return cached == emote;
+        });
+}
+
+EmoteMap::const_iterator::const_iterator(const EmoteMap *map,
+                                         Base::const_iterator base)
+    : map_(map)
+    , inOverlay_(false)
+    , base_(base)
+{
+    this->settle();
+}
+
+EmoteMap::const_iterator::const_iterator(const EmoteMap *map,
+                                         Overlay::const_iterator overlay)
+    : map_(map)
+    , inOverlay_(true)
+    , overlay_(std::move(overlay))
+{
+    this->settle();
+}
+
+EmoteMap::const_iterator::reference EmoteMap::const_iterator::operator*() const
+{
+    if (this->inOverlay_)
+    {
+        return *this->overlay_;
+    }
+    return *this->base_;
+}
+
+EmoteMap::const_iterator::pointer EmoteMap::const_iterator::operator->() const
+{
+    return &**this;
+}
+
+EmoteMap::const_iterator &EmoteMap::const_iterator::operator++()
+{
+    if (this->inOverlay_)
+    {
+        ++this->overlay_;
+    }
+    else
+    {
+        ++this->base_;
+    }
+    this->settle();
+    return *this;
+}
+
+EmoteMap::const_iterator EmoteMap::const_iterator::operator++(int)
+{
+    auto copy = *this;
+    ++*this;
+    return copy;
+}
+
+bool EmoteMap::const_iterator::operator==(const const_iterator &other) const
+{
+    if (this->inOverlay_ != other.inOverlay_)
+    {
+        return false;
+    }
+    if (this->inOverlay_)
+    {
+        return this->overlay_ == other.overlay_;
+    }
+    return this->base_ == other.base_;
+}
+
+bool EmoteMap::const_iterator::operator!=(const const_iterator &other) const
+{
+    return !(*this == other);
+}
+
+void EmoteMap::const_iterator::settle()
+{
+    const auto &overlay = this->map_->overlay_;
+
+    if (!this->inOverlay_)
+    {
+        const auto &base = this->map_->base();
+        if (!overlay.empty())
+        {
+            while (this->base_ != base.end() &&
+                   overlay.count(this->base_->first) != 0)
+            {
+                ++this->base_;
+            }
+        }
+        if (this->base_ != base.end())
+        {
+            return;
+        }
+
+        this->inOverlay_ = true;
+        this->overlay_ = overlay.begin();
+    }
+
+    while (this->overlay_ != overlay.end() && !this->overlay_->second)
+    {
+        ++this->overlay_;
+    }
+}
+
+EmoteMap::EmoteMap(EmoteMap &&other) noexcept
+    : base_(std::move(other.base_))
+    , overlay_(std::move(other.overlay_))
+    , size_(std::exchange(other.size_, 0))
+{
+}
+
+EmoteMap &EmoteMap::operator=(EmoteMap &&other) noexcept
+{
+    this->base_ = std::move(other.base_);
+    this->overlay_ = std::move(other.overlay_);
+    this->size_ = std::exchange(other.size_, 0);
+    return *this;
+}
+
+EmoteMap::size_type EmoteMap::size() const
+{
+    return this->size_;
+}
+
+bool EmoteMap::empty() const
+{
+    return this->size_ == 0;
+}
+
+EmoteMap::const_iterator EmoteMap::begin() const
 {
-    std::lock_guard<std::mutex> guard(mutex);
+    return {this, this->base().begin()};
+}
+
+EmoteMap::const_iterator EmoteMap::end() const
+{
+    return {this, this->overlay_.end()};
+}
+
+EmoteMap::const_iterator EmoteMap::find(const EmoteName &name) const
+{
+    if (!this->overlay_.empty())
+    {
+        auto it = this->overlay_.find(name);
+        if (it != this->overlay_.end())
+        {
+            return it->second ? const_iterator(this, it) : this->end();
+        }
+    }
+
+    auto it = this->base().find(name);
+    if (it == this->base().end())
+    {
+        return this->end();
+    }
+    return {this, it};
+}
+
+EmoteMap::size_type EmoteMap::count(const EmoteName &name) const
+{
+    return this->find(name) == this->end() ? 0 : 1;
+}
+
+EmotePtr &EmoteMap::operator[](const EmoteName &name)
+{
+    if (this->prepareModification())
+    {
+        auto &emote = (*this->base_)[name];
+        this->size_ = this->base_->size();
+        return emote;
+    }
+
+    auto current = this->find(name);
+    auto existed = current != this->end();
+    auto emote = existed ? current->second : EmotePtr();
+
+    auto &slot = this->overlay_[name];
+    slot = std::move(emote);
+    if (!existed)
+    {
+        this->size_++;
+    }
+    return slot;
+}
+
+std::pair<EmoteMap::const_iterator, bool> EmoteMap::insert(
+    const value_type &value)
+{
+    auto it = this->find(value.first);
+    if (it != this->end())
+    {
+        return {it, false};
+    }
+
+    (*this)[value.first] = value.second;
+    return {this->find(value.first), true};
+}
+
+EmoteMap::size_type EmoteMap::erase(const EmoteName &name)
+{
+    if (this->find(name) == this->end())
+    {
+        return 0;
+    }
 
-    auto shared = cache[id].lock();
-    if (shared && *shared == emote)
+    if (this->prepareModification())
+    {
+        this->base_->erase(name);
+    }
+    else if (this->base_->count(name) != 0)
     {
-        // reuse old shared_ptr if nothing changed
-        return shared;
+        // Shadow the emote of the base
+        this->overlay_.insert_or_assign(name, EmotePtr());
     }
     else
     {
-        shared = std::make_shared<Emote>(std::move(emote));
-        cache[id] = shared;
-        return shared;
+        this->overlay_.erase(name);
+    }
+
+    this->size_--;
+    return 1;
+}
+
+EmoteMap::const_iterator EmoteMap::erase(const_iterator pos)
+{
+    // Erasing invalidates both iterators, so the names are copied
+    auto name = pos->first;
+    auto next = std::next(pos);
+    if (next == this->end())
+    {
+        this->erase(name);
+        return this->end();
+    }
+
+    auto nextName = next->first;
+    this->erase(name);
+    return this->find(nextName);
+}
+
+void EmoteMap::clear()
+{
+    this->base_.reset();
+    this->overlay_.clear();
+    this->size_ = 0;
+}
+
+bool EmoteMap::prepareModification()
+{
+    if (!this->base_)
+    {
+        this->base_ = std::make_shared<Base>();
+    }
+
+    if (this->base_.use_count() == 1)
+    {
+        // No other map shares the base anymore, so the overlay can be
+        // applied to it
+        for (const auto &[name, emote] : this->overlay_)
+        {
+            if (emote)
+            {
+                (*this->base_)[name] = emote;
+            }
+            else
+            {
+                this->base_->erase(name);
+            }
+        }
+        this->overlay_.clear();
+        return true;
+    }
+
+    if (this->overlay_.size() >= MIN_MERGED_OVERLAY &&
+        this->overlay_.size() * OVERLAY_RATIO >= this->base_->size())
+    {
+        this->base_ = std::make_shared<Base>(this->begin(), this->end());
+        this->overlay_.clear();
+        return true;
+    }
+
+    return false;
+}
+
+const EmoteMap::Base &EmoteMap::base() const
+{
+    static const Base empty;
+
+    if (!this->base_)
+    {
+        return empty;
     }
+    return *this->base_;
 }
 
 EmoteMap::const_iterator EmoteMap::findEmote(const QString &emoteNameHint,
@@ -2,10 +2,14 @@
 
 #include "common/Aliases.hpp"
 #include "messages/ImageSet.hpp"
+#include "util/PersistentHashMap.hpp"
+#include "util/WeakCache.hpp"
 
 #include <boost/optional.hpp>
 
+#include <cstddef>
 #include <functional>
+#include <iterator>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -38,9 +42,96 @@ bool operator!=(const Emote &a, const Emote &b);
 
 using EmotePtr = std::shared_ptr<const Emote>;
 
-class EmoteMap : public std::unordered_map<EmoteName, EmotePtr>
+/**
+ * @brief Emotes by their name
+ *
+ * Emote maps are shared as immutable snapshots and updated by modifying a
+ * copy (see SeventvEmotes::addEmote). To keep these copies cheap, copies
+ * share their emotes: a map that shares its emotes with another map records
+ * its changes in a persistent overlay, which is O(log n) per change. Once
+ * the overlay grows large compared to the shared emotes, both are merged
+ * into emotes only this map owns.
+ *
+ * The interface follows std::unordered_map, but all iterators are constant.
+ * Emotes must not be null.
+ */
+class EmoteMap
 {
+    using Base = std::unordered_map<EmoteName, EmotePtr>;
+    // Emotes added or replaced since base_ was shared, removed emotes are null
+    using Overlay = PersistentHashMap<EmoteName, EmotePtr>;
+
 public:
+    using key_type = EmoteName;
+    using mapped_type = EmotePtr;
+    using value_type = Base::value_type;
+    using size_type = size_t;
+
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = EmoteMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type *;
+        using reference = const value_type &;
+
+        const_iterator() = default;
+
+        reference operator*() const;
+        pointer operator->() const;
+        const_iterator &operator++();
+        const_iterator operator++(int);
+
+        bool operator==(const const_iterator &other) const;
+        bool operator!=(const const_iterator &other) const;
+
+    private:
+        friend class EmoteMap;
+
+        const_iterator(const EmoteMap *map, Base::const_iterator base);
+        const_iterator(const EmoteMap *map, Overlay::const_iterator overlay);
+
+        // Skips shadowed emotes of the base and removed ones of the overlay
+        void settle();
+
+        const EmoteMap *map_{};
+        bool inOverlay_ = true;
+        Base::const_iterator base_;
+        Overlay::const_iterator overlay_;
+    };
+    using iterator = const_iterator;
+
+    EmoteMap() = default;
+    EmoteMap(const EmoteMap &other) = default;
+    EmoteMap(EmoteMap &&other) noexcept;
+    EmoteMap &operator=(const EmoteMap &other) = default;
+    EmoteMap &operator=(EmoteMap &&other) noexcept;
+
+    [[nodiscard]] size_type size() const;
+    [[nodiscard]] bool empty() const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    const_iterator find(const EmoteName &name) const;
+    [[nodiscard]] size_type count(const EmoteName &name) const;
+
+    /// The reference is invalidated by the next modification of the map
+    EmotePtr &operator[](const EmoteName &name);
+    std::pair<const_iterator, bool> insert(const value_type &value);
+
+    template <typename... Args>
+    std::pair<const_iterator, bool> emplace(Args &&...args)
+    {
+        return this->insert(value_type(std::forward<Args>(args)...));
+    }
+
+    size_type erase(const EmoteName &name);
+    /// Returns the iterator following pos
+    const_iterator erase(const_iterator pos);
+    void clear();
+
     /**
      * Finds an emote by it's id with a hint to it's name.
      *
@@ -54,15 +145,29 @@ public:
      */
     EmoteMap::const_iterator findEmote(const QString &emoteNameHint,
                                        const QString &emoteID) const;
+
+private:
+    /**
+     * @brief Prepares a modification
+     *
+     * @return true if base_ is owned by this map and can be modified,
+     *         otherwise the modification goes to overlay_
+     */
+    bool prepareModification();
+    const Base &base() const;
+
+    // Null if this map is empty
+    std::shared_ptr<Base> base_;
+    Overlay overlay_;
+    size_type size_ = 0;
 };
 
 static const std::shared_ptr<const EmoteMap> EMPTY_EMOTE_MAP = std::make_shared<
     const EmoteMap>();  // NOLINT(cert-err58-cpp) -- assume this doesn't throw an exception
 
 EmotePtr cachedOrMakeEmotePtr(Emote &&emote, const EmoteMap &cache);
-EmotePtr cachedOrMakeEmotePtr(
-    Emote &&emote,
-    std::unordered_map<EmoteId, std::weak_ptr<const Emote>> &cache,
-    std::mutex &mutex, const EmoteId &id);
+EmotePtr cachedOrMakeEmotePtr(Emote &&emote,
+                              WeakCache<EmoteId, const Emote> &cache,
+                              const EmoteId &id);
 
 }  // namespace chatterino
@@ -13,6 +13,7 @@
 #include "singletons/WindowManager.hpp"
 #include "util/DebugCount.hpp"
 #include "util/PostToThread.hpp"
+#include "util/WeakCache.hpp"
 
 #include <boost/functional/hash.hpp>
 #include <QBuffer>
@@ -162,6 +163,21 @@ namespace detail {
         return this->items_.front().image;
     }
 
+    boost::optional<long unsigned> Frames::nextFrameDeadline() const
+    {
+        if (!this->animated())
+            return boost::none;
+
+        // The frame changes on the first tick that pushes durationOffset_
+        // past the duration of the current frame, see processOffset
+        auto remaining = static_cast<long unsigned>(std::max(
+            0, this->items_[this->index_].duration - this->durationOffset_));
+        auto ticks = remaining / GIF_FRAME_LENGTH + 1;
+
+        return getApp()->emotes->gifTimer.position() +
+               ticks * GIF_FRAME_LENGTH;
+    }
+
     // functions
     QVector<Frame<QImage>> readFrames(QImageReader &reader, const Url &url)
     {
@@ -290,19 +306,11 @@ Image::~Image()
 
 ImagePtr Image::fromUrl(const Url &url, qreal scale)
 {
-    static std::unordered_map<Url, std::weak_ptr<Image>> cache;
-    static std::mutex mutex;
-
-    std::lock_guard<std::mutex> lock(mutex);
-
-    auto shared = cache[url].lock();
+    static WeakCache<Url, Image> cache("image cache");
 
-    if (!shared)
-    {
-        cache[url] = shared = ImagePtr(new Image(url, scale));
-    }
-
-    return shared;
+    return cache.getOrCreate(url, [&] {
+        return ImagePtr(new Image(url, scale));
+    });
 }
 
 ImagePtr Image::fromResourcePixmap(const QPixmap &pixmap, qreal scale)
@@ -443,6 +451,13 @@ bool Image::animated() const
     return this->frames_->animated();
 }
 
+boost::optional<long unsigned> Image::nextFrameDeadline() const
+{
+    assertInGuiThread();
+
+    return this->frames_->nextFrameDeadline();
+}
+
 int Image::width() const
 {
     assertInGuiThread();
@@ -39,6 +39,8 @@ namespace detail {
         void advance();
         boost::optional<QPixmap> current() const;
         boost::optional<QPixmap> first() const;
+        /// GIF timer position at which current() changes, see Image
+        boost::optional<long unsigned> nextFrameDeadline() const;
 
     private:
         void processOffset();
@@ -75,6 +77,13 @@ public:
     int width() const;
     int height() const;
     bool animated() const;
+    /**
+     * @brief Returns when the image shows its next frame
+     *
+     * The returned value is the position of the GIF timer at which the
+     * current pixmap changes. It's empty for images that aren't animated.
+     */
+    boost::optional<long unsigned> nextFrameDeadline() const;
 
     bool operator==(const Image &image) = delete;
     bool operator!=(const Image &image) = delete;
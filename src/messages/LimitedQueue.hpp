@@ -2,23 +2,43 @@
 
 #include "messages/LimitedQueueSnapshot.hpp"
 
-#include <boost/circular_buffer.hpp>
 #include <boost/optional.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <memory>
 #include <mutex>
 #include <shared_mutex>
 #include <vector>
 
 namespace chatterino {
 
+/**
+ * @brief A bounded queue that evicts items from the front when full
+ *
+ * Items are stored in fixed-size chunks that are shared with snapshots.
+ * Taking a snapshot is O(1); chunks (and the chunk list) are copied on write
+ * only while a snapshot still references them. Appending never touches a
+ * slot that's visible to an existing snapshot, so it doesn't need to copy.
+ *
+ * Evicted items stay alive until their chunk is released, i.e. at most
+ * MAX_CHUNK_SIZE - 1 items are retained past their eviction.
+ */
 template <typename T>
 class LimitedQueue
 {
+    using Chunk = detail::LimitedQueueChunk<T>;
+    using Chunks = detail::LimitedQueueChunks<T>;
+
 public:
+    /// Upper bound of items stored in a single chunk
+    static constexpr size_t MAX_CHUNK_SIZE = 128;
+
     LimitedQueue(size_t limit = 1000)
         : limit_(limit)
-        , buffer_(limit)
+        , chunkSize_(std::clamp<size_t>(limit, 1, MAX_CHUNK_SIZE))
+        , chunks_(std::make_shared<Chunks>())
     {
     }
 
@@ -39,7 +59,141 @@ private:
      */
     [[nodiscard]] size_t space() const
     {
-        return this->limit() - this->buffer_.size();
+        return this->limit() - this->size_;
+    }
+
+    /// Chunk helpers
+    // None of these lock, the caller must hold a unique lock for the
+    // mutating ones
+
+    /**
+     * @brief Return the item at the given index
+     */
+    [[nodiscard]] const T &at(size_t index) const
+    {
+        assert(index < this->size_);
+
+        auto pos = this->offset_ + index;
+        return (*(*this->chunks_)[pos / this->chunkSize_])[pos %
+                                                           this->chunkSize_];
+    }
+
+    /**
+     * @brief Return true if nobody but us holds a reference to ptr
+     *
+     * The acquire fence pairs with the release in the shared_ptr destructor
+     * of other owners, so their reads happen before our writes.
+     */
+    template <typename U>
+    [[nodiscard]] static bool isUnique(const std::shared_ptr<U> &ptr)
+    {
+        if (ptr.use_count() == 1)
+        {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Return the chunk list, copying it first if a snapshot uses it
+     */
+    Chunks &mutableChunks()
+    {
+        if (!isUnique(this->chunks_))
+        {
+            this->chunks_ = std::make_shared<Chunks>(*this->chunks_);
+        }
+        return *this->chunks_;
+    }
+
+    /**
+     * @brief Return a writable reference to the slot at the given position
+     *
+     * The chunk containing the slot is copied first if a snapshot uses it.
+     * mutableChunks() must have been called before.
+     *
+     * @param pos position relative to the start of the first chunk
+     */
+    T &mutableSlot(size_t pos)
+    {
+        assert(isUnique(this->chunks_));
+
+        auto &chunk = (*this->chunks_)[pos / this->chunkSize_];
+        if (!isUnique(chunk))
+        {
+            chunk = std::make_shared<Chunk>(*chunk);
+        }
+        return (*chunk)[pos % this->chunkSize_];
+    }
+
+    /**
+     * @brief Drop the first item, releasing its chunk once it's empty
+     */
+    void popFront()
+    {
+        assert(this->size_ > 0);
+
+        ++this->offset_;
+        --this->size_;
+        if (this->offset_ == this->chunkSize_)
+        {
+            auto &chunks = this->mutableChunks();
+            chunks.erase(chunks.begin());
+            this->offset_ = 0;
+        }
+    }
+
+    /**
+     * @brief Append an item, growing the chunk list if required
+     *
+     * The slot written to lies past the end of every snapshot, so the chunk
+     * itself is never copied.
+     */
+    void appendSlot(const T &item)
+    {
+        assert(this->size_ < this->limit_);
+
+        auto pos = this->offset_ + this->size_;
+        if (pos / this->chunkSize_ >= this->chunks_->size())
+        {
+            this->mutableChunks().push_back(
+                std::make_shared<Chunk>(this->chunkSize_));
+        }
+
+        (*(*this->chunks_)[pos / this->chunkSize_])[pos % this->chunkSize_] =
+            item;
+        ++this->size_;
+    }
+
+    /**
+     * @brief Copy all items out of the queue
+     */
+    [[nodiscard]] std::vector<T> toVector() const
+    {
+        std::vector<T> items;
+        items.reserve(this->size_);
+        for (size_t i = 0; i < this->size_; ++i)
+        {
+            items.push_back(this->at(i));
+        }
+        return items;
+    }
+
+    /**
+     * @brief Replace the contents of the queue with fresh chunks
+     */
+    void rebuild(const std::vector<T> &items)
+    {
+        assert(items.size() <= this->limit_);
+
+        this->chunks_ = std::make_shared<Chunks>();
+        this->offset_ = 0;
+        this->size_ = 0;
+        for (const auto &item : items)
+        {
+            this->appendSlot(item);
+        }
     }
 
 public:
@@ -50,7 +204,7 @@ public:
     {
         std::shared_lock lock(this->mutex_);
 
-        return this->buffer_.empty();
+        return this->size_ == 0;
     }
 
     /// Value Accessors
@@ -66,12 +220,12 @@ public:
     {
         std::shared_lock lock(this->mutex_);
 
-        if (index >= this->buffer_.size())
+        if (index >= this->size_)
         {
             return boost::none;
         }
 
-        return this->buffer_[index];
+        return this->at(index);
     }
 
     /**
@@ -83,12 +237,12 @@ public:
     {
         std::shared_lock lock(this->mutex_);
 
-        if (this->buffer_.empty())
+        if (this->size_ == 0)
         {
             return boost::none;
         }
 
-        return this->buffer_.front();
+        return this->at(0);
     }
 
     /**
@@ -100,12 +254,12 @@ public:
     {
         std::shared_lock lock(this->mutex_);
 
-        if (this->buffer_.empty())
+        if (this->size_ == 0)
         {
             return boost::none;
         }
 
-        return this->buffer_.back();
+        return this->at(this->size_ - 1);
     }
 
     /// Modifiers
@@ -115,7 +269,9 @@ public:
     {
         std::unique_lock lock(this->mutex_);
 
-        this->buffer_.clear();
+        this->chunks_ = std::make_shared<Chunks>();
+        this->offset_ = 0;
+        this->size_ = 0;
     }
 
     /**
@@ -129,12 +285,18 @@ public:
     {
         std::unique_lock lock(this->mutex_);
 
-        bool full = this->buffer_.full();
+        if (this->limit_ == 0)
+        {
+            return false;
+        }
+
+        bool full = this->size_ == this->limit_;
         if (full)
         {
-            deleted = this->buffer_.front();
+            deleted = this->at(0);
+            this->popFront();
         }
-        this->buffer_.push_back(item);
+        this->appendSlot(item);
         return full;
     }
 
@@ -148,11 +310,64 @@ public:
     {
         std::unique_lock lock(this->mutex_);
 
-        bool full = this->buffer_.full();
-        this->buffer_.push_back(item);
+        if (this->limit_ == 0)
+        {
+            return false;
+        }
+
+        bool full = this->size_ == this->limit_;
+        if (full)
+        {
+            this->popFront();
+        }
+        this->appendSlot(item);
         return full;
     }
 
+    /**
+     * @brief Push items to the end of the queue
+     *
+     * Equivalent to calling pushBack for each item, but only locks once.
+     *
+     * @param items the items to push
+     * @param[out] deleted the items that were deleted, appended in order
+     * @return the number of items that were deleted to make room
+     */
+    size_t pushBackItems(const std::vector<T> &items, std::vector<T> &deleted)
+    {
+        std::unique_lock lock(this->mutex_);
+
+        if (this->limit_ == 0)
+        {
+            return 0;
+        }
+
+        size_t numDeleted = 0;
+        for (const auto &item : items)
+        {
+            if (this->size_ == this->limit_)
+            {
+                deleted.push_back(this->at(0));
+                this->popFront();
+                ++numDeleted;
+            }
+            this->appendSlot(item);
+        }
+        return numDeleted;
+    }
+
+    /**
+     * @brief Push items to the end of the queue
+     *
+     * @param items the items to push
+     * @return the number of items that were deleted to make room
+     */
+    size_t pushBackItems(const std::vector<T> &items)
+    {
+        std::vector<T> deleted;
+        return this->pushBackItems(items, deleted);
+    }
+
     /**
      * @brief Push items into beginning of queue
      *
@@ -169,16 +384,40 @@ public:
 
         size_t numToPush = std::min(items.size(), this->space());
         std::vector<T> pushed;
+        if (numToPush == 0)
+        {
+            return pushed;
+        }
         pushed.reserve(numToPush);
 
+        // Make room in front of the first item by prepending fresh chunks
+        auto &chunks = this->mutableChunks();
+        if (numToPush > this->offset_)
+        {
+            auto missing = numToPush - this->offset_;
+            auto newChunks =
+                (missing + this->chunkSize_ - 1) / this->chunkSize_;
+            chunks.insert(chunks.begin(), newChunks, nullptr);
+            for (size_t i = 0; i < newChunks; ++i)
+            {
+                chunks[i] = std::make_shared<Chunk>(this->chunkSize_);
+            }
+            this->offset_ += newChunks * this->chunkSize_;
+        }
+
         size_t f = items.size() - numToPush;
-        size_t b = items.size() - 1;
-        for (; f < items.size(); ++f, --b)
+        for (; f < items.size(); ++f)
         {
-            this->buffer_.push_front(items[b]);
             pushed.push_back(items[f]);
         }
 
+        this->offset_ -= numToPush;
+        this->size_ += numToPush;
+        for (size_t i = 0; i < numToPush; ++i)
+        {
+            this->mutableSlot(this->offset_ + i) = pushed[i];
+        }
+
         return pushed;
     }
 
@@ -196,12 +435,13 @@ public:
         std::unique_lock lock(this->mutex_);
 
         Equals eq;
-        for (int i = 0; i < this->buffer_.size(); ++i)
+        for (size_t i = 0; i < this->size_; ++i)
         {
-            if (eq(this->buffer_[i], needle))
+            if (eq(this->at(i), needle))
             {
-                this->buffer_[i] = replacement;
-                return i;
+                this->mutableChunks();
+                this->mutableSlot(this->offset_ + i) = replacement;
+                return int(i);
             }
         }
         return -1;
@@ -218,12 +458,13 @@ public:
     {
         std::unique_lock lock(this->mutex_);
 
-        if (index >= this->buffer_.size())
+        if (index >= this->size_)
         {
             return false;
         }
 
-        this->buffer_[index] = replacement;
+        this->mutableChunks();
+        this->mutableSlot(this->offset_ + index) = replacement;
         return true;
     }
 
@@ -241,11 +482,11 @@ public:
         std::unique_lock lock(this->mutex_);
 
         Equals eq;
-        for (auto it = this->buffer_.begin(); it != this->buffer_.end(); ++it)
+        for (size_t i = 0; i < this->size_; ++i)
         {
-            if (eq(*it, needle))
+            if (eq(this->at(i), needle))
             {
-                this->buffer_.insert(it, item);
+                this->insertAt(i, item);
                 return true;
             }
         }
@@ -267,12 +508,11 @@ public:
         std::unique_lock lock(this->mutex_);
 
         Equals eq;
-        for (auto it = this->buffer_.begin(); it != this->buffer_.end(); ++it)
+        for (size_t i = 0; i < this->size_; ++i)
         {
-            if (eq(*it, needle))
+            if (eq(this->at(i), needle))
             {
-                ++it;  // advance to insert after it
-                this->buffer_.insert(it, item);
+                this->insertAt(i + 1, item);
                 return true;
             }
         }
@@ -283,7 +523,8 @@ public:
     [[nodiscard]] LimitedQueueSnapshot<T> getSnapshot() const
     {
         std::shared_lock lock(this->mutex_);
-        return LimitedQueueSnapshot<T>(this->buffer_);
+        return LimitedQueueSnapshot<T>(this->chunks_, this->chunkSize_,
+                                       this->offset_, this->size_);
     }
 
     // Actions
@@ -304,8 +545,9 @@ public:
     {
         std::shared_lock lock(this->mutex_);
 
-        for (const auto &item : this->buffer_)
+        for (size_t i = 0; i < this->size_; ++i)
         {
+            const auto &item = this->at(i);
             if (pred(item))
             {
                 return item;
@@ -331,11 +573,12 @@ public:
     {
         std::shared_lock lock(this->mutex_);
 
-        for (auto it = this->buffer_.rbegin(); it != this->buffer_.rend(); ++it)
+        for (size_t i = this->size_; i-- > 0;)
         {
-            if (pred(*it))
+            const auto &item = this->at(i);
+            if (pred(item))
             {
-                return *it;
+                return item;
             }
         }
 
@@ -343,10 +586,46 @@ public:
     }
 
 private:
+    /**
+     * @brief Insert an item before the item at index
+     *
+     * Mirrors boost::circular_buffer::insert: if the queue is full, the first
+     * item is dropped to make room, unless the item would be inserted at the
+     * very front, in which case nothing is inserted.
+     */
+    void insertAt(size_t index, const T &item)
+    {
+        if (this->size_ == this->limit_)
+        {
+            if (index == 0)
+            {
+                return;
+            }
+
+            this->popFront();
+            --index;
+        }
+
+        if (index == this->size_)
+        {
+            this->appendSlot(item);
+            return;
+        }
+
+        auto items = this->toVector();
+        items.insert(items.begin() + index, item);
+        this->rebuild(items);
+    }
+
     mutable std::shared_mutex mutex_;
 
     const size_t limit_;
-    boost::circular_buffer<T> buffer_;
+    const size_t chunkSize_;
+
+    std::shared_ptr<Chunks> chunks_;
+    /// Position of the first item in the first chunk
+    size_t offset_ = 0;
+    size_t size_ = 0;
 };
 
 }  // namespace chatterino
@@ -1,8 +1,8 @@
 #pragma once
 
-#include <boost/circular_buffer.hpp>
-
 #include <cassert>
+#include <cstddef>
+#include <iterator>
 #include <memory>
 #include <vector>
 
@@ -11,52 +11,213 @@ namespace chatterino {
 template <typename T>
 class LimitedQueue;
 
+namespace detail {
+
+    /// A fixed-size block of items. Slots are never reallocated, so a writer
+    /// can fill slots that no snapshot can see without disturbing readers.
+    template <typename T>
+    using LimitedQueueChunk = std::vector<T>;
+
+    template <typename T>
+    using LimitedQueueChunks =
+        std::vector<std::shared_ptr<LimitedQueueChunk<T>>>;
+
+}  // namespace detail
+
+/**
+ * @brief An immutable view of a LimitedQueue at a point in time
+ *
+ * Taking a snapshot only copies a pointer to the queue's chunk list, so it's
+ * O(1) regardless of the size of the queue. The queue copies chunks (or the
+ * chunk list) on write whenever a snapshot still references them, which keeps
+ * every snapshot stable while the queue is modified.
+ */
 template <typename T>
 class LimitedQueueSnapshot
 {
 private:
     friend class LimitedQueue<T>;
 
-    LimitedQueueSnapshot(const boost::circular_buffer<T> &buf)
-        : buffer_(buf.begin(), buf.end())
+    using Chunks = detail::LimitedQueueChunks<T>;
+
+    LimitedQueueSnapshot(std::shared_ptr<const Chunks> chunks,
+                         size_t chunkSize, size_t offset, size_t size)
+        : chunks_(std::move(chunks))
+        , chunkSize_(chunkSize)
+        , offset_(offset)
+        , size_(size)
     {
     }
 
 public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        Iterator() = default;
+
+        reference operator*() const
+        {
+            return (*this->snapshot_)[this->index_];
+        }
+
+        pointer operator->() const
+        {
+            return &**this;
+        }
+
+        reference operator[](difference_type n) const
+        {
+            return *(*this + n);
+        }
+
+        Iterator &operator++()
+        {
+            ++this->index_;
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            auto copy = *this;
+            ++this->index_;
+            return copy;
+        }
+
+        Iterator &operator--()
+        {
+            --this->index_;
+            return *this;
+        }
+
+        Iterator operator--(int)
+        {
+            auto copy = *this;
+            --this->index_;
+            return copy;
+        }
+
+        Iterator &operator+=(difference_type n)
+        {
+            this->index_ += n;
+            return *this;
+        }
+
+        Iterator &operator-=(difference_type n)
+        {
+            this->index_ -= n;
+            return *this;
+        }
+
+        friend Iterator operator+(Iterator it, difference_type n)
+        {
+            return it += n;
+        }
+
+        friend Iterator operator+(difference_type n, Iterator it)
+        {
+            return it += n;
+        }
+
+        friend Iterator operator-(Iterator it, difference_type n)
+        {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const Iterator &a, const Iterator &b)
+        {
+            return difference_type(a.index_) - difference_type(b.index_);
+        }
+
+        friend bool operator==(const Iterator &a, const Iterator &b)
+        {
+            return a.index_ == b.index_;
+        }
+
+        friend bool operator!=(const Iterator &a, const Iterator &b)
+        {
+            return a.index_ != b.index_;
+        }
+
+        friend bool operator<(const Iterator &a, const Iterator &b)
+        {
+            return a.index_ < b.index_;
+        }
+
+        friend bool operator>(const Iterator &a, const Iterator &b)
+        {
+            return a.index_ > b.index_;
+        }
+
+        friend bool operator<=(const Iterator &a, const Iterator &b)
+        {
+            return a.index_ <= b.index_;
+        }
+
+        friend bool operator>=(const Iterator &a, const Iterator &b)
+        {
+            return a.index_ >= b.index_;
+        }
+
+    private:
+        friend class LimitedQueueSnapshot<T>;
+
+        Iterator(const LimitedQueueSnapshot<T> *snapshot, size_t index)
+            : snapshot_(snapshot)
+            , index_(index)
+        {
+        }
+
+        const LimitedQueueSnapshot<T> *snapshot_{};
+        size_t index_{};
+    };
+
     LimitedQueueSnapshot() = default;
 
     size_t size() const
     {
-        return this->buffer_.size();
+        return this->size_;
     }
 
     const T &operator[](size_t index) const
     {
-        return this->buffer_[index];
+        assert(index < this->size_);
+
+        auto pos = this->offset_ + index;
+        return (*(*this->chunks_)[pos / this->chunkSize_])[pos %
+                                                           this->chunkSize_];
     }
 
-    auto begin() const
+    Iterator begin() const
     {
-        return this->buffer_.begin();
+        return Iterator(this, 0);
     }
 
-    auto end() const
+    Iterator end() const
     {
-        return this->buffer_.end();
+        return Iterator(this, this->size_);
     }
 
     auto rbegin() const
     {
-        return this->buffer_.rbegin();
+        return std::reverse_iterator<Iterator>(this->end());
     }
 
     auto rend() const
     {
-        return this->buffer_.rend();
+        return std::reverse_iterator<Iterator>(this->begin());
     }
 
 private:
-    std::vector<T> buffer_;
+    std::shared_ptr<const Chunks> chunks_;
+    size_t chunkSize_ = 1;
+    size_t offset_ = 0;
+    size_t size_ = 0;
 };
 
 }  // namespace chatterino
@@ -19,6 +19,61 @@ namespace chatterino {
 
 namespace {
 
+    // Returns the length of the longest prefix of text that fits in the
+    // current line, but at least one character
+    int longestFittingPrefix(MessageLayoutContainer &container,
+                             const QFontMetrics &metrics, const QString &text)
+    {
+        auto fits = [&](int length) {
+            return container.fitsInLine(
+                metrics.horizontalAdvance(text, length));
+        };
+
+        // Gallop to a prefix that doesn't fit, so long texts are only
+        // measured up to about twice the width of a line
+        int fitting = 0;
+        int failing = text.length() + 1;
+        for (int length = 8;; length *= 2)
+        {
+            length = std::min<int>(length, text.length());
+            if (!fits(length))
+            {
+                failing = length;
+                break;
+            }
+
+            fitting = length;
+            if (length == text.length())
+            {
+                return length;
+            }
+        }
+
+        while (failing - fitting > 1)
+        {
+            auto middle = (fitting + failing) / 2;
+            if (fits(middle))
+            {
+                fitting = middle;
+            }
+            else
+            {
+                failing = middle;
+            }
+        }
+
+        auto length = std::max(fitting, 1);
+
+        // Don't split surrogate pairs
+        if (length < text.length() && text[length].isLowSurrogate() &&
+            text[length - 1].isHighSurrogate())
+        {
+            length += length == 1 ? 1 : -1;
+        }
+
+        return length;
+    }
+
     // Computes the bounding box for the given vector of images
     QSize getBoundingBoxSize(const std::vector<ImagePtr> &images)
     {
@@ -178,8 +233,10 @@ void ImageElement::addToContainer(MessageLayoutContainer &container,
         auto size = QSize(this->image_->width() * container.getScale(),
                           this->image_->height() * container.getScale());
 
-        container.addElement((new ImageLayoutElement(*this, this->image_, size))
-                                 ->setLink(this->getLink()));
+        container.addElement(
+            container
+                .makeElement<ImageLayoutElement>(*this, this->image_, size)
+                ->setLink(this->getLink()));
     }
 }
 
@@ -208,10 +265,12 @@ void CircularImageElement::addToContainer(MessageLayoutContainer &container,
         auto imgSize = QSize(this->image_->width(), this->image_->height()) *
                        container.getScale();
 
-        container.addElement((new ImageWithCircleBackgroundLayoutElement(
-                                  *this, this->image_, imgSize,
-                                  this->background_, this->padding_))
-                                 ->setLink(this->getLink()));
+        container.addElement(
+            container
+                .makeElement<ImageWithCircleBackgroundLayoutElement>(
+                    *this, this->image_, imgSize, this->background_,
+                    this->padding_)
+                ->setLink(this->getLink()));
     }
 }
 
@@ -258,8 +317,9 @@ void EmoteElement::addToContainer(MessageLayoutContainer &container,
                 QSize(int(container.getScale() * image->width() * emoteScale),
                       int(container.getScale() * image->height() * emoteScale));
 
-            container.addElement(this->makeImageLayoutElement(image, size)
-                                     ->setLink(this->getLink()));
+            container.addElement(
+                this->makeImageLayoutElement(container, image, size)
+                    ->setLink(this->getLink()));
         }
         else
         {
@@ -273,9 +333,10 @@ void EmoteElement::addToContainer(MessageLayoutContainer &container,
 }
 
 MessageLayoutElement *EmoteElement::makeImageLayoutElement(
-    const ImagePtr &image, const QSize &size)
+    MessageLayoutContainer &container, const ImagePtr &image,
+    const QSize &size)
 {
-    return new ImageLayoutElement(*this, image, size);
+    return container.makeElement<ImageLayoutElement>(*this, image, size);
 }
 
 std::unique_ptr<MessageElement> EmoteElement::clone() const
@@ -328,9 +389,10 @@ void LayeredEmoteElement::addToContainer(MessageLayoutContainer &container,
                                           overallScale);
             }
 
-            container.addElement(this->makeImageLayoutElement(
-                                         images, individualSizes, largestSize)
-                                     ->setLink(this->getLink()));
+            container.addElement(
+                this->makeImageLayoutElement(container, images,
+                                             individualSizes, largestSize)
+                    ->setLink(this->getLink()));
         }
         else
         {
@@ -361,10 +423,11 @@ std::vector<ImagePtr> LayeredEmoteElement::getLoadedImages(float scale)
 }
 
 MessageLayoutElement *LayeredEmoteElement::makeImageLayoutElement(
-    const std::vector<ImagePtr> &images, const std::vector<QSize> &sizes,
-    QSize largestSize)
+    MessageLayoutContainer &container, const std::vector<ImagePtr> &images,
+    const std::vector<QSize> &sizes, QSize largestSize)
 {
-    return new LayeredImageLayoutElement(*this, images, sizes, largestSize);
+    return container.makeElement<LayeredImageLayoutElement>(
+        *this, images, sizes, largestSize);
 }
 
 void LayeredEmoteElement::updateTooltips()
@@ -486,7 +549,8 @@ void BadgeElement::addToContainer(MessageLayoutContainer &container,
         auto size = QSize(int(container.getScale() * image->width()),
                           int(container.getScale() * image->height()));
 
-        container.addElement(this->makeImageLayoutElement(image, size));
+        container.addElement(
+            this->makeImageLayoutElement(container, image, size));
     }
 }
 
@@ -496,10 +560,11 @@ EmotePtr BadgeElement::getEmote() const
 }
 
 MessageLayoutElement *BadgeElement::makeImageLayoutElement(
-    const ImagePtr &image, const QSize &size)
+    MessageLayoutContainer &container, const ImagePtr &image,
+    const QSize &size)
 {
-    auto element =
-        (new ImageLayoutElement(*this, image, size))->setLink(this->getLink());
+    auto element = container.makeElement<ImageLayoutElement>(*this, image, size)
+                       ->setLink(this->getLink());
 
     return element;
 }
@@ -519,12 +584,14 @@ ModBadgeElement::ModBadgeElement(const EmotePtr &data,
 }
 
 MessageLayoutElement *ModBadgeElement::makeImageLayoutElement(
-    const ImagePtr &image, const QSize &size)
+    MessageLayoutContainer &container, const ImagePtr &image,
+    const QSize &size)
 {
     static const QColor modBadgeBackgroundColor("#34AE0A");
 
-    auto element = (new ImageWithBackgroundLayoutElement(
-                        *this, image, size, modBadgeBackgroundColor))
+    auto element = container
+                       .makeElement<ImageWithBackgroundLayoutElement>(
+                           *this, image, size, modBadgeBackgroundColor)
                        ->setLink(this->getLink());
 
     return element;
@@ -545,10 +612,11 @@ VipBadgeElement::VipBadgeElement(const EmotePtr &data,
 }
 
 MessageLayoutElement *VipBadgeElement::makeImageLayoutElement(
-    const ImagePtr &image, const QSize &size)
+    MessageLayoutContainer &container, const ImagePtr &image,
+    const QSize &size)
 {
-    auto element =
-        (new ImageLayoutElement(*this, image, size))->setLink(this->getLink());
+    auto element = container.makeElement<ImageLayoutElement>(*this, image, size)
+                       ->setLink(this->getLink());
 
     return element;
 }
@@ -569,11 +637,13 @@ FfzBadgeElement::FfzBadgeElement(const EmotePtr &data,
 }
 
 MessageLayoutElement *FfzBadgeElement::makeImageLayoutElement(
-    const ImagePtr &image, const QSize &size)
+    MessageLayoutContainer &container, const ImagePtr &image,
+    const QSize &size)
 {
-    auto element =
-        (new ImageWithBackgroundLayoutElement(*this, image, size, this->color))
-            ->setLink(this->getLink());
+    auto element = container
+                       .makeElement<ImageWithBackgroundLayoutElement>(
+                           *this, image, size, this->color)
+                       ->setLink(this->getLink());
 
     return element;
 }
@@ -627,26 +697,27 @@ const std::vector<TextElement::Word> &TextElement::words() const
 void TextElement::addToContainer(MessageLayoutContainer &container,
                                  MessageElementFlags flags)
 {
-    auto app = getApp();
+    auto *fonts = getIApp()->getFonts();
+    auto *themes = getIApp()->getThemes();
 
     if (flags.hasAny(this->getFlags()))
     {
         QFontMetrics metrics =
-            app->fonts->getFontMetrics(this->style_, container.getScale());
+            fonts->getFontMetrics(this->style_, container.getScale());
 
         for (Word &word : this->words_)
         {
             auto getTextLayoutElement = [&](QString text, int width,
                                             bool hasTrailingSpace) {
-                auto color = this->color_.getColor(*app->themes);
-                app->themes->normalizeColor(color);
+                auto color = this->color_.getColor(*themes);
+                themes->normalizeColor(color);
 
-                auto e = (new TextLayoutElement(
-                              *this, text, QSize(width, metrics.height()),
-                              color, this->style_, container.getScale()))
+                auto e = container
+                             .makeElement<TextLayoutElement>(
+                                 *this, text, QSize(width, metrics.height()),
+                                 color, this->style_, container.getScale())
                              ->setLink(this->getLink());
                 e->setTrailingSpace(hasTrailingSpace);
-                e->setText(text);
 
                 // If URL link was changed,
                 // Should update it in MessageLayoutElement too!
@@ -657,10 +728,14 @@ void TextElement::addToContainer(MessageLayoutContainer &container,
                 return e;
             };
 
-            // fourtf: add again
-            //            if (word.width == -1) {
-            word.width = metrics.horizontalAdvance(word.text);
-            //            }
+            if (word.width == -1 || word.widthScale != container.getScale() ||
+                word.widthGeneration != fonts->generation())
+            {
+                word.width = fonts->getTextWidth(
+                    this->style_, container.getScale(), word.text);
+                word.widthScale = container.getScale();
+                word.widthGeneration = fonts->generation();
+            }
 
             // see if the text fits in the current line
             if (container.fitsInLine(word.width))
@@ -684,44 +759,26 @@ void TextElement::addToContainer(MessageLayoutContainer &container,
             }
 
             // we done goofed, we need to wrap the text
-            QString text = word.text;
-            int textLength = text.length();
-            int wordStart = 0;
-            int width = 0;
-
-            // QChar::isHighSurrogate(text[0].unicode()) ? 2 : 1
-
-            for (int i = 0; i < textLength; i++)
+            QString rest = word.text;
+            while (true)
             {
-                auto isSurrogate = text.size() > i + 1 &&
-                                   QChar::isHighSurrogate(text[i].unicode());
-
-                auto charWidth = isSurrogate
-                                     ? metrics.horizontalAdvance(text.mid(i, 2))
-                                     : metrics.horizontalAdvance(text[i]);
-
-                if (!container.fitsInLine(width + charWidth))
+                auto length = longestFittingPrefix(container, metrics, rest);
+                if (length == rest.length())
                 {
+                    //add the final piece of wrapped text
                     container.addElementNoLineBreak(getTextLayoutElement(
-                        text.mid(wordStart, i - wordStart), width, false));
-                    container.breakLine();
-
-                    wordStart = i;
-                    width = charWidth;
-
-                    if (isSurrogate)
-                        i++;
-                    continue;
+                        rest, metrics.horizontalAdvance(rest),
+                        this->hasTrailingSpace()));
+                    break;
                 }
 
-                width += charWidth;
+                container.addElementNoLineBreak(getTextLayoutElement(
+                    rest.left(length), metrics.horizontalAdvance(rest, length),
+                    false));
+                container.breakLine();
 
-                if (isSurrogate)
-                    i++;
+                rest = rest.mid(length);
             }
-            //add the final piece of wrapped text
-            container.addElementNoLineBreak(getTextLayoutElement(
-                text.mid(wordStart), width, this->hasTrailingSpace()));
         }
     }
 }
@@ -764,12 +821,12 @@ void SingleLineTextElement::addToContainer(MessageLayoutContainer &container,
             auto color = this->color_.getColor(*app->themes);
             app->themes->normalizeColor(color);
 
-            auto e = (new TextLayoutElement(
-                          *this, text, QSize(width, metrics.height()), color,
-                          this->style_, container.getScale()))
+            auto e = container
+                         .makeElement<TextLayoutElement>(
+                             *this, text, QSize(width, metrics.height()), color,
+                             this->style_, container.getScale())
                          ->setLink(this->getLink());
             e->setTrailingSpace(hasTrailingSpace);
-            e->setText(text);
 
             // If URL link was changed,
             // Should update it in MessageLayoutElement too!
@@ -862,7 +919,9 @@ void SingleLineTextElement::addToContainer(MessageLayoutContainer &container,
                     currentText.clear();
 
                     container.addElementNoLineBreak(
-                        (new ImageLayoutElement(*this, image, emoteSize))
+                        container
+                            .makeElement<ImageLayoutElement>(*this, image,
+                                                             emoteSize)
                             ->setLink(this->getLink()));
                 }
             }
@@ -952,15 +1011,18 @@ void TwitchModerationElement::addToContainer(MessageLayoutContainer &container,
             if (auto image = action.getImage())
             {
                 container.addElement(
-                    (new ImageLayoutElement(*this, image.get(), size))
+                    container
+                        .makeElement<ImageLayoutElement>(*this, image.get(),
+                                                         size)
                         ->setLink(Link(Link::UserAction, action.getAction())));
             }
             else
             {
                 container.addElement(
-                    (new TextIconLayoutElement(*this, action.getLine1(),
-                                               action.getLine2(),
-                                               container.getScale(), size))
+                    container
+                        .makeElement<TextIconLayoutElement>(
+                            *this, action.getLine1(), action.getLine2(),
+                            container.getScale(), size)
                         ->setLink(Link(Link::UserAction, action.getAction())));
             }
         }
@@ -976,7 +1038,7 @@ void TwitchModerationElement::addToContainer(MessageLayoutContainer &container,
         auto image = action.getImage();
 
         container.addElement(
-            (new ImageLayoutElement(*this, image.get(), size))
+            container.makeElement<ImageLayoutElement>(*this, image.get(), size)
                 ->setLink(Link(Link::UserAction, action.getAction())));
     }
 }
@@ -1029,8 +1091,9 @@ void ScalingImageElement::addToContainer(MessageLayoutContainer &container,
         auto size = QSize(image->width() * container.getScale(),
                           image->height() * container.getScale());
 
-        container.addElement((new ImageLayoutElement(*this, image, size))
-                                 ->setLink(this->getLink()));
+        container.addElement(
+            container.makeElement<ImageLayoutElement>(*this, image, size)
+                ->setLink(this->getLink()));
     }
 }
 
@@ -1058,9 +1121,9 @@ void ReplyCurveElement::addToContainer(MessageLayoutContainer &container,
     if (flags.hasAny(this->getFlags()))
     {
         float scale = container.getScale();
-        container.addElement(
-            new ReplyCurveLayoutElement(*this, width * scale, thickness * scale,
-                                        radius * scale, margin * scale));
+        container.addElement(container.makeElement<ReplyCurveLayoutElement>(
+            *this, width * scale, thickness * scale, radius * scale,
+            margin * scale));
     }
 }
 
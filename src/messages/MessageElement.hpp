@@ -283,6 +283,9 @@ public:
     struct Word {
         QString text;
         int width = -1;
+        // Font the width was measured with, see Fonts::generation
+        float widthScale = 0;
+        uint64_t widthGeneration = 0;
     };
 
     TextElement(const QString &text, MessageElementFlags flags,
@@ -351,8 +354,9 @@ public:
     std::unique_ptr<MessageElement> clone() const override;
 
 protected:
-    virtual MessageLayoutElement *makeImageLayoutElement(const ImagePtr &image,
-                                                         const QSize &size);
+    virtual MessageLayoutElement *makeImageLayoutElement(
+        MessageLayoutContainer &container, const ImagePtr &image,
+        const QSize &size);
 
 private:
     std::unique_ptr<TextElement> textElement_;
@@ -390,8 +394,8 @@ public:
 
 private:
     MessageLayoutElement *makeImageLayoutElement(
-        const std::vector<ImagePtr> &image, const std::vector<QSize> &sizes,
-        QSize largestSize);
+        MessageLayoutContainer &container, const std::vector<ImagePtr> &image,
+        const std::vector<QSize> &sizes, QSize largestSize);
 
     QString getCopyString() const;
     void updateTooltips();
@@ -417,8 +421,9 @@ public:
     std::unique_ptr<MessageElement> clone() const override;
 
 protected:
-    virtual MessageLayoutElement *makeImageLayoutElement(const ImagePtr &image,
-                                                         const QSize &size);
+    virtual MessageLayoutElement *makeImageLayoutElement(
+        MessageLayoutContainer &container, const ImagePtr &image,
+        const QSize &size);
     EmotePtr emote_;
 };
 
@@ -430,8 +435,9 @@ public:
     std::unique_ptr<MessageElement> clone() const override;
 
 protected:
-    MessageLayoutElement *makeImageLayoutElement(const ImagePtr &image,
-                                                 const QSize &size) override;
+    MessageLayoutElement *makeImageLayoutElement(
+        MessageLayoutContainer &container, const ImagePtr &image,
+        const QSize &size) override;
 };
 
 class VipBadgeElement : public BadgeElement
@@ -442,8 +448,9 @@ public:
     std::unique_ptr<MessageElement> clone() const override;
 
 protected:
-    MessageLayoutElement *makeImageLayoutElement(const ImagePtr &image,
-                                                 const QSize &size) override;
+    MessageLayoutElement *makeImageLayoutElement(
+        MessageLayoutContainer &container, const ImagePtr &image,
+        const QSize &size) override;
 };
 
 class FfzBadgeElement : public BadgeElement
@@ -455,8 +462,9 @@ public:
     std::unique_ptr<MessageElement> clone() const override;
 
 protected:
-    MessageLayoutElement *makeImageLayoutElement(const ImagePtr &image,
-                                                 const QSize &size) override;
+    MessageLayoutElement *makeImageLayoutElement(
+        MessageLayoutContainer &container, const ImagePtr &image,
+        const QSize &size) override;
     const QColor color;
 };
 
@@ -146,6 +146,12 @@ void SharedMessageBuilder::parseUsername()
 }
 
 void SharedMessageBuilder::parseHighlights()
+{
+    this->checkHighlights(*getIApp()->getHighlights());
+}
+
+void SharedMessageBuilder::checkHighlights(
+    const HighlightController &highlights)
 {
     if (getCSettings().isBlacklistedUser(this->ircMessage->nick()))
     {
@@ -154,7 +160,7 @@ void SharedMessageBuilder::parseHighlights()
     }
 
     auto badges = SharedMessageBuilder::parseBadgeTag(this->tags);
-    auto [highlighted, highlightResult] = getIApp()->getHighlights()->check(
+    auto [highlighted, highlightResult] = highlights.check(
         this->args, badges, this->ircMessage->nick(), this->originalMessage_,
         this->message().flags, this->channel->getName());
 
@@ -229,8 +235,6 @@ void SharedMessageBuilder::triggerHighlights()
 QString SharedMessageBuilder::stylizeUsername(const QString &username,
                                               const Message &message)
 {
-    auto app = getApp();
-
     const QString &localizedName = message.localizedName;
     bool hasLocalizedName = !localizedName.isEmpty();
 
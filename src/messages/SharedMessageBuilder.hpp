@@ -12,6 +12,7 @@ namespace chatterino {
 
 class Badge;
 class Channel;
+class HighlightController;
 
 class SharedMessageBuilder : public MessageBuilder
 {
@@ -57,6 +58,8 @@ protected:
 
     // parseHighlights only updates the visual state of the message, but leaves the playing of alerts and sounds to the triggerHighlights function
     virtual void parseHighlights();
+    // checkHighlights is parseHighlights with the given highlight controller
+    void checkHighlights(const HighlightController &highlights);
 
     void appendChannelName();
 
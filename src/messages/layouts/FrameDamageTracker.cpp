@@ -0,0 +1,69 @@
+#include "messages/layouts/FrameDamageTracker.hpp"
+
+#include <algorithm>
+
+namespace chatterino {
+
+void FrameDamageTracker::add(const QRect &rect, long unsigned deadline)
+{
+    if (rect.isEmpty())
+    {
+        return;
+    }
+
+    this->entries_.push_back({rect, deadline});
+    this->nextDeadline_ = std::min(this->nextDeadline_, deadline);
+}
+
+void FrameDamageTracker::clear()
+{
+    this->entries_.clear();
+    this->nextDeadline_ = ULONG_MAX;
+}
+
+bool FrameDamageTracker::empty() const
+{
+    return this->entries_.empty();
+}
+
+size_t FrameDamageTracker::size() const
+{
+    return this->entries_.size();
+}
+
+long unsigned FrameDamageTracker::nextDeadline() const
+{
+    return this->nextDeadline_;
+}
+
+QRegion FrameDamageTracker::takeDue(long unsigned position)
+{
+    QRegion damage;
+
+    // Most ticks don't change any frame
+    if (position < this->nextDeadline_)
+    {
+        return damage;
+    }
+
+    this->nextDeadline_ = ULONG_MAX;
+
+    size_t kept = 0;
+    for (auto &entry : this->entries_)
+    {
+        if (entry.deadline <= position)
+        {
+            damage += entry.rect;
+        }
+        else
+        {
+            this->nextDeadline_ = std::min(this->nextDeadline_, entry.deadline);
+            this->entries_[kept++] = entry;
+        }
+    }
+    this->entries_.resize(kept);
+
+    return damage;
+}
+
+}  // namespace chatterino
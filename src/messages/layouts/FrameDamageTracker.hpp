@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QRect>
+#include <QRegion>
+
+#include <climits>
+#include <cstddef>
+#include <vector>
+
+namespace chatterino {
+
+/**
+ * @brief Remembers where animated elements were painted and when they change
+ *
+ * A ChannelView fills this while painting. On every tick of the GIF timer it
+ * takes the areas of the elements whose frame changed and repaints only
+ * those, instead of the whole view.
+ *
+ * Deadlines are positions of the GIF timer, see Image::nextFrameDeadline.
+ */
+class FrameDamageTracker
+{
+public:
+    /// Adds an element painted at rect that shows its next frame at deadline
+    void add(const QRect &rect, long unsigned deadline);
+    void clear();
+
+    [[nodiscard]] bool empty() const;
+    [[nodiscard]] size_t size() const;
+
+    /// Earliest deadline of all elements, ULONG_MAX if there are none
+    [[nodiscard]] long unsigned nextDeadline() const;
+
+    /**
+     * @brief Removes the elements that are due at position
+     *
+     * @return the area covered by the removed elements. They're added again
+     *         once that area is painted.
+     */
+    QRegion takeDue(long unsigned position);
+
+private:
+    struct Entry {
+        QRect rect;
+        long unsigned deadline;
+    };
+
+    std::vector<Entry> entries_;
+    long unsigned nextDeadline_ = ULONG_MAX;
+};
+
+}  // namespace chatterino
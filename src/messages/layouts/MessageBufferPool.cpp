@@ -0,0 +1,192 @@
+#include "messages/layouts/MessageBufferPool.hpp"
+
+#include "debug/AssertInGuiThread.hpp"
+#include "singletons/Settings.hpp"
+#include "util/DebugCount.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+// Buffers are made in steps of this many pixels, so that messages of
+// similar heights in splits of similar widths can share them
+constexpr int WIDTH_STEP = 64;
+constexpr int HEIGHT_STEP = 32;
+
+// The buffers are 32-bit ARGB
+constexpr size_t BYTES_PER_PIXEL = 4;
+
+int roundUp(int value, int step)
+{
+    return (std::max(value, 0) + step - 1) / step * step;
+}
+
+}  // namespace
+
+namespace chatterino {
+
+MessageBufferPool::MessageBufferPool(size_t budget,
+                                     std::chrono::milliseconds offScreenAfter,
+                                     Factory factory)
+    : budget_(budget)
+    , offScreenAfter_(offScreenAfter)
+    , factory_(std::move(factory))
+{
+    if (!this->factory_)
+    {
+        this->factory_ = [](QSize size) {
+            return std::make_shared<QPixmap>(size);
+        };
+    }
+}
+
+MessageBufferPool &MessageBufferPool::instance()
+{
+    // Never destroyed, layouts can release their buffers until the very end
+    static auto *instance = [] {
+        auto *pool = new MessageBufferPool(0);
+        getSettings()->messageBufferBudget.connect(
+            [pool](const auto &megabytes) {
+                pool->setBudget(size_t(std::max(megabytes, 0)) * 1024 * 1024);
+            });
+        return pool;
+    }();
+    return *instance;
+}
+
+std::shared_ptr<QPixmap> MessageBufferPool::acquire(QSize size,
+                                                    qreal devicePixelRatio)
+{
+    assertInGuiThread();
+
+    size = MessageBufferPool::sizeClass(size);
+    DebugCount::increase("message drawing buffers");
+
+    auto released = this->released_.find({size.width(), size.height()});
+    if (released != this->released_.end() && !released->second.empty())
+    {
+        auto entry = this->index_.at(released->second.back());
+        released->second.pop_back();
+
+        entry->inUse = true;
+        entry->lastUsed = Clock::now();
+        entry->buffer->setDevicePixelRatio(devicePixelRatio);
+        this->entries_.splice(this->entries_.begin(), this->entries_, entry);
+        return entry->buffer;
+    }
+
+    auto buffer = this->factory_(size);
+    buffer->setDevicePixelRatio(devicePixelRatio);
+
+    auto bytes =
+        size_t(size.width()) * size_t(size.height()) * BYTES_PER_PIXEL;
+    this->entries_.push_front({buffer, size, bytes, true, Clock::now()});
+    this->index_.emplace(buffer.get(), this->entries_.begin());
+    this->bytes_ += bytes;
+    DebugCount::increase("message drawing buffer bytes", int64_t(bytes));
+
+    this->evict(1);
+
+    return buffer;
+}
+
+void MessageBufferPool::touch(const QPixmap *buffer)
+{
+    auto it = this->index_.find(buffer);
+    if (it == this->index_.end() || !it->second->inUse)
+    {
+        return;
+    }
+
+    it->second->lastUsed = Clock::now();
+    this->entries_.splice(this->entries_.begin(), this->entries_, it->second);
+}
+
+void MessageBufferPool::release(const QPixmap *buffer)
+{
+    assertInGuiThread();
+
+    auto it = this->index_.find(buffer);
+    if (it == this->index_.end() || !it->second->inUse)
+    {
+        return;
+    }
+
+    auto entry = it->second;
+    entry->inUse = false;
+    this->entries_.splice(this->entries_.end(), this->entries_, entry);
+    this->released_[{entry->size.width(), entry->size.height()}].push_back(
+        buffer);
+    DebugCount::decrease("message drawing buffers");
+}
+
+void MessageBufferPool::setBudget(size_t bytes)
+{
+    this->budget_ = bytes;
+    this->evict(0);
+}
+
+size_t MessageBufferPool::budget() const
+{
+    return this->budget_;
+}
+
+size_t MessageBufferPool::bytes() const
+{
+    return this->bytes_;
+}
+
+size_t MessageBufferPool::size() const
+{
+    return this->entries_.size();
+}
+
+QSize MessageBufferPool::sizeClass(QSize size)
+{
+    return {roundUp(size.width(), WIDTH_STEP),
+            roundUp(size.height(), HEIGHT_STEP)};
+}
+
+void MessageBufferPool::evict(size_t keep)
+{
+    // Released buffers are at the back, followed by the buffers in use from
+    // the least to the most recently used one
+    auto now = Clock::now();
+    while (this->bytes_ > this->budget_ && this->entries_.size() > keep)
+    {
+        auto last = std::prev(this->entries_.end());
+        if (last->inUse && now - last->lastUsed < this->offScreenAfter_)
+        {
+            // Everything that's left is on screen
+            break;
+        }
+
+        this->erase(last);
+    }
+}
+
+void MessageBufferPool::erase(Entries::iterator entry)
+{
+    const auto *buffer = entry->buffer.get();
+
+    if (entry->inUse)
+    {
+        // The layout notices that its buffer is gone on its next paint
+        DebugCount::decrease("message drawing buffers");
+    }
+    else
+    {
+        auto &released =
+            this->released_[{entry->size.width(), entry->size.height()}];
+        released.erase(std::find(released.begin(), released.end(), buffer));
+    }
+
+    this->bytes_ -= entry->bytes;
+    DebugCount::decrease("message drawing buffer bytes", int64_t(entry->bytes));
+
+    this->index_.erase(buffer);
+    this->entries_.erase(entry);
+}
+
+}  // namespace chatterino
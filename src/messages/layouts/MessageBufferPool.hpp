@@ -0,0 +1,109 @@
+#pragma once
+
+#include <boost/noncopyable.hpp>
+#include <QPixmap>
+#include <QSize>
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace chatterino {
+
+/**
+ * @brief Holds the drawing buffers of the message layouts of all views
+ *
+ * The buffers are owned by the pool, layouts only keep a weak reference
+ * between paints. Views release the buffers of messages that leave the
+ * screen. Once the buffers take up more than the budget, the released ones
+ * are dropped first, then the buffers that are in use but weren't painted
+ * for a while. Buffers that were painted recently are on screen, they're
+ * kept even if that exceeds the budget, otherwise every paint would drop and
+ * redraw them. Released buffers are reused for buffers of the same size
+ * class.
+ */
+class MessageBufferPool : boost::noncopyable
+{
+public:
+    /// Makes an empty buffer of size pixels
+    using Factory = std::function<std::shared_ptr<QPixmap>(QSize size)>;
+
+    /**
+     * @param budget Bytes the buffers may take up
+     * @param offScreenAfter Buffers in use that weren't painted for this
+     *                       long are assumed to be off screen
+     * @param factory Makes the buffers, QPixmaps by default
+     */
+    explicit MessageBufferPool(
+        size_t budget,
+        std::chrono::milliseconds offScreenAfter = std::chrono::seconds(10),
+        Factory factory = {});
+
+    /// The pool shared by all views, its budget is the messageBufferBudget
+    /// setting
+    static MessageBufferPool &instance();
+
+    /**
+     * @brief Returns a buffer of at least size pixels
+     *
+     * The buffer is the most recently used one afterwards. Its contents are
+     * undefined if it was released before.
+     */
+    std::shared_ptr<QPixmap> acquire(QSize size, qreal devicePixelRatio);
+
+    /// Marks buffer as the most recently used one, it was just painted
+    void touch(const QPixmap *buffer);
+
+    /// Gives buffer back to the pool, it's reused for the next buffer of its
+    /// size class or dropped first
+    void release(const QPixmap *buffer);
+
+    /// Drops buffers that aren't on screen until they fit into bytes
+    void setBudget(size_t bytes);
+    size_t budget() const;
+
+    /// Bytes held by all buffers, including the released ones
+    size_t bytes() const;
+    /// Number of buffers, including the released ones
+    size_t size() const;
+
+    /// Size of the buffers that are made for size
+    static QSize sizeClass(QSize size);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        std::shared_ptr<QPixmap> buffer;
+        // Size class of the buffer
+        QSize size;
+        size_t bytes;
+        bool inUse;
+        Clock::time_point lastUsed;
+    };
+    using Entries = std::list<Entry>;
+
+    /// Drops released buffers, then the least recently used ones that
+    /// weren't painted for a while, until the pool is within its budget. The
+    /// first keep buffers are always kept.
+    void evict(size_t keep);
+    void erase(Entries::iterator entry);
+
+    size_t budget_;
+    Clock::duration offScreenAfter_;
+    Factory factory_;
+    size_t bytes_ = 0;
+    // Most recently used buffers first, released ones are moved to the back
+    Entries entries_;
+    std::unordered_map<const QPixmap *, Entries::iterator> index_;
+    // Released buffers by their width and height
+    std::map<std::pair<int, int>, std::vector<const QPixmap *>> released_;
+};
+
+}  // namespace chatterino
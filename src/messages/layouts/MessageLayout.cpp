@@ -2,6 +2,8 @@
 
 #include "Application.hpp"
 #include "debug/Benchmark.hpp"
+#include "messages/layouts/MessageBufferPool.hpp"
+#include "messages/layouts/MessageLayoutCache.hpp"
 #include "messages/layouts/MessageLayoutContainer.hpp"
 #include "messages/layouts/MessageLayoutElement.hpp"
 #include "messages/Message.hpp"
@@ -40,16 +42,28 @@ namespace {
                        base.blueF() * (1 - alpha) + apply.blueF() * alpha);
         return result;
     }
+
+    /// Used until the message is laid out for the first time
+    const std::shared_ptr<const MessageLayoutContainer> &emptyContainer()
+    {
+        static const auto container =
+            std::make_shared<const MessageLayoutContainer>();
+        return container;
+    }
 }  // namespace
 
 MessageLayout::MessageLayout(MessagePtr message)
     : message_(std::move(message))
+    , container_(emptyContainer())
 {
     DebugCount::increase("message layout");
 }
 
 MessageLayout::~MessageLayout()
 {
+    // The pool owns the buffer, it would stay in use otherwise
+    this->deleteBuffer();
+
     DebugCount::decrease("message layout");
 }
 
@@ -66,12 +80,17 @@ const MessagePtr &MessageLayout::getMessagePtr() const
 // Height
 int MessageLayout::getHeight() const
 {
-    return this->container_.getHeight();
+    return this->height_;
 }
 
 int MessageLayout::getWidth() const
 {
-    return this->container_.getWidth();
+    return this->container_->getWidth();
+}
+
+const MessageLayoutContainer *MessageLayout::getContainer() const
+{
+    return this->container_.get();
 }
 
 // Layout
@@ -80,7 +99,7 @@ bool MessageLayout::layout(int width, float scale, MessageElementFlags flags)
 {
     //    BenchmarkGuard benchmark("MessageLayout::layout()");
 
-    auto app = getApp();
+    auto *windows = getIApp()->getWindows();
 
     bool layoutRequired = false;
 
@@ -90,11 +109,11 @@ bool MessageLayout::layout(int width, float scale, MessageElementFlags flags)
     this->currentLayoutWidth_ = width;
 
     // check if layout state changed
-    if (this->layoutState_ != app->windows->getGeneration())
+    if (this->layoutState_ != windows->getGeneration())
     {
         layoutRequired = true;
         this->flags.set(MessageLayoutFlag::RequiresBufferUpdate);
-        this->layoutState_ = app->windows->getGeneration();
+        this->layoutState_ = windows->getGeneration();
     }
 
     // check if work mask changed
@@ -114,9 +133,9 @@ bool MessageLayout::layout(int width, float scale, MessageElementFlags flags)
         return false;
     }
 
-    int oldHeight = this->container_.getHeight();
+    int oldHeight = this->container_->getHeight();
     this->actuallyLayout(width, flags);
-    if (widthChanged || this->container_.getHeight() != oldHeight)
+    if (widthChanged || this->container_->getHeight() != oldHeight)
     {
         this->deleteBuffer();
     }
@@ -140,88 +159,116 @@ void MessageLayout::actuallyLayout(int width, MessageElementFlags flags)
         messageFlags.unset(MessageFlag::Collapsed);
     }
 
-    bool hideModerated = getSettings()->hideModerated;
-    bool hideModerationActions = getSettings()->hideModerationActions;
-    bool hideSimilar = getSettings()->hideSimilar;
-    bool hideReplies = !flags.has(MessageElementFlag::RepliedMessage);
+    bool hidden = this->isHidden();
 
-    this->container_.begin(width, this->scale_, messageFlags);
+    MessageLayoutKey key{
+        this->message_.get(), width, this->scale_, flags, messageFlags,
+        hidden, this->layoutState_,
+    };
+    auto &cache = MessageLayoutCache::instance();
+    auto container = cache.get(key);
+    if (container == nullptr)
+    {
+        auto fresh = std::make_shared<MessageLayoutContainer>();
+        this->addElements(*fresh, width, flags, messageFlags, hidden);
+        cache.put(key, this->message_, fresh);
+        container = std::move(fresh);
+    }
+    this->container_ = std::move(container);
 
-    for (const auto &element : this->message_->elements)
+    if (this->height_ != this->container_->getHeight())
     {
-        if (hideModerated && this->message_->flags.has(MessageFlag::Disabled))
-        {
-            continue;
-        }
+        this->deleteBuffer();
+    }
+    this->height_ = this->container_->getHeight();
 
-        if (this->message_->flags.has(MessageFlag::Timeout) ||
-            this->message_->flags.has(MessageFlag::Untimeout))
-        {
-            // This condition has been set up to execute isInStreamerMode() as the last thing
-            // as it could end up being expensive.
-            if (hideModerationActions ||
-                (getSettings()->streamerModeHideModActions &&
-                 isInStreamerMode()))
-            {
-                continue;
-            }
-        }
+    // collapsed state
+    this->flags.unset(MessageLayoutFlag::Collapsed);
+    if (this->container_->isCollapsed())
+    {
+        this->flags.set(MessageLayoutFlag::Collapsed);
+    }
+}
 
-        if (hideSimilar && this->message_->flags.has(MessageFlag::Similar))
+bool MessageLayout::isHidden() const
+{
+    const auto &messageFlags = this->message_->flags;
+
+    if (getSettings()->hideModerated && messageFlags.has(MessageFlag::Disabled))
+    {
+        return true;
+    }
+
+    if (messageFlags.has(MessageFlag::Timeout) ||
+        messageFlags.has(MessageFlag::Untimeout))
+    {
+        // This condition has been set up to execute isInStreamerMode() as the last thing
+        // as it could end up being expensive.
+        if (getSettings()->hideModerationActions ||
+            (getSettings()->streamerModeHideModActions && isInStreamerMode()))
         {
-            continue;
+            return true;
         }
+    }
+
+    return getSettings()->hideSimilar && messageFlags.has(MessageFlag::Similar);
+}
+
+void MessageLayout::addElements(MessageLayoutContainer &container, int width,
+                                MessageElementFlags flags,
+                                MessageFlags messageFlags, bool hidden) const
+{
+    bool hideReplies = !flags.has(MessageElementFlag::RepliedMessage);
+
+    container.begin(width, this->scale_, messageFlags);
+    if (hidden)
+    {
+        container.end();
+        return;
+    }
+    container.reserve(this->message_->elements.size());
 
+    for (const auto &element : this->message_->elements)
+    {
         if (hideReplies &&
             element->getFlags().has(MessageElementFlag::RepliedMessage))
         {
             continue;
         }
 
-        element->addToContainer(this->container_, flags);
+        element->addToContainer(container, flags);
     }
 
-    if (this->height_ != this->container_.getHeight())
-    {
-        this->deleteBuffer();
-    }
-
-    this->container_.end();
-    this->height_ = this->container_.getHeight();
-
-    // collapsed state
-    this->flags.unset(MessageLayoutFlag::Collapsed);
-    if (this->container_.isCollapsed())
-    {
-        this->flags.set(MessageLayoutFlag::Collapsed);
-    }
+    container.end();
 }
 
 // Painting
 void MessageLayout::paint(QPainter &painter, int width, int y, int messageIndex,
                           Selection &selection, bool isLastReadMessage,
-                          bool isWindowFocused, bool isMentions)
+                          bool isWindowFocused, bool isMentions,
+                          FrameDamageTracker *damage)
 {
     auto app = getApp();
-    QPixmap *pixmap = this->ensureBuffer(painter, width);
+    auto pixmap = this->ensureBuffer(painter, width);
 
     if (!this->bufferValid_ || !selection.isEmpty())
     {
-        this->updateBuffer(pixmap, messageIndex, selection);
+        this->updateBuffer(pixmap.get(), messageIndex, selection);
     }
 
-    // draw on buffer
-    painter.drawPixmap(0, y, *pixmap);
+    // draw on buffer, pooled buffers can be larger than the message
+    painter.drawPixmap(QPoint(0, y), *pixmap,
+                       QRect(QPoint(0, 0), this->bufferSize_));
     //    painter.drawPixmap(0, y, this->container.width,
     //    this->container.getHeight(), *pixmap);
 
     // draw gif emotes
-    this->container_.paintAnimatedElements(painter, y);
+    this->container_->paintAnimatedElements(painter, y, damage);
 
     // draw disabled
     if (this->message_->flags.has(MessageFlag::Disabled))
     {
-        painter.fillRect(0, y, pixmap->width(), pixmap->height(),
+        painter.fillRect(QRect(QPoint(0, y), this->bufferSize_),
                          app->themes->messages.disabled);
         //        painter.fillRect(0, y, pixmap->width(), pixmap->height(),
         //                         QBrush(QColor(64, 64, 64, 64)));
@@ -230,7 +277,7 @@ void MessageLayout::paint(QPainter &painter, int width, int y, int messageIndex,
     if (this->message_->flags.has(MessageFlag::RecentMessage) &&
         getSettings()->grayOutRecents)
     {
-        painter.fillRect(0, y, pixmap->width(), pixmap->height(),
+        painter.fillRect(QRect(QPoint(0, y), this->bufferSize_),
                          app->themes->messages.disabled);
     }
 
@@ -240,20 +287,20 @@ void MessageLayout::paint(QPainter &painter, int width, int y, int messageIndex,
         getSettings()->enableRedeemedHighlight.getValue())
     {
         painter.fillRect(
-            0, y, this->scale_ * 4, pixmap->height(),
+            0, y, this->scale_ * 4, this->bufferSize_.height(),
             *ColorProvider::instance().color(ColorType::RedeemedHighlight));
     }
 
     // draw selection
     if (!selection.isEmpty())
     {
-        this->container_.paintSelection(painter, messageIndex, selection, y);
+        this->container_->paintSelection(painter, messageIndex, selection, y);
     }
 
     // draw message seperation line
     if (getSettings()->separateMessages.getValue())
     {
-        painter.fillRect(0, y, this->container_.getWidth() + 64, 1,
+        painter.fillRect(0, y, this->container_->getWidth() + 64, 1,
                          app->themes->splits.messageSeperator);
     }
 
@@ -275,35 +322,39 @@ void MessageLayout::paint(QPainter &painter, int width, int y, int messageIndex,
         QBrush brush(color, static_cast<Qt::BrushStyle>(
                                 getSettings()->lastMessagePattern.getValue()));
 
-        painter.fillRect(0, y + this->container_.getHeight() - 1,
-                         pixmap->width(), 1, brush);
+        painter.fillRect(0, y + this->container_->getHeight() - 1,
+                         this->bufferSize_.width(), 1, brush);
     }
 
     this->bufferValid_ = true;
 }
 
-QPixmap *MessageLayout::ensureBuffer(QPainter &painter, int width)
+std::shared_ptr<QPixmap> MessageLayout::ensureBuffer(QPainter &painter,
+                                                     int width)
 {
-    if (this->buffer_ != nullptr)
+    auto &pool = MessageBufferPool::instance();
+
+    if (auto buffer = this->buffer_.lock())
     {
-        return this->buffer_.get();
+        pool.touch(buffer.get());
+        return buffer;
     }
 
     // Create new buffer
 #if defined(Q_OS_MACOS) || defined(Q_OS_LINUX)
-    this->buffer_ = std::make_unique<QPixmap>(
-        int(width * painter.device()->devicePixelRatioF()),
-        int(this->container_.getHeight() *
-            painter.device()->devicePixelRatioF()));
-    this->buffer_->setDevicePixelRatio(painter.device()->devicePixelRatioF());
+    auto ratio = painter.device()->devicePixelRatioF();
+    this->bufferSize_ = QSize(int(width * ratio),
+                              int(this->container_->getHeight() * ratio));
 #else
-    this->buffer_ = std::make_unique<QPixmap>(
-        width, std::max(16, this->container_.getHeight()));
+    qreal ratio = 1;
+    this->bufferSize_ =
+        QSize(width, std::max(16, this->container_->getHeight()));
 #endif
 
+    auto buffer = pool.acquire(this->bufferSize_, ratio);
+    this->buffer_ = buffer;
     this->bufferValid_ = false;
-    DebugCount::increase("message drawing buffers");
-    return this->buffer_.get();
+    return buffer;
 }
 
 void MessageLayout::updateBuffer(QPixmap *buffer, int /*messageIndex*/,
@@ -384,7 +435,7 @@ void MessageLayout::updateBuffer(QPixmap *buffer, int /*messageIndex*/,
     painter.fillRect(buffer->rect(), backgroundColor);
 
     // draw message
-    this->container_.paintElements(painter);
+    this->container_->paintElements(painter);
 
 #ifdef FOURTF
     // debug
@@ -395,7 +446,7 @@ void MessageLayout::updateBuffer(QPixmap *buffer, int /*messageIndex*/,
     QTextOption option;
     option.setAlignment(Qt::AlignRight | Qt::AlignTop);
 
-    painter.drawText(QRectF(1, 1, this->container_.getWidth() - 3, 1000),
+    painter.drawText(QRectF(1, 1, this->container_->getWidth() - 3, 1000),
                      QString::number(this->layoutCount_) + ", " +
                          QString::number(++this->bufferUpdatedCount_),
                      option);
@@ -409,12 +460,11 @@ void MessageLayout::invalidateBuffer()
 
 void MessageLayout::deleteBuffer()
 {
-    if (this->buffer_ != nullptr)
+    if (auto buffer = this->buffer_.lock())
     {
-        DebugCount::decrease("message drawing buffers");
-
-        this->buffer_ = nullptr;
+        MessageBufferPool::instance().release(buffer.get());
     }
+    this->buffer_.reset();
 }
 
 void MessageLayout::deleteCache()
@@ -422,7 +472,7 @@ void MessageLayout::deleteCache()
     this->deleteBuffer();
 
 #ifdef XD
-    this->container_.clear();
+    this->container_ = emptyContainer();
 #endif
 }
 
@@ -435,28 +485,28 @@ void MessageLayout::deleteCache()
 const MessageLayoutElement *MessageLayout::getElementAt(QPoint point)
 {
     // go through all words and return the first one that contains the point.
-    return this->container_.getElementAt(point);
+    return this->container_->getElementAt(point);
 }
 
 int MessageLayout::getLastCharacterIndex() const
 {
-    return this->container_.getLastCharacterIndex();
+    return this->container_->getLastCharacterIndex();
 }
 
 int MessageLayout::getFirstMessageCharacterIndex() const
 {
-    return this->container_.getFirstMessageCharacterIndex();
+    return this->container_->getFirstMessageCharacterIndex();
 }
 
 int MessageLayout::getSelectionIndex(QPoint position)
 {
-    return this->container_.getSelectionIndex(position);
+    return this->container_->getSelectionIndex(position);
 }
 
 void MessageLayout::addSelectionText(QString &str, uint32_t from, uint32_t to,
                                      CopyMode copymode)
 {
-    this->container_.addSelectionText(str, from, to, copymode);
+    this->container_->addSelectionText(str, from, to, copymode);
 }
 
 bool MessageLayout::isReplyable() const
@@ -17,6 +17,7 @@ using MessagePtr = std::shared_ptr<const Message>;
 
 struct Selection;
 struct MessageLayoutContainer;
+class FrameDamageTracker;
 class MessageLayoutElement;
 
 enum class MessageElementFlag : int64_t;
@@ -43,15 +44,19 @@ public:
 
     int getHeight() const;
     int getWidth() const;
+    /// The laid out elements, shared with other views of the message
+    const MessageLayoutContainer *getContainer() const;
 
     MessageLayoutFlags flags;
 
     bool layout(int width, float scale_, MessageElementFlags flags);
 
     // Painting
+    // The animated elements are added to damage if it's set
     void paint(QPainter &painter, int width, int y, int messageIndex,
                Selection &selection, bool isLastReadMessage,
-               bool isWindowFocused, bool isMentions);
+               bool isWindowFocused, bool isMentions,
+               FrameDamageTracker *damage = nullptr);
     void invalidateBuffer();
     void deleteBuffer();
     void deleteCache();
@@ -72,15 +77,26 @@ public:
 private:
     // methods
     void actuallyLayout(int width, MessageElementFlags flags);
+    /// Whether the settings hide the message, e.g. hideSimilar for a similar
+    /// message. Its container stays empty then.
+    bool isHidden() const;
+    void addElements(MessageLayoutContainer &container, int width,
+                     MessageElementFlags flags, MessageFlags messageFlags,
+                     bool hidden) const;
     void updateBuffer(QPixmap *pixmap, int messageIndex, Selection &selection);
 
     // Create new buffer if required, returning the buffer
-    QPixmap *ensureBuffer(QPainter &painter, int width);
+    std::shared_ptr<QPixmap> ensureBuffer(QPainter &painter, int width);
 
     // variables
     MessagePtr message_;
-    MessageLayoutContainer container_;
-    std::unique_ptr<QPixmap> buffer_{};
+    // Shared with other views laying out the message the same way, see
+    // MessageLayoutCache
+    std::shared_ptr<const MessageLayoutContainer> container_;
+    // Owned by MessageBufferPool, which drops it when it runs out of memory
+    std::weak_ptr<QPixmap> buffer_;
+    // The part of the buffer used by the message, in pixels
+    QSize bufferSize_;
     bool bufferValid_ = false;
 
     int height_ = 0;
@@ -0,0 +1,94 @@
+#include "messages/layouts/MessageLayoutCache.hpp"
+
+#include "debug/AssertInGuiThread.hpp"
+#include "messages/layouts/MessageLayoutContainer.hpp"
+#include "messages/Message.hpp"
+#include "messages/MessageElement.hpp"
+#include "util/DebugCount.hpp"
+
+#include <boost/functional/hash.hpp>
+
+namespace chatterino {
+
+bool MessageLayoutKey::operator==(const MessageLayoutKey &other) const
+{
+    return this->message == other.message && this->width == other.width &&
+           this->scale == other.scale &&
+           this->elementFlags == other.elementFlags &&
+           this->messageFlags == other.messageFlags &&
+           this->hidden == other.hidden && this->generation == other.generation;
+}
+
+}  // namespace chatterino
+
+namespace std {
+
+size_t hash<chatterino::MessageLayoutKey>::operator()(
+    const chatterino::MessageLayoutKey &key) const
+{
+    size_t seed = 0;
+    boost::hash_combine(seed, key.message);
+    boost::hash_combine(seed, key.width);
+    boost::hash_combine(seed, key.scale);
+    boost::hash_combine(seed,
+                        static_cast<int64_t>(key.elementFlags.value()));
+    boost::hash_combine(seed,
+                        static_cast<int64_t>(key.messageFlags.value()));
+    boost::hash_combine(seed, key.hidden);
+    boost::hash_combine(seed, key.generation);
+    return seed;
+}
+
+}  // namespace std
+
+namespace chatterino {
+
+MessageLayoutCache::MessageLayoutCache(size_t maxSize)
+    : maxSize_(maxSize)
+    , cache_(maxSize)
+{
+}
+
+MessageLayoutCache &MessageLayoutCache::instance()
+{
+    // Enough for the visible messages and some scrollback of a few splits
+    static MessageLayoutCache instance(4096);
+    return instance;
+}
+
+std::shared_ptr<const MessageLayoutContainer> MessageLayoutCache::get(
+    const MessageLayoutKey &key)
+{
+    assertInGuiThread();
+
+    if (!this->cache_.exists(key))
+    {
+        return nullptr;
+    }
+
+    DebugCount::increase("message layout cache hits");
+    return this->cache_.get(key).container;
+}
+
+void MessageLayoutCache::put(
+    const MessageLayoutKey &key, MessagePtr message,
+    std::shared_ptr<const MessageLayoutContainer> container)
+{
+    assertInGuiThread();
+
+    this->cache_.put(key, {std::move(message), std::move(container)});
+}
+
+void MessageLayoutCache::clear()
+{
+    assertInGuiThread();
+
+    this->cache_ = cache::lru_cache<MessageLayoutKey, Entry>(this->maxSize_);
+}
+
+size_t MessageLayoutCache::size() const
+{
+    return this->cache_.size();
+}
+
+}  // namespace chatterino
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "common/FlagsEnum.hpp"
+
+#include <lrucache/lrucache.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace chatterino {
+
+struct Message;
+using MessagePtr = std::shared_ptr<const Message>;
+struct MessageLayoutContainer;
+
+enum class MessageFlag : int64_t;
+using MessageFlags = FlagsEnum<MessageFlag>;
+enum class MessageElementFlag : int64_t;
+using MessageElementFlags = FlagsEnum<MessageElementFlag>;
+
+struct MessageLayoutKey {
+    const Message *message;
+    int width;
+    float scale;
+    MessageElementFlags elementFlags;
+    // The flags the message is laid out with, see MessageLayout::actuallyLayout
+    MessageFlags messageFlags;
+    // Whether the settings hide the message, see MessageLayout::isHidden
+    bool hidden;
+    // See WindowManager::getGeneration
+    int generation;
+
+    bool operator==(const MessageLayoutKey &other) const;
+};
+
+}  // namespace chatterino
+
+namespace std {
+
+template <>
+struct hash<chatterino::MessageLayoutKey> {
+    size_t operator()(const chatterino::MessageLayoutKey &key) const;
+};
+
+}  // namespace std
+
+namespace chatterino {
+
+/**
+ * @brief Laid out messages shared between views
+ *
+ * Splits showing the same channel lay out the same messages with the same
+ * width and flags. This keeps the most recently laid out containers, so
+ * only the first view does the work and the others share its container.
+ *
+ * Containers are immutable once they're in here. Everything a view changes
+ * (background, selection, its buffer) stays in its MessageLayout.
+ * Must only be used from the GUI thread.
+ */
+class MessageLayoutCache
+{
+public:
+    explicit MessageLayoutCache(size_t maxSize);
+
+    static MessageLayoutCache &instance();
+
+    /// Returns the container laid out for key or nullptr
+    std::shared_ptr<const MessageLayoutContainer> get(
+        const MessageLayoutKey &key);
+
+    void put(const MessageLayoutKey &key, MessagePtr message,
+             std::shared_ptr<const MessageLayoutContainer> container);
+
+    void clear();
+    [[nodiscard]] size_t size() const;
+
+private:
+    struct Entry {
+        // Keeps the message alive while its address is used in a key
+        MessagePtr message;
+        std::shared_ptr<const MessageLayoutContainer> container;
+    };
+
+    size_t maxSize_;
+    cache::lru_cache<MessageLayoutKey, Entry> cache_;
+};
+
+}  // namespace chatterino
@@ -1,6 +1,7 @@
 #include "MessageLayoutContainer.hpp"
 
 #include "Application.hpp"
+#include "messages/layouts/FrameDamageTracker.hpp"
 #include "messages/layouts/MessageLayoutElement.hpp"
 #include "messages/Message.hpp"
 #include "messages/MessageElement.hpp"
@@ -8,17 +9,26 @@
 #include "singletons/Fonts.hpp"
 #include "singletons/Settings.hpp"
 #include "singletons/Theme.hpp"
+#include "util/DebugCount.hpp"
 #include "util/Helpers.hpp"
 
 #include <QDebug>
 #include <QPainter>
 
+#include <algorithm>
+#include <tuple>
+
 #define COMPACT_EMOTES_OFFSET 4
 #define MAX_UNCOLLAPSED_LINES \
     (getSettings()->collpseMessagesMinLines.getValue())
 
 namespace chatterino {
 
+MessageLayoutContainer::~MessageLayoutContainer()
+{
+    this->clear();
+}
+
 int MessageLayoutContainer::getHeight() const
 {
     return this->height_;
@@ -42,7 +52,7 @@ void MessageLayoutContainer::begin(int width, float scale, MessageFlags flags)
     this->scale_ = scale;
     this->flags_ = flags;
     auto mediumFontMetrics =
-        getApp()->fonts->getFontMetrics(FontStyle::ChatMedium, scale);
+        getIApp()->getFonts()->getFontMetrics(FontStyle::ChatMedium, scale);
     this->textLineHeight_ = mediumFontMetrics.height();
     this->spaceWidth_ = mediumFontMetrics.horizontalAdvance(' ');
     this->dotdotdotWidth_ = mediumFontMetrics.horizontalAdvance("...");
@@ -53,8 +63,21 @@ void MessageLayoutContainer::begin(int width, float scale, MessageFlags flags)
 
 void MessageLayoutContainer::clear()
 {
+    if (this->countedElements_ > 0)
+    {
+        DebugCount::decrease("message layout elements",
+                             static_cast<int64_t>(this->countedElements_));
+        this->countedElements_ = 0;
+    }
+
     this->elements_.clear();
+    this->textRuns_.clear();
+    this->textPositions_.clear();
+    this->texts_.clear();
+    this->otherElements_.clear();
+    this->arena_.clear();
     this->lines_.clear();
+    this->charStarts_.clear();
 
     this->height_ = 0;
     this->line_ = 0;
@@ -86,12 +109,21 @@ bool MessageLayoutContainer::canAddElements() const
     return this->canAddMessages_;
 }
 
+void MessageLayoutContainer::reserve(size_t count)
+{
+    this->elements_.reserve(count);
+    // Most elements are words
+    this->arena_.reserve(count * sizeof(TextLayoutElement));
+}
+
 void MessageLayoutContainer::_addElement(MessageLayoutElement *element,
                                          bool forceAdd, int prevIndex)
 {
     if (!this->canAddElements() && !forceAdd)
     {
-        delete element;
+        // Usually the element was just made, otherwise it's destroyed with
+        // the container
+        this->arena_.destroyLast(element);
         return;
     }
 
@@ -214,8 +246,7 @@ void MessageLayoutContainer::_addElement(MessageLayoutElement *element,
     // add element
     if (isAddingMode)
     {
-        this->elements_.push_back(
-            std::unique_ptr<MessageLayoutElement>(element));
+        this->elements_.push_back(element);
     }
 
     // set current x
@@ -320,12 +351,12 @@ void MessageLayoutContainer::reorderRTL(int firstTextIndex)
     // manually do the first call with -1 as previous index
     if (this->canAddElements())
     {
-        this->_addElement(this->elements_[correctSequence[0]].get(), false, -1);
+        this->_addElement(this->elements_[correctSequence[0]], false, -1);
     }
 
     for (int i = 1; i < correctSequence.size() && this->canAddElements(); i++)
     {
-        this->_addElement(this->elements_[correctSequence[i]].get(), false,
+        this->_addElement(this->elements_[correctSequence[i]], false,
                           correctSequence[i - 1]);
     }
 }
@@ -360,7 +391,7 @@ void MessageLayoutContainer::breakLine()
 
     for (size_t i = lineStart_; i < this->elements_.size(); i++)
     {
-        MessageLayoutElement *element = this->elements_.at(i).get();
+        MessageLayoutElement *element = this->elements_.at(i);
 
         bool isCompactEmote =
             !this->flags_.has(MessageFlag::DisableCompactEmotes) &&
@@ -388,8 +419,9 @@ void MessageLayoutContainer::breakLine()
         {(int)lineStart_, 0, this->charIndex_, 0,
          QRect(-100000, this->currentY_, 200000, lineHeight_)});
 
-    for (int i = this->lineStart_; i < this->elements_.size(); i++)
+    for (size_t i = this->lineStart_; i < this->elements_.size(); i++)
     {
+        this->charStarts_.push_back(this->charIndex_);
         this->charIndex_ += this->elements_[i]->getSelectionIndexCount();
     }
 
@@ -431,7 +463,7 @@ void MessageLayoutContainer::end()
                                      MessageColor::Link);
         static QString dotdotdotText("...");
 
-        auto *element = new TextLayoutElement(
+        auto *element = this->makeElement<TextLayoutElement>(
             dotdotdot, dotdotdotText,
             QSize(this->dotdotdotWidth_, this->textLineHeight_),
             QColor("#00D80A"), FontStyle::ChatMediumBold, this->scale_);
@@ -465,6 +497,14 @@ void MessageLayoutContainer::end()
         this->lines_.back().endIndex = this->elements_.size();
         this->lines_.back().endCharIndex = this->charIndex_;
     }
+    this->charStarts_.push_back(this->charIndex_);
+
+    this->buildTextRuns();
+
+    DebugCount::increase(
+        "message layout elements",
+        static_cast<int64_t>(this->elements_.size() - this->countedElements_));
+    this->countedElements_ = this->elements_.size();
 }
 
 bool MessageLayoutContainer::canCollapse()
@@ -473,18 +513,118 @@ bool MessageLayoutContainer::canCollapse()
            this->flags_.has(MessageFlag::Collapsed);
 }
 
-bool MessageLayoutContainer::isCollapsed()
+void MessageLayoutContainer::buildTextRuns()
+{
+    std::vector<const TextLayoutElement *> texts;
+    for (auto *element : this->elements_)
+    {
+        const auto *text = dynamic_cast<const TextLayoutElement *>(element);
+        if (text != nullptr && text->isPlainText())
+        {
+            texts.push_back(text);
+        }
+        else
+        {
+            this->otherElements_.push_back(element);
+        }
+    }
+
+    auto key = [](const TextLayoutElement *text) {
+        return std::make_tuple(text->getStyle(), text->getScale(),
+                               text->getColor().rgba());
+    };
+    std::stable_sort(texts.begin(), texts.end(), [&](auto *a, auto *b) {
+        return key(a) < key(b);
+    });
+
+    this->textPositions_.reserve(texts.size());
+    this->texts_.reserve(texts.size());
+    for (const auto *text : texts)
+    {
+        if (this->textRuns_.empty() ||
+            key(text) != std::make_tuple(this->textRuns_.back().style,
+                                         this->textRuns_.back().scale,
+                                         this->textRuns_.back().color.rgba()))
+        {
+            this->textRuns_.push_back({
+                text->getStyle(),
+                text->getScale(),
+                text->getColor(),
+                0,
+            });
+        }
+
+        this->textPositions_.push_back(text->getRect().topLeft());
+        this->texts_.push_back(text->getText());
+        this->textRuns_.back().end = this->texts_.size();
+    }
+}
+
+bool MessageLayoutContainer::isCollapsed() const
 {
     return this->isCollapsed_;
 }
 
-MessageLayoutElement *MessageLayoutContainer::getElementAt(QPoint point)
+size_t MessageLayoutContainer::memoryUsage() const
+{
+    auto bytes = [](const auto &vector) {
+        return vector.capacity() * sizeof(vector[0]);
+    };
+
+    return sizeof(*this) + this->arena_.capacity() + bytes(this->elements_) +
+           bytes(this->lines_) + bytes(this->charStarts_) +
+           bytes(this->textRuns_) + bytes(this->textPositions_) +
+           bytes(this->texts_) + bytes(this->otherElements_);
+}
+
+std::vector<MessageLayoutContainer::Line>::const_iterator
+    MessageLayoutContainer::lineAt(QPoint point) const
+{
+    // Lines are stacked on top of each other, so their bottoms are sorted
+    auto it = std::lower_bound(this->lines_.begin(), this->lines_.end(),
+                               point.y(), [](const Line &line, int y) {
+                                   return line.rect.bottom() < y;
+                               });
+
+    if (it == this->lines_.end() || !it->rect.contains(point))
+    {
+        return this->lines_.end();
+    }
+    return it;
+}
+
+int MessageLayoutContainer::elementAtCharIndex(const Line &line,
+                                               int charIndex) const
 {
-    for (std::unique_ptr<MessageLayoutElement> &element : this->elements_)
+    // charStarts_[i + 1] is where element i ends
+    auto end = std::upper_bound(this->charStarts_.begin() + line.startIndex + 1,
+                                this->charStarts_.begin() + line.endIndex + 1,
+                                charIndex);
+
+    return int(end - this->charStarts_.begin()) - 1;
+}
+
+MessageLayoutElement *MessageLayoutContainer::getElementAt(QPoint point) const
+{
+    size_t start = 0;
+    size_t end = this->elements_.size();
+
+    auto line = this->lineAt(point);
+    if (line != this->lines_.end())
     {
-        if (element->getRect().contains(point))
+        // Emotes and replies stick out of their line a bit, so the elements
+        // of the neighbouring lines are checked too
+        auto first = line == this->lines_.begin() ? line : line - 1;
+        auto last = line + 1 == this->lines_.end() ? line : line + 1;
+        start = first->startIndex;
+        end = last->endIndex;
+    }
+
+    for (size_t i = start; i < end; i++)
+    {
+        if (this->elements_[i]->getRect().contains(point))
         {
-            return element.get();
+            return this->elements_[i];
         }
     }
 
@@ -492,9 +632,9 @@ MessageLayoutElement *MessageLayoutContainer::getElementAt(QPoint point)
 }
 
 // painting
-void MessageLayoutContainer::paintElements(QPainter &painter)
+void MessageLayoutContainer::paintElements(QPainter &painter) const
 {
-    for (const std::unique_ptr<MessageLayoutElement> &element : this->elements_)
+    for (auto *element : this->otherElements_)
     {
 #ifdef FOURTF
         painter.setPen(QColor(0, 255, 0));
@@ -503,19 +643,48 @@ void MessageLayoutContainer::paintElements(QPainter &painter)
 
         element->paint(painter);
     }
+
+    auto *fonts = getIApp()->getFonts();
+    size_t i = 0;
+    for (const auto &run : this->textRuns_)
+    {
+        painter.setPen(run.color);
+        painter.setFont(fonts->getFont(run.style, run.scale));
+        // The positions are the top left corners, drawText wants baselines
+        auto ascent = fonts->getFontMetrics(run.style, run.scale).ascent();
+
+        for (; i < run.end; ++i)
+        {
+            const auto &position = this->textPositions_[i];
+            painter.drawText(QPoint(position.x(), position.y() + ascent),
+                             this->texts_[i]);
+        }
+    }
 }
 
-void MessageLayoutContainer::paintAnimatedElements(QPainter &painter,
-                                                   int yOffset)
+void MessageLayoutContainer::paintAnimatedElements(
+    QPainter &painter, int yOffset, FrameDamageTracker *damage) const
 {
-    for (const std::unique_ptr<MessageLayoutElement> &element : this->elements_)
+    // Plain text doesn't animate
+    for (auto *element : this->otherElements_)
     {
         element->paintAnimated(painter, yOffset);
+
+        if (damage == nullptr)
+        {
+            continue;
+        }
+
+        if (auto deadline = element->nextFrameDeadline())
+        {
+            damage->add(element->getRect().translated(0, yOffset), *deadline);
+        }
     }
 }
 
 void MessageLayoutContainer::paintSelection(QPainter &painter, int messageIndex,
-                                            Selection &selection, int yOffset)
+                                            Selection &selection,
+                                            int yOffset) const
 {
     auto app = getApp();
     QColor selectionColor = app->themes->messages.selection;
@@ -531,7 +700,7 @@ void MessageLayoutContainer::paintSelection(QPainter &painter, int messageIndex,
     if (selection.selectionMin.messageIndex < messageIndex &&
         selection.selectionMax.messageIndex > messageIndex)
     {
-        for (Line &line : this->lines_)
+        for (const Line &line : this->lines_)
         {
             QRect rect = line.rect;
 
@@ -547,90 +716,78 @@ void MessageLayoutContainer::paintSelection(QPainter &painter, int messageIndex,
     }
 
     int lineIndex = 0;
-    int index = 0;
 
     // start in this message
     if (selection.selectionMin.messageIndex == messageIndex)
     {
+        // skip the lines before the selection
+        lineIndex = int(
+            std::partition_point(this->lines_.begin(), this->lines_.end(),
+                                 [&](const Line &line) {
+                                     return line.endCharIndex <=
+                                            selection.selectionMin.charIndex;
+                                 }) -
+            this->lines_.begin());
+
         for (; lineIndex < this->lines_.size(); lineIndex++)
         {
-            Line &line = this->lines_[lineIndex];
-            index = line.startCharIndex;
+            const Line &line = this->lines_[lineIndex];
 
             bool returnAfter = false;
             bool breakAfter = false;
             int x = this->elements_[line.startIndex]->getRect().left();
             int r = this->elements_[line.endIndex - 1]->getRect().right();
 
-            if (line.endCharIndex <= selection.selectionMin.charIndex)
-            {
-                continue;
-            }
-
-            for (int i = line.startIndex; i < line.endIndex; i++)
+            int i = this->elementAtCharIndex(
+                line, selection.selectionMin.charIndex);
+            if (i < line.endIndex)
             {
-                int c = this->elements_[i]->getSelectionIndexCount();
+                x = this->elements_[i]->getXFromIndex(
+                    selection.selectionMin.charIndex - this->charStarts_[i]);
 
-                if (index + c > selection.selectionMin.charIndex)
+                // ends in same line
+                if (selection.selectionMax.messageIndex == messageIndex &&
+                    line.endCharIndex > /*=*/selection.selectionMax.charIndex)
                 {
-                    x = this->elements_[i]->getXFromIndex(
-                        selection.selectionMin.charIndex - index);
-
-                    // ends in same line
-                    if (selection.selectionMax.messageIndex == messageIndex &&
-                        line.endCharIndex >
-                            /*=*/selection.selectionMax.charIndex)
+                    returnAfter = true;
+                    int j = this->elementAtCharIndex(
+                        line, selection.selectionMax.charIndex);
+                    if (j < line.endIndex)
                     {
-                        returnAfter = true;
-                        index = line.startCharIndex;
-                        for (int i = line.startIndex; i < line.endIndex; i++)
-                        {
-                            int c =
-                                this->elements_[i]->getSelectionIndexCount();
-
-                            if (index + c > selection.selectionMax.charIndex)
-                            {
-                                r = this->elements_[i]->getXFromIndex(
-                                    selection.selectionMax.charIndex - index);
-                                break;
-                            }
-                            index += c;
-                        }
+                        r = this->elements_[j]->getXFromIndex(
+                            selection.selectionMax.charIndex -
+                            this->charStarts_[j]);
                     }
-                    // ends in same line end
+                }
+                // ends in same line end
 
-                    if (selection.selectionMax.messageIndex != messageIndex)
-                    {
-                        int lineIndex2 = lineIndex + 1;
-                        for (; lineIndex2 < this->lines_.size(); lineIndex2++)
-                        {
-                            Line &line2 = this->lines_[lineIndex2];
-                            QRect rect = line2.rect;
-
-                            rect.setTop(std::max(0, rect.top()) + yOffset);
-                            rect.setBottom(
-                                std::min(this->height_, rect.bottom()) +
-                                yOffset);
-                            rect.setLeft(this->elements_[line2.startIndex]
-                                             ->getRect()
-                                             .left());
-                            rect.setRight(this->elements_[line2.endIndex - 1]
-                                              ->getRect()
-                                              .right());
-
-                            painter.fillRect(rect, selectionColor);
-                        }
-                        returnAfter = true;
-                    }
-                    else
+                if (selection.selectionMax.messageIndex != messageIndex)
+                {
+                    int lineIndex2 = lineIndex + 1;
+                    for (; lineIndex2 < this->lines_.size(); lineIndex2++)
                     {
-                        lineIndex++;
-                        breakAfter = true;
+                        const Line &line2 = this->lines_[lineIndex2];
+                        QRect rect = line2.rect;
+
+                        rect.setTop(std::max(0, rect.top()) + yOffset);
+                        rect.setBottom(std::min(this->height_, rect.bottom()) +
+                                       yOffset);
+                        rect.setLeft(this->elements_[line2.startIndex]
+                                         ->getRect()
+                                         .left());
+                        rect.setRight(this->elements_[line2.endIndex - 1]
+                                          ->getRect()
+                                          .right());
+
+                        painter.fillRect(rect, selectionColor);
                     }
-
-                    break;
+                    returnAfter = true;
+                }
+                else
+                {
+                    lineIndex++;
+                    breakAfter = true;
                 }
-                index += c;
             }
 
             QRect rect = line.rect;
@@ -657,8 +814,7 @@ void MessageLayoutContainer::paintSelection(QPainter &painter, int messageIndex,
     // start in this message
     for (; lineIndex < this->lines_.size(); lineIndex++)
     {
-        Line &line = this->lines_[lineIndex];
-        index = line.startCharIndex;
+        const Line &line = this->lines_[lineIndex];
 
         // just draw the garbage
         if (line.endCharIndex < /*=*/selection.selectionMax.charIndex)
@@ -677,18 +833,12 @@ void MessageLayoutContainer::paintSelection(QPainter &painter, int messageIndex,
 
         int r = this->elements_[line.endIndex - 1]->getRect().right();
 
-        for (int i = line.startIndex; i < line.endIndex; i++)
+        int i =
+            this->elementAtCharIndex(line, selection.selectionMax.charIndex);
+        if (i < line.endIndex)
         {
-            int c = this->elements_[i]->getSelectionIndexCount();
-
-            if (index + c > selection.selectionMax.charIndex)
-            {
-                r = this->elements_[i]->getXFromIndex(
-                    selection.selectionMax.charIndex - index);
-                break;
-            }
-
-            index += c;
+            r = this->elements_[i]->getXFromIndex(
+                selection.selectionMax.charIndex - this->charStarts_[i]);
         }
 
         QRect rect = line.rect;
@@ -704,64 +854,33 @@ void MessageLayoutContainer::paintSelection(QPainter &painter, int messageIndex,
 }
 
 // selection
-int MessageLayoutContainer::getSelectionIndex(QPoint point)
+int MessageLayoutContainer::getSelectionIndex(QPoint point) const
 {
-    if (this->elements_.size() == 0)
+    if (this->elements_.size() == 0 || this->lines_.size() == 0)
     {
         return 0;
     }
 
-    auto line = this->lines_.begin();
-
-    for (; line != this->lines_.end(); line++)
+    auto line = this->lineAt(point);
+    if (line == this->lines_.end())
     {
-        if (line->rect.contains(point))
-        {
-            break;
-        }
-    }
-
-    int lineStart = line == this->lines_.end() ? this->lines_.back().startIndex
-                                               : line->startIndex;
-    if (line != this->lines_.end())
-    {
-        line++;
+        line = this->lines_.end() - 1;
     }
-    int lineEnd =
-        line == this->lines_.end() ? this->elements_.size() : line->startIndex;
-
-    int index = 0;
 
-    for (int i = 0; i < lineEnd; i++)
+    for (int i = line->startIndex; i < line->endIndex; i++)
     {
-        auto &&element = this->elements_[i];
-
-        // end of line
-        if (i == lineEnd)
-        {
-            break;
-        }
-
-        // before line
-        if (i < lineStart)
-        {
-            index += element->getSelectionIndexCount();
-            continue;
-        }
+        const auto *element = this->elements_[i];
 
         // this is the word
         auto rightMargin = element->hasTrailingSpace() ? this->spaceWidth_ : 0;
 
         if (point.x() <= element->getRect().right() + rightMargin)
         {
-            index += element->getMouseOverIndex(point);
-            break;
+            return this->charStarts_[i] + element->getMouseOverIndex(point);
         }
-
-        index += element->getSelectionIndexCount();
     }
 
-    return index;
+    return this->charStarts_[line->endIndex];
 }
 
 // fourtf: no idea if this is acurate LOL
@@ -784,7 +903,7 @@ int MessageLayoutContainer::getFirstMessageCharacterIndex() const
 
     // Get the index of the first character of the real message
     int index = 0;
-    for (auto &element : this->elements_)
+    for (const auto *element : this->elements_)
     {
         if (element->getFlags().hasAny(skippedFlags))
         {
@@ -799,12 +918,13 @@ int MessageLayoutContainer::getFirstMessageCharacterIndex() const
 }
 
 void MessageLayoutContainer::addSelectionText(QString &str, uint32_t from,
-                                              uint32_t to, CopyMode copymode)
+                                              uint32_t to,
+                                              CopyMode copymode) const
 {
     uint32_t index = 0;
     bool first = true;
 
-    for (auto &element : this->elements_)
+    for (const auto *element : this->elements_)
     {
         if (copymode != CopyMode::Everything &&
             element->getCreator().getFlags().has(
@@ -2,11 +2,15 @@
 
 #include "common/Common.hpp"
 #include "common/FlagsEnum.hpp"
+#include "util/ObjectArena.hpp"
 
+#include <QColor>
 #include <QPoint>
 #include <QRect>
+#include <QString>
 
-#include <memory>
+#include <cstdint>
+#include <utility>
 #include <vector>
 
 class QPainter;
@@ -18,6 +22,8 @@ enum class FirstWord { Neutral, RTL, LTR };
 using MessageFlags = FlagsEnum<MessageFlag>;
 class MessageLayoutElement;
 struct Selection;
+class FrameDamageTracker;
+enum class FontStyle : uint8_t;
 
 struct Margin {
     int top;
@@ -46,6 +52,7 @@ struct Margin {
 
 struct MessageLayoutContainer {
     MessageLayoutContainer() = default;
+    ~MessageLayoutContainer();
 
     FirstWord first = FirstWord::Neutral;
     bool containsRTL = false;
@@ -60,6 +67,19 @@ struct MessageLayoutContainer {
 
     void clear();
     bool canAddElements() const;
+
+    /// Makes room for about count elements, so they're allocated at once.
+    /// Called after begin.
+    void reserve(size_t count);
+
+    /// Creates an element in this container's arena, it's owned by the
+    /// container even if it isn't added
+    template <typename T, typename... Args>
+    T *makeElement(Args &&...args)
+    {
+        return this->arena_.make<T>(std::forward<Args>(args)...);
+    }
+
     void addElement(MessageLayoutElement *element);
     void addElementNoLineBreak(MessageLayoutElement *element);
     void breakLine();
@@ -70,22 +90,30 @@ struct MessageLayoutContainer {
     // however we don't we to reorder non-text elements like badges, timestamps, username
     // firstTextIndex is the index of the first text element that we need to start the reordering from
     void reorderRTL(int firstTextIndex);
-    MessageLayoutElement *getElementAt(QPoint point);
+    MessageLayoutElement *getElementAt(QPoint point) const;
 
     // painting
-    void paintElements(QPainter &painter);
-    void paintAnimatedElements(QPainter &painter, int yOffset);
+    /// Paints the plain text elements in one loop per font and color, the
+    /// other elements paint themselves
+    void paintElements(QPainter &painter) const;
+    // Adds the animated elements to damage if it's set
+    void paintAnimatedElements(QPainter &painter, int yOffset,
+                               FrameDamageTracker *damage = nullptr) const;
     void paintSelection(QPainter &painter, int messageIndex,
-                        Selection &selection, int yOffset);
+                        Selection &selection, int yOffset) const;
 
     // selection
-    int getSelectionIndex(QPoint point);
+    int getSelectionIndex(QPoint point) const;
     int getLastCharacterIndex() const;
     int getFirstMessageCharacterIndex() const;
     void addSelectionText(QString &str, uint32_t from, uint32_t to,
-                          CopyMode copymode);
+                          CopyMode copymode) const;
+
+    bool isCollapsed() const;
 
-    bool isCollapsed();
+    /// Bytes held by the elements and the lookup arrays. Text shared with
+    /// the message elements isn't counted.
+    size_t memoryUsage() const;
 
 private:
     struct Line {
@@ -110,6 +138,14 @@ private:
     void _addElement(MessageLayoutElement *element, bool forceAdd = false,
                      int prevIndex = -2);
     bool canCollapse();
+    /// Splits the elements into textRuns_ and otherElements_
+    void buildTextRuns();
+
+    /// The line containing point, lines_.end() if there's none
+    std::vector<Line>::const_iterator lineAt(QPoint point) const;
+    /// Index of the first element in line whose characters reach past
+    /// charIndex, line.endIndex if there's none
+    int elementAtCharIndex(const Line &line, int charIndex) const;
 
     const Margin margin = {4, 8, 4, 8};
 
@@ -131,8 +167,30 @@ private:
     bool isCollapsed_ = false;
     bool wasPrevReversed_ = false;
 
-    std::vector<std::unique_ptr<MessageLayoutElement>> elements_;
+    // Elements of a message live and die together, so they're allocated
+    // next to each other
+    ObjectArena arena_;
+    std::vector<MessageLayoutElement *> elements_;
+    // Number of elements reported to DebugCount
+    size_t countedElements_ = 0;
     std::vector<Line> lines_;
+    // Selection index of the first character of each element, followed by
+    // the total count
+    std::vector<int> charStarts_;
+
+    // The plain text elements as flat arrays, sorted by font and color.
+    // Everything else is in otherElements_.
+    struct TextRun {
+        FontStyle style;
+        float scale;
+        QColor color;
+        // One past the last text of the run
+        size_t end;
+    };
+    std::vector<TextRun> textRuns_;
+    std::vector<QPoint> textPositions_;
+    std::vector<QString> texts_;
+    std::vector<MessageLayoutElement *> otherElements_;
 };
 
 }  // namespace chatterino
@@ -9,7 +9,6 @@
 #include "providers/twitch/TwitchEmotes.hpp"
 #include "singletons/Settings.hpp"
 #include "singletons/Theme.hpp"
-#include "util/DebugCount.hpp"
 
 #include <QDebug>
 #include <QGraphicsDropShadowEffect>
@@ -44,13 +43,10 @@ MessageLayoutElement::MessageLayoutElement(MessageElement &creator,
     : creator_(creator)
 {
     this->rect_.setSize(size);
-    DebugCount::increase("message layout elements");
 }
 
-MessageLayoutElement::~MessageLayoutElement()
-{
-    DebugCount::decrease("message layout elements");
-}
+// Counted by MessageLayoutContainer, it knows how many elements it holds
+MessageLayoutElement::~MessageLayoutElement() = default;
 
 MessageElement &MessageLayoutElement::getCreator() const
 {
@@ -106,6 +102,11 @@ const QString &MessageLayoutElement::getText() const
     return this->text_;
 }
 
+boost::optional<long unsigned> MessageLayoutElement::nextFrameDeadline() const
+{
+    return boost::none;
+}
+
 FlagsEnum<MessageElementFlag> MessageLayoutElement::getFlags() const
 {
     return this->creator_.getFlags();
@@ -177,6 +178,16 @@ void ImageLayoutElement::paintAnimated(QPainter &painter, int yOffset)
     }
 }
 
+boost::optional<long unsigned> ImageLayoutElement::nextFrameDeadline() const
+{
+    if (this->image_ == nullptr)
+    {
+        return boost::none;
+    }
+
+    return this->image_->nextFrameDeadline();
+}
+
 int ImageLayoutElement::getMouseOverIndex(const QPoint &abs) const
 {
     return 0;
@@ -304,6 +315,27 @@ void LayeredImageLayoutElement::paintAnimated(QPainter &painter, int yOffset)
     }
 }
 
+boost::optional<long unsigned> LayeredImageLayoutElement::nextFrameDeadline()
+    const
+{
+    boost::optional<long unsigned> deadline;
+
+    for (const auto &img : this->images_)
+    {
+        if (img == nullptr)
+        {
+            continue;
+        }
+
+        if (auto next = img->nextFrameDeadline())
+        {
+            deadline = deadline ? std::min(*deadline, *next) : *next;
+        }
+    }
+
+    return deadline;
+}
+
 int LayeredImageLayoutElement::getMouseOverIndex(const QPoint &abs) const
 {
     return 0;
@@ -414,6 +446,29 @@ void TextLayoutElement::listenToLinkChanges()
         });
 }
 
+bool TextLayoutElement::isPlainText() const
+{
+    // Only usernames can have a 7TV paint, see seventvPaint
+    const auto &link = this->getLink();
+    return link.type != Link::UserInfo && link.type != Link::UserWhisper &&
+           !this->reversedNeutral && !this->getText().isRightToLeft();
+}
+
+const QColor &TextLayoutElement::getColor() const
+{
+    return this->color_;
+}
+
+FontStyle TextLayoutElement::getStyle() const
+{
+    return this->style_;
+}
+
+float TextLayoutElement::getScale() const
+{
+    return this->scale_;
+}
+
 void TextLayoutElement::addCopyTextToString(QString &str, uint32_t from,
                                             uint32_t to) const
 {
@@ -432,31 +487,15 @@ int TextLayoutElement::getSelectionIndexCount() const
 
 void TextLayoutElement::paint(QPainter &painter)
 {
-    auto app = getApp();
-    QString text = this->getText();
-    if (text.isRightToLeft() || this->reversedNeutral)
-    {
-        text.prepend(RTL_EMBED);
-    }
-
-    const auto font = getApp()->getFonts()->getFont(this->style_, this->scale_);
-
-    const bool isNametag =
-        this->getLink().type == chatterino::Link::UserInfo ||
-        this->getLink().type == chatterino::Link::UserWhisper;
-    const bool drawPaint = isNametag && getSettings()->displaySevenTVPaints;
-    const auto seventvPaint =
-        getApp()->seventvPaints->getPaint(this->getLink().value.toLower());
-    if (drawPaint && seventvPaint.has_value())
+    const auto seventvPaint = this->seventvPaint();
+    if (seventvPaint != nullptr)
     {
-        if (seventvPaint.value()->animated())
+        if (seventvPaint->animated())
             return;
 
-        const auto paint = seventvPaint.value();
-
-        const auto paintPixmap =
-            paint->getPixmap(this->getText(), font, this->color_,
-                             this->getRect().size(), this->scale_);
+        const auto paintPixmap = getApp()->seventvPaints->getPaintPixmap(
+            seventvPaint, this->getText(), this->style_, this->scale_,
+            this->color_, this->getRect().size());
 
         painter.drawPixmap(QRect(this->getRect().x(), this->getRect().y(),
                                  paintPixmap.width(), paintPixmap.height()),
@@ -464,8 +503,15 @@ void TextLayoutElement::paint(QPainter &painter)
     }
     else
     {
+        QString text = this->getText();
+        if (text.isRightToLeft() || this->reversedNeutral)
+        {
+            text.prepend(RTL_EMBED);
+        }
+
         painter.setPen(this->color_);
-        painter.setFont(font);
+        painter.setFont(
+            getApp()->getFonts()->getFont(this->style_, this->scale_));
 
         painter.drawText(
             QRectF(this->getRect().x(), this->getRect().y(), 10000, 10000),
@@ -478,23 +524,12 @@ void TextLayoutElement::paintAnimated(QPainter &painter, const int yOffset)
     if (this->getRect().isEmpty())
         return;
 
-    const auto font = getApp()->getFonts()->getFont(this->style_, this->scale_);
-
-    const bool isNametag =
-        this->getLink().type == chatterino::Link::UserInfo ||
-        this->getLink().type == chatterino::Link::UserWhisper;
-    const bool drawPaint = isNametag && getSettings()->displaySevenTVPaints;
-    const auto seventvPaint =
-        getApp()->seventvPaints->getPaint(this->getLink().value.toLower());
-
-    if (drawPaint && seventvPaint.has_value() &&
-        seventvPaint.value()->animated())
+    const auto seventvPaint = this->seventvPaint();
+    if (seventvPaint != nullptr && seventvPaint->animated())
     {
-        const auto paint = seventvPaint.value();
-
-        const auto paintPixmap =
-            paint->getPixmap(this->getText(), font, this->color_,
-                             this->getRect().size(), this->scale_);
+        const auto paintPixmap = getApp()->seventvPaints->getPaintPixmap(
+            seventvPaint, this->getText(), this->style_, this->scale_,
+            this->color_, this->getRect().size());
 
         auto rect = this->getRect();
         rect.moveTop(rect.y() + yOffset);
@@ -502,6 +537,49 @@ void TextLayoutElement::paintAnimated(QPainter &painter, const int yOffset)
     }
 }
 
+boost::optional<long unsigned> TextLayoutElement::nextFrameDeadline() const
+{
+    if (this->getRect().isEmpty())
+    {
+        return boost::none;
+    }
+
+    const auto seventvPaint = this->seventvPaint();
+    if (seventvPaint == nullptr)
+    {
+        return boost::none;
+    }
+
+    return seventvPaint->nextFrameDeadline();
+}
+
+std::shared_ptr<Paint> TextLayoutElement::seventvPaint() const
+{
+    if (!getSettings()->displaySevenTVPaints)
+    {
+        return nullptr;
+    }
+
+    const auto &link = this->getLink();
+    if (link.type != Link::UserInfo && link.type != Link::UserWhisper)
+    {
+        return nullptr;
+    }
+
+    // Only looked up again once a paint or the paint of a user changed
+    auto *paints = getApp()->seventvPaints;
+    const auto generation = paints->generation();
+    if (generation != this->paintGeneration_ ||
+        link.value != this->paintUserName_)
+    {
+        this->paint_ = paints->getPaint(link.value.toLower()).value_or(nullptr);
+        this->paintGeneration_ = generation;
+        this->paintUserName_ = link.value;
+    }
+
+    return this->paint_;
+}
+
 int TextLayoutElement::getMouseOverIndex(const QPoint &abs) const
 {
     if (abs.x() < this->getRect().left())
@@ -509,9 +587,8 @@ int TextLayoutElement::getMouseOverIndex(const QPoint &abs) const
         return 0;
     }
 
-    auto app = getApp();
-
-    auto metrics = app->fonts->getFontMetrics(this->style_, this->scale_);
+    auto metrics =
+        getIApp()->getFonts()->getFontMetrics(this->style_, this->scale_);
     auto x = this->getRect().left();
 
     for (auto i = 0; i < this->getText().size(); i++)
@@ -543,10 +620,8 @@ int TextLayoutElement::getMouseOverIndex(const QPoint &abs) const
 
 int TextLayoutElement::getXFromIndex(int index)
 {
-    auto app = getApp();
-
     QFontMetrics metrics =
-        app->fonts->getFontMetrics(this->style_, this->scale_);
+        getIApp()->getFonts()->getFontMetrics(this->style_, this->scale_);
 
     if (index <= 0)
     {
@@ -4,6 +4,7 @@
 #include "messages/Link.hpp"
 
 #include <boost/noncopyable.hpp>
+#include <boost/optional.hpp>
 #include <pajlada/signals/signalholder.hpp>
 #include <QPen>
 #include <QPoint>
@@ -12,6 +13,7 @@
 
 #include <climits>
 #include <cstdint>
+#include <memory>
 
 class QPainter;
 
@@ -19,6 +21,7 @@ namespace chatterino {
 class MessageElement;
 class Image;
 using ImagePtr = std::shared_ptr<Image>;
+class Paint;
 enum class FontStyle : uint8_t;
 enum class MessageElementFlag : int64_t;
 
@@ -46,6 +49,9 @@ public:
     virtual int getSelectionIndexCount() const = 0;
     virtual void paint(QPainter &painter) = 0;
     virtual void paintAnimated(QPainter &painter, int yOffset) = 0;
+    /// GIF timer position at which paintAnimated draws something different,
+    /// empty if the element doesn't animate. See Image::nextFrameDeadline
+    virtual boost::optional<long unsigned> nextFrameDeadline() const;
     virtual int getMouseOverIndex(const QPoint &abs) const = 0;
     virtual int getXFromIndex(int index) = 0;
 
@@ -77,6 +83,7 @@ protected:
     int getSelectionIndexCount() const override;
     void paint(QPainter &painter) override;
     void paintAnimated(QPainter &painter, int yOffset) override;
+    boost::optional<long unsigned> nextFrameDeadline() const override;
     int getMouseOverIndex(const QPoint &abs) const override;
     int getXFromIndex(int index) override;
 
@@ -96,6 +103,7 @@ protected:
     int getSelectionIndexCount() const override;
     void paint(QPainter &painter) override;
     void paintAnimated(QPainter &painter, int yOffset) override;
+    boost::optional<long unsigned> nextFrameDeadline() const override;
     int getMouseOverIndex(const QPoint &abs) const override;
     int getXFromIndex(int index) override;
 
@@ -143,12 +151,20 @@ public:
 
     void listenToLinkChanges();
 
+    /// Whether the text is drawn without a 7TV paint and without RTL
+    /// embedding, MessageLayoutContainer draws those elements itself
+    bool isPlainText() const;
+    const QColor &getColor() const;
+    FontStyle getStyle() const;
+    float getScale() const;
+
 protected:
     void addCopyTextToString(QString &str, uint32_t from = 0,
                              uint32_t to = UINT32_MAX) const override;
     int getSelectionIndexCount() const override;
     void paint(QPainter &painter) override;
     void paintAnimated(QPainter &painter, int yOffset) override;
+    boost::optional<long unsigned> nextFrameDeadline() const override;
     int getMouseOverIndex(const QPoint &abs) const override;
     int getXFromIndex(int index) override;
 
@@ -157,6 +173,15 @@ protected:
     float scale_;
 
     pajlada::Signals::SignalHolder managedConnections_;
+
+private:
+    /// Returns the 7TV paint to draw this text with, if any
+    std::shared_ptr<Paint> seventvPaint() const;
+
+    // Paint of the linked user as of SeventvPaints::generation
+    mutable std::shared_ptr<Paint> paint_;
+    mutable uint64_t paintGeneration_ = UINT64_MAX;
+    mutable QString paintUserName_;
 };
 
 // TEXT ICON
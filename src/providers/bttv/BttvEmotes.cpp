@@ -8,6 +8,7 @@
 #include "messages/ImageSet.hpp"
 #include "messages/MessageBuilder.hpp"
 #include "providers/bttv/liveupdates/BttvLiveUpdateMessages.hpp"
+#include "providers/twitch/ChannelEmoteIndex.hpp"
 #include "providers/twitch/TwitchChannel.hpp"
 #include "singletons/Settings.hpp"
 
@@ -46,10 +47,9 @@ namespace {
     }
     EmotePtr cachedOrMake(Emote &&emote, const EmoteId &id)
     {
-        static std::unordered_map<EmoteId, std::weak_ptr<const Emote>> cache;
-        static std::mutex mutex;
+        static WeakCache<EmoteId, const Emote> cache("BTTV emote cache");
 
-        return cachedOrMakeEmotePtr(std::move(emote), cache, mutex, id);
+        return cachedOrMakeEmotePtr(std::move(emote), cache, id);
     }
     std::pair<Outcome, EmoteMap> parseGlobalEmotes(
         const QJsonArray &jsonEmotes, const EmoteMap &currentEmotes)
@@ -296,6 +296,7 @@ void BttvEmotes::loadEmotes()
 void BttvEmotes::setEmotes(std::shared_ptr<const EmoteMap> emotes)
 {
     this->global_.set(std::move(emotes));
+    ChannelEmoteIndex::globalEmotesChanged();
 }
 
 void BttvEmotes::loadChannel(std::weak_ptr<Channel> channel,
@@ -369,7 +370,7 @@ EmotePtr BttvEmotes::addEmote(
     Atomic<std::shared_ptr<const EmoteMap>> &channelEmoteMap,
     const BttvLiveUpdateEmoteUpdateAddMessage &message)
 {
-    // This copies the map.
+    // This copies the map, the copy shares its emotes with the current map.
     EmoteMap updatedMap = *channelEmoteMap.get();
     auto result = createChannelEmote(channelDisplayName, message.jsonEmote);
 
@@ -385,7 +386,7 @@ boost::optional<std::pair<EmotePtr, EmotePtr>> BttvEmotes::updateEmote(
     Atomic<std::shared_ptr<const EmoteMap>> &channelEmoteMap,
     const BttvLiveUpdateEmoteUpdateAddMessage &message)
 {
-    // This copies the map.
+    // This copies the map, the copy shares its emotes with the current map.
     EmoteMap updatedMap = *channelEmoteMap.get();
 
     // Step 1: remove the existing emote
@@ -420,7 +421,7 @@ boost::optional<EmotePtr> BttvEmotes::removeEmote(
     Atomic<std::shared_ptr<const EmoteMap>> &channelEmoteMap,
     const BttvLiveUpdateEmoteRemoveMessage &message)
 {
-    // This copies the map.
+    // This copies the map, the copy shares its emotes with the current map.
     EmoteMap updatedMap = *channelEmoteMap.get();
     auto it = updatedMap.findEmote(QString(), message.emoteID);
     if (it == updatedMap.end())
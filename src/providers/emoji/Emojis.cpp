@@ -12,6 +12,7 @@
 #include <rapidjson/error/error.h>
 #include <rapidjson/rapidjson.h>
 
+#include <algorithm>
 #include <array>
 #include <memory>
 
@@ -127,6 +128,40 @@ namespace {
         return toneNameResults.join('-');
     }
 
+    // Most chat is plain ASCII and can't contain an emoji. Code units are
+    // ORed in blocks without branching so compilers vectorize the loop.
+    bool isAscii(const QString &text)
+    {
+        constexpr int BLOCK_SIZE = 32;
+
+        const auto *data = text.utf16();
+        const int length = text.length();
+        int i = 0;
+
+        for (; i + BLOCK_SIZE <= length; i += BLOCK_SIZE)
+        {
+            ushort bits = 0;
+            for (int j = 0; j < BLOCK_SIZE; ++j)
+            {
+                bits |= data[i + j];
+            }
+            if (bits >= 0x80)
+            {
+                return false;
+            }
+        }
+
+        for (; i < length; ++i)
+        {
+            if (data[i] >= 0x80)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
 }  // namespace
 
 void Emojis::load()
@@ -156,6 +191,8 @@ void Emojis::loadEmojis()
         return;
     }
 
+    std::vector<std::shared_ptr<EmojiData>> loadedEmojis;
+
     for (const auto &unparsedEmoji : root.GetArray())
     {
         auto emojiData = std::make_shared<EmojiData>();
@@ -167,7 +204,7 @@ void Emojis::loadEmojis()
             this->shortCodes.emplace_back(shortCode);
         }
 
-        this->emojiFirstByte_[emojiData->value.at(0)].append(emojiData);
+        loadedEmojis.push_back(emojiData);
 
         this->emojis.insert(emojiData->unifiedCode, emojiData);
 
@@ -188,26 +225,80 @@ void Emojis::loadEmojis()
                     variationEmojiData->shortCodes[0], variationEmojiData);
                 this->shortCodes.push_back(variationEmojiData->shortCodes[0]);
 
-                this->emojiFirstByte_[variationEmojiData->value.at(0)].append(
-                    variationEmojiData);
+                loadedEmojis.push_back(variationEmojiData);
 
                 this->emojis.insert(variationEmojiData->unifiedCode,
                                     variationEmojiData);
             }
         }
     }
+
+    this->buildEmojiTrie(loadedEmojis);
 }
 
-void Emojis::sortEmojis()
+void Emojis::buildEmojiTrie(
+    const std::vector<std::shared_ptr<EmojiData>> &emojis)
 {
-    for (auto &p : this->emojiFirstByte_)
+    struct BuildNode {
+        std::map<char16_t, std::unique_ptr<BuildNode>> children;
+        std::shared_ptr<EmojiData> emoji;
+    };
+
+    BuildNode root;
+    for (const auto &emoji : emojis)
+    {
+        if (emoji->value.isEmpty())
+        {
+            continue;
+        }
+
+        auto *node = &root;
+        bool ascii = true;
+        for (auto character : emoji->value)
+        {
+            auto &child = node->children[character.unicode()];
+            if (!child)
+            {
+                child = std::make_unique<BuildNode>();
+            }
+            node = child.get();
+            ascii = ascii && character.unicode() < 0x80;
+        }
+
+        // The first emoji with a value wins, like the first match did before
+        if (!node->emoji)
+        {
+            node->emoji = emoji;
+        }
+        this->emojiStart_.set(emoji->value.at(0).unicode());
+        this->hasAsciiEmoji_ = this->hasAsciiEmoji_ || ascii;
+    }
+
+    // Flatten the trie breadth first, so the children of every node end up
+    // next to each other
+    this->emojiTrie_.clear();
+    this->emojiTrie_.emplace_back();
+    std::vector<const BuildNode *> queue{&root};
+    for (size_t i = 0; i < queue.size(); ++i)
     {
-        std::stable_sort(p.begin(), p.end(),
-                         [](const auto &lhs, const auto &rhs) {
-                             return lhs->value.length() > rhs->value.length();
-                         });
+        const auto *buildNode = queue[i];
+        this->emojiTrie_[i].emoji = buildNode->emoji;
+        this->emojiTrie_[i].firstChild =
+            static_cast<uint32_t>(this->emojiTrie_.size());
+        this->emojiTrie_[i].childCount =
+            static_cast<uint32_t>(buildNode->children.size());
+
+        for (const auto &[character, child] : buildNode->children)
+        {
+            this->emojiTrie_.emplace_back();
+            this->emojiTrie_.back().character = character;
+            queue.push_back(child.get());
+        }
     }
+}
 
+void Emojis::sortEmojis()
+{
     auto &p = this->shortCodes;
     std::stable_sort(p.begin(), p.end(), [](const auto &lhs, const auto &rhs) {
         return lhs < rhs;
@@ -268,59 +359,52 @@ std::vector<boost::variant<EmotePtr, QString>> Emojis::parse(
     const QString &text) const
 {
     auto result = std::vector<boost::variant<EmotePtr, QString>>();
-    int lastParsedEmojiEndIndex = 0;
 
-    for (auto i = 0; i < text.length(); ++i)
+    if (!this->hasAsciiEmoji_ && isAscii(text))
     {
-        const QChar character = text.at(i);
-
-        if (character.isLowSurrogate())
+        if (!text.isEmpty())
         {
-            continue;
+            result.emplace_back(text);
         }
+        return result;
+    }
 
-        auto it = this->emojiFirstByte_.find(character);
-        if (it == this->emojiFirstByte_.end())
+    const auto *data = text.utf16();
+    const int length = text.length();
+    int lastParsedEmojiEndIndex = 0;
+
+    for (auto i = 0; i < length; ++i)
+    {
+        if (!this->emojiStart_.test(data[i]))
         {
             // No emoji starts with this character
             continue;
         }
 
-        const auto &possibleEmojis = it.value();
-
-        int remainingCharacters = text.length() - i - 1;
-
-        std::shared_ptr<EmojiData> matchedEmoji;
-
+        // Walk the trie as far as the text matches, the last emoji passed
+        // is the longest one starting here
+        const auto *node = &this->emojiTrie_.front();
+        const EmojiData *matchedEmoji = nullptr;
         int matchedEmojiLength = 0;
 
-        for (const std::shared_ptr<EmojiData> &emoji : possibleEmojis)
+        for (int j = i; j < length && node->childCount > 0; ++j)
         {
-            int emojiExtraCharacters = emoji->value.length() - 1;
-            if (emojiExtraCharacters > remainingCharacters)
+            auto begin = this->emojiTrie_.begin() + node->firstChild;
+            auto end = begin + node->childCount;
+            auto child = std::lower_bound(
+                begin, end, data[j], [](const auto &lhs, auto character) {
+                    return lhs.character < character;
+                });
+            if (child == end || child->character != data[j])
             {
-                // It cannot be this emoji, there's not enough space for it
-                continue;
-            }
-
-            bool match = true;
-
-            for (int j = 1; j < emoji->value.length(); ++j)
-            {
-                if (text.at(i + j) != emoji->value.at(j))
-                {
-                    match = false;
-
-                    break;
-                }
+                break;
             }
 
-            if (match)
+            node = &*child;
+            if (node->emoji)
             {
-                matchedEmoji = emoji;
-                matchedEmojiLength = emoji->value.length();
-
-                break;
+                matchedEmoji = node->emoji.get();
+                matchedEmojiLength = j - i + 1;
             }
         }
 
@@ -7,7 +7,10 @@
 #include <QRegularExpression>
 #include <QVector>
 
+#include <bitset>
+#include <cstdint>
 #include <map>
+#include <memory>
 #include <set>
 #include <vector>
 
@@ -69,15 +72,34 @@ private:
     void sortEmojis();
     void loadEmojiSet();
 
+    /// Compiles the values of the given emojis into emojiTrie_
+    void buildEmojiTrie(const std::vector<std::shared_ptr<EmojiData>> &emojis);
+
     /// Emojis
     QRegularExpression findShortCodesRegex_{":([-+\\w]+):"};
 
     // shortCodeToEmoji maps strings like "sunglasses" to its emoji
     QMap<QString, std::shared_ptr<EmojiData>> emojiShortCodeToEmoji_;
 
-    // Maps the first character of the emoji unicode string to a vector of
-    // possible emojis
-    QMap<QChar, QVector<std::shared_ptr<EmojiData>>> emojiFirstByte_;
+    struct EmojiTrieNode {
+        // UTF-16 code unit leading to this node
+        char16_t character = 0;
+        // Children are stored next to each other, sorted by their character
+        uint32_t firstChild = 0;
+        uint32_t childCount = 0;
+        // Emoji whose value ends at this node
+        std::shared_ptr<EmojiData> emoji;
+    };
+
+    // Trie over the values of all emojis, the root is the first node
+    std::vector<EmojiTrieNode> emojiTrie_;
+
+    // UTF-16 code units which start an emoji
+    std::bitset<0x10000> emojiStart_;
+
+    // Whether some emoji value only consists of ASCII characters, which
+    // rules out skipping ASCII only text
+    bool hasAsciiEmoji_ = false;
 };
 
 }  // namespace chatterino
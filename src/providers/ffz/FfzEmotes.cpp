@@ -8,6 +8,7 @@
 #include "messages/Image.hpp"
 #include "messages/MessageBuilder.hpp"
 #include "providers/ffz/FfzUtil.hpp"
+#include "providers/twitch/ChannelEmoteIndex.hpp"
 #include "providers/twitch/TwitchChannel.hpp"
 #include "singletons/Settings.hpp"
 
@@ -50,10 +51,9 @@ namespace {
 
     EmotePtr cachedOrMake(Emote &&emote, const EmoteId &id)
     {
-        static std::unordered_map<EmoteId, std::weak_ptr<const Emote>> cache;
-        static std::mutex mutex;
+        static WeakCache<EmoteId, const Emote> cache("FFZ emote cache");
 
-        return cachedOrMakeEmotePtr(std::move(emote), cache, mutex, id);
+        return cachedOrMakeEmotePtr(std::move(emote), cache, id);
     }
 
     void parseEmoteSetInto(const QJsonObject &emoteSet, const QString &kind,
@@ -209,6 +209,7 @@ void FfzEmotes::loadEmotes()
 void FfzEmotes::setEmotes(std::shared_ptr<const EmoteMap> emotes)
 {
     this->global_.set(std::move(emotes));
+    ChannelEmoteIndex::globalEmotesChanged();
 }
 
 void FfzEmotes::loadChannel(
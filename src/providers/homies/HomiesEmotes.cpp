@@ -8,6 +8,7 @@
 #include "messages/Image.hpp"
 #include "messages/ImageSet.hpp"
 #include "messages/MessageBuilder.hpp"
+#include "providers/twitch/ChannelEmoteIndex.hpp"
 #include "providers/twitch/TwitchChannel.hpp"
 #include "singletons/Settings.hpp"
 
@@ -31,10 +32,9 @@ namespace {
 
     EmotePtr cachedOrMake(Emote &&emote, const EmoteId &id)
     {
-        static std::unordered_map<EmoteId, std::weak_ptr<const Emote>> cache;
-        static std::mutex mutex;
+        static WeakCache<EmoteId, const Emote> cache("Homies emote cache");
 
-        return cachedOrMakeEmotePtr(std::move(emote), cache, mutex, id);
+        return cachedOrMakeEmotePtr(std::move(emote), cache, id);
     }
 
     struct CreateEmoteResult {
@@ -124,6 +124,7 @@ void HomiesEmotes::loadEmotes()
     if (!Settings::instance().enableHomiesGlobalEmotes)
     {
         this->global_.set(EMPTY_EMOTE_MAP);
+        ChannelEmoteIndex::globalEmotesChanged();
         return;
     }
 
@@ -137,8 +138,11 @@ void HomiesEmotes::loadEmotes()
 
             auto pair = parseGlobalEmotes(parsedEmotes, *this->global_.get());
             if (pair.first)
+            {
                 this->global_.set(
                     std::make_shared<EmoteMap>(std::move(pair.second)));
+                ChannelEmoteIndex::globalEmotesChanged();
+            }
             return pair.first;
         })
         .execute();
@@ -8,6 +8,7 @@
 #include "messages/ImageSet.hpp"
 #include "messages/MessageBuilder.hpp"
 #include "providers/seventv/eventapi/Dispatch.hpp"
+#include "providers/twitch/ChannelEmoteIndex.hpp"
 #include "providers/twitch/TwitchChannel.hpp"
 #include "singletons/Settings.hpp"
 
@@ -50,10 +51,9 @@ struct CreateEmoteResult {
 
 EmotePtr cachedOrMake(Emote &&emote, const EmoteId &id)
 {
-    static std::unordered_map<EmoteId, std::weak_ptr<const Emote>> cache;
-    static std::mutex mutex;
+    static WeakCache<EmoteId, const Emote> cache("7TV emote cache");
 
-    return cachedOrMakeEmotePtr(std::move(emote), cache, mutex, id);
+    return cachedOrMakeEmotePtr(std::move(emote), cache, id);
 }
 
 /**
@@ -419,6 +419,7 @@ void SeventvEmotes::loadGlobalEmotes()
 void SeventvEmotes::setGlobalEmotes(std::shared_ptr<const EmoteMap> emotes)
 {
     this->global_.set(std::move(emotes));
+    ChannelEmoteIndex::globalEmotesChanged();
 }
 
 void SeventvEmotes::loadChannelEmotes(
@@ -535,7 +536,7 @@ boost::optional<EmotePtr> SeventvEmotes::addEmote(
         return boost::none;
     }
 
-    // This copies the map.
+    // This copies the map, the copy shares its emotes with the current map.
     EmoteMap updatedMap = *map.get();
     auto result = createEmote(dispatch.emoteJson, emoteData, kind);
     if (!result.hasImages)
@@ -563,8 +564,8 @@ boost::optional<EmotePtr> SeventvEmotes::updateEmote(
         return boost::none;
     }
 
-    // This copies the map.
-    EmoteMap updatedMap = *map.get();
+    // This copies the map, the copy shares its emotes with the current map.
+    EmoteMap updatedMap = *oldMap;
     updatedMap.erase(oldEmote->second->name);
 
     auto emote = createUpdatedEmote(oldEmote->second, dispatch, kind);
@@ -578,7 +579,7 @@ boost::optional<EmotePtr> SeventvEmotes::removeEmote(
     Atomic<std::shared_ptr<const EmoteMap>> &map,
     const EmoteRemoveDispatch &dispatch)
 {
-    // This copies the map.
+    // This copies the map, the copy shares its emotes with the current map.
     EmoteMap updatedMap = *map.get();
     auto it = updatedMap.findEmote(dispatch.emoteName, dispatch.emoteID);
     if (it == updatedMap.end())
@@ -1,5 +1,6 @@
 #include "SeventvPaints.hpp"
 
+#include "Application.hpp"
 #include "common/NetworkRequest.hpp"
 #include "common/NetworkResult.hpp"
 #include "common/Outcome.hpp"
@@ -8,6 +9,8 @@
 #include "providers/seventv/paints/PaintDropShadow.hpp"
 #include "providers/seventv/paints/RadialGradientPaint.hpp"
 #include "providers/seventv/paints/UrlPaint.hpp"
+#include "singletons/Fonts.hpp"
+#include "singletons/Theme.hpp"
 
 #include <QUrlQuery>
 
@@ -129,6 +132,15 @@ namespace chatterino {
 
 void SeventvPaints::initialize(Settings & /*settings*/, Paths & /*paths*/)
 {
+    // The theme provides the color of the colon after a nametag
+    this->signalHolder_.managedConnect(getApp()->getThemes()->updated, [this] {
+        this->pixmapCache_.clear();
+    });
+    this->signalHolder_.managedConnect(getApp()->getFonts()->fontChanged,
+                                       [this] {
+                                           this->pixmapCache_.clear();
+                                       });
+
     this->loadSeventvPaints();
 }
 
@@ -145,14 +157,30 @@ std::optional<std::shared_ptr<Paint>> SeventvPaints::getPaint(
     return std::nullopt;
 }
 
+QPixmap SeventvPaints::getPaintPixmap(const std::shared_ptr<Paint> &paint,
+                                      const QString &text, FontStyle style,
+                                      float scale, QColor color, QSize size)
+{
+    return this->pixmapCache_.getPixmap(paint, text, style, scale, color,
+                                        size);
+}
+
 void SeventvPaints::addPaint(const QJsonObject &paintJson)
 {
     const auto paintID = paintJson["id"].toString();
 
     std::unique_lock lock(this->mutex_);
 
-    if (this->knownPaints_.find(paintID) != this->knownPaints_.end())
+    const auto known = this->knownPaints_.find(paintID);
+    const auto knownJson = this->knownPaintJson_.find(paintID);
+    const bool updated = knownJson != this->knownPaintJson_.end() &&
+                         knownJson->second != paintJson;
+    if (known != this->knownPaints_.end() && !updated)
     {
+        if (knownJson == this->knownPaintJson_.end())
+        {
+            this->knownPaintJson_.emplace(paintID, paintJson);
+        }
         return;
     }
 
@@ -162,7 +190,31 @@ void SeventvPaints::addPaint(const QJsonObject &paintJson)
         return;
     }
 
-    this->knownPaints_[paintID] = *paint;
+    this->knownPaintJson_[paintID] = paintJson;
+
+    if (known == this->knownPaints_.end())
+    {
+        this->knownPaints_[paintID] = *paint;
+        return;
+    }
+
+    // The paint was changed, its users get the new one
+    const auto oldPaint = known->second;
+    (*paint)->version = oldPaint->version + 1;
+    known->second = *paint;
+    for (auto &[userName, userPaint] : this->paintMap_)
+    {
+        if (userPaint == oldPaint)
+        {
+            userPaint = *paint;
+        }
+    }
+    this->generation_++;
+}
+
+uint64_t SeventvPaints::generation() const
+{
+    return this->generation_.load(std::memory_order_acquire);
 }
 
 void SeventvPaints::assignPaintToUser(const QString &paintID,
@@ -174,6 +226,7 @@ void SeventvPaints::assignPaintToUser(const QString &paintID,
     if (paintIt != this->knownPaints_.end())
     {
         this->paintMap_[userName.string] = paintIt->second;
+        this->generation_++;
     }
 }
 
@@ -186,6 +239,7 @@ void SeventvPaints::clearPaintFromUser(const QString &paintID,
     if (it != this->paintMap_.end() && it->second->id == paintID)
     {
         this->paintMap_.erase(userName.string);
+        this->generation_++;
     }
 }
 
@@ -223,6 +277,7 @@ void SeventvPaints::loadSeventvPaints()
                     this->paintMap_[userJson.toString()] = *paint;
                 }
             }
+            this->generation_++;
 
             return Success;
         })
@@ -5,10 +5,15 @@
 #include "common/Singleton.hpp"
 #include "providers/seventv/paints/Paint.hpp"
 #include "providers/seventv/paints/PaintDropShadow.hpp"
+#include "providers/seventv/paints/PaintPixmapCache.hpp"
 
+#include <pajlada/signals/signalholder.hpp>
 #include <QJsonArray>
+#include <QJsonObject>
 #include <QString>
 
+#include <atomic>
+#include <cstdint>
 #include <optional>
 #include <shared_mutex>
 #include <unordered_map>
@@ -27,6 +32,15 @@ public:
     std::optional<std::shared_ptr<Paint>> getPaint(
         const QString &userName) const;
 
+    /// Changes whenever a paint or the paint of a user changes, paints that
+    /// were looked up before may be outdated then
+    uint64_t generation() const;
+
+    /// Renders a nametag with paint, see PaintPixmapCache. GUI thread only.
+    QPixmap getPaintPixmap(const std::shared_ptr<Paint> &paint,
+                           const QString &text, FontStyle style, float scale,
+                           QColor color, QSize size);
+
 private:
     void loadSeventvPaints();
 
@@ -37,6 +51,13 @@ private:
     std::unordered_map<QString, std::shared_ptr<Paint>> paintMap_;
     // paint-id => paint
     std::unordered_map<QString, std::shared_ptr<Paint>> knownPaints_;
+    // paint-id => paint from the event api, to notice updates
+    std::unordered_map<QString, QJsonObject> knownPaintJson_;
+    std::atomic<uint64_t> generation_{0};
+
+    // gui thread only
+    PaintPixmapCache pixmapCache_{512};
+    pajlada::Signals::SignalHolder signalHolder_;
 };
 
 }  // namespace chatterino
@@ -2,9 +2,11 @@
 
 #include "providers/seventv/paints/PaintDropShadow.hpp"
 
+#include <boost/optional.hpp>
 #include <QBrush>
 #include <QFont>
 
+#include <cstdint>
 #include <vector>
 
 namespace chatterino {
@@ -15,6 +17,17 @@ public:
     virtual QBrush asBrush(QColor userColor, QRectF drawingRect) const = 0;
     virtual std::vector<PaintDropShadow> getDropShadows() const = 0;
     virtual bool animated() const = 0;
+    /// See Image::nextFrameDeadline
+    virtual boost::optional<long unsigned> nextFrameDeadline() const
+    {
+        return boost::none;
+    }
+    /// Identifies what the paint currently looks like, rendered nametags are
+    /// cached by it. Empty while the paint can't be rendered properly yet.
+    virtual boost::optional<qint64> frameKey() const
+    {
+        return 0;
+    }
 
     QPixmap getPixmap(QString text, QFont font, QColor userColor, QSize size,
                       float scale) const;
@@ -24,6 +37,9 @@ public:
     virtual ~Paint() = default;
 
     QString id;
+    /// Number of times the paint with this id was changed, rendered nametags
+    /// are cached by id and version
+    uint32_t version = 0;
 
 protected:
     QColor overlayColors(const QColor background,
@@ -0,0 +1,94 @@
+#include "providers/seventv/paints/PaintPixmapCache.hpp"
+
+#include "Application.hpp"
+#include "debug/AssertInGuiThread.hpp"
+#include "providers/seventv/paints/Paint.hpp"
+#include "singletons/Fonts.hpp"
+
+#include <boost/functional/hash.hpp>
+#include <QHash>
+
+namespace chatterino {
+
+bool PaintPixmapKey::operator==(const PaintPixmapKey &other) const
+{
+    return this->version == other.version && this->frame == other.frame &&
+           this->style == other.style && this->scale == other.scale &&
+           this->color == other.color && this->size == other.size &&
+           this->paintID == other.paintID && this->text == other.text;
+}
+
+}  // namespace chatterino
+
+namespace std {
+
+size_t hash<chatterino::PaintPixmapKey>::operator()(
+    const chatterino::PaintPixmapKey &key) const
+{
+    size_t seed = qHash(key.text);
+    boost::hash_combine(seed, qHash(key.paintID));
+    boost::hash_combine(seed, key.version);
+    boost::hash_combine(seed, key.frame);
+    boost::hash_combine(seed, static_cast<uint8_t>(key.style));
+    boost::hash_combine(seed, key.scale);
+    boost::hash_combine(seed, key.color);
+    boost::hash_combine(seed, key.size.width());
+    boost::hash_combine(seed, key.size.height());
+    return seed;
+}
+
+}  // namespace std
+
+namespace chatterino {
+
+PaintPixmapCache::PaintPixmapCache(size_t maxSize)
+    : maxSize_(maxSize)
+    , cache_(maxSize)
+{
+}
+
+QPixmap PaintPixmapCache::getPixmap(const std::shared_ptr<Paint> &paint,
+                                    const QString &text, FontStyle style,
+                                    float scale, QColor color, QSize size)
+{
+    assertInGuiThread();
+
+    auto font = [&] {
+        return getApp()->getFonts()->getFont(style, scale);
+    };
+
+    auto frame = paint->frameKey();
+    if (!frame)
+    {
+        // The paint is still loading, don't keep the placeholder around
+        return paint->getPixmap(text, font(), color, size, scale);
+    }
+
+    PaintPixmapKey key{
+        paint->id, paint->version, *frame, text, style, scale, color.rgba(),
+        size,
+    };
+    if (this->cache_.exists(key))
+    {
+        return this->cache_.get(key);
+    }
+
+    auto pixmap = paint->getPixmap(text, font(), color, size, scale);
+    this->cache_.put(key, pixmap);
+
+    return pixmap;
+}
+
+void PaintPixmapCache::clear()
+{
+    assertInGuiThread();
+
+    this->cache_ = cache::lru_cache<PaintPixmapKey, QPixmap>(this->maxSize_);
+}
+
+size_t PaintPixmapCache::size() const
+{
+    return this->cache_.size();
+}
+
+}  // namespace chatterino
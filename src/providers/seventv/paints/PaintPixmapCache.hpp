@@ -0,0 +1,74 @@
+#pragma once
+
+#include <lrucache/lrucache.hpp>
+#include <QColor>
+#include <QPixmap>
+#include <QSize>
+#include <QString>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace chatterino {
+
+class Paint;
+enum class FontStyle : uint8_t;
+
+struct PaintPixmapKey {
+    QString paintID;
+    // See Paint::version
+    uint32_t version;
+    // See Paint::frameKey
+    qint64 frame;
+    QString text;
+    FontStyle style;
+    float scale;
+    QRgb color;
+    QSize size;
+
+    bool operator==(const PaintPixmapKey &other) const;
+};
+
+}  // namespace chatterino
+
+namespace std {
+
+template <>
+struct hash<chatterino::PaintPixmapKey> {
+    size_t operator()(const chatterino::PaintPixmapKey &key) const;
+};
+
+}  // namespace std
+
+namespace chatterino {
+
+/**
+ * @brief Nametags rendered with 7TV paints
+ *
+ * Rendering a paint builds its brush and draws the text and its drop shadows
+ * into a new pixmap. This keeps the most recently used nametags, so each one
+ * is only rendered once instead of on every paint.
+ *
+ * Nametags are cached by the id and version of their paint, so a changed
+ * paint is rendered again while the old nametags just fall out of the cache.
+ * Animated paints are cached per frame. Must only be used from the GUI thread.
+ */
+class PaintPixmapCache
+{
+public:
+    explicit PaintPixmapCache(size_t maxSize);
+
+    /// Returns paint->getPixmap(...) for the font of style and scale
+    QPixmap getPixmap(const std::shared_ptr<Paint> &paint, const QString &text,
+                      FontStyle style, float scale, QColor color, QSize size);
+
+    void clear();
+    [[nodiscard]] size_t size() const;
+
+private:
+    size_t maxSize_;
+    cache::lru_cache<PaintPixmapKey, QPixmap> cache_;
+};
+
+}  // namespace chatterino
@@ -20,6 +20,21 @@ bool UrlPaint::animated() const
     return image_->animated();
 }
 
+boost::optional<long unsigned> UrlPaint::nextFrameDeadline() const
+{
+    return image_->nextFrameDeadline();
+}
+
+boost::optional<qint64> UrlPaint::frameKey() const
+{
+    if (auto pixmap = this->image_->pixmapOrLoad())
+    {
+        return pixmap->cacheKey();
+    }
+
+    return boost::none;
+}
+
 QBrush UrlPaint::asBrush(const QColor userColor, const QRectF drawingRect) const
 {
     if (auto paintPixmap = this->image_->pixmapOrLoad())
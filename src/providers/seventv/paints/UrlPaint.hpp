@@ -14,6 +14,8 @@ public:
     QBrush asBrush(QColor userColor, QRectF drawingRect) const override;
     std::vector<PaintDropShadow> getDropShadows() const override;
     bool animated() const override;
+    boost::optional<long unsigned> nextFrameDeadline() const override;
+    boost::optional<qint64> frameKey() const override;
 
 private:
     const QString name_;
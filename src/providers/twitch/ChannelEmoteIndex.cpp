@@ -0,0 +1,256 @@
+#include "providers/twitch/ChannelEmoteIndex.hpp"
+
+#include "messages/Emote.hpp"
+#include "messages/MessageElement.hpp"
+
+#include <QSet>
+#include <QString>
+
+#include <atomic>
+#include <utility>
+
+namespace {
+
+using namespace chatterino;
+using Source = ChannelEmoteIndex::Source;
+
+const QSet<QString> zeroWidthBttvEmotes{
+    "SoSnowy",  "IceCold",   "SantaHat", "TopHat",
+    "ReinDeer", "CandyCane", "cvMask",   "cvHazmat",
+};
+
+// Starts at 1 so a default constructed index picks up the globals
+std::atomic<uint64_t> globalsGeneration{1};
+
+MessageElementFlag flagOf(Source source)
+{
+    switch (source)
+    {
+        case Source::FfzChannel:
+        case Source::FfzGlobal:
+            return MessageElementFlag::FfzEmote;
+        case Source::BttvChannel:
+        case Source::BttvGlobal:
+            return MessageElementFlag::BttvEmote;
+        case Source::SeventvChannel:
+        case Source::SeventvGlobal:
+            return MessageElementFlag::SevenTVEmote;
+        case Source::HomiesChannel:
+        case Source::HomiesGlobal:
+            return MessageElementFlag::HomiesEmote;
+    }
+
+    return MessageElementFlag::None;
+}
+
+bool isZeroWidth(Source source, const EmoteName &name, const Emote &emote)
+{
+    switch (source)
+    {
+        case Source::FfzChannel:
+        case Source::FfzGlobal:
+        case Source::BttvChannel:
+            return false;
+        case Source::BttvGlobal:
+            // BTTV only has a fixed set of global zero-width emotes
+            return zeroWidthBttvEmotes.contains(name.string);
+        default:
+            return emote.zeroWidth;
+    }
+}
+
+}  // namespace
+
+namespace chatterino {
+
+ChannelEmoteIndex::ChannelEmoteIndex()
+    : globalsGeneration_(0)
+{
+    this->sources_.fill(EMPTY_EMOTE_MAP);
+}
+
+ChannelEmoteIndex::ChannelEmoteIndex(Sources sources,
+                                     uint64_t globalsGeneration)
+    : sources_(std::move(sources))
+    , globalsGeneration_(globalsGeneration)
+{
+    for (size_t i = 0; i < SOURCE_COUNT; i++)
+    {
+        auto &map = this->sources_[i];
+        if (!map)
+        {
+            map = EMPTY_EMOTE_MAP;
+        }
+
+        // Sources are visited by priority, so the first emote of a name wins
+        auto source = static_cast<Source>(i);
+        for (const auto &[name, emote] : *map)
+        {
+            this->emotes_.emplace(
+                name, Entry{emote, flagOf(source),
+                            isZeroWidth(source, name, *emote)});
+        }
+    }
+}
+
+const ChannelEmoteIndex::Entry *ChannelEmoteIndex::find(
+    const EmoteName &name) const
+{
+    auto it = this->emotes_.find(name);
+    if (it == this->emotes_.end())
+    {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+size_t ChannelEmoteIndex::size() const
+{
+    return this->emotes_.size();
+}
+
+const std::shared_ptr<const EmoteMap> &ChannelEmoteIndex::source(
+    Source source) const
+{
+    return this->sources_[static_cast<size_t>(source)];
+}
+
+std::shared_ptr<const ChannelEmoteIndex> ChannelEmoteIndex::withSource(
+    Source source, std::shared_ptr<const EmoteMap> map) const
+{
+    if (!map)
+    {
+        map = EMPTY_EMOTE_MAP;
+    }
+
+    auto next = std::make_shared<ChannelEmoteIndex>(*this);
+    auto old = std::exchange(next->sources_[static_cast<size_t>(source)],
+                             std::move(map));
+    next->reindex(*old, *next->source(source));
+    return next;
+}
+
+std::shared_ptr<const ChannelEmoteIndex> ChannelEmoteIndex::withEmotes(
+    Source source, std::shared_ptr<const EmoteMap> map,
+    std::initializer_list<EmoteName> names) const
+{
+    if (!map)
+    {
+        map = EMPTY_EMOTE_MAP;
+    }
+
+    auto next = std::make_shared<ChannelEmoteIndex>(*this);
+    next->sources_[static_cast<size_t>(source)] = std::move(map);
+    for (const auto &name : names)
+    {
+        next->reindex(name);
+    }
+    return next;
+}
+
+std::shared_ptr<const ChannelEmoteIndex> ChannelEmoteIndex::withGlobals(
+    std::shared_ptr<const EmoteMap> ffz, std::shared_ptr<const EmoteMap> bttv,
+    std::shared_ptr<const EmoteMap> seventv,
+    std::shared_ptr<const EmoteMap> homies, uint64_t generation) const
+{
+    auto next = std::make_shared<ChannelEmoteIndex>(*this);
+    next->globalsGeneration_ = generation;
+
+    std::pair<Source, std::shared_ptr<const EmoteMap>> globals[] = {
+        {Source::FfzGlobal, std::move(ffz)},
+        {Source::BttvGlobal, std::move(bttv)},
+        {Source::SeventvGlobal, std::move(seventv)},
+        {Source::HomiesGlobal, std::move(homies)},
+    };
+    for (auto &[source, map] : globals)
+    {
+        if (!map)
+        {
+            map = EMPTY_EMOTE_MAP;
+        }
+
+        auto old = std::exchange(
+            next->sources_[static_cast<size_t>(source)], std::move(map));
+        next->reindex(*old, *next->source(source));
+    }
+
+    return next;
+}
+
+uint64_t ChannelEmoteIndex::globalsGeneration() const
+{
+    return this->globalsGeneration_;
+}
+
+boost::optional<ChannelEmoteIndex::Entry> ChannelEmoteIndex::resolve(
+    const Sources &sources, const EmoteName &name)
+{
+    for (size_t i = 0; i < SOURCE_COUNT; i++)
+    {
+        if (!sources[i])
+        {
+            continue;
+        }
+
+        auto it = sources[i]->find(name);
+        if (it != sources[i]->end())
+        {
+            auto source = static_cast<Source>(i);
+            return Entry{it->second, flagOf(source),
+                         isZeroWidth(source, name, *it->second)};
+        }
+    }
+
+    return boost::none;
+}
+
+void ChannelEmoteIndex::globalEmotesChanged()
+{
+    ++globalsGeneration;
+}
+
+uint64_t ChannelEmoteIndex::currentGlobalsGeneration()
+{
+    return globalsGeneration.load();
+}
+
+void ChannelEmoteIndex::reindex(const EmoteMap &oldMap, const EmoteMap &newMap)
+{
+    if (&oldMap == &newMap)
+    {
+        return;
+    }
+
+    // Reloads usually keep most emotes, so only the names whose emote
+    // changed between the two maps are resolved again
+    for (const auto &[name, emote] : oldMap)
+    {
+        auto it = newMap.find(name);
+        if (it == newMap.end() || it->second != emote)
+        {
+            this->reindex(name);
+        }
+    }
+    for (const auto &[name, emote] : newMap)
+    {
+        auto it = oldMap.find(name);
+        if (it == oldMap.end() || it->second != emote)
+        {
+            this->reindex(name);
+        }
+    }
+}
+
+void ChannelEmoteIndex::reindex(const EmoteName &name)
+{
+    if (auto entry = resolve(this->sources_, name))
+    {
+        this->emotes_.insert_or_assign(name, *entry);
+    }
+    else
+    {
+        this->emotes_.erase(name);
+    }
+}
+
+}  // namespace chatterino
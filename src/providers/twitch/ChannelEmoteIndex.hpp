@@ -0,0 +1,113 @@
+#pragma once
+
+#include "common/Aliases.hpp"
+#include "util/PersistentHashMap.hpp"
+
+#include <boost/optional.hpp>
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+
+namespace chatterino {
+
+struct Emote;
+using EmotePtr = std::shared_ptr<const Emote>;
+class EmoteMap;
+enum class MessageElementFlag : int64_t;
+
+/**
+ * @brief The third party emotes usable in a channel, merged into one map
+ *
+ * Every name is resolved to the emote that wins by priority, together with
+ * the flag and zero-width state it's shown with, so looking up a word is a
+ * single probe instead of one lookup per provider.
+ *
+ * An index is immutable. When one of its source maps changes, withSource()
+ * creates a new index where only the names of the old and new map are
+ * resolved again. Copies of an index share their entries, so a live update
+ * of a single emote (withEmotes()) is O(log n).
+ */
+class ChannelEmoteIndex
+{
+public:
+    /// The sources of an index, ordered from highest to lowest priority
+    enum class Source : uint8_t {
+        FfzChannel,
+        BttvChannel,
+        SeventvChannel,
+        HomiesChannel,
+        FfzGlobal,
+        BttvGlobal,
+        SeventvGlobal,
+        HomiesGlobal,
+    };
+    static constexpr size_t SOURCE_COUNT = 8;
+
+    using Sources = std::array<std::shared_ptr<const EmoteMap>, SOURCE_COUNT>;
+
+    struct Entry {
+        EmotePtr emote;
+        MessageElementFlag flag;
+        bool zeroWidth;
+    };
+
+    /// Creates an index where every source is empty
+    ChannelEmoteIndex();
+    explicit ChannelEmoteIndex(Sources sources,
+                               uint64_t globalsGeneration = 0);
+
+    /// Returns nullptr if no source has an emote called name
+    [[nodiscard]] const Entry *find(const EmoteName &name) const;
+
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] const std::shared_ptr<const EmoteMap> &source(
+        Source source) const;
+
+    /// Creates a copy of this index with source replaced by map
+    [[nodiscard]] std::shared_ptr<const ChannelEmoteIndex> withSource(
+        Source source, std::shared_ptr<const EmoteMap> map) const;
+
+    /**
+     * @brief Creates a copy of this index with source replaced by map
+     *
+     * map may only differ from the current map of source in the emotes
+     * called names, only these are resolved again.
+     */
+    [[nodiscard]] std::shared_ptr<const ChannelEmoteIndex> withEmotes(
+        Source source, std::shared_ptr<const EmoteMap> map,
+        std::initializer_list<EmoteName> names) const;
+
+    /// Creates a copy of this index with the global sources replaced
+    [[nodiscard]] std::shared_ptr<const ChannelEmoteIndex> withGlobals(
+        std::shared_ptr<const EmoteMap> ffz,
+        std::shared_ptr<const EmoteMap> bttv,
+        std::shared_ptr<const EmoteMap> seventv,
+        std::shared_ptr<const EmoteMap> homies,
+        uint64_t generation) const;
+
+    /// The value of globalsGeneration() the global sources were taken at
+    [[nodiscard]] uint64_t globalsGeneration() const;
+
+    /// Resolves name against sources without building an index
+    [[nodiscard]] static boost::optional<Entry> resolve(
+        const Sources &sources, const EmoteName &name);
+
+    /// Must be called whenever one of the global emote maps is replaced
+    static void globalEmotesChanged();
+
+    /// Incremented on every call to globalEmotesChanged()
+    [[nodiscard]] static uint64_t currentGlobalsGeneration();
+
+private:
+    /// Resolves the names whose emote differs between the two maps again
+    void reindex(const EmoteMap &oldMap, const EmoteMap &newMap);
+    void reindex(const EmoteName &name);
+
+    Sources sources_;
+    PersistentHashMap<EmoteName, Entry> emotes_;
+    uint64_t globalsGeneration_;
+};
+
+}  // namespace chatterino
@@ -23,6 +23,7 @@
 #include "util/FormatTime.hpp"
 #include "util/Helpers.hpp"
 #include "util/IrcHelpers.hpp"
+#include "util/OrderedWorkQueue.hpp"
 #include "util/StreamerMode.hpp"
 
 #include <IrcMessage>
@@ -180,90 +181,26 @@ void updateReplyParticipatedStatus(const QVariantMap &tags,
 }  // namespace
 namespace chatterino {
 
-static float relativeSimilarity(const QString &str1, const QString &str2)
+void IrcMessageHandler::setSimilarityFlags(MessagePtr msg, ChannelPtr chan)
 {
-    // Longest Common Substring Problem
-    std::vector<std::vector<int>> tree(str1.size(),
-                                       std::vector<int>(str2.size(), 0));
-    int z = 0;
-
-    for (int i = 0; i < str1.size(); ++i)
+    if (!getSettings()->similarityEnabled)
     {
-        for (int j = 0; j < str2.size(); ++j)
-        {
-            if (str1[i] == str2[j])
-            {
-                if (i == 0 || j == 0)
-                {
-                    tree[i][j] = 1;
-                }
-                else
-                {
-                    tree[i][j] = tree[i - 1][j - 1] + 1;
-                }
-                if (tree[i][j] > z)
-                {
-                    z = tree[i][j];
-                }
-            }
-            else
-            {
-                tree[i][j] = 0;
-            }
-        }
+        return;
     }
 
-    // ensure that no div by 0
-    return z == 0 ? 0.f
-                  : float(z) / std::max<int>(
-                                   1, std::max<int>(str1.size(), str2.size()));
-};
-
-float IrcMessageHandler::similarity(
-    MessagePtr msg, const LimitedQueueSnapshot<MessagePtr> &messages)
-{
-    float similarityPercent = 0.0f;
-    int checked = 0;
-    for (int i = 1; i <= messages.size(); ++i)
-    {
-        if (checked >= getSettings()->hideSimilarMaxMessagesToCheck)
-        {
-            break;
-        }
-        const auto &prevMsg = messages[messages.size() - i];
-        if (prevMsg->parseTime.secsTo(QTime::currentTime()) >=
-            getSettings()->hideSimilarMaxDelay)
-        {
-            break;
-        }
-        if (getSettings()->hideSimilarBySameUser &&
-            msg->loginName != prevMsg->loginName)
-        {
-            continue;
-        }
-        ++checked;
-        similarityPercent = std::max<float>(
-            similarityPercent,
-            relativeSimilarity(msg->messageText, prevMsg->messageText));
-    }
-    return similarityPercent;
-}
+    bool isMyself = msg->loginName ==
+                    getApp()->accounts->twitch.getCurrent()->getUserName();
+    bool hideMyself = getSettings()->hideSimilarMyself;
 
-void IrcMessageHandler::setSimilarityFlags(MessagePtr msg, ChannelPtr chan)
-{
-    if (getSettings()->similarityEnabled)
+    if (!isMyself || hideMyself)
     {
-        bool isMyself = msg->loginName ==
-                        getApp()->accounts->twitch.getCurrent()->getUserName();
-        bool hideMyself = getSettings()->hideSimilarMyself;
+        float similarity = chan->similarityHistory.similarity(
+            msg->messageText, msg->loginName, QTime::currentTime(),
+            getSettings()->hideSimilarMaxMessagesToCheck,
+            getSettings()->hideSimilarMaxDelay,
+            getSettings()->hideSimilarBySameUser);
 
-        if (isMyself && !hideMyself)
-        {
-            return;
-        }
-
-        if (IrcMessageHandler::similarity(msg, chan->getMessageSnapshot()) >
-            getSettings()->similarityPercentage)
+        if (similarity > getSettings()->similarityPercentage)
         {
             msg->flags.set(MessageFlag::Similar, true);
             if (getSettings()->colorSimilarDisabled)
@@ -272,6 +209,11 @@ void IrcMessageHandler::setSimilarityFlags(MessagePtr msg, ChannelPtr chan)
             }
         }
     }
+
+    // Own messages are remembered even when they aren't checked, since other
+    // messages are compared against them
+    chan->similarityHistory.add(msg->messageText, msg->loginName,
+                                msg->parseTime);
 }
 
 static QMap<QString, QString> parseBadges(QString badgesString)
@@ -335,7 +277,9 @@ std::vector<MessagePtr> IrcMessageHandler::parsePrivMessage(
         message->isAction());
     if (!builder.isIgnored())
     {
-        builtMessages.emplace_back(builder.build());
+        auto msg = builder.build();
+        builder.applyBuildResults(msg);
+        builtMessages.emplace_back(std::move(msg));
         builder.triggerHighlights();
     }
     return builtMessages;
@@ -392,7 +336,9 @@ std::vector<MessagePtr> IrcMessageHandler::parseMessageWithReply(
 
         if (!builder.isIgnored())
         {
-            builtMessages.emplace_back(builder.build());
+            auto msg = builder.build();
+            builder.applyBuildResults(msg);
+            builtMessages.emplace_back(std::move(msg));
             builder.triggerHighlights();
         }
     }
@@ -534,9 +480,30 @@ void IrcMessageHandler::addMessage(Communi::IrcMessage *_message,
     QString content = content_;
     int messageOffset = stripLeadingReplyMention(tags, content);
 
-    TwitchMessageBuilder builder(chan.get(), _message, args, content, isAction);
-    builder.setMessageOffset(messageOffset);
+    // Subscription messages are added from within USERNOTICE handlers which
+    // are already ordered, so only chat messages are built concurrently
+    auto &queue = server.messageBuildQueue();
+    bool concurrent = !isSub && (getSettings()->buildMessagesConcurrently ||
+                                 queue.hasPending(target));
 
+    // The builder keeps a pointer to the IRC message, when building on a
+    // worker we need a copy that outlives this handler
+    std::shared_ptr<Communi::IrcMessage> ownedMessage;
+    if (concurrent)
+    {
+        ownedMessage = std::shared_ptr<Communi::IrcMessage>(
+            _message->clone(), [](Communi::IrcMessage *message) {
+                message->deleteLater();
+            });
+    }
+
+    auto builder = std::make_shared<TwitchMessageBuilder>(
+        chan.get(), concurrent ? ownedMessage.get() : _message, args, content,
+        isAction);
+    builder->setMessageOffset(messageOffset);
+
+    // Reply threads are owned by the GUI thread, so they're resolved before
+    // building
     if (const auto it = tags.find("reply-parent-msg-id"); it != tags.end())
     {
         const QString replyID = it.value().toString();
@@ -545,9 +512,9 @@ void IrcMessageHandler::addMessage(Communi::IrcMessage *_message,
         {
             // Thread already exists (has a reply)
             auto thread = threadIt->second.lock();
-            updateReplyParticipatedStatus(tags, _message->nick(), builder,
+            updateReplyParticipatedStatus(tags, _message->nick(), *builder,
                                           thread, false);
-            builder.setThread(thread);
+            builder->setThread(thread);
         }
         else
         {
@@ -557,48 +524,77 @@ void IrcMessageHandler::addMessage(Communi::IrcMessage *_message,
             {
                 // Found root reply message
                 auto newThread = std::make_shared<MessageThread>(root);
-                updateReplyParticipatedStatus(tags, _message->nick(), builder,
+                updateReplyParticipatedStatus(tags, _message->nick(), *builder,
                                               newThread, true);
 
-                builder.setThread(newThread);
+                builder->setThread(newThread);
                 // Store weak reference to thread in channel
                 channel->addReplyThread(newThread);
             }
         }
     }
 
-    if (isSub || !builder.isIgnored())
-    {
+    auto build = [builder, isSub]() -> MessagePtr {
+        if (!isSub && builder->isIgnored())
+        {
+            return nullptr;
+        }
+
         if (isSub)
         {
-            builder->flags.set(MessageFlag::Subscription);
-            builder->flags.unset(MessageFlag::Highlighted);
+            (*builder)->flags.set(MessageFlag::Subscription);
+            (*builder)->flags.unset(MessageFlag::Highlighted);
+        }
+        return builder->build();
+    };
+
+    // Everything that looks at or modifies the channel happens here, on the
+    // GUI thread and in order
+    auto commit = [builder, chan, &server](const MessagePtr &msg) {
+        if (!msg)
+        {
+            return;
         }
-        auto msg = builder.build();
 
+        builder->applyBuildResults(msg);
         IrcMessageHandler::setSimilarityFlags(msg, chan);
 
         if (!msg->flags.has(MessageFlag::Similar) ||
             (!getSettings()->hideSimilar &&
              getSettings()->shownSimilarTriggerHighlights))
         {
-            builder.triggerHighlights();
+            builder->triggerHighlights();
         }
 
         const auto highlighted = msg->flags.has(MessageFlag::Highlighted);
         const auto showInMentions = msg->flags.has(MessageFlag::ShowInMentions);
 
+        // Messages are added in batches, once per event loop iteration
         if (highlighted && showInMentions)
         {
-            server.mentionsChannel->addMessage(msg);
+            server.mentionsChannel->queueMessage(msg);
         }
 
-        chan->addMessage(msg);
+        chan->queueMessage(msg);
         if (auto chatters = dynamic_cast<ChannelChatters *>(chan.get()))
         {
             chatters->addRecentChatter(msg->displayName);
         }
+    };
+
+    if (!concurrent)
+    {
+        commit(build());
+        return;
     }
+
+    queue.submit(target, [build, commit,
+                          ownedMessage]() -> OrderedWorkQueue::Commit {
+        auto msg = build();
+        return [commit, msg, ownedMessage] {
+            commit(msg);
+        };
+    });
 }
 
 void IrcMessageHandler::handleRoomStateMessage(Communi::IrcMessage *message)
@@ -847,6 +843,7 @@ void IrcMessageHandler::handleWhisperMessage(Communi::IrcMessage *message)
 
     builder->flags.set(MessageFlag::Whisper);
     MessagePtr _message = builder.build();
+    builder.applyBuildResults(_message);
     builder.triggerHighlights();
 
     getApp()->twitch->lastUserThatWhisperedMe.set(builder.userName);
@@ -900,7 +897,9 @@ std::vector<MessagePtr> IrcMessageHandler::parseUserNoticeMessage(
                                          false);
             builder->flags.set(MessageFlag::Subscription);
             builder->flags.unset(MessageFlag::Highlighted);
-            builtMessages.emplace_back(builder.build());
+            auto msg = builder.build();
+            builder.applyBuildResults(msg);
+            builtMessages.emplace_back(std::move(msg));
         }
     }
 
@@ -62,8 +62,6 @@ public:
     void handleJoinMessage(Communi::IrcMessage *message);
     void handlePartMessage(Communi::IrcMessage *message);
 
-    static float similarity(MessagePtr msg,
-                            const LimitedQueueSnapshot<MessagePtr> &messages);
     static void setSimilarityFlags(MessagePtr message, ChannelPtr channel);
 
 private:
@@ -87,6 +87,7 @@ TwitchChannel::TwitchChannel(const QString &name)
     , ffzEmotes_(std::make_shared<EmoteMap>())
     , seventvEmotes_(std::make_shared<EmoteMap>())
     , homiesEmotes_(std::make_shared<EmoteMap>())
+    , emoteIndex_(std::make_shared<const ChannelEmoteIndex>())
     , mod_(false)
 {
     qCDebug(chatterinoTwitch) << "[TwitchChannel" << name << "] Opened";
@@ -231,6 +232,7 @@ void TwitchChannel::refreshBTTVChannelEmotes(bool manualRefresh)
     if (!Settings::instance().enableBTTVChannelEmotes)
     {
         this->bttvEmotes_.set(EMPTY_EMOTE_MAP);
+        this->emoteMapChanged(ChannelEmoteIndex::Source::BttvChannel);
         return;
     }
 
@@ -238,8 +240,11 @@ void TwitchChannel::refreshBTTVChannelEmotes(bool manualRefresh)
         weakOf<Channel>(this), this->roomId(), this->getLocalizedName(),
         [this, weak = weakOf<Channel>(this)](auto &&emoteMap) {
             if (auto shared = weak.lock())
+            {
                 this->bttvEmotes_.set(
                     std::make_shared<EmoteMap>(std::move(emoteMap)));
+                this->emoteMapChanged(ChannelEmoteIndex::Source::BttvChannel);
+            }
         },
         manualRefresh);
 }
@@ -249,6 +254,7 @@ void TwitchChannel::refreshFFZChannelEmotes(bool manualRefresh)
     if (!Settings::instance().enableFFZChannelEmotes)
     {
         this->ffzEmotes_.set(EMPTY_EMOTE_MAP);
+        this->emoteMapChanged(ChannelEmoteIndex::Source::FfzChannel);
         return;
     }
 
@@ -256,8 +262,11 @@ void TwitchChannel::refreshFFZChannelEmotes(bool manualRefresh)
         weakOf<Channel>(this), this->roomId(),
         [this, weak = weakOf<Channel>(this)](auto &&emoteMap) {
             if (auto shared = weak.lock())
+            {
                 this->ffzEmotes_.set(
                     std::make_shared<EmoteMap>(std::move(emoteMap)));
+                this->emoteMapChanged(ChannelEmoteIndex::Source::FfzChannel);
+            }
         },
         [this, weak = weakOf<Channel>(this)](auto &&modBadge) {
             if (auto shared = weak.lock())
@@ -279,6 +288,7 @@ void TwitchChannel::refreshSevenTVChannelEmotes(bool manualRefresh)
     if (!Settings::instance().enableSevenTVChannelEmotes)
     {
         this->seventvEmotes_.set(EMPTY_EMOTE_MAP);
+        this->emoteMapChanged(ChannelEmoteIndex::Source::SeventvChannel);
         return;
     }
 
@@ -290,6 +300,8 @@ void TwitchChannel::refreshSevenTVChannelEmotes(bool manualRefresh)
             {
                 this->seventvEmotes_.set(std::make_shared<EmoteMap>(
                     std::forward<decltype(emoteMap)>(emoteMap)));
+                this->emoteMapChanged(
+                    ChannelEmoteIndex::Source::SeventvChannel);
                 this->updateSeventvData(channelInfo.userID,
                                         channelInfo.emoteSetID);
                 this->seventvUserTwitchConnectionIndex_ =
@@ -310,6 +322,7 @@ void TwitchChannel::refreshHomiesChannelEmotes(bool manualRefresh)
     if (!Settings::instance().enableHomiesChannelEmotes)
     {
         this->homiesEmotes_.set(EMPTY_EMOTE_MAP);
+        this->emoteMapChanged(ChannelEmoteIndex::Source::HomiesChannel);
         return;
     }
 
@@ -317,8 +330,11 @@ void TwitchChannel::refreshHomiesChannelEmotes(bool manualRefresh)
         weakOf<Channel>(this), this->roomId(),
         [this, weak = weakOf<Channel>(this)](auto &&emoteMap) {
             if (auto shared = weak.lock())
+            {
                 this->homiesEmotes_.set(
                     std::make_shared<EmoteMap>(std::move(emoteMap)));
+                this->emoteMapChanged(ChannelEmoteIndex::Source::HomiesChannel);
+            }
         },
         manualRefresh);
 }
@@ -331,7 +347,8 @@ void TwitchChannel::addChannelPointReward(const ChannelPointReward &reward)
     {
         MessageBuilder builder;
         TwitchMessageBuilder::appendChannelPointRewardMessage(
-            reward, &builder, this->isMod(), this->isBroadcaster());
+            reward, &builder, this->isMod(), this->isBroadcaster(),
+            *getIApp()->getAccounts()->twitch.getCurrent());
         this->addMessage(builder.release());
         return;
     }
@@ -692,6 +709,81 @@ std::shared_ptr<const EmoteMap> TwitchChannel::seventvEmotes() const
     return this->seventvEmotes_.get();
 }
 
+std::shared_ptr<const ChannelEmoteIndex> TwitchChannel::emoteIndex(
+    const ITwitchIrcServer &twitch) const
+{
+    auto index = this->emoteIndex_.get();
+    auto generation = ChannelEmoteIndex::currentGlobalsGeneration();
+    if (index->globalsGeneration() == generation)
+    {
+        return index;
+    }
+
+    // The global emotes changed since the index was built
+    std::lock_guard<std::mutex> guard(this->emoteIndexMutex_);
+    index = this->emoteIndex_.get();
+    if (index->globalsGeneration() != generation)
+    {
+        index = index->withGlobals(
+            twitch.getFfzEmotes().emotes(), twitch.getBttvEmotes().emotes(),
+            twitch.getSeventvEmotes().globalEmotes(),
+            twitch.getHomiesEmotes().emotes(), generation);
+        this->emoteIndex_.set(index);
+    }
+    return index;
+}
+
+std::shared_ptr<const EmoteMap> TwitchChannel::channelEmotes(
+    ChannelEmoteIndex::Source source) const
+{
+    switch (source)
+    {
+        case ChannelEmoteIndex::Source::FfzChannel:
+            return this->ffzEmotes_.get();
+        case ChannelEmoteIndex::Source::BttvChannel:
+            return this->bttvEmotes_.get();
+        case ChannelEmoteIndex::Source::SeventvChannel:
+            return this->seventvEmotes_.get();
+        case ChannelEmoteIndex::Source::HomiesChannel:
+            return this->homiesEmotes_.get();
+        default:
+            return nullptr;
+    }
+}
+
+void TwitchChannel::emoteMapChanged(ChannelEmoteIndex::Source source)
+{
+    auto map = this->channelEmotes(source);
+    if (!map)
+    {
+        // Global emotes are picked up lazily by emoteIndex()
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(this->emoteIndexMutex_);
+    auto index = this->emoteIndex_.get();
+    if (index->source(source) != map)
+    {
+        this->emoteIndex_.set(index->withSource(source, std::move(map)));
+    }
+}
+
+void TwitchChannel::emoteMapChanged(ChannelEmoteIndex::Source source,
+                                    std::initializer_list<EmoteName> names)
+{
+    auto map = this->channelEmotes(source);
+    if (!map)
+    {
+        return;
+    }
+
+    // Always resolved again, another live update might have published its
+    // map before this one got here
+    std::lock_guard<std::mutex> guard(this->emoteIndexMutex_);
+    auto index = this->emoteIndex_.get();
+    this->emoteIndex_.set(index->withEmotes(source, std::move(map), names));
+}
+
 const QString &TwitchChannel::seventvUserID() const
 {
     return this->seventvUserID_;
@@ -721,6 +813,8 @@ void TwitchChannel::addBttvEmote(
 {
     auto emote = BttvEmotes::addEmote(this->getDisplayName(), this->bttvEmotes_,
                                       message);
+    this->emoteMapChanged(ChannelEmoteIndex::Source::BttvChannel,
+                          {emote->name});
 
     this->addOrReplaceLiveUpdatesAddRemove(true, "BTTV", QString() /*actor*/,
                                            emote->name.string);
@@ -737,6 +831,9 @@ void TwitchChannel::updateBttvEmote(
     }
 
     const auto [oldEmote, newEmote] = *updated;
+    this->emoteMapChanged(ChannelEmoteIndex::Source::BttvChannel,
+                          {oldEmote->name, newEmote->name});
+
     if (oldEmote->name == newEmote->name)
     {
         return;  // only the creator changed
@@ -756,6 +853,8 @@ void TwitchChannel::removeBttvEmote(
     {
         return;
     }
+    this->emoteMapChanged(ChannelEmoteIndex::Source::BttvChannel,
+                          {removed.get()->name});
 
     this->addOrReplaceLiveUpdatesAddRemove(false, "BTTV", QString() /*actor*/,
                                            removed.get()->name.string);
@@ -764,10 +863,13 @@ void TwitchChannel::removeBttvEmote(
 void TwitchChannel::addSeventvEmote(
     const seventv::eventapi::EmoteAddDispatch &dispatch)
 {
-    if (!SeventvEmotes::addEmote(this->seventvEmotes_, dispatch))
+    auto added = SeventvEmotes::addEmote(this->seventvEmotes_, dispatch);
+    if (!added)
     {
         return;
     }
+    this->emoteMapChanged(ChannelEmoteIndex::Source::SeventvChannel,
+                          {added.get()->name});
 
     this->addOrReplaceLiveUpdatesAddRemove(
         true, "7TV", dispatch.actorName, dispatch.emoteJson["name"].toString());
@@ -776,10 +878,22 @@ void TwitchChannel::addSeventvEmote(
 void TwitchChannel::updateSeventvEmote(
     const seventv::eventapi::EmoteUpdateDispatch &dispatch)
 {
-    if (!SeventvEmotes::updateEmote(this->seventvEmotes_, dispatch))
+    // The name the emote had in our map, the dispatch might be out of date
+    auto oldMap = this->seventvEmotes_.get();
+    auto oldEmote = oldMap->findEmote(dispatch.oldEmoteName, dispatch.emoteID);
+    if (oldEmote == oldMap->end())
     {
         return;
     }
+    auto oldName = oldEmote->first;
+
+    auto updated = SeventvEmotes::updateEmote(this->seventvEmotes_, dispatch);
+    if (!updated)
+    {
+        return;
+    }
+    this->emoteMapChanged(ChannelEmoteIndex::Source::SeventvChannel,
+                          {oldName, updated.get()->name});
 
     auto builder =
         MessageBuilder(liveUpdatesUpdateEmoteMessage, "7TV", dispatch.actorName,
@@ -795,6 +909,8 @@ void TwitchChannel::removeSeventvEmote(
     {
         return;
     }
+    this->emoteMapChanged(ChannelEmoteIndex::Source::SeventvChannel,
+                          {removed.get()->name});
 
     this->addOrReplaceLiveUpdatesAddRemove(false, "7TV", dispatch.actorName,
                                            removed.get()->name.string);
@@ -819,6 +935,8 @@ void TwitchChannel::updateSeventvUser(
                 {
                     this->seventvEmotes_.set(
                         std::make_shared<EmoteMap>(emotes));
+                    this->emoteMapChanged(
+                        ChannelEmoteIndex::Source::SeventvChannel);
                     auto builder =
                         MessageBuilder(liveUpdatesUpdateEmoteSetMessage, "7TV",
                                        dispatch.actorName, name);
@@ -831,6 +949,8 @@ void TwitchChannel::updateSeventvUser(
                 if (auto shared = weak.lock())
                 {
                     this->seventvEmotes_.set(EMPTY_EMOTE_MAP);
+                    this->emoteMapChanged(
+                        ChannelEmoteIndex::Source::SeventvChannel);
                     this->addMessage(makeSystemMessage(
                         QString("Failed updating 7TV emote set (%1).")
                             .arg(reason)));
@@ -1723,22 +1843,15 @@ void TwitchChannel::upsertPersonalSeventvEmotes(
     const QString &userLogin, const std::shared_ptr<const EmoteMap> &emoteMap)
 {
     assertInGuiThread();
-    auto snapshot = this->getMessageSnapshot();
-    if (snapshot.size() == 0)
-    {
-        return;
-    }
 
     const auto findMessage = [&]() -> std::optional<MessagePtr> {
-        auto end = std::max<ptrdiff_t>(0, (ptrdiff_t)snapshot.size() - 5);
-
-        // explicitly using signed integers here to represent '-1'
-        for (ptrdiff_t i = (ptrdiff_t)snapshot.size() - 1; i >= end; i--)
+        // Only look at the last 5 messages of the channel
+        auto messages = this->getUserMessages(userLogin, 5);
+        for (auto it = messages.rbegin(); it != messages.rend(); ++it)
         {
-            const auto &message = snapshot[i];
-            if (message->loginName == userLogin)
+            if ((*it)->loginName == userLogin)
             {
-                return message;
+                return *it;
             }
         }
 
@@ -6,6 +6,7 @@
 #include "common/ChannelChatters.hpp"
 #include "common/Outcome.hpp"
 #include "common/UniqueAccess.hpp"
+#include "providers/twitch/ChannelEmoteIndex.hpp"
 #include "providers/twitch/TwitchEmotes.hpp"
 #include "util/QStringHash.hpp"
 
@@ -67,6 +68,7 @@ struct CheerEmoteSet;
 struct HelixStream;
 
 class TwitchIrcServer;
+class ITwitchIrcServer;
 
 class TwitchChannel : public Channel, public ChannelChatters
 {
@@ -144,6 +146,11 @@ public:
     std::shared_ptr<const EmoteMap> seventvEmotes() const;
     std::shared_ptr<const EmoteMap> homiesEmotes() const;
 
+    /// Channel and global third party emotes resolved by priority. Global
+    /// emotes that changed since the last call are taken from twitch.
+    std::shared_ptr<const ChannelEmoteIndex> emoteIndex(
+        const ITwitchIrcServer &twitch) const;
+
     const QString &seventvUserId() const;
     const QString &seventvEmoteSetId() const;
 
@@ -227,6 +234,15 @@ private:
 private:
     // Methods
     void refreshLiveStatus();
+    /// Updates the emote index after the map of source was replaced
+    void emoteMapChanged(ChannelEmoteIndex::Source source);
+    /// Updates the emote index after a live update of the map of source that
+    /// only changed the emotes called names
+    void emoteMapChanged(ChannelEmoteIndex::Source source,
+                         std::initializer_list<EmoteName> names);
+    /// The channel emotes of source, nullptr for the global sources
+    std::shared_ptr<const EmoteMap> channelEmotes(
+        ChannelEmoteIndex::Source source) const;
     void parseLiveStatus(bool live, const HelixStream &stream);
     void refreshPubSub();
     void refreshChatters();
@@ -309,6 +325,10 @@ protected:
     Atomic<boost::optional<EmotePtr>> ffzCustomModBadge_;
     Atomic<boost::optional<EmotePtr>> ffzCustomVipBadge_;
 
+    // Serializes updates of emoteIndex_, reads don't need it
+    mutable std::mutex emoteIndexMutex_;
+    mutable Atomic<std::shared_ptr<const ChannelEmoteIndex>> emoteIndex_;
+
 private:
     // Badges
     UniqueAccess<std::map<QString, std::map<QString, EmotePtr>>>
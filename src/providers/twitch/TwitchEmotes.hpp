@@ -1,14 +1,13 @@
 #pragma once
 
 #include "common/Aliases.hpp"
-#include "common/UniqueAccess.hpp"
+#include "util/WeakCache.hpp"
 
 #include <QColor>
 #include <QRegularExpression>
 #include <QString>
 
 #include <memory>
-#include <unordered_map>
 
 // NB: "default" can be replaced with "static" to always get a non-animated
 // variant
@@ -46,15 +45,14 @@ class TwitchEmotes : public ITwitchEmotes
 {
 public:
     static QString cleanUpEmoteCode(const QString &dirtyEmoteCode);
-    TwitchEmotes() = default;
+    TwitchEmotes();
 
     EmotePtr getOrCreateEmote(const EmoteId &id,
                               const EmoteName &name) override;
 
 private:
     Url getEmoteLink(const EmoteId &id, const QString &emoteScale);
-    UniqueAccess<std::unordered_map<EmoteId, std::weak_ptr<Emote>>>
-        twitchEmotesCache_;
+    WeakCache<EmoteId, const Emote> twitchEmotesCache_;
 };
 
 }  // namespace chatterino
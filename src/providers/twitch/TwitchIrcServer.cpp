@@ -21,6 +21,7 @@
 
 #include <IrcCommand>
 #include <QMetaEnum>
+#include <QThread>
 
 #include <cassert>
 
@@ -43,6 +44,7 @@ TwitchIrcServer::TwitchIrcServer()
     , mentionsChannel(new Channel("/mentions", Channel::Type::TwitchMentions))
     , liveChannel(new Channel("/live", Channel::Type::TwitchLive))
     , watchingChannel(Channel::getEmpty(), Channel::Type::TwitchWatching)
+    , messageBuildQueue_(QThread::idealThreadCount() - 1)
 {
     this->initializeIrc();
 
@@ -174,6 +176,26 @@ void TwitchIrcServer::readConnectionMessageReceived(
         return;
     }
 
+    // Channel events (e.g. CLEARMSG) must not overtake chat messages of the
+    // same channel that are still being built
+    if (auto target = message->parameter(0);
+        target.startsWith('#') && this->messageBuildQueue_.hasPending(target))
+    {
+        std::shared_ptr<Communi::IrcMessage> clone(
+            message->clone(), [](Communi::IrcMessage *message) {
+                message->deleteLater();
+            });
+        this->messageBuildQueue_.post(target, [this, clone] {
+            this->handleReadConnectionMessage(clone.get());
+        });
+        return;
+    }
+
+    this->handleReadConnectionMessage(message);
+}
+
+void TwitchIrcServer::handleReadConnectionMessage(Communi::IrcMessage *message)
+{
     const QString &command = message->command();
 
     auto &handler = IrcMessageHandler::instance();
@@ -504,6 +526,11 @@ const HomiesEmotes &TwitchIrcServer::getHomiesEmotes() const
     return this->homies;
 }
 
+OrderedWorkQueue &TwitchIrcServer::messageBuildQueue()
+{
+    return this->messageBuildQueue_;
+}
+
 void TwitchIrcServer::reloadBTTVGlobalEmotes()
 {
     this->bttv.loadEmotes();
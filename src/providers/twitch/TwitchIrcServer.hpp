@@ -8,6 +8,7 @@
 #include "providers/homies/HomiesEmotes.hpp"
 #include "providers/irc/AbstractIrcServer.hpp"
 #include "providers/seventv/SeventvEmotes.hpp"
+#include "util/OrderedWorkQueue.hpp"
 
 #include <pajlada/signals/signalholder.hpp>
 
@@ -93,6 +94,13 @@ public:
     const SeventvEmotes &getSeventvEmotes() const override;
     const HomiesEmotes &getHomiesEmotes() const override;
 
+    /**
+     * Builds chat messages on background threads while keeping the order of
+     * messages within a channel. Lanes are the channel targets ("#name").
+     * See Settings::buildMessagesConcurrently.
+     */
+    OrderedWorkQueue &messageBuildQueue();
+
 protected:
     virtual void initializeConnection(IrcConnection *connection,
                                       ConnectionType type) override;
@@ -113,6 +121,8 @@ protected:
     virtual bool hasSeparateWriteConnection() const override;
 
 private:
+    void handleReadConnectionMessage(Communi::IrcMessage *message);
+
     void onMessageSendRequested(TwitchChannel *channel, const QString &message,
                                 bool &sent);
     void onReplySendRequested(TwitchChannel *channel, const QString &message,
@@ -132,6 +142,8 @@ private:
     HomiesEmotes homies;
     QTimer bulkLiveStatusTimer_;
 
+    OrderedWorkQueue messageBuildQueue_;
+
     pajlada::Signals::SignalHolder signalHolder_;
 };
 
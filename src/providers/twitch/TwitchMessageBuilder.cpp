@@ -4,9 +4,12 @@
 #include "common/LinkParser.hpp"
 #include "common/QLogging.hpp"
 #include "controllers/accounts/AccountController.hpp"
+#include "controllers/highlights/HighlightController.hpp"
 #include "controllers/ignores/IgnoreController.hpp"
 #include "controllers/ignores/IgnorePhrase.hpp"
+#include "controllers/ignores/IgnoreReplacer.hpp"
 #include "controllers/userdata/UserDataController.hpp"
+#include "debug/AssertInGuiThread.hpp"
 #include "messages/Emote.hpp"
 #include "messages/Image.hpp"
 #include "messages/Message.hpp"
@@ -18,6 +21,7 @@
 #include "providers/seventv/SeventvBadges.hpp"
 #include "providers/seventv/SeventvPersonalEmotes.hpp"
 #include "providers/twitch/api/Helix.hpp"
+#include "providers/twitch/ChannelEmoteIndex.hpp"
 #include "providers/twitch/ChannelPointReward.hpp"
 #include "providers/twitch/PubSubActions.hpp"
 #include "providers/twitch/TwitchAccount.hpp"
@@ -40,6 +44,10 @@
 #include <QDebug>
 #include <QStringRef>
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
 namespace {
 
 const QString regexHelpString("(\\w+)[.,!?;:]*?$");
@@ -50,51 +58,89 @@ const QRegularExpression mentionRegex("^@" + regexHelpString);
 // if findAllUsernames setting is enabled, matches strings like in the examples above, but without @ symbol at the beginning
 const QRegularExpression allUsernamesMentionRegex("^" + regexHelpString);
 
-const QSet<QString> zeroWidthEmotes{
-    "SoSnowy",  "IceCold",   "SantaHat", "TopHat",
-    "ReinDeer", "CandyCane", "cvMask",   "cvHazmat",
-};
-
 }  // namespace
 
 namespace chatterino {
 
 namespace {
 
-    void appendTwitchEmoteOccurrences(const QString &emote,
-                                      std::vector<TwitchEmoteOccurrence> &vec,
-                                      const std::vector<int> &correctPositions,
-                                      const QString &originalMessage,
-                                      int messageOffset)
+    // Returns the text from pos up to the next separator and moves pos past
+    // the separator. pos ends up beyond text.size() once there are no more
+    // fields, like QString::split every separator starts a new field.
+    QStringView nextField(QStringView text, qsizetype &pos, QChar separator)
     {
-        auto *app = getIApp();
-        if (!emote.contains(':'))
+        auto start = pos;
+        while (pos < text.size() && text[pos] != separator)
         {
-            return;
+            ++pos;
         }
 
-        auto parameters = emote.split(':');
+        auto field = text.mid(start, pos - start);
+        ++pos;
+        return field;
+    }
+
+    // Like QString::toUInt, invalid numbers are 0
+    unsigned int parseUInt(QStringView text)
+    {
+        if (text.isEmpty())
+        {
+            return 0;
+        }
 
-        if (parameters.length() < 2)
+        uint64_t value = 0;
+        for (auto c : text)
+        {
+            if (c < u'0' || c > u'9')
+            {
+                return 0;
+            }
+
+            value = value * 10 + (c.unicode() - u'0');
+            if (value > std::numeric_limits<unsigned int>::max())
+            {
+                return 0;
+            }
+        }
+
+        return static_cast<unsigned int>(value);
+    }
+
+    // emote has the format "id:from-to,from-to"
+    void appendTwitchEmoteOccurrences(ITwitchEmotes &twitchEmotes,
+                                      QStringView emote,
+                                      std::vector<TwitchEmoteOccurrence> &vec,
+                                      const std::vector<int> &correctPositions,
+                                      const QString &originalMessage,
+                                      int messageOffset)
+    {
+        qsizetype pos = 0;
+        auto idField = nextField(emote, pos, u':');
+        if (pos > emote.size())
         {
+            // There's no ':'
             return;
         }
 
-        auto id = EmoteId{parameters.at(0)};
+        auto id = EmoteId{idField.toString()};
 
-        auto occurrences = parameters.at(1).split(',');
+        auto occurrences = nextField(emote, pos, u':');
 
-        for (const QString &occurrence : occurrences)
+        for (qsizetype occurrencePos = 0; occurrencePos <= occurrences.size();)
         {
-            auto coords = occurrence.split('-');
+            auto occurrence = nextField(occurrences, occurrencePos, u',');
 
-            if (coords.length() < 2)
+            qsizetype coordPos = 0;
+            auto fromField = nextField(occurrence, coordPos, u'-');
+            if (coordPos > occurrence.size())
             {
+                // There's no '-'
                 return;
             }
+            auto toField = nextField(occurrence, coordPos, u'-');
 
-            auto from = coords.at(0).toUInt() - messageOffset;
-            auto to = coords.at(1).toUInt() - messageOffset;
+            auto from = parseUInt(fromField) - messageOffset;
+            auto to = parseUInt(toField) - messageOffset;
             auto maxPositions = correctPositions.size();
             if (from > to || to >= maxPositions)
             {
@@ -120,7 +166,7 @@ namespace {
             TwitchEmoteOccurrence emoteOccurrence{
                 start,
                 end,
-                app->getEmotes()->getTwitchEmotes()->getOrCreateEmote(id, name),
+                twitchEmotes.getOrCreateEmote(id, name),
                 name,
             };
             if (emoteOccurrence.ptr == nullptr)
@@ -132,6 +178,33 @@ namespace {
         }
     }
 
+    bool doesWordContainATwitchEmote(
+        int cursor, qsizetype wordLength,
+        const std::vector<TwitchEmoteOccurrence> &twitchEmotes,
+        std::vector<TwitchEmoteOccurrence>::const_iterator
+            &currentTwitchEmoteIt)
+    {
+        if (currentTwitchEmoteIt == twitchEmotes.end())
+        {
+            // No emote to add!
+            return false;
+        }
+
+        const auto &currentTwitchEmote = *currentTwitchEmoteIt;
+
+        auto wordEnd = cursor + wordLength;
+
+        // Check if this emote fits within the word boundaries
+        if (currentTwitchEmote.start < cursor ||
+            currentTwitchEmote.end > wordEnd)
+        {
+            // this emote does not fit xd
+            return false;
+        }
+
+        return true;
+    }
+
 }  // namespace
 
 TwitchMessageBuilder::TwitchMessageBuilder(
@@ -139,6 +212,10 @@ TwitchMessageBuilder::TwitchMessageBuilder(
     const MessageParseArgs &_args)
     : SharedMessageBuilder(_channel, _ircMessage, _args)
     , twitchChannel(dynamic_cast<TwitchChannel *>(_channel))
+    , app_(getIApp())
+    , currentUser_(this->app_->getAccounts()->twitch.getCurrent())
+    , channelIsMod_(_channel->isMod())
+    , channelIsBroadcaster_(_channel->isBroadcaster())
 {
 }
 
@@ -147,28 +224,36 @@ TwitchMessageBuilder::TwitchMessageBuilder(
     const MessageParseArgs &_args, QString content, bool isAction)
     : SharedMessageBuilder(_channel, _ircMessage, _args, content, isAction)
     , twitchChannel(dynamic_cast<TwitchChannel *>(_channel))
+    , app_(getIApp())
+    , currentUser_(this->app_->getAccounts()->twitch.getCurrent())
+    , channelIsMod_(_channel->isMod())
+    , channelIsBroadcaster_(_channel->isBroadcaster())
 {
 }
 
 bool TwitchMessageBuilder::isIgnored() const
 {
-    return isIgnoredMessage({
-        /*.message = */ this->originalMessage_,
-        /*.twitchUserID = */ this->tags.value("user-id").toString(),
-        /*.isMod = */ this->channel->isMod(),
-        /*.isBroadcaster = */ this->channel->isBroadcaster(),
-    });
+    return isIgnoredMessage(
+        {
+            /*.message = */ this->originalMessage_,
+            /*.twitchUserID = */ this->tags.value("user-id").toString(),
+            /*.isMod = */ this->channelIsMod_,
+            /*.isBroadcaster = */ this->channelIsBroadcaster_,
+        },
+        *this->currentUser_);
 }
 
 bool TwitchMessageBuilder::isIgnoredReply() const
 {
-    return isIgnoredMessage({
-        /*.message = */ this->originalMessage_,
-        /*.twitchUserID = */
-        this->tags.value("reply-parent-user-id").toString(),
-        /*.isMod = */ this->channel->isMod(),
-        /*.isBroadcaster = */ this->channel->isBroadcaster(),
-    });
+    return isIgnoredMessage(
+        {
+            /*.message = */ this->originalMessage_,
+            /*.twitchUserID = */
+            this->tags.value("reply-parent-user-id").toString(),
+            /*.isMod = */ this->channelIsMod_,
+            /*.isBroadcaster = */ this->channelIsBroadcaster_,
+        },
+        *this->currentUser_);
 }
 
 void TwitchMessageBuilder::triggerHighlights()
@@ -208,8 +293,8 @@ MessagePtr TwitchMessageBuilder::build()
         if (reward)
         {
             this->appendChannelPointRewardMessage(
-                reward.get(), this, this->channel->isMod(),
-                this->channel->isBroadcaster());
+                reward.get(), this, this->channelIsMod_,
+                this->channelIsBroadcaster_, *this->currentUser_);
         }
     }
 
@@ -278,7 +363,8 @@ MessagePtr TwitchMessageBuilder::build()
 
     // Twitch emotes
     auto twitchEmotes = TwitchMessageBuilder::parseTwitchEmotes(
-        this->tags, this->originalMessage_, this->messageOffset_);
+        *this->app_->getEmotes()->getTwitchEmotes(), this->tags,
+        this->originalMessage_, this->messageOffset_);
 
     // This runs through all ignored phrases and runs its replacements on this->originalMessage_
     this->runIgnoreReplaces(twitchEmotes);
@@ -294,9 +380,10 @@ MessagePtr TwitchMessageBuilder::build()
                        twitchEmotes.end());
 
     // words
-    QStringList splits = this->originalMessage_.split(' ');
+    auto tokens = TwitchMessageBuilder::tokenizeMessage(this->originalMessage_,
+                                                        twitchEmotes);
 
-    this->addWords(splits, twitchEmotes);
+    this->addWords(tokens);
 
     this->message().messageText = this->originalMessage_;
     this->message().searchText = this->message().localizedName + " " +
@@ -333,48 +420,58 @@ MessagePtr TwitchMessageBuilder::build()
     return this->release();
 }
 
-bool doesWordContainATwitchEmote(
-    int cursor, const QString &word,
-    const std::vector<TwitchEmoteOccurrence> &twitchEmotes,
-    std::vector<TwitchEmoteOccurrence>::const_iterator &currentTwitchEmoteIt)
+void TwitchMessageBuilder::applyBuildResults(const MessagePtr &message)
 {
-    if (currentTwitchEmoteIt == twitchEmotes.end())
-    {
-        // No emote to add!
-        return false;
-    }
+    assertInGuiThread();
 
-    const auto &currentTwitchEmote = *currentTwitchEmoteIt;
+    if (this->twitchChannel != nullptr)
+    {
+        if (!this->roomID_.isEmpty() &&
+            this->twitchChannel->roomId().isEmpty())
+        {
+            this->twitchChannel->setRoomId(this->roomID_);
+        }
 
-    auto wordEnd = cursor + word.length();
+        this->twitchChannel->setUserColor(this->userName, this->usernameColor_);
+    }
 
-    // Check if this emote fits within the word boundaries
-    if (currentTwitchEmote.start < cursor || currentTwitchEmote.end > wordEnd)
+    if (this->thread_)
     {
-        // this emote does not fit xd
-        return false;
+        this->thread_->addToThread(message);
     }
 
-    return true;
+    // Update current user color if this is our message
+    if (this->ircMessage->nick() == this->currentUser_->getUserName())
+    {
+        this->currentUser_->setColor(this->usernameColor_);
+    }
 }
 
-void TwitchMessageBuilder::addWords(
-    const QStringList &words,
+std::vector<MessageToken> TwitchMessageBuilder::tokenizeMessage(
+    const QString &message,
     const std::vector<TwitchEmoteOccurrence> &twitchEmotes)
 {
+    std::vector<MessageToken> tokens;
+    const QStringView messageView(message);
+
     // cursor currently indicates what character index we're currently operating in the full list of words
     int cursor = 0;
     auto currentTwitchEmoteIt = twitchEmotes.begin();
 
-    for (auto word : words)
+    // Every space starts a new word, so consecutive spaces make empty words
+    for (qsizetype wordStart = 0; wordStart <= messageView.size();)
     {
+        auto word = nextField(messageView, wordStart, u' ');
+        // Position of word in the message
+        auto offset = static_cast<int>(wordStart - word.size() - 1);
+
         if (word.isEmpty())
         {
             cursor++;
             continue;
         }
 
-        while (doesWordContainATwitchEmote(cursor, word, twitchEmotes,
+        while (doesWordContainATwitchEmote(cursor, word.size(), twitchEmotes,
                                            currentTwitchEmoteIt))
         {
             const auto &currentTwitchEmote = *currentTwitchEmoteIt;
@@ -382,13 +479,14 @@ void TwitchMessageBuilder::addWords(
             if (currentTwitchEmote.start == cursor)
             {
                 // This emote exists right at the start of the word!
-                this->emplace<EmoteElement>(currentTwitchEmote.ptr,
-                                            MessageElementFlag::TwitchEmote,
-                                            this->textColor_);
-
                 auto len = currentTwitchEmote.name.string.length();
+                auto emoteLength = std::min<qsizetype>(len, word.size());
+                tokens.push_back({offset, word.left(emoteLength),
+                                  &currentTwitchEmote});
+
                 cursor += len;
-                word = word.mid(len);
+                word = word.mid(emoteLength);
+                offset += static_cast<int>(emoteLength);
 
                 ++currentTwitchEmoteIt;
 
@@ -400,28 +498,19 @@ void TwitchMessageBuilder::addWords(
                 }
                 else
                 {
-                    this->message().elements.back()->setTrailingSpace(false);
+                    tokens.back().trailingSpace = false;
                 }
 
                 continue;
             }
 
-            // Emote is not at the start
-
-            // 1. Add text before the emote
-            QString preText = word.left(currentTwitchEmote.start - cursor);
-            for (auto &variant : getApp()->emotes->emojis.parse(preText))
-            {
-                boost::apply_visitor(
-                    [&](auto &&arg) {
-                        this->addTextOrEmoji(arg);
-                    },
-                    variant);
-            }
-
-            cursor += preText.size();
+            // Emote is not at the start, add the text before the emote
+            auto preText = word.left(currentTwitchEmote.start - cursor);
+            tokens.push_back({offset, preText});
 
+            cursor += static_cast<int>(preText.size());
             word = word.mid(preText.size());
+            offset += static_cast<int>(preText.size());
         }
 
         if (word.isEmpty())
@@ -429,8 +518,33 @@ void TwitchMessageBuilder::addWords(
             continue;
         }
 
-        // split words
-        for (auto &variant : getApp()->emotes->emojis.parse(word))
+        tokens.push_back({offset, word});
+
+        cursor += static_cast<int>(word.size()) + 1;
+    }
+
+    return tokens;
+}
+
+void TwitchMessageBuilder::addWords(const std::vector<MessageToken> &tokens)
+{
+    for (const auto &token : tokens)
+    {
+        if (token.twitchEmote != nullptr)
+        {
+            this->emplace<EmoteElement>(token.twitchEmote->ptr,
+                                        MessageElementFlag::TwitchEmote,
+                                        this->textColor_);
+            if (!token.trailingSpace)
+            {
+                this->message().elements.back()->setTrailingSpace(false);
+            }
+            continue;
+        }
+
+        // Only text is copied out of the message, emojis split it further
+        for (auto &variant :
+             this->app_->getEmotes()->getEmojis()->parse(token.text.toString()))
         {
             boost::apply_visitor(
                 [&](auto &&arg) {
@@ -438,8 +552,6 @@ void TwitchMessageBuilder::addWords(
                 },
                 variant);
         }
-
-        cursor += word.size() + 1;
     }
 }
 
@@ -600,12 +712,8 @@ void TwitchMessageBuilder::parseRoomID()
 
     if (iterator != std::end(this->tags))
     {
+        // The channel gets it in applyBuildResults
         this->roomID_ = iterator.value().toString();
-
-        if (this->twitchChannel->roomId().isEmpty())
-        {
-            this->twitchChannel->setRoomId(this->roomID_);
-        }
     }
 }
 
@@ -613,9 +721,9 @@ void TwitchMessageBuilder::parseThread()
 {
     if (this->thread_)
     {
-        // set references
+        // set references, the message is added to the thread in
+        // applyBuildResults
         this->message().replyThread = this->thread_;
-        this->thread_->addToThread(this->weakOf());
 
         // enable reply flag
         this->message().flags.set(MessageFlag::ReplyMessage);
@@ -689,7 +797,7 @@ void TwitchMessageBuilder::parseThread()
 
 void TwitchMessageBuilder::parseUsernameColor()
 {
-    const auto *userData = getIApp()->getUserData();
+    const auto *userData = this->app_->getUserData();
     assert(userData != nullptr);
 
     if (const auto &user = userData->getUser(this->userId_))
@@ -737,23 +845,15 @@ void TwitchMessageBuilder::parseUsername()
     //    }
 
     this->message().loginName = this->userName;
-    if (this->twitchChannel != nullptr)
-    {
-        this->twitchChannel->setUserColor(this->userName, this->usernameColor_);
-    }
+}
 
-    // Update current user color if this is our message
-    auto currentUser = getApp()->accounts->twitch.getCurrent();
-    if (this->ircMessage->nick() == currentUser->getUserName())
-    {
-        currentUser->setColor(this->usernameColor_);
-    }
+void TwitchMessageBuilder::parseHighlights()
+{
+    this->checkHighlights(*this->app_->getHighlights());
 }
 
 void TwitchMessageBuilder::appendUsername()
 {
-    auto app = getApp();
-
     QString username = this->userName;
     this->message().loginName = username;
     QString localizedName;
@@ -797,7 +897,7 @@ void TwitchMessageBuilder::appendUsername()
                                    FontStyle::ChatMediumBold)
             ->setLink({Link::UserWhisper, this->message().displayName});
 
-        auto currentUser = app->accounts->twitch.getCurrent();
+        const auto &currentUser = this->currentUser_;
 
         // Separator
         this->emplace<TextElement>("->", MessageElementFlag::Username,
@@ -829,240 +929,144 @@ void TwitchMessageBuilder::appendUsername()
 void TwitchMessageBuilder::runIgnoreReplaces(
     std::vector<TwitchEmoteOccurrence> &twitchEmotes)
 {
-    auto phrases = getCSettings().ignoredMessages.readOnly();
-    auto removeEmotesInRange = [](int pos, int len,
-                                  auto &twitchEmotes) mutable {
-        auto it = std::partition(
-            twitchEmotes.begin(), twitchEmotes.end(),
-            [pos, len](const auto &item) {
-                return !((item.start >= pos) && item.start < (pos + len));
+    auto replacer = ignoreReplacer();
+    if (replacer->empty())
+    {
+        return;
+    }
+
+    auto replacements = replacer->replace(this->originalMessage_);
+    if (replacements.empty())
+    {
+        return;
+    }
+    const auto &message = this->originalMessage_;
+
+    // Emotes starting in a replaced text are removed, the others are moved by
+    // how much the replacements before them changed the length
+    std::vector<std::vector<TwitchEmoteOccurrence>> removedEmotes(
+        replacements.size());
+    auto kept = twitchEmotes.begin();
+    for (auto &emote : twitchEmotes)
+    {
+        auto next = std::upper_bound(
+            replacements.begin(), replacements.end(), emote.start,
+            [](int start, const IgnoreReplacement &replacement) {
+                return start < replacement.start + replacement.length;
             });
-        for (auto copy = it; copy != twitchEmotes.end(); ++copy)
-        {
-            if ((*copy).ptr == nullptr)
-            {
-                qCDebug(chatterinoTwitch)
-                    << "remem nullptr" << (*copy).name.string;
-            }
-        }
-        std::vector<TwitchEmoteOccurrence> v(it, twitchEmotes.end());
-        twitchEmotes.erase(it, twitchEmotes.end());
-        return v;
-    };
 
-    auto shiftIndicesAfter = [&twitchEmotes](int pos, int by) mutable {
-        for (auto &item : twitchEmotes)
+        if (next != replacements.end() && next->start <= emote.start)
         {
-            auto &index = item.start;
-            if (index >= pos)
-            {
-                index += by;
-                item.end += by;
-            }
+            removedEmotes[next - replacements.begin()].push_back(
+                std::move(emote));
+            continue;
         }
-    };
 
-    auto addReplEmotes = [&twitchEmotes](const IgnorePhrase &phrase,
-                                         const auto &midrepl,
-                                         int startIndex) mutable {
-        if (!phrase.containsEmote())
+        if (next != replacements.begin())
         {
-            return;
+            const auto &previous = *std::prev(next);
+            auto by = (previous.newStart + previous.newLength) -
+                      (previous.start + previous.length);
+            emote.start += by;
+            emote.end += by;
         }
-
-        auto words = midrepl.split(' ');
-        int pos = 0;
-        for (const auto &word : words)
+        if (&*kept != &emote)
         {
-            for (const auto &emote : phrase.getEmotes())
-            {
-                if (word == emote.first.string)
-                {
-                    if (emote.second == nullptr)
-                    {
-                        qCDebug(chatterinoTwitch)
-                            << "emote null" << emote.first.string;
-                    }
-                    twitchEmotes.push_back(TwitchEmoteOccurrence{
-                        startIndex + pos,
-                        startIndex + pos + (int)emote.first.string.length(),
-                        emote.second,
-                        emote.first,
-                    });
-                }
-            }
-            pos += word.length() + 1;
+            *kept = std::move(emote);
         }
-    };
+        ++kept;
+    }
+    twitchEmotes.erase(kept, twitchEmotes.end());
 
-    for (const auto &phrase : *phrases)
+    // Emotes of the current account that are written in a replacement are
+    // shown as emotes
+    const auto accountEmotes = this->currentUser_->accessEmotes();
+
+    for (size_t i = 0; i < replacements.size(); ++i)
     {
-        if (phrase.isBlock())
+        const auto &replacement = replacements[i];
+        const auto &replace = replacement.phrase->getReplace();
+        if (removedEmotes[i].empty() && replace.isEmpty())
         {
             continue;
         }
-        const auto &pattern = phrase.getPattern();
-        if (pattern.isEmpty())
+
+        // The words the replacement is part of
+        int wordsStart = replacement.newStart;
+        while (wordsStart > 0 && message[wordsStart - 1] != ' ')
         {
-            continue;
+            --wordsStart;
         }
-        if (phrase.isRegex())
+        int wordsEnd = replacement.newStart + replacement.newLength;
+        while (wordsEnd < message.length() && message[wordsEnd] != ' ')
         {
-            const auto &regex = phrase.getRegex();
-            if (!regex.isValid())
+            ++wordsEnd;
+        }
+
+        // Removed emotes are kept if they're still there after the
+        // replacement
+        for (auto &emote : removedEmotes[i])
+        {
+            if (emote.ptr == nullptr)
             {
+                qCDebug(chatterinoTwitch) << "v nullptr" << emote.name.string;
                 continue;
             }
-            QRegularExpressionMatch match;
-            int from = 0;
-            while ((from = this->originalMessage_.indexOf(regex, from,
-                                                          &match)) != -1)
-            {
-                int len = match.capturedLength();
-                auto vret = removeEmotesInRange(from, len, twitchEmotes);
-                auto mid = this->originalMessage_.mid(from, len);
-                mid.replace(regex, phrase.getReplace());
-
-                int midsize = mid.size();
-                this->originalMessage_.replace(from, len, mid);
-                int pos1 = from;
-                while (pos1 > 0)
-                {
-                    if (this->originalMessage_[pos1 - 1] == ' ')
-                    {
-                        break;
-                    }
-                    --pos1;
-                }
-                int pos2 = from + midsize;
-                while (pos2 < this->originalMessage_.length())
-                {
-                    if (this->originalMessage_[pos2] == ' ')
-                    {
-                        break;
-                    }
-                    ++pos2;
-                }
-
-                shiftIndicesAfter(from + len, midsize - len);
 
-#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
-                auto midExtendedRef =
-                    QStringView{this->originalMessage_}.mid(pos1, pos2 - pos1);
-#else
-                auto midExtendedRef =
-                    this->originalMessage_.midRef(pos1, pos2 - pos1);
-#endif
-
-                for (auto &tup : vret)
-                {
-                    if (tup.ptr == nullptr)
-                    {
-                        qCDebug(chatterinoTwitch)
-                            << "v nullptr" << tup.name.string;
-                        continue;
-                    }
-                    QRegularExpression emoteregex(
-                        "\\b" + tup.name.string + "\\b",
-                        QRegularExpression::UseUnicodePropertiesOption);
-                    auto _match = emoteregex.match(midExtendedRef);
-                    if (_match.hasMatch())
-                    {
-                        int last = _match.lastCapturedIndex();
-                        for (int i = 0; i <= last; ++i)
-                        {
-                            tup.start = from + _match.capturedStart();
-                            twitchEmotes.push_back(std::move(tup));
-                        }
-                    }
-                }
-
-                addReplEmotes(phrase, midExtendedRef, pos1);
-
-                from += midsize;
+            QRegularExpression emoteRegex(
+                "\\b" + QRegularExpression::escape(emote.name.string) +
+                    "\\b",
+                QRegularExpression::UseUnicodePropertiesOption);
+            auto match = emoteRegex.match(message, wordsStart);
+            if (match.hasMatch() && match.capturedEnd() <= wordsEnd)
+            {
+                emote.start = match.capturedStart();
+                emote.end = match.capturedEnd() - 1;
+                twitchEmotes.push_back(std::move(emote));
             }
         }
-        else
-        {
-            int from = 0;
-            while ((from = this->originalMessage_.indexOf(
-                        pattern, from, phrase.caseSensitivity())) != -1)
-            {
-                int len = pattern.size();
-                auto vret = removeEmotesInRange(from, len, twitchEmotes);
-                auto replace = phrase.getReplace();
-
-                int replacesize = replace.size();
-                this->originalMessage_.replace(from, len, replace);
-
-                int pos1 = from;
-                while (pos1 > 0)
-                {
-                    if (this->originalMessage_[pos1 - 1] == ' ')
-                    {
-                        break;
-                    }
-                    --pos1;
-                }
-                int pos2 = from + replacesize;
-                while (pos2 < this->originalMessage_.length())
-                {
-                    if (this->originalMessage_[pos2] == ' ')
-                    {
-                        break;
-                    }
-                    ++pos2;
-                }
 
-                shiftIndicesAfter(from + len, replacesize - len);
+        if (replace.isEmpty())
+        {
+            continue;
+        }
 
-#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
-                auto midExtendedRef =
-                    QStringView{this->originalMessage_}.mid(pos1, pos2 - pos1);
-#else
-                auto midExtendedRef =
-                    this->originalMessage_.midRef(pos1, pos2 - pos1);
-#endif
+        const auto &emotes = accountEmotes->emotes;
+        for (int wordStart = wordsStart; wordStart <= wordsEnd;)
+        {
+            auto wordEnd = message.indexOf(' ', wordStart);
+            if (wordEnd == -1 || wordEnd > wordsEnd)
+            {
+                wordEnd = wordsEnd;
+            }
 
-                for (auto &tup : vret)
+            auto word = message.mid(wordStart, wordEnd - wordStart);
+            auto it = word.isEmpty() || !replace.contains(word)
+                          ? emotes.end()
+                          : emotes.find(EmoteName{word});
+            if (it != emotes.end())
+            {
+                if (it->second == nullptr)
                 {
-                    if (tup.ptr == nullptr)
-                    {
-                        qCDebug(chatterinoTwitch)
-                            << "v nullptr" << tup.name.string;
-                        continue;
-                    }
-                    QRegularExpression emoteregex(
-                        "\\b" + tup.name.string + "\\b",
-                        QRegularExpression::UseUnicodePropertiesOption);
-                    auto match = emoteregex.match(midExtendedRef);
-                    if (match.hasMatch())
-                    {
-                        int last = match.lastCapturedIndex();
-                        for (int i = 0; i <= last; ++i)
-                        {
-                            tup.start = from + match.capturedStart();
-                            twitchEmotes.push_back(std::move(tup));
-                        }
-                    }
+                    qCDebug(chatterinoTwitch)
+                        << "emote null" << it->first.string;
                 }
-
-                addReplEmotes(phrase, midExtendedRef, pos1);
-
-                from += replacesize;
+                twitchEmotes.push_back(TwitchEmoteOccurrence{
+                    wordStart,
+                    static_cast<int>(wordEnd) - 1,
+                    it->second,
+                    it->first,
+                });
             }
+
+            wordStart = static_cast<int>(wordEnd) + 1;
         }
     }
 }
 
 Outcome TwitchMessageBuilder::tryAppendEmote(const EmoteName &name)
 {
-    auto *app = getApp();
-
-    const auto &globalBttvEmotes = app->twitch->getBttvEmotes();
-    const auto &globalFfzEmotes = app->twitch->getFfzEmotes();
-    const auto &globalSeventvEmotes = app->twitch->getSeventvEmotes();
-    const auto &globalHomiesEmotes = app->twitch->getHomiesEmotes();
+    auto *app = this->app_;
 
     auto flags = MessageElementFlags();
     auto emote = boost::optional<EmotePtr>{};
@@ -1078,52 +1082,53 @@ Outcome TwitchMessageBuilder::tryAppendEmote(const EmoteName &name)
     //  - BetterTTV Global
     //  - 7TV Global
     //  - Homies Global
+    // Everything but the personal emotes is resolved by the channel's
+    // ChannelEmoteIndex, which is a single lookup
+    boost::optional<ChannelEmoteIndex::Entry> entry;
     if (this->twitchChannel != nullptr &&
         (emote =
-             app->seventvPersonalEmotes->getEmoteForUser(this->userId_, name)))
+             app->getSeventvPersonalEmotes()->getEmoteForUser(this->userId_,
+                                                              name)))
     {
         flags = MessageElementFlag::SevenTVEmote;
     }
-    else if (this->twitchChannel &&
-             (emote = this->twitchChannel->ffzEmote(name)))
+    else if (this->twitchChannel != nullptr)
     {
-        flags = MessageElementFlag::FfzEmote;
-    }
-    else if (this->twitchChannel &&
-             (emote = this->twitchChannel->bttvEmote(name)))
-    {
-        flags = MessageElementFlag::BttvEmote;
-    }
-    else if (this->twitchChannel != nullptr &&
-             (emote = this->twitchChannel->seventvEmote(name)))
-    {
-        flags = MessageElementFlag::SevenTVEmote;
-        zeroWidth = emote.value()->zeroWidth;
-    }
-    else if (this->twitchChannel &&
-             (emote = this->twitchChannel->homiesEmote(name)))
-    {
-        flags = MessageElementFlag::HomiesEmote;
-        zeroWidth = emote.value()->zeroWidth;
-    }
-    else if ((emote = globalFfzEmotes.emote(name)))
-    {
-        flags = MessageElementFlag::FfzEmote;
-    }
-    else if ((emote = globalBttvEmotes.emote(name)))
-    {
-        flags = MessageElementFlag::BttvEmote;
-        zeroWidth = zeroWidthEmotes.contains(name.string);
+        if (!this->emoteIndex_)
+        {
+            this->emoteIndex_ =
+                this->twitchChannel->emoteIndex(*app->getTwitch());
+        }
+        if (const auto *found = this->emoteIndex_->find(name))
+        {
+            entry = *found;
+        }
     }
-    else if ((emote = globalSeventvEmotes.globalEmote(name)))
+    else
     {
-        flags = MessageElementFlag::SevenTVEmote;
-        zeroWidth = emote.value()->zeroWidth;
+        if (!this->globalEmotes_)
+        {
+            auto &sources = this->globalEmotes_.emplace();
+            auto setSource = [&](ChannelEmoteIndex::Source source, auto map) {
+                sources[static_cast<size_t>(source)] = std::move(map);
+            };
+            setSource(ChannelEmoteIndex::Source::FfzGlobal,
+                      app->getTwitch()->getFfzEmotes().emotes());
+            setSource(ChannelEmoteIndex::Source::BttvGlobal,
+                      app->getTwitch()->getBttvEmotes().emotes());
+            setSource(ChannelEmoteIndex::Source::SeventvGlobal,
+                      app->getTwitch()->getSeventvEmotes().globalEmotes());
+            setSource(ChannelEmoteIndex::Source::HomiesGlobal,
+                      app->getTwitch()->getHomiesEmotes().emotes());
+        }
+        entry = ChannelEmoteIndex::resolve(*this->globalEmotes_, name);
     }
-    else if ((emote = globalHomiesEmotes.emote(name)))
+
+    if (entry)
     {
-        flags = MessageElementFlag::HomiesEmote;
-        zeroWidth = emote.value()->zeroWidth;
+        emote = entry->emote;
+        flags = entry->flag;
+        zeroWidth = entry->zeroWidth;
     }
 
     if (emote)
@@ -1206,19 +1211,29 @@ std::unordered_map<QString, QString> TwitchMessageBuilder::parseBadgeInfoTag(
 
 std::vector<TwitchEmoteOccurrence> TwitchMessageBuilder::parseTwitchEmotes(
     const QVariantMap &tags, const QString &originalMessage, int messageOffset)
+{
+    return TwitchMessageBuilder::parseTwitchEmotes(
+        *getIApp()->getEmotes()->getTwitchEmotes(), tags, originalMessage,
+        messageOffset);
+}
+
+std::vector<TwitchEmoteOccurrence> TwitchMessageBuilder::parseTwitchEmotes(
+    ITwitchEmotes &twitchEmotes, const QVariantMap &tags,
+    const QString &originalMessage, int messageOffset)
 {
     // Twitch emotes
-    std::vector<TwitchEmoteOccurrence> twitchEmotes;
+    std::vector<TwitchEmoteOccurrence> occurrences;
 
     auto emotesTag = tags.find("emotes");
 
     if (emotesTag == tags.end())
     {
-        return twitchEmotes;
+        return occurrences;
     }
 
-    QStringList emoteString = emotesTag.value().toString().split('/');
+    const auto emotesString = emotesTag.value().toString();
     std::vector<int> correctPositions;
+    correctPositions.reserve(originalMessage.size());
     for (int i = 0; i < originalMessage.size(); ++i)
     {
         if (!originalMessage.at(i).isLowSurrogate())
@@ -1226,13 +1241,17 @@ std::vector<TwitchEmoteOccurrence> TwitchMessageBuilder::parseTwitchEmotes(
             correctPositions.push_back(i);
         }
     }
-    for (const QString &emote : emoteString)
+
+    // The tag has the format "id:from-to,from-to/id:from-to"
+    const QStringView emotes(emotesString);
+    for (qsizetype pos = 0; pos <= emotes.size();)
     {
-        appendTwitchEmoteOccurrences(emote, twitchEmotes, correctPositions,
+        appendTwitchEmoteOccurrences(twitchEmotes, nextField(emotes, pos, u'/'),
+                                     occurrences, correctPositions,
                                      originalMessage, messageOffset);
     }
 
-    return twitchEmotes;
+    return occurrences;
 }
 
 void TwitchMessageBuilder::appendTwitchBadges()
@@ -1329,7 +1348,8 @@ void TwitchMessageBuilder::appendTwitchBadges()
 
 void TwitchMessageBuilder::appendChatterinoBadges()
 {
-    if (auto badge = getApp()->chatterinoBadges->getBadge({this->userId_}))
+    if (auto badge =
+            this->app_->getChatterinoBadges()->getBadge({this->userId_}))
     {
         this->emplace<BadgeElement>(*badge,
                                     MessageElementFlag::BadgeChatterino);
@@ -1339,7 +1359,7 @@ void TwitchMessageBuilder::appendChatterinoBadges()
 void TwitchMessageBuilder::appendFfzBadges()
 {
     for (const auto &badge :
-         getApp()->ffzBadges->getUserBadges({this->userId_}))
+         this->app_->getFfzBadges()->getUserBadges({this->userId_}))
     {
         this->emplace<FfzBadgeElement>(
             badge.emote, MessageElementFlag::BadgeFfz, badge.color);
@@ -1348,7 +1368,7 @@ void TwitchMessageBuilder::appendFfzBadges()
 
 void TwitchMessageBuilder::appendSeventvBadges()
 {
-    if (auto badge = getApp()->seventvBadges->getBadge({this->userId_}))
+    if (auto badge = this->app_->getSeventvBadges()->getBadge({this->userId_}))
     {
         this->emplace<BadgeElement>(*badge, MessageElementFlag::BadgeSevenTV);
     }
@@ -1356,15 +1376,15 @@ void TwitchMessageBuilder::appendSeventvBadges()
 
 void TwitchMessageBuilder::appendHomiesBadges()
 {
-    if (auto badge = getApp()->homiesBadges->getBadge({this->userId_}))
+    if (auto badge = this->app_->getHomiesBadges()->getBadge({this->userId_}))
     {
         this->emplace<BadgeElement>(*badge, MessageElementFlag::BadgeHomies);
     }
-    if (auto badge = getApp()->homiesBadges->getBadge2({this->userId_}))
+    if (auto badge = this->app_->getHomiesBadges()->getBadge2({this->userId_}))
     {
         this->emplace<BadgeElement>(*badge, MessageElementFlag::BadgeHomies);
     }
-    if (auto badge = getApp()->homiesBadges->getBadge3({this->userId_}))
+    if (auto badge = this->app_->getHomiesBadges()->getBadge3({this->userId_}))
     {
         this->emplace<BadgeElement>(*badge, MessageElementFlag::BadgeHomies);
     }
@@ -1465,8 +1485,7 @@ bool TwitchMessageBuilder::shouldAddModerationElements() const
         return false;
     }
 
-    auto currentUser = getApp()->accounts->twitch.getCurrent();
-    if (this->channel->getName() == currentUser->getUserName())
+    if (this->channel->getName() == this->currentUser_->getUserName())
     {
         return true;
     }
@@ -1483,14 +1502,16 @@ bool TwitchMessageBuilder::shouldAddModerationElements() const
 
 void TwitchMessageBuilder::appendChannelPointRewardMessage(
     const ChannelPointReward &reward, MessageBuilder *builder, bool isMod,
-    bool isBroadcaster)
+    bool isBroadcaster, const TwitchAccount &currentUser)
 {
-    if (isIgnoredMessage({
-            /*.message = */ "",
-            /*.twitchUserID = */ reward.user.id,
-            /*.isMod = */ isMod,
-            /*.isBroadcaster = */ isBroadcaster,
-        }))
+    if (isIgnoredMessage(
+            {
+                /*.message = */ "",
+                /*.twitchUserID = */ reward.user.id,
+                /*.isMod = */ isMod,
+                /*.isBroadcaster = */ isBroadcaster,
+            },
+            currentUser))
     {
         return;
     }
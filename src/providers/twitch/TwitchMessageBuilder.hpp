@@ -3,10 +3,12 @@
 #include "common/Aliases.hpp"
 #include "common/Outcome.hpp"
 #include "messages/SharedMessageBuilder.hpp"
+#include "providers/twitch/ChannelEmoteIndex.hpp"
 
 #include <boost/optional.hpp>
 #include <IrcMessage>
 #include <QString>
+#include <QStringView>
 #include <QVariant>
 
 #include <unordered_map>
@@ -16,7 +18,10 @@ namespace chatterino {
 struct Emote;
 using EmotePtr = std::shared_ptr<const Emote>;
 
+class IApplication;
+class ITwitchEmotes;
 class Channel;
+class TwitchAccount;
 class TwitchChannel;
 class MessageThread;
 struct HelixVip;
@@ -37,6 +42,17 @@ struct TwitchEmoteOccurrence {
     }
 };
 
+/// A word of a message, or the part of a word before, between or after
+/// Twitch emotes
+struct MessageToken {
+    // Position of the token in the message
+    int start;
+    QStringView text;
+    // Set if the token is a Twitch emote
+    const TwitchEmoteOccurrence *twitchEmote = nullptr;
+    bool trailingSpace = true;
+};
+
 class TwitchMessageBuilder : public SharedMessageBuilder
 {
 public:
@@ -55,14 +71,31 @@ public:
     [[nodiscard]] bool isIgnored() const override;
     bool isIgnoredReply() const;
     void triggerHighlights() override;
+
+    /**
+     * @brief Builds the message without changing anything outside of it
+     *
+     * Only reads from the application, so it can run on a worker thread.
+     * What the message says about its channel, thread and sender is kept
+     * until applyBuildResults.
+     */
     MessagePtr build() override;
 
+    /**
+     * @brief Applies what build found out about the channel and its users
+     *
+     * Sets the room id of the channel if it doesn't have one yet, adds
+     * message to its reply thread and updates the color of the sender.
+     * GUI thread only.
+     */
+    void applyBuildResults(const MessagePtr &message);
+
     void setThread(std::shared_ptr<MessageThread> thread);
     void setMessageOffset(int offset);
 
     static void appendChannelPointRewardMessage(
         const ChannelPointReward &reward, MessageBuilder *builder, bool isMod,
-        bool isBroadcaster);
+        bool isBroadcaster, const TwitchAccount &currentUser);
 
     // Message in the /live chat for channel going live
     static void liveMessage(const QString &channelName,
@@ -93,10 +126,24 @@ public:
     static std::vector<TwitchEmoteOccurrence> parseTwitchEmotes(
         const QVariantMap &tags, const QString &originalMessage,
         int messageOffset);
+    static std::vector<TwitchEmoteOccurrence> parseTwitchEmotes(
+        ITwitchEmotes &twitchEmotes, const QVariantMap &tags,
+        const QString &originalMessage, int messageOffset);
+
+    /**
+     * @brief Splits a message into words and Twitch emotes
+     *
+     * twitchEmotes must be sorted by their start. The tokens point into
+     * message and twitchEmotes, nothing is copied.
+     */
+    static std::vector<MessageToken> tokenizeMessage(
+        const QString &message,
+        const std::vector<TwitchEmoteOccurrence> &twitchEmotes);
 
 private:
     void parseUsernameColor() override;
     void parseUsername() override;
+    void parseHighlights() override;
     void parseMessageID();
     void appendIsMod();
     void parseRoomID();
@@ -110,8 +157,7 @@ private:
     boost::optional<EmotePtr> getTwitchBadge(const Badge &badge);
     Outcome tryAppendEmote(const EmoteName &name) override;
 
-    void addWords(const QStringList &words,
-                  const std::vector<TwitchEmoteOccurrence> &twitchEmotes);
+    void addWords(const std::vector<MessageToken> &tokens);
     void addTextOrEmoji(EmotePtr emote) override;
     void addTextOrEmoji(const QString &value) override;
 
@@ -146,6 +192,21 @@ private:
 
     QString userId_;
     bool senderIsBroadcaster{};
+
+    // Taken from twitchChannel on the first emote lookup
+    std::shared_ptr<const ChannelEmoteIndex> emoteIndex_;
+    // The global emotes, taken on the first emote lookup if there's no
+    // twitchChannel
+    boost::optional<ChannelEmoteIndex::Sources> globalEmotes_;
+
+    // Taken on the GUI thread when the builder is made, build() may run on
+    // a worker
+    IApplication *const app_;
+    const std::shared_ptr<TwitchAccount> currentUser_;
+    // TwitchChannel::isBroadcaster looks at the current account through
+    // getApp(), which is only safe on the GUI thread
+    const bool channelIsMod_;
+    const bool channelIsBroadcaster_;
 };
 
 }  // namespace chatterino
@@ -83,24 +83,14 @@ void Fonts::initialize(Settings &, Paths &)
 {
     this->chatFontFamily.connect(
         [this]() {
-            assertInGuiThread();
-
-            for (auto &map : this->fontsByType_)
-            {
-                map.clear();
-            }
+            this->clearFontData();
             this->fontChanged.invoke();
         },
         false);
 
     this->chatFontSize.connect(
         [this]() {
-            assertInGuiThread();
-
-            for (auto &map : this->fontsByType_)
-            {
-                map.clear();
-            }
+            this->clearFontData();
             this->fontChanged.invoke();
         },
         false);
@@ -108,15 +98,10 @@ void Fonts::initialize(Settings &, Paths &)
 #ifdef CHATTERINO
     getSettings()->boldScale.connect(
         [this]() {
-            assertInGuiThread();
-
             // REMOVED
             getApp()->windows->incGeneration();
 
-            for (auto &map : this->fontsByType_)
-            {
-                map.clear();
-            }
+            this->clearFontData();
             this->fontChanged.invoke();
         },
         false);
@@ -133,6 +118,27 @@ QFontMetrics Fonts::getFontMetrics(FontStyle type, float scale)
     return this->getOrCreateFontData(type, scale).metrics;
 }
 
+int Fonts::getTextWidth(FontStyle type, float scale, const QString &text)
+{
+    return this->getOrCreateFontData(type, scale).widths.width(text);
+}
+
+uint64_t Fonts::generation() const
+{
+    return this->generation_;
+}
+
+void Fonts::clearFontData()
+{
+    assertInGuiThread();
+
+    for (auto &map : this->fontsByType_)
+    {
+        map.clear();
+    }
+    ++this->generation_;
+}
+
 Fonts::FontData &Fonts::getOrCreateFontData(FontStyle type, float scale)
 {
     assertInGuiThread();
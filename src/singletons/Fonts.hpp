@@ -2,6 +2,7 @@
 
 #include "common/ChatterinoSetting.hpp"
 #include "common/Singleton.hpp"
+#include "singletons/helper/TextWidthCache.hpp"
 
 #include <boost/noncopyable.hpp>
 #include <pajlada/signals/signal.hpp>
@@ -10,6 +11,7 @@
 #include <QFontMetrics>
 
 #include <array>
+#include <cstdint>
 #include <unordered_map>
 
 namespace chatterino {
@@ -51,6 +53,13 @@ public:
     QFont getFont(FontStyle type, float scale);
     QFontMetrics getFontMetrics(FontStyle type, float scale);
 
+    /// Returns the width of text in the font, see TextWidthCache
+    int getTextWidth(FontStyle type, float scale, const QString &text);
+
+    /// Changes whenever the fonts change, widths measured before that are
+    /// stale then
+    uint64_t generation() const;
+
     QStringSetting chatFontFamily;
     IntSetting chatFontSize;
 
@@ -62,11 +71,13 @@ private:
         FontData(const QFont &_font)
             : font(_font)
             , metrics(_font)
+            , widths(metrics)
         {
         }
 
         const QFont font;
         const QFontMetrics metrics;
+        TextWidthCache widths;
     };
 
     struct ChatFontData {
@@ -84,8 +95,10 @@ private:
 
     FontData &getOrCreateFontData(FontStyle type, float scale);
     FontData createFontData(FontStyle type, float scale);
+    void clearFontData();
 
     std::vector<std::unordered_map<float, FontData>> fontsByType_;
+    uint64_t generation_ = 1;
 };
 
 Fonts *getFonts();
@@ -28,10 +28,17 @@ void Logging::initialize(Settings &settings, Paths & /*paths*/)
 
 void Logging::addMessage(const QString &channelName, MessagePtr message,
                          const QString &platformName)
+{
+    this->addMessages(channelName, {std::move(message)}, platformName);
+}
+
+void Logging::addMessages(const QString &channelName,
+                          const std::vector<MessagePtr> &messages,
+                          const QString &platformName)
 {
     this->threadGuard.guard();
 
-    if (!getSettings()->enableLogging)
+    if (messages.empty() || !getSettings()->enableLogging)
     {
         return;
     }
@@ -44,28 +51,17 @@ void Logging::addMessage(const QString &channelName, MessagePtr message,
         }
     }
 
-    auto platIt = this->loggingChannels_.find(platformName);
-    if (platIt == this->loggingChannels_.end())
+    auto &channels = this->loggingChannels_[platformName];
+    auto chanIt = channels.find(channelName);
+    if (chanIt == channels.end())
     {
-        auto channel = new LoggingChannel(channelName, platformName);
-        channel->addMessage(message);
-        auto map = std::map<QString, std::unique_ptr<LoggingChannel>>();
-        this->loggingChannels_[platformName] = std::move(map);
-        auto &ref = this->loggingChannels_.at(platformName);
-        ref.emplace(channelName, std::move(channel));
-        return;
-    }
-    auto chanIt = platIt->second.find(channelName);
-    if (chanIt == platIt->second.end())
-    {
-        auto channel = new LoggingChannel(channelName, platformName);
-        channel->addMessage(message);
-        platIt->second.emplace(channelName, std::move(channel));
-    }
-    else
-    {
-        chanIt->second->addMessage(message);
+        chanIt = channels
+                     .emplace(channelName, new LoggingChannel(channelName,
+                                                              platformName))
+                     .first;
     }
+
+    chanIt->second->addMessages(messages);
 }
 
 }  // namespace chatterino
@@ -9,6 +9,7 @@
 #include <map>
 #include <memory>
 #include <unordered_set>
+#include <vector>
 
 namespace chatterino {
 
@@ -28,6 +29,10 @@ public:
 
     void addMessage(const QString &channelName, MessagePtr message,
                     const QString &platformName);
+    /// Logs all messages to the channel's log file in one write
+    void addMessages(const QString &channelName,
+                     const std::vector<MessagePtr> &messages,
+                     const QString &platformName);
 
 private:
     using PlatformName = QString;
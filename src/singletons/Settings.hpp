@@ -473,6 +473,8 @@ public:
     BoolSetting useKeyring = {"/misc/useKeyring", true};
 #endif
     BoolSetting enableExperimentalIrc = {"/misc/experimentalIrc", false};
+    BoolSetting buildMessagesConcurrently = {
+        "/misc/twitch/buildMessagesConcurrently", false};
 
     IntSetting startUpNotification = {"/misc/startUpNotification", 0};
     QStringSetting currentVersion = {"/misc/currentVersion", ""};
@@ -491,6 +493,11 @@ public:
         "/misc/scrollback/usercardLimit",
         1000,
     };
+    // In MiB, see MessageBufferPool
+    IntSetting messageBufferBudget = {
+        "/misc/messageBufferBudget",
+        128,
+    };
     BoolSetting displaySevenTVAnimatedProfile = {
         "/misc/displaySevenTVAnimatedProfile", true};
 
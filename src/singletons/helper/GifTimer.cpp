@@ -3,6 +3,7 @@
 #include "Application.hpp"
 #include "singletons/Settings.hpp"
 #include "singletons/WindowManager.hpp"
+#include "util/DebugCount.hpp"
 
 namespace chatterino {
 
@@ -13,7 +14,7 @@ void GIFTimer::initialize()
 
     getSettings()->animateEmotes.connect([this](bool enabled, auto) {
         if (enabled)
-            this->timer.start();
+            this->wake();
         else
             this->timer.stop();
     });
@@ -23,10 +24,28 @@ void GIFTimer::initialize()
             qApp->activeWindow() == nullptr)
             return;
 
+        this->awake_ = false;
         this->position_ += GIF_FRAME_LENGTH;
         this->signal.invoke();
         getApp()->windows->repaintGifEmotes();
+
+        if (!this->awake_)
+        {
+            // No animated image is visible anymore
+            this->timer.stop();
+            DebugCount::increase("gif timer sleeps");
+        }
     });
 }
 
+void GIFTimer::wake()
+{
+    this->awake_ = true;
+
+    if (!this->timer.isActive() && getSettings()->animateEmotes)
+    {
+        this->timer.start();
+    }
+}
+
 }  // namespace chatterino
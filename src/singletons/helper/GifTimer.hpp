@@ -12,6 +12,16 @@ class GIFTimer
 public:
     void initialize();
 
+    /**
+     * @brief Keeps the timer running for another tick
+     *
+     * The timer goes to sleep after a tick in which nothing called this, so
+     * everything that shows animated images has to call it while they're
+     * visible: when they're painted and on every tick after that.
+     * Starts the timer again if it's sleeping.
+     */
+    void wake();
+
     pajlada::Signals::NoArgSignal signal;
     long unsigned position()
     {
@@ -21,6 +31,7 @@ public:
 private:
     QTimer timer;
     long unsigned position_{};
+    bool awake_{false};
 };
 
 }  // namespace chatterino
@@ -85,6 +85,11 @@ void LoggingChannel::openLogFile()
 }
 
 void LoggingChannel::addMessage(MessagePtr message)
+{
+    this->addMessages({std::move(message)});
+}
+
+void LoggingChannel::addMessages(const std::vector<MessagePtr> &messages)
 {
     QDateTime now = QDateTime::currentDateTime();
 
@@ -95,31 +100,38 @@ void LoggingChannel::addMessage(MessagePtr message)
         this->openLogFile();
     }
 
+    const auto timestamp = now.toString("HH:mm:ss");
+
+    // All lines are written and flushed at once
     QString str;
-    if (channelName.startsWith("/mentions"))
+    for (const auto &message : messages)
     {
-        str.append("#" + message->channelName + " ");
-    }
+        if (channelName.startsWith("/mentions"))
+        {
+            str.append("#" + message->channelName + " ");
+        }
 
-    str.append('[');
-    str.append(now.toString("HH:mm:ss"));
-    str.append("] ");
+        str.append('[');
+        str.append(timestamp);
+        str.append("] ");
 
-    QString messageSearchText = message->searchText;
-    if ((message->flags.has(MessageFlag::ReplyMessage) &&
-         getSettings()->stripReplyMention) &&
-        !getSettings()->hideReplyContext)
-    {
-        qsizetype colonIndex = messageSearchText.indexOf(':');
-        if (colonIndex != -1)
+        QString messageSearchText = message->searchText;
+        if ((message->flags.has(MessageFlag::ReplyMessage) &&
+             getSettings()->stripReplyMention) &&
+            !getSettings()->hideReplyContext)
         {
-            QString rootMessageChatter =
-                message->replyThread->root()->loginName;
-            messageSearchText.insert(colonIndex + 1, " @" + rootMessageChatter);
+            qsizetype colonIndex = messageSearchText.indexOf(':');
+            if (colonIndex != -1)
+            {
+                QString rootMessageChatter =
+                    message->replyThread->root()->loginName;
+                messageSearchText.insert(colonIndex + 1,
+                                         " @" + rootMessageChatter);
+            }
         }
+        str.append(messageSearchText);
+        str.append(endline);
     }
-    str.append(messageSearchText);
-    str.append(endline);
 
     this->appendLine(str);
 }
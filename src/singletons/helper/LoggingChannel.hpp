@@ -6,6 +6,7 @@
 #include <QString>
 
 #include <memory>
+#include <vector>
 
 namespace chatterino {
 
@@ -21,6 +22,7 @@ class LoggingChannel : boost::noncopyable
 public:
     ~LoggingChannel();
     void addMessage(MessagePtr message);
+    void addMessages(const std::vector<MessagePtr> &messages);
 
 private:
     void openLogFile();
@@ -0,0 +1,29 @@
+#include "singletons/helper/TextWidthCache.hpp"
+
+namespace chatterino {
+
+TextWidthCache::TextWidthCache(const QFontMetrics &metrics, size_t maxSize)
+    : metrics_(metrics)
+    , widths_(maxSize)
+{
+}
+
+int TextWidthCache::width(const QString &text)
+{
+    if (this->widths_.exists(text))
+    {
+        return this->widths_.get(text);
+    }
+
+    auto width = this->metrics_.horizontalAdvance(text);
+    this->widths_.put(text, width);
+
+    return width;
+}
+
+size_t TextWidthCache::size() const
+{
+    return this->widths_.size();
+}
+
+}  // namespace chatterino
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "util/QStringHash.hpp"
+
+#include <lrucache/lrucache.hpp>
+#include <QFontMetrics>
+#include <QString>
+
+#include <cstddef>
+
+namespace chatterino {
+
+/**
+ * @brief Widths of texts in one font
+ *
+ * Chat repeats the same words a lot, so measuring each word once saves most
+ * of the work when messages are laid out again, e.g. after resizing a split.
+ * Keeps the most recently used widths.
+ */
+class TextWidthCache
+{
+public:
+    explicit TextWidthCache(const QFontMetrics &metrics,
+                            size_t maxSize = 20000);
+
+    /// Returns the horizontal advance of text
+    int width(const QString &text);
+
+    [[nodiscard]] size_t size() const;
+
+private:
+    QFontMetrics metrics_;
+    cache::lru_cache<QString, int> widths_;
+};
+
+}  // namespace chatterino
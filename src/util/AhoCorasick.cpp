@@ -0,0 +1,152 @@
+#include "util/AhoCorasick.hpp"
+
+#include <algorithm>
+#include <deque>
+
+namespace chatterino {
+
+AhoCorasick::AhoCorasick(bool caseInsensitive)
+    : caseInsensitive_(caseInsensitive)
+{
+}
+
+void AhoCorasick::add(QStringView pattern, size_t id)
+{
+    if (pattern.isEmpty())
+    {
+        return;
+    }
+
+    std::u16string folded;
+    folded.reserve(pattern.size());
+    for (qsizetype i = 0; i < pattern.size(); ++i)
+    {
+        folded.push_back(this->fold(pattern.utf16()[i]));
+    }
+    this->patterns_.emplace_back(std::move(folded), id);
+}
+
+void AhoCorasick::build()
+{
+    this->nodes_.clear();
+    this->edges_.clear();
+    this->ids_.clear();
+    this->firstCharacters_.reset();
+
+    if (this->patterns_.empty())
+    {
+        return;
+    }
+
+    // Build the trie with the children of each node in a separate list
+    struct TrieNode {
+        std::vector<Edge> children;
+        std::vector<size_t> ids;
+    };
+    std::vector<TrieNode> trie(1);
+
+    // In sorted order, children are always added after their smaller
+    // siblings, which keeps the lists sorted
+    std::sort(this->patterns_.begin(), this->patterns_.end());
+    for (const auto &[pattern, id] : this->patterns_)
+    {
+        uint32_t node = 0;
+        for (auto c : pattern)
+        {
+            auto &children = trie[node].children;
+            if (!children.empty() && children.back().character == c)
+            {
+                node = children.back().target;
+                continue;
+            }
+
+            auto target = static_cast<uint32_t>(trie.size());
+            children.push_back({c, target});
+            trie.emplace_back();
+            node = target;
+        }
+        trie[node].ids.push_back(id);
+        this->firstCharacters_.set(pattern.front());
+    }
+
+    // Flatten the trie
+    this->nodes_.resize(trie.size());
+    for (size_t i = 0; i < trie.size(); ++i)
+    {
+        auto &node = this->nodes_[i];
+        node.firstEdge = static_cast<uint32_t>(this->edges_.size());
+        node.edgeCount = static_cast<uint32_t>(trie[i].children.size());
+        this->edges_.insert(this->edges_.end(), trie[i].children.begin(),
+                            trie[i].children.end());
+
+        node.firstId = static_cast<uint32_t>(this->ids_.size());
+        node.idCount = static_cast<uint32_t>(trie[i].ids.size());
+        this->ids_.insert(this->ids_.end(), trie[i].ids.begin(),
+                          trie[i].ids.end());
+    }
+
+    // Compute the fail and output links breadth first, so the links of
+    // shorter strings are known first
+    std::deque<uint32_t> queue;
+    for (uint32_t e = 0; e < this->nodes_[0].edgeCount; ++e)
+    {
+        queue.push_back(this->edges_[e].target);
+    }
+    while (!queue.empty())
+    {
+        auto parent = queue.front();
+        queue.pop_front();
+
+        for (uint32_t e = 0; e < this->nodes_[parent].edgeCount; ++e)
+        {
+            const auto &edge = this->edges_[this->nodes_[parent].firstEdge + e];
+            auto &node = this->nodes_[edge.target];
+
+            node.fail = this->next(this->nodes_[parent].fail, edge.character);
+
+            const auto &fail = this->nodes_[node.fail];
+            node.output = fail.idCount > 0 ? node.fail : fail.output;
+
+            queue.push_back(edge.target);
+        }
+    }
+}
+
+bool AhoCorasick::empty() const
+{
+    return this->patterns_.empty();
+}
+
+uint32_t AhoCorasick::child(uint32_t node, char16_t c) const
+{
+    const auto &n = this->nodes_[node];
+    auto begin = this->edges_.begin() + n.firstEdge;
+    auto end = begin + n.edgeCount;
+    auto it = std::lower_bound(begin, end, c, [](const Edge &edge, char16_t c) {
+        return edge.character < c;
+    });
+    if (it == end || it->character != c)
+    {
+        return NONE;
+    }
+    return it->target;
+}
+
+uint32_t AhoCorasick::next(uint32_t state, char16_t c) const
+{
+    while (true)
+    {
+        auto target = this->child(state, c);
+        if (target != NONE)
+        {
+            return target;
+        }
+        if (state == 0)
+        {
+            return 0;
+        }
+        state = this->nodes_[state].fail;
+    }
+}
+
+}  // namespace chatterino
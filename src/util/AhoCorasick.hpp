@@ -0,0 +1,130 @@
+#pragma once
+
+#include <QChar>
+#include <QStringView>
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace chatterino {
+
+/**
+ * @brief Finds the occurrences of many patterns in a text in a single pass
+ *
+ * Patterns are added with add() and compiled into an Aho-Corasick automaton
+ * by build(). Patterns and texts are compared by UTF-16 code units. If
+ * caseInsensitive is set, code units are compared by their simple case
+ * folding, characters outside the BMP are compared as they are.
+ */
+class AhoCorasick
+{
+public:
+    explicit AhoCorasick(bool caseInsensitive = false);
+
+    /// Adds a pattern which is reported as id, empty patterns are ignored
+    void add(QStringView pattern, size_t id);
+
+    /// Compiles the added patterns, must be called before find()
+    void build();
+
+    /// Whether no patterns were added
+    bool empty() const;
+
+    /**
+     * @brief Calls onMatch(id, end) for every occurrence of a pattern in text
+     *
+     * end is the index after the last character of the occurrence.
+     * Occurrences are reported in the order of their end.
+     */
+    template <typename TOnMatch>
+    void find(QStringView text, TOnMatch &&onMatch) const
+    {
+        if (this->nodes_.empty())
+        {
+            return;
+        }
+
+        const auto *characters = text.utf16();
+        uint32_t state = 0;
+        for (qsizetype i = 0; i < text.size(); ++i)
+        {
+            auto c = this->fold(characters[i]);
+            if (state == 0 && !this->firstCharacters_[c])
+            {
+                continue;
+            }
+
+            state = this->next(state, c);
+
+            auto node = this->nodes_[state].idCount > 0
+                            ? state
+                            : this->nodes_[state].output;
+            while (node != NONE)
+            {
+                const auto &matched = this->nodes_[node];
+                for (uint32_t j = 0; j < matched.idCount; ++j)
+                {
+                    onMatch(this->ids_[matched.firstId + j], i + 1);
+                }
+                node = matched.output;
+            }
+        }
+    }
+
+private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct Node {
+        // Outgoing edges are stored next to each other, sorted by character
+        uint32_t firstEdge = 0;
+        uint32_t edgeCount = 0;
+        // Node of the longest proper suffix of this node's string
+        uint32_t fail = 0;
+        // Nearest node on the fail chain which ends a pattern
+        uint32_t output = NONE;
+        // Ids of the patterns ending at this node
+        uint32_t firstId = 0;
+        uint32_t idCount = 0;
+    };
+
+    struct Edge {
+        char16_t character;
+        uint32_t target;
+    };
+
+    char16_t fold(char16_t c) const
+    {
+        if (!this->caseInsensitive_)
+        {
+            return c;
+        }
+        if (c < 0x80)
+        {
+            return c >= 'A' && c <= 'Z' ? static_cast<char16_t>(c + 32) : c;
+        }
+        return QChar(c).toCaseFolded().unicode();
+    }
+
+    /// Returns the child of node for c, NONE if there is none
+    uint32_t child(uint32_t node, char16_t c) const;
+
+    /// Follows fail links from state until c can be consumed
+    uint32_t next(uint32_t state, char16_t c) const;
+
+    const bool caseInsensitive_;
+    std::vector<std::pair<std::u16string, size_t>> patterns_;
+
+    // The root is the first node
+    std::vector<Node> nodes_;
+    std::vector<Edge> edges_;
+    std::vector<size_t> ids_;
+
+    // Characters which start a pattern, lets find() skip everything else
+    std::bitset<0x10000> firstCharacters_;
+};
+
+}  // namespace chatterino
@@ -0,0 +1,109 @@
+#include "util/ObjectArena.hpp"
+
+#include <algorithm>
+
+namespace chatterino {
+
+ObjectArena::ObjectArena(size_t firstBlockSize)
+    : firstBlockSize_(std::max<size_t>(1, firstBlockSize))
+{
+}
+
+ObjectArena::~ObjectArena()
+{
+    this->clear();
+}
+
+void ObjectArena::reserve(size_t bytes)
+{
+    if (!this->blocks_.empty() &&
+        this->blocks_.back().size - this->used_ >= bytes)
+    {
+        return;
+    }
+
+    this->addBlock(bytes);
+}
+
+bool ObjectArena::destroyLast(const void *object)
+{
+    if (this->objects_.empty() || this->objects_.back().pointer != object)
+    {
+        return false;
+    }
+
+    auto last = this->objects_.back();
+    this->objects_.pop_back();
+    last.destroy(last.pointer);
+    this->used_ = last.usedBefore;
+    return true;
+}
+
+void ObjectArena::clear()
+{
+    for (auto it = this->objects_.rbegin(); it != this->objects_.rend(); ++it)
+    {
+        it->destroy(it->pointer);
+    }
+    this->objects_.clear();
+
+    // Blocks only grow, so the last one is the largest
+    if (this->blocks_.size() > 1)
+    {
+        this->blocks_.erase(this->blocks_.begin(), this->blocks_.end() - 1);
+    }
+    this->used_ = 0;
+}
+
+size_t ObjectArena::size() const
+{
+    return this->objects_.size();
+}
+
+size_t ObjectArena::capacity() const
+{
+    size_t total = 0;
+    for (const auto &block : this->blocks_)
+    {
+        total += block.size;
+    }
+    return total;
+}
+
+void *ObjectArena::allocate(size_t size, size_t alignment)
+{
+    if (!this->blocks_.empty())
+    {
+        auto &block = this->blocks_.back();
+        auto start = (this->used_ + alignment - 1) & ~(alignment - 1);
+        if (start + size <= block.size)
+        {
+            this->used_ = start + size;
+            return block.data.get() + start;
+        }
+    }
+
+    this->addBlock(size);
+    this->used_ = size;
+    return this->blocks_.back().data.get();
+}
+
+void ObjectArena::addBlock(size_t size)
+{
+    auto blockSize = this->firstBlockSize_;
+    if (!this->blocks_.empty())
+    {
+        blockSize = std::max(
+            blockSize, std::min(this->blocks_.back().size * 2, MAX_BLOCK_SIZE));
+    }
+    blockSize = std::max(blockSize, size);
+
+    // Blocks come from operator new[], so they're aligned for any object
+    this->blocks_.push_back({
+        std::unique_ptr<std::byte[]>(new std::byte[blockSize]),
+        blockSize,
+    });
+    this->used_ = 0;
+}
+
+}  // namespace chatterino
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <boost/noncopyable.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace chatterino {
+
+/**
+ * @brief Allocates objects that die together from a few blocks
+ *
+ * Objects are placed next to each other in blocks instead of getting their
+ * own heap allocation. The first block is firstBlockSize bytes and every
+ * further block is twice as large as the one before, up to MAX_BLOCK_SIZE,
+ * so arenas with a few objects stay small. Objects are destroyed in the
+ * reverse order of their creation once the arena is cleared or destroyed,
+ * the memory of a single object is only reused by destroyLast.
+ */
+class ObjectArena : boost::noncopyable
+{
+public:
+    /// Blocks don't grow beyond this, unless a single object is larger
+    static constexpr size_t MAX_BLOCK_SIZE = 16 * 1024;
+
+    explicit ObjectArena(size_t firstBlockSize = 256);
+    ~ObjectArena();
+
+    /// Makes sure the next bytes bytes of objects fit into the current
+    /// block, e.g. if the number of objects is known up front
+    void reserve(size_t bytes);
+
+    /// Creates a T in the arena, it's owned by the arena
+    template <typename T, typename... Args>
+    T *make(Args &&...args)
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t),
+                      "Over-aligned types aren't supported");
+
+        auto blockCount = this->blocks_.size();
+        auto used = this->used_;
+        void *memory = this->allocate(sizeof(T), alignof(T));
+        auto *object = new (memory) T(std::forward<Args>(args)...);
+
+        this->objects_.push_back({
+            object,
+            [](void *o) {
+                static_cast<T *>(o)->~T();
+            },
+            this->blocks_.size() == blockCount ? used : 0,
+        });
+        return object;
+    }
+
+    /**
+     * @brief Destroys object if it's the last one that was made
+     *
+     * Its memory is reused by the next object then.
+     * @return false if object isn't the last one, it's kept then
+     */
+    bool destroyLast(const void *object);
+
+    /// Destroys all objects, the largest block is kept for new objects
+    void clear();
+
+    /// Number of living objects
+    [[nodiscard]] size_t size() const;
+
+    /// Total size of the blocks
+    [[nodiscard]] size_t capacity() const;
+
+private:
+    void *allocate(size_t size, size_t alignment);
+    /// Adds a block of at least size bytes, the next objects go there
+    void addBlock(size_t size);
+
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size;
+    };
+
+    struct Object {
+        void *pointer;
+        void (*destroy)(void *);
+        // Bytes used in the last block before this object was made
+        size_t usedBefore;
+    };
+
+    size_t firstBlockSize_;
+    std::vector<Block> blocks_;
+    // Bytes used in the last block
+    size_t used_ = 0;
+    std::vector<Object> objects_;
+};
+
+}  // namespace chatterino
@@ -0,0 +1,108 @@
+#include "util/OrderedWorkQueue.hpp"
+
+#include "debug/AssertInGuiThread.hpp"
+#include "util/PostToThread.hpp"
+
+#include <algorithm>
+
+namespace chatterino {
+
+OrderedWorkQueue::OrderedWorkQueue(int maxThreadCount)
+    : state_(std::make_shared<State>())
+{
+    this->pool_.setMaxThreadCount(std::max(1, maxThreadCount));
+}
+
+OrderedWorkQueue::~OrderedWorkQueue()
+{
+    this->pool_.waitForDone();
+}
+
+void OrderedWorkQueue::submit(const QString &lane, Work work)
+{
+    assertInGuiThread();
+
+    auto ticket = this->state_->lanes[lane].nextTicket++;
+
+    std::weak_ptr<State> weak = this->state_;
+    this->pool_.start(new LambdaRunnable(
+        [weak, lane, ticket, work = std::move(work)] {
+            auto commit = work();
+
+            postToThread([weak, lane, ticket, commit = std::move(commit)] {
+                if (auto state = weak.lock())
+                {
+                    OrderedWorkQueue::finish(*state, lane, ticket, commit);
+                }
+            });
+        }));
+}
+
+void OrderedWorkQueue::post(const QString &lane, Commit commit)
+{
+    assertInGuiThread();
+
+    if (!this->hasPending(lane))
+    {
+        if (commit)
+        {
+            commit();
+        }
+        return;
+    }
+
+    auto ticket = this->state_->lanes[lane].nextTicket++;
+    OrderedWorkQueue::finish(*this->state_, lane, ticket, std::move(commit));
+}
+
+bool OrderedWorkQueue::hasPending(const QString &lane) const
+{
+    return this->state_->lanes.count(lane) != 0;
+}
+
+void OrderedWorkQueue::finish(State &state, const QString &lane,
+                              uint64_t ticket, Commit commit)
+{
+    auto it = state.lanes.find(lane);
+    if (it == state.lanes.end())
+    {
+        return;
+    }
+
+    it->second.ready.emplace(ticket, std::move(commit));
+
+    // Commit everything that's now in order. Commits can submit new tasks to
+    // the same lane, so the lane is looked up again after each one.
+    while (true)
+    {
+        it = state.lanes.find(lane);
+        if (it == state.lanes.end())
+        {
+            return;
+        }
+
+        auto &entry = it->second;
+        auto readyIt = entry.ready.find(entry.nextCommit);
+        if (readyIt == entry.ready.end())
+        {
+            return;
+        }
+
+        auto next = std::move(readyIt->second);
+        entry.ready.erase(readyIt);
+        ++entry.nextCommit;
+
+        if (entry.nextCommit == entry.nextTicket)
+        {
+            // The lane is idle, drop it so lanes don't accumulate
+            state.lanes.erase(it);
+        }
+
+        if (next)
+        {
+            next();
+        }
+    }
+}
+
+}  // namespace chatterino
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "util/QStringHash.hpp"
+
+#include <QString>
+#include <QThreadPool>
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <unordered_map>
+
+namespace chatterino {
+
+/**
+ * @brief Runs work on a thread pool and commits the results on the GUI thread
+ *
+ * Every task belongs to a lane (e.g. a channel name). Tasks of one lane are
+ * committed in the order they were submitted, no matter in which order the
+ * workers finish. Tasks of different lanes don't wait for each other.
+ *
+ * All member functions must be called from the GUI thread.
+ **/
+class OrderedWorkQueue
+{
+public:
+    using Commit = std::function<void()>;
+    using Work = std::function<Commit()>;
+
+    explicit OrderedWorkQueue(int maxThreadCount);
+    ~OrderedWorkQueue();
+
+    OrderedWorkQueue(const OrderedWorkQueue &) = delete;
+    OrderedWorkQueue &operator=(const OrderedWorkQueue &) = delete;
+
+    /**
+     * @brief Runs work on the pool, then the returned commit on the GUI thread
+     *
+     * The returned commit may be empty.
+     **/
+    void submit(const QString &lane, Work work);
+
+    /**
+     * @brief Runs commit on the GUI thread after all earlier tasks of the lane
+     *
+     * If the lane is idle, commit runs immediately.
+     **/
+    void post(const QString &lane, Commit commit);
+
+    /**
+     * @brief Returns true if the lane has tasks that haven't been committed
+     **/
+    [[nodiscard]] bool hasPending(const QString &lane) const;
+
+private:
+    struct Lane {
+        uint64_t nextTicket = 0;
+        uint64_t nextCommit = 0;
+        std::map<uint64_t, Commit> ready;
+    };
+
+    // Shared with in-flight workers, so results that arrive after the queue
+    // was destroyed are dropped
+    struct State {
+        std::unordered_map<QString, Lane> lanes;
+    };
+
+    static void finish(State &state, const QString &lane, uint64_t ticket,
+                       Commit commit);
+
+    std::shared_ptr<State> state_;
+    QThreadPool pool_;
+};
+
+}  // namespace chatterino
@@ -0,0 +1,601 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace chatterino {
+
+/**
+ * @brief A hash map whose copies share their structure
+ *
+ * The map is a hash array mapped trie: every node branches on 5 bits of the
+ * hash and stores entries and child nodes in compact arrays. Copying a map
+ * only copies the pointer to the root, so copies are O(1). Modifying a map
+ * copies the nodes on the path to the changed entry unless this map is
+ * their only owner, so inserting and erasing is O(log n) even if the map was
+ * just copied.
+ *
+ * Copies can be read from other threads while the original is modified,
+ * which allows keeping a snapshot in a shared_ptr<const ...> and publishing
+ * a modified copy.
+ *
+ * The interface follows std::unordered_map, but all iterators are constant
+ * and references to values are invalidated by any modification.
+ */
+template <typename TKey, typename TValue, typename THash = std::hash<TKey>,
+          typename TKeyEqual = std::equal_to<TKey>>
+class PersistentHashMap
+{
+    struct Node;
+    using NodePtr = std::shared_ptr<Node>;
+
+    static constexpr size_t BITS_PER_LEVEL = 5;
+    /// Nodes at this depth have used all bits of the hash and store their
+    /// entries in a list
+    static constexpr size_t MAX_DEPTH =
+        (sizeof(size_t) * 8 + BITS_PER_LEVEL - 1) / BITS_PER_LEVEL;
+
+public:
+    using key_type = TKey;
+    using mapped_type = TValue;
+    using value_type = std::pair<const TKey, TValue>;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = THash;
+    using key_equal = TKeyEqual;
+    using reference = const value_type &;
+    using const_reference = const value_type &;
+
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = PersistentHashMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type *;
+        using reference = const value_type &;
+
+        const_iterator() = default;
+
+        reference operator*() const
+        {
+            const auto &top = this->stack_[this->depth_ - 1];
+            return top.node->entries[top.index];
+        }
+
+        pointer operator->() const
+        {
+            return &**this;
+        }
+
+        const_iterator &operator++()
+        {
+            ++this->stack_[this->depth_ - 1].index;
+            this->settle();
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        bool operator==(const const_iterator &other) const
+        {
+            if (this->depth_ == 0 || other.depth_ == 0)
+            {
+                return this->depth_ == other.depth_;
+            }
+
+            const auto &a = this->stack_[this->depth_ - 1];
+            const auto &b = other.stack_[other.depth_ - 1];
+            return a.node == b.node && a.index == b.index;
+        }
+
+        bool operator!=(const const_iterator &other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        friend class PersistentHashMap;
+
+        // index counts the entries of node first, then its children
+        struct Frame {
+            const Node *node;
+            size_t index;
+        };
+
+        void push(const Node *node, size_t index)
+        {
+            assert(this->depth_ < this->stack_.size());
+            this->stack_[this->depth_++] = {node, index};
+        }
+
+        // Moves forward until the top of the stack is an entry
+        void settle()
+        {
+            while (this->depth_ > 0)
+            {
+                auto &top = this->stack_[this->depth_ - 1];
+                auto entries = top.node->entries.size();
+                if (top.index < entries)
+                {
+                    return;
+                }
+
+                auto child = top.index - entries;
+                if (child < top.node->children.size())
+                {
+                    ++top.index;
+                    this->push(top.node->children[child].get(), 0);
+                }
+                else
+                {
+                    --this->depth_;
+                }
+            }
+        }
+
+        std::array<Frame, MAX_DEPTH + 1> stack_{};
+        size_t depth_ = 0;
+    };
+    using iterator = const_iterator;
+
+    PersistentHashMap() = default;
+    PersistentHashMap(const PersistentHashMap &other) = default;
+    PersistentHashMap &operator=(const PersistentHashMap &other) = default;
+
+    PersistentHashMap(PersistentHashMap &&other) noexcept
+        : root_(std::move(other.root_))
+        , size_(std::exchange(other.size_, 0))
+    {
+    }
+
+    PersistentHashMap &operator=(PersistentHashMap &&other) noexcept
+    {
+        this->root_ = std::move(other.root_);
+        this->size_ = std::exchange(other.size_, 0);
+        return *this;
+    }
+
+    template <typename TInputIt>
+    PersistentHashMap(TInputIt first, TInputIt last)
+    {
+        for (; first != last; ++first)
+        {
+            this->insert(*first);
+        }
+    }
+
+    PersistentHashMap(std::initializer_list<value_type> init)
+        : PersistentHashMap(init.begin(), init.end())
+    {
+    }
+
+    [[nodiscard]] size_type size() const
+    {
+        return this->size_;
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return this->size_ == 0;
+    }
+
+    const_iterator begin() const
+    {
+        const_iterator it;
+        if (this->root_)
+        {
+            it.push(this->root_.get(), 0);
+            it.settle();
+        }
+        return it;
+    }
+
+    const_iterator end() const
+    {
+        return {};
+    }
+
+    const_iterator cbegin() const
+    {
+        return this->begin();
+    }
+
+    const_iterator cend() const
+    {
+        return this->end();
+    }
+
+    const_iterator find(const TKey &key) const
+    {
+        const_iterator it;
+        const auto *node = this->root_.get();
+        auto hash = THash{}(key);
+
+        for (size_t depth = 0; node != nullptr; ++depth)
+        {
+            if (depth >= MAX_DEPTH)
+            {
+                for (size_t i = 0; i < node->entries.size(); ++i)
+                {
+                    if (TKeyEqual{}(node->entries[i].first, key))
+                    {
+                        it.push(node, i);
+                        return it;
+                    }
+                }
+                return {};
+            }
+
+            auto bit = bitOf(hash, depth);
+            if ((node->dataMap & bit) != 0)
+            {
+                auto index = indexOf(node->dataMap, bit);
+                if (!TKeyEqual{}(node->entries[index].first, key))
+                {
+                    return {};
+                }
+                it.push(node, index);
+                return it;
+            }
+            if ((node->nodeMap & bit) == 0)
+            {
+                return {};
+            }
+
+            // Iteration continues after this child
+            auto child = indexOf(node->nodeMap, bit);
+            it.push(node, node->entries.size() + child + 1);
+            node = node->children[child].get();
+        }
+
+        return {};
+    }
+
+    [[nodiscard]] size_type count(const TKey &key) const
+    {
+        return this->find(key) == this->end() ? 0 : 1;
+    }
+
+    const TValue &at(const TKey &key) const
+    {
+        auto it = this->find(key);
+        if (it == this->end())
+        {
+            throw std::out_of_range("PersistentHashMap::at");
+        }
+        return it->second;
+    }
+
+    /// The reference is invalidated by the next modification of the map
+    TValue &operator[](const TKey &key)
+    {
+        return this->findOrInsert(key, [] {
+                       return TValue();
+                   })
+            .first;
+    }
+
+    std::pair<const_iterator, bool> insert(const value_type &value)
+    {
+        return this->emplace(value.first, value.second);
+    }
+
+    template <typename... TArgs>
+    std::pair<const_iterator, bool> emplace(TArgs &&...args)
+    {
+        value_type value(std::forward<TArgs>(args)...);
+        auto it = this->find(value.first);
+        if (it != this->end())
+        {
+            return {it, false};
+        }
+
+        this->findOrInsert(value.first, [&] {
+            return std::move(value.second);
+        });
+        return {this->find(value.first), true};
+    }
+
+    template <typename TMapped>
+    std::pair<const_iterator, bool> insert_or_assign(const TKey &key,
+                                                     TMapped &&mapped)
+    {
+        auto [value, inserted] = this->findOrInsert(key, [&] {
+            return TValue(mapped);
+        });
+        if (!inserted)
+        {
+            value = std::forward<TMapped>(mapped);
+        }
+        return {this->find(key), inserted};
+    }
+
+    size_type erase(const TKey &key)
+    {
+        if (this->find(key) == this->end())
+        {
+            return 0;
+        }
+
+        this->eraseFrom(this->root_, 0, THash{}(key), key);
+        --this->size_;
+        return 1;
+    }
+
+    /// Returns the iterator following pos
+    const_iterator erase(const_iterator pos)
+    {
+        // Erasing invalidates both iterators, so the keys are copied
+        auto key = pos->first;
+        auto next = std::next(pos);
+        if (next == this->end())
+        {
+            this->erase(key);
+            return this->end();
+        }
+
+        auto nextKey = next->first;
+        this->erase(key);
+        return this->find(nextKey);
+    }
+
+    void clear()
+    {
+        this->root_.reset();
+        this->size_ = 0;
+    }
+
+private:
+    struct Node {
+        // Bit i is set if the entry or child for hash fragment i is stored
+        // in this node. Entries and children are stored in order of their
+        // fragments. Nodes at MAX_DEPTH don't use the maps.
+        uint32_t dataMap = 0;
+        uint32_t nodeMap = 0;
+        std::vector<value_type> entries;
+        std::vector<NodePtr> children;
+    };
+
+    static uint32_t bitOf(size_t hash, size_t depth)
+    {
+        return uint32_t(1) << ((hash >> (depth * BITS_PER_LEVEL)) & 0x1f);
+    }
+
+    static size_t indexOf(uint32_t map, uint32_t bit)
+    {
+        return std::bitset<32>(map & (bit - 1)).count();
+    }
+
+    // value_type isn't assignable, so the vectors are rebuilt
+    static void insertEntry(std::vector<value_type> &entries, size_t index,
+                            value_type &&entry)
+    {
+        std::vector<value_type> next;
+        next.reserve(entries.size() + 1);
+        for (size_t i = 0; i < index; ++i)
+        {
+            next.emplace_back(std::move(entries[i]));
+        }
+        next.emplace_back(std::move(entry));
+        for (size_t i = index; i < entries.size(); ++i)
+        {
+            next.emplace_back(std::move(entries[i]));
+        }
+        entries = std::move(next);
+    }
+
+    static value_type takeEntry(std::vector<value_type> &entries,
+                                size_t index)
+    {
+        value_type entry(std::move(entries[index]));
+        std::vector<value_type> next;
+        next.reserve(entries.size() - 1);
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            if (i != index)
+            {
+                next.emplace_back(std::move(entries[i]));
+            }
+        }
+        entries = std::move(next);
+        return entry;
+    }
+
+    // Copies node unless this map is its only owner
+    static void makeUnique(NodePtr &node)
+    {
+        if (!node)
+        {
+            node = std::make_shared<Node>();
+        }
+        else if (node.use_count() != 1)
+        {
+            node = std::make_shared<Node>(*node);
+        }
+    }
+
+    template <typename TMakeValue>
+    std::pair<TValue &, bool> findOrInsert(const TKey &key,
+                                           TMakeValue &&makeValue)
+    {
+        auto result = insertInto(this->root_, 0, THash{}(key), key,
+                                 std::forward<TMakeValue>(makeValue));
+        if (result.second)
+        {
+            ++this->size_;
+        }
+        return {*result.first, result.second};
+    }
+
+    template <typename TMakeValue>
+    static std::pair<TValue *, bool> insertInto(NodePtr &slot, size_t depth,
+                                                size_t hash, const TKey &key,
+                                                TMakeValue &&makeValue)
+    {
+        makeUnique(slot);
+        auto &node = *slot;
+
+        if (depth >= MAX_DEPTH)
+        {
+            for (auto &entry : node.entries)
+            {
+                if (TKeyEqual{}(entry.first, key))
+                {
+                    return {&entry.second, false};
+                }
+            }
+            node.entries.emplace_back(key, makeValue());
+            return {&node.entries.back().second, true};
+        }
+
+        auto bit = bitOf(hash, depth);
+        if ((node.nodeMap & bit) != 0)
+        {
+            return insertInto(node.children[indexOf(node.nodeMap, bit)],
+                              depth + 1, hash, key,
+                              std::forward<TMakeValue>(makeValue));
+        }
+
+        if ((node.dataMap & bit) == 0)
+        {
+            auto index = indexOf(node.dataMap, bit);
+            insertEntry(node.entries, index, value_type(key, makeValue()));
+            node.dataMap |= bit;
+            return {&node.entries[index].second, true};
+        }
+
+        auto index = indexOf(node.dataMap, bit);
+        if (TKeyEqual{}(node.entries[index].first, key))
+        {
+            return {&node.entries[index].second, false};
+        }
+
+        // Two keys share this fragment, both are moved to a new child
+        auto existing = takeEntry(node.entries, index);
+        node.dataMap &= ~bit;
+
+        NodePtr child;
+        auto existingHash = THash{}(existing.first);
+        placeEntry(child, depth + 1, existingHash, std::move(existing));
+
+        auto childIndex = indexOf(node.nodeMap, bit);
+        node.children.insert(node.children.begin() + childIndex,
+                             std::move(child));
+        node.nodeMap |= bit;
+
+        return insertInto(node.children[childIndex], depth + 1, hash, key,
+                          std::forward<TMakeValue>(makeValue));
+    }
+
+    // Adds an entry whose key isn't in the trie below slot yet
+    static void placeEntry(NodePtr &slot, size_t depth, size_t hash,
+                           value_type &&entry)
+    {
+        makeUnique(slot);
+        auto &node = *slot;
+
+        if (depth >= MAX_DEPTH)
+        {
+            node.entries.emplace_back(std::move(entry));
+            return;
+        }
+
+        auto bit = bitOf(hash, depth);
+        if ((node.nodeMap & bit) != 0)
+        {
+            placeEntry(node.children[indexOf(node.nodeMap, bit)], depth + 1,
+                       hash, std::move(entry));
+            return;
+        }
+
+        auto index = indexOf(node.dataMap, bit);
+        if ((node.dataMap & bit) == 0)
+        {
+            insertEntry(node.entries, index, std::move(entry));
+            node.dataMap |= bit;
+            return;
+        }
+
+        auto existing = takeEntry(node.entries, index);
+        node.dataMap &= ~bit;
+
+        NodePtr child;
+        auto existingHash = THash{}(existing.first);
+        placeEntry(child, depth + 1, existingHash, std::move(existing));
+        placeEntry(child, depth + 1, hash, std::move(entry));
+
+        node.children.insert(
+            node.children.begin() + indexOf(node.nodeMap, bit),
+            std::move(child));
+        node.nodeMap |= bit;
+    }
+
+    // key must be in the map
+    static void eraseFrom(NodePtr &slot, size_t depth, size_t hash,
+                          const TKey &key)
+    {
+        makeUnique(slot);
+        auto &node = *slot;
+
+        if (depth >= MAX_DEPTH)
+        {
+            for (size_t i = 0; i < node.entries.size(); ++i)
+            {
+                if (TKeyEqual{}(node.entries[i].first, key))
+                {
+                    takeEntry(node.entries, i);
+                    return;
+                }
+            }
+            assert(false && "key must be in the map");
+            return;
+        }
+
+        auto bit = bitOf(hash, depth);
+        if ((node.dataMap & bit) != 0)
+        {
+            takeEntry(node.entries, indexOf(node.dataMap, bit));
+            node.dataMap &= ~bit;
+            return;
+        }
+
+        assert((node.nodeMap & bit) != 0);
+        auto childIndex = indexOf(node.nodeMap, bit);
+        auto &child = node.children[childIndex];
+        eraseFrom(child, depth + 1, hash, key);
+
+        // A child with a single entry is merged back into this node, so the
+        // shape of the trie only depends on its contents
+        if (child->children.empty() && child->entries.size() == 1)
+        {
+            auto entry = takeEntry(child->entries, 0);
+            node.children.erase(node.children.begin() + childIndex);
+            node.nodeMap &= ~bit;
+
+            insertEntry(node.entries, indexOf(node.dataMap, bit),
+                        std::move(entry));
+            node.dataMap |= bit;
+        }
+    }
+
+    NodePtr root_;
+    size_type size_ = 0;
+};
+
+}  // namespace chatterino
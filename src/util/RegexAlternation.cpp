@@ -0,0 +1,98 @@
+#include "util/RegexAlternation.hpp"
+
+namespace chatterino {
+
+bool RegexAlternation::canCombine(const QString &pattern)
+{
+    for (qsizetype i = 0; i < pattern.size(); ++i)
+    {
+        auto c = pattern[i];
+        if (c == '\\')
+        {
+            if (i + 1 < pattern.size())
+            {
+                auto escaped = pattern[i + 1];
+                if (escaped.isDigit() || escaped == 'g' || escaped == 'k' ||
+                    escaped == 'Q')
+                {
+                    return false;
+                }
+            }
+            ++i;
+            continue;
+        }
+
+        if (c != '(' || i + 1 >= pattern.size())
+        {
+            continue;
+        }
+
+        auto next = pattern[i + 1];
+        if (next == '*')
+        {
+            return false;
+        }
+        if (next != '?')
+        {
+            continue;
+        }
+
+        auto kind = pattern.mid(i + 2, 2);
+        if (!(kind.startsWith(':') || kind.startsWith('=') ||
+              kind.startsWith('!') || kind == "<=" || kind == "<!"))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+RegexAlternation::RegexAlternation(const std::vector<QString> &patterns,
+                                   QRegularExpression::PatternOptions options)
+{
+    QString joined;
+    int group = 1;
+    for (const auto &pattern : patterns)
+    {
+        if (!joined.isEmpty())
+        {
+            joined += '|';
+        }
+        joined += '(';
+        joined += pattern;
+        joined += ')';
+
+        this->groups_.push_back(group);
+        group += 1 + QRegularExpression(pattern).captureCount();
+    }
+
+    this->regex_ = QRegularExpression(joined, options);
+}
+
+bool RegexAlternation::isValid() const
+{
+    return !this->groups_.empty() && this->regex_.isValid();
+}
+
+const QRegularExpression &RegexAlternation::regex() const
+{
+    return this->regex_;
+}
+
+size_t RegexAlternation::matchedPattern(
+    const QRegularExpressionMatch &match) const
+{
+    for (size_t i = 0; i < this->groups_.size(); ++i)
+    {
+        if (match.capturedStart(this->groups_[i]) != -1)
+        {
+            return i;
+        }
+    }
+
+    // Not reached for matches of regex()
+    return 0;
+}
+
+}  // namespace chatterino
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QRegularExpression>
+#include <QString>
+
+#include <cstddef>
+#include <vector>
+
+namespace chatterino {
+
+/**
+ * @brief Joins regexes into one alternation which tells which of them matched
+ *
+ * Searching the alternation finds the leftmost position where one of the
+ * patterns matches, at that position the first matching pattern wins. If the
+ * alternation doesn't match, none of the patterns match.
+ */
+class RegexAlternation
+{
+public:
+    /**
+     * @brief Whether pattern can be part of an alternation without changing
+     *        what it matches
+     *
+     * Back references, named groups, inline options (which could enable
+     * extended mode and comment out the rest of the alternation), \Q without
+     * \E and verbs like (*UTF) are ruled out. This is conservative, for
+     * example "(?" inside a character class also rules a pattern out.
+     */
+    static bool canCombine(const QString &pattern);
+
+    RegexAlternation() = default;
+    RegexAlternation(const std::vector<QString> &patterns,
+                     QRegularExpression::PatternOptions options);
+
+    bool isValid() const;
+    const QRegularExpression &regex() const;
+
+    /// Returns the index of the pattern which matched
+    size_t matchedPattern(const QRegularExpressionMatch &match) const;
+
+private:
+    QRegularExpression regex_;
+    // Capture group of each pattern
+    std::vector<int> groups_;
+};
+
+}  // namespace chatterino
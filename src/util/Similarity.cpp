@@ -0,0 +1,144 @@
+#include "util/Similarity.hpp"
+
+#include <algorithm>
+
+namespace chatterino {
+
+float relativeSimilarity(QStringView a, QStringView b)
+{
+    if (a.isEmpty() || b.isEmpty())
+    {
+        return 0.F;
+    }
+
+    const auto longest = std::max(a.size(), b.size());
+
+    // Spam waves are mostly exact copies
+    if (a.size() == b.size() &&
+        std::equal(a.utf16(), a.utf16() + a.size(), b.utf16()))
+    {
+        return 1.F;
+    }
+
+    if (a.size() < b.size())
+    {
+        std::swap(a, b);
+    }
+
+    // The longest common substring is the longest run of equal characters
+    // on one of the diagonals of the comparison table. Once a run of length
+    // best was found, only runs longer than that matter, and these have to
+    // contain every (best + 1)th position of a diagonal. Checking those
+    // positions first skips most of the table when the messages share a
+    // long substring, which is the common case for spam.
+    const auto *rows = a.utf16();
+    const auto *columns = b.utf16();
+    const qsizetype rowCount = a.size();
+    const qsizetype columnCount = b.size();
+    qsizetype best = 0;
+
+    auto scanDiagonal = [&](qsizetype row, qsizetype column) {
+        const auto length = std::min(rowCount - row, columnCount - column);
+        const auto *x = rows + row;
+        const auto *y = columns + column;
+
+        // Runs starting before start were already seen
+        qsizetype start = 0;
+        while (start + best < length)
+        {
+            auto probe = start + best;
+            if (x[probe] != y[probe])
+            {
+                start = probe + 1;
+                continue;
+            }
+
+            auto first = probe;
+            while (first > start && x[first - 1] == y[first - 1])
+            {
+                --first;
+            }
+            auto last = probe + 1;
+            while (last < length && x[last] == y[last])
+            {
+                ++last;
+            }
+
+            best = std::max(best, last - first);
+            start = last + 1;
+        }
+    };
+
+    // Near copies have their longest match close to the main diagonal, so
+    // diagonals are scanned outwards from it to find long runs early. The
+    // remaining diagonals are too short once best reaches their length.
+    for (qsizetype offset = 0;
+         best < std::min(rowCount - offset, columnCount); ++offset)
+    {
+        scanDiagonal(offset, 0);
+        if (offset > 0 && offset < columnCount)
+        {
+            scanDiagonal(0, offset);
+        }
+    }
+
+    return static_cast<float>(best) / static_cast<float>(longest);
+}
+
+float SimilarityHistory::similarity(const QString &text,
+                                    const QString &loginName,
+                                    const QTime &now, int maxMessages,
+                                    int maxDelaySeconds,
+                                    bool sameUserOnly) const
+{
+    float similarityPercent = 0.0F;
+    int checked = 0;
+
+    for (size_t i = 0; i < this->entries_.size(); ++i)
+    {
+        if (checked >= maxMessages)
+        {
+            break;
+        }
+
+        // Newest first
+        const auto &entry =
+            this->entries_[(this->newest_ + this->entries_.size() - i) %
+                           this->entries_.size()];
+        if (entry.parseTime.secsTo(now) >= maxDelaySeconds)
+        {
+            break;
+        }
+        if (sameUserOnly && loginName != entry.loginName)
+        {
+            continue;
+        }
+
+        ++checked;
+        similarityPercent = std::max(similarityPercent,
+                                     relativeSimilarity(text, entry.text));
+    }
+
+    return similarityPercent;
+}
+
+void SimilarityHistory::add(const QString &text, const QString &loginName,
+                            const QTime &parseTime)
+{
+    if (this->entries_.size() < CAPACITY)
+    {
+        this->entries_.push_back({text, loginName, parseTime});
+        this->newest_ = this->entries_.size() - 1;
+        return;
+    }
+
+    this->newest_ = (this->newest_ + 1) % CAPACITY;
+    this->entries_[this->newest_] = {text, loginName, parseTime};
+}
+
+size_t SimilarityHistory::size() const
+{
+    return this->entries_.size();
+}
+
+}  // namespace chatterino
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QString>
+#include <QStringView>
+#include <QTime>
+
+#include <cstddef>
+#include <vector>
+
+namespace chatterino {
+
+/**
+ * @brief Length of the longest common substring of a and b relative to the
+ *        longer string
+ *
+ * @return a value between 0 (nothing in common) and 1 (equal strings)
+ */
+float relativeSimilarity(QStringView a, QStringView b);
+
+/**
+ * @brief The recent messages of a channel which new messages are checked
+ *        for similarity against
+ *
+ * Keeps the last CAPACITY message texts, so the channel's messages don't
+ * have to be copied or scanned. Only used on the GUI thread.
+ */
+class SimilarityHistory
+{
+public:
+    static constexpr size_t CAPACITY = 512;
+
+    /**
+     * @brief Returns the highest similarity of text to the recent messages
+     *
+     * Messages are checked newest first. Checking stops after maxMessages
+     * messages or at the first message older than maxDelaySeconds.
+     *
+     * @param sameUserOnly only check messages sent by loginName
+     */
+    float similarity(const QString &text, const QString &loginName,
+                     const QTime &now, int maxMessages, int maxDelaySeconds,
+                     bool sameUserOnly) const;
+
+    void add(const QString &text, const QString &loginName,
+             const QTime &parseTime);
+
+    size_t size() const;
+
+private:
+    struct Entry {
+        QString text;
+        QString loginName;
+        QTime parseTime;
+    };
+
+    // Grows up to CAPACITY, then the oldest entry is overwritten
+    std::vector<Entry> entries_;
+    // Index of the newest entry
+    size_t newest_ = 0;
+};
+
+}  // namespace chatterino
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "util/DebugCount.hpp"
+
+#include <boost/noncopyable.hpp>
+#include <QString>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace chatterino {
+
+/**
+ * @brief Interns shared values by key without keeping them alive
+ *
+ * Values are kept as weak pointers, so every user of a key shares the same
+ * value for as long as anyone holds it. The cache is split into shards with
+ * their own lock so lookups from different threads rarely wait on each
+ * other. Expired entries are swept from a shard once it has doubled in size
+ * since its last sweep, so the cache doesn't grow with every key it has ever
+ * seen.
+ *
+ * The number of entries is reported to DebugCount under the given name.
+ */
+template <typename TKey, typename TValue, typename THash = std::hash<TKey>,
+          std::size_t ShardCount = 16>
+class WeakCache : boost::noncopyable
+{
+public:
+    explicit WeakCache(QString debugName)
+        : debugName_(std::move(debugName))
+    {
+    }
+
+    ~WeakCache()
+    {
+        DebugCount::decrease(this->debugName_,
+                             static_cast<int64_t>(this->size()));
+    }
+
+    /**
+     * @brief Returns the value for key, creating it with make() if there is
+     *        no living value
+     *
+     * make() is called with the shard locked, it must not use this cache.
+     */
+    template <typename TMake>
+    std::shared_ptr<TValue> getOrCreate(const TKey &key, TMake &&make)
+    {
+        return this->getOrCreate(key, std::forward<TMake>(make),
+                                 [](const TValue &) {
+                                     return true;
+                                 });
+    }
+
+    /**
+     * @brief Returns the value for key if it's alive and canReuse() accepts
+     *        it, otherwise the value is replaced by make()
+     *
+     * make() is called with the shard locked, it must not use this cache.
+     */
+    template <typename TMake, typename TCanReuse>
+    std::shared_ptr<TValue> getOrCreate(const TKey &key, TMake &&make,
+                                        TCanReuse &&canReuse)
+    {
+        auto &shard = this->shardOf(key);
+        std::lock_guard<std::mutex> guard(shard.mutex);
+
+        auto it = shard.entries.find(key);
+        if (it != shard.entries.end())
+        {
+            if (auto shared = it->second.lock(); shared && canReuse(*shared))
+            {
+                return shared;
+            }
+
+            std::shared_ptr<TValue> shared = make();
+            it->second = shared;
+            return shared;
+        }
+
+        if (shard.entries.size() >= shard.sweepAt)
+        {
+            this->sweep(shard);
+        }
+
+        std::shared_ptr<TValue> shared = make();
+        shard.entries.emplace(key, shared);
+        DebugCount::increase(this->debugName_);
+        return shared;
+    }
+
+    /// Returns the living value for key or nullptr
+    std::shared_ptr<TValue> get(const TKey &key) const
+    {
+        auto &shard = this->shardOf(key);
+        std::lock_guard<std::mutex> guard(shard.mutex);
+
+        auto it = shard.entries.find(key);
+        if (it == shard.entries.end())
+        {
+            return nullptr;
+        }
+        return it->second.lock();
+    }
+
+    /// Number of entries, including expired ones which weren't swept yet
+    std::size_t size() const
+    {
+        std::size_t total = 0;
+        for (auto &shard : this->shards_)
+        {
+            std::lock_guard<std::mutex> guard(shard.mutex);
+            total += shard.entries.size();
+        }
+        return total;
+    }
+
+    /// Removes all expired entries
+    void sweep()
+    {
+        for (auto &shard : this->shards_)
+        {
+            std::lock_guard<std::mutex> guard(shard.mutex);
+            this->sweep(shard);
+        }
+    }
+
+private:
+    // Shards are never swept below this size
+    static constexpr std::size_t MIN_SWEEP_SIZE = 64;
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<TKey, std::weak_ptr<TValue>, THash> entries;
+        std::size_t sweepAt = MIN_SWEEP_SIZE;
+    };
+
+    Shard &shardOf(const TKey &key) const
+    {
+        auto hash = THash{}(key);
+        // Spread keys whose hashes only differ in the high bits
+        hash ^= hash >> 16;
+        return this->shards_[hash % ShardCount];
+    }
+
+    void sweep(Shard &shard)
+    {
+        auto before = shard.entries.size();
+        for (auto it = shard.entries.begin(); it != shard.entries.end();)
+        {
+            if (it->second.expired())
+            {
+                it = shard.entries.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        auto removed = before - shard.entries.size();
+        if (removed > 0)
+        {
+            DebugCount::decrease(this->debugName_,
+                                 static_cast<int64_t>(removed));
+        }
+
+        // Doubling keeps sweeping amortized O(1) per insertion
+        shard.sweepAt = std::max(MIN_SWEEP_SIZE, shard.entries.size() * 2);
+    }
+
+    const QString debugName_;
+    mutable std::array<Shard, ShardCount> shards_;
+};
+
+}  // namespace chatterino
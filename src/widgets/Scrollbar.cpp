@@ -11,6 +11,7 @@
 #include <QTimer>
 
 #include <cmath>
+#include <utility>
 
 #define MIN_THUMB_HEIGHT 10
 
@@ -34,6 +35,11 @@ void Scrollbar::addHighlight(ScrollbarHighlight highlight)
     this->highlights_.pushBack(highlight);
 }
 
+void Scrollbar::addHighlights(const std::vector<ScrollbarHighlight> &highlights)
+{
+    this->highlights_.pushBackItems(highlights);
+}
+
 void Scrollbar::addHighlightsAtStart(
     const std::vector<ScrollbarHighlight> &_highlights)
 {
@@ -45,6 +51,11 @@ void Scrollbar::replaceHighlight(size_t index, ScrollbarHighlight replacement)
     this->highlights_.replaceItem(index, replacement);
 }
 
+void Scrollbar::setHighlightPosition(std::function<qreal(size_t)> position)
+{
+    this->highlightPosition_ = std::move(position);
+}
+
 void Scrollbar::pauseHighlights()
 {
     this->highlightsPaused_ = true;
@@ -292,14 +303,24 @@ void Scrollbar::paintEvent(QPaintEvent *)
         return;
     }
 
+    auto positionOf = [&](size_t index) {
+        if (this->highlightPosition_)
+        {
+            return float(this->highlightPosition_(index));
+        }
+        return float(index) / float(snapshotLength);
+    };
+
     int w = this->width();
     float y = 0;
-    float dY = float(this->height()) / float(snapshotLength);
-    int highlightHeight =
-        int(std::ceil(std::max<float>(this->scale() * 2, dY)));
+    float nextY = 0;
 
-    for (size_t i = 0; i < snapshotLength; i++, y += dY)
+    for (size_t i = 0; i < snapshotLength; i++, y = nextY)
     {
+        nextY = positionOf(i + 1) * float(this->height());
+        int highlightHeight =
+            int(std::ceil(std::max<float>(this->scale() * 2, nextY - y)));
+
         ScrollbarHighlight const &highlight = snapshot[i];
 
         if (highlight.isNull())
@@ -9,6 +9,8 @@
 #include <QPropertyAnimation>
 #include <QWidget>
 
+#include <functional>
+
 namespace chatterino {
 
 class ChannelView;
@@ -21,10 +23,15 @@ public:
     Scrollbar(size_t messagesLimit, ChannelView *parent = nullptr);
 
     void addHighlight(ScrollbarHighlight highlight);
+    void addHighlights(const std::vector<ScrollbarHighlight> &highlights);
     void addHighlightsAtStart(
         const std::vector<ScrollbarHighlight> &highlights_);
     void replaceHighlight(size_t index, ScrollbarHighlight replacement);
 
+    /// Sets where the highlight at an index starts, as a fraction of the
+    /// track's height. Without it, the highlights are spread evenly.
+    void setHighlightPosition(std::function<qreal(size_t)> position);
+
     void pauseHighlights();
     void unpauseHighlights();
     void clearHighlights();
@@ -78,6 +85,7 @@ private:
     LimitedQueue<ScrollbarHighlight> highlights_;
     bool highlightsPaused_{false};
     LimitedQueueSnapshot<ScrollbarHighlight> highlightSnapshot_;
+    std::function<qreal(size_t)> highlightPosition_;
 
     bool atBottom_{false};
 
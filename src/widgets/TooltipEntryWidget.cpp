@@ -1,5 +1,8 @@
 #include "widgets/TooltipEntryWidget.hpp"
 
+#include "Application.hpp"
+#include "singletons/Emotes.hpp"
+
 #include <QVBoxLayout>
 
 namespace chatterino {
@@ -98,6 +101,12 @@ bool TooltipEntryWidget::refreshPixmap()
     }
     this->displayImage_->show();
 
+    if (this->image_->animated())
+    {
+        // TooltipWidget refreshes animated entries on every tick
+        getApp()->emotes->gifTimer.wake();
+    }
+
     return true;
 }
 
@@ -169,20 +169,35 @@ void ReplyThreadPopup::addMessagesFromThread()
         }
     }
 
-    this->messageConnection_ =
-        std::make_unique<pajlada::Signals::ScopedConnection>(
-            sourceChannel->messageAppended.connect(
-                [this, virtualChannel](MessagePtr &message, auto) {
-                    if (message->replyThread == this->thread_)
-                    {
-                        auto overrideFlags =
-                            boost::optional<MessageFlags>(message->flags);
-                        overrideFlags->set(MessageFlag::DoNotLog);
-
-                        // same reply thread, add message
-                        virtualChannel->addMessage(message, overrideFlags);
-                    }
-                }));
+    this->messageConnections_.clear();
+    this->messageConnections_.managedConnect(
+        sourceChannel->messageAppended,
+        [this, virtualChannel](MessagePtr &message, auto) {
+            if (message->replyThread == this->thread_)
+            {
+                auto overrideFlags =
+                    boost::optional<MessageFlags>(message->flags);
+                overrideFlags->set(MessageFlag::DoNotLog);
+
+                // same reply thread, add message
+                virtualChannel->addMessage(message, overrideFlags);
+            }
+        });
+    this->messageConnections_.managedConnect(
+        sourceChannel->messagesAppended,
+        [this, virtualChannel](std::vector<MessagePtr> &messages) {
+            std::vector<MessagePtr> replies;
+            for (const auto &message : messages)
+            {
+                if (message->replyThread == this->thread_)
+                {
+                    replies.push_back(message);
+                }
+            }
+
+            // same reply thread, add messages
+            virtualChannel->addMessages(std::move(replies), false);
+        });
 }
 
 void ReplyThreadPopup::updateInputUI()
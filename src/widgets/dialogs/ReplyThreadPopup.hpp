@@ -4,8 +4,8 @@
 #include "widgets/DraggablePopup.hpp"
 
 #include <boost/signals2.hpp>
-#include <pajlada/signals/scoped-connection.hpp>
 #include <pajlada/signals/signal.hpp>
+#include <pajlada/signals/signalholder.hpp>
 
 namespace chatterino {
 
@@ -41,7 +41,7 @@ private:
         SplitInput *replyInput = nullptr;
     } ui_;
 
-    std::unique_ptr<pajlada::Signals::ScopedConnection> messageConnection_;
+    pajlada::Signals::SignalHolder messageConnections_;
     std::vector<boost::signals2::scoped_connection> bSignals_;
 };
 
@@ -92,9 +92,6 @@ namespace {
 
     ChannelPtr filterMessages(const QString &userName, ChannelPtr channel)
     {
-        LimitedQueueSnapshot<MessagePtr> snapshot =
-            channel->getMessageSnapshot();
-
         ChannelPtr channelPtr;
         if (channel->isTwitchChannel())
         {
@@ -106,10 +103,8 @@ namespace {
                                                    Channel::Type::None);
         }
 
-        for (size_t i = 0; i < snapshot.size(); i++)
+        for (const auto &message : channel->getUserMessages(userName))
         {
-            MessagePtr message = snapshot[i];
-
             auto overrideFlags = boost::optional<MessageFlags>(message->flags);
             overrideFlags->set(MessageFlag::DoNotLog);
 
@@ -772,26 +767,51 @@ void UserInfoPopup::updateLatestMessages()
     // shrink dialog in case ChannelView goes from visible to hidden
     this->adjustSize();
 
-    this->refreshConnection_ =
-        std::make_unique<pajlada::Signals::ScopedConnection>(
-            this->underlyingChannel_->messageAppended.connect(
-                [this, hasMessages](auto message, auto) {
-                    if (!checkMessageUserName(this->userName_, message))
-                        return;
+    this->refreshConnections_.clear();
+    this->refreshConnections_.managedConnect(
+        this->underlyingChannel_->messageAppended,
+        [this, hasMessages](auto message, auto) {
+            if (!checkMessageUserName(this->userName_, message))
+                return;
 
-                    if (hasMessages)
-                    {
-                        // display message in ChannelView
-                        this->ui_.latestMessages->channel()->addMessage(
-                            message);
-                    }
-                    else
-                    {
-                        // The ChannelView is currently hidden, so manually refresh
-                        // and display the latest messages
-                        this->updateLatestMessages();
-                    }
-                }));
+            if (hasMessages)
+            {
+                // display message in ChannelView
+                this->ui_.latestMessages->channel()->addMessage(message);
+            }
+            else
+            {
+                // The ChannelView is currently hidden, so manually refresh
+                // and display the latest messages
+                this->updateLatestMessages();
+            }
+        });
+    this->refreshConnections_.managedConnect(
+        this->underlyingChannel_->messagesAppended,
+        [this, hasMessages](std::vector<MessagePtr> &messages) {
+            std::vector<MessagePtr> userMessages;
+            for (const auto &message : messages)
+            {
+                if (checkMessageUserName(this->userName_, message))
+                {
+                    userMessages.push_back(message);
+                }
+            }
+
+            if (userMessages.empty())
+                return;
+
+            if (hasMessages)
+            {
+                // The messages were already logged by the underlying channel
+                this->ui_.latestMessages->channel()->addMessages(
+                    std::move(userMessages), false);
+            }
+            else
+            {
+                this->updateLatestMessages();
+            }
+        });
 }
 
 void UserInfoPopup::updateUserData()
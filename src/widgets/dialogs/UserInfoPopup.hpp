@@ -4,8 +4,8 @@
 #include "widgets/BaseWindow.hpp"
 #include "widgets/DraggablePopup.hpp"
 
-#include <pajlada/signals/scoped-connection.hpp>
 #include <pajlada/signals/signal.hpp>
+#include <pajlada/signals/signalholder.hpp>
 #include <QMovie>
 
 #include <chrono>
@@ -72,7 +72,7 @@ private:
 
     pajlada::Signals::NoArgSignal userStateChanged_;
 
-    std::unique_ptr<pajlada::Signals::ScopedConnection> refreshConnection_;
+    pajlada::Signals::SignalHolder refreshConnections_;
 
     // If we should close the dialog automatically if the user clicks out
     // Initially set based on the "Automatically close usercard when it loses focus" setting
@@ -10,6 +10,7 @@
 #include "debug/Benchmark.hpp"
 #include "messages/Emote.hpp"
 #include "messages/Image.hpp"
+#include "messages/layouts/FrameDamageTracker.hpp"
 #include "messages/layouts/MessageLayout.hpp"
 #include "messages/layouts/MessageLayoutElement.hpp"
 #include "messages/LimitedQueueSnapshot.hpp"
@@ -24,11 +25,13 @@
 #include "providers/twitch/TwitchAccount.hpp"
 #include "providers/twitch/TwitchChannel.hpp"
 #include "providers/twitch/TwitchIrcServer.hpp"
+#include "singletons/Emotes.hpp"
 #include "singletons/Resources.hpp"
 #include "singletons/Settings.hpp"
 #include "singletons/Theme.hpp"
 #include "singletons/WindowManager.hpp"
 #include "util/Clipboard.hpp"
+#include "util/DebugCount.hpp"
 #include "util/DistanceBetweenPoints.hpp"
 #include "util/Helpers.hpp"
 #include "util/IncognitoBrowser.hpp"
@@ -192,6 +195,7 @@ ChannelView::ChannelView(BaseWidget *parent, Split *split, Context context,
     , highlightAnimation_(this)
     , context_(context)
     , messages_(messagesLimit)
+    , heightIndex_(messagesLimit)
 {
     this->setMouseTracking(true);
 
@@ -262,10 +266,43 @@ void ChannelView::initializeLayout()
 
 void ChannelView::initializeScrollbar()
 {
+    // Highlights are drawn next to their messages, which have different
+    // heights. The highlights mirror messages_, like heightIndex_.
+    this->scrollBar_->setHighlightPosition([this](size_t index) {
+        auto totalHeight = this->heightIndex_.totalHeight();
+        if (totalHeight == 0)
+        {
+            return qreal(0);
+        }
+        return qreal(this->heightIndex_.offsetOf(index)) / qreal(totalHeight);
+    });
+
     this->scrollBar_->getCurrentValueChanged().connect([this] {
         this->performLayout(true);
         this->queueUpdate();
     });
+
+    // Merge the messages that arrived during a scroll animation once it's
+    // done. The animation might be restarted right away, so this is queued.
+    QObject::connect(
+        &this->scrollBar_->getCurrentValueAnimation(),
+        &QAbstractAnimation::stateChanged, this,
+        [this](QAbstractAnimation::State newState) {
+            if (newState != QAbstractAnimation::Stopped)
+            {
+                return;
+            }
+
+            QMetaObject::invokeMethod(
+                this,
+                [this] {
+                    if (!this->isScrollAnimating())
+                    {
+                        this->mergePendingAppends();
+                    }
+                },
+                Qt::QueuedConnection);
+        });
 }
 
 void ChannelView::initializeSignals()
@@ -284,7 +321,7 @@ void ChannelView::initializeSignals()
 
     this->signalHolder_.managedConnect(getApp()->windows->gifRepaintRequested,
                                        [&] {
-                                           this->queueUpdate();
+                                           this->repaintAnimatedElements();
                                        });
 
     this->signalHolder_.managedConnect(
@@ -491,27 +528,31 @@ void ChannelView::performLayout(bool causedByScrollbar)
 }
 
 void ChannelView::layoutVisibleMessages(
-    const LimitedQueueSnapshot<MessageLayoutPtr> &messages)
+    const LimitedQueueSnapshot<MessageSlot> &messages)
 {
-    const auto start = size_t(this->scrollBar_->getCurrentValue());
+    const auto value = this->scrollBar_->getCurrentValue();
+    const auto start = this->snapshotIndexAt(value);
     const auto layoutWidth = this->getLayoutWidth();
     const auto flags = this->getFlags();
     auto redrawRequired = false;
 
     if (messages.size() > start)
     {
-        auto y = int(-(messages[start]->getHeight() *
-                       (fmod(this->scrollBar_->getCurrentValue(), 1))));
+        auto end = start;
+        auto y = int(qreal(this->snapshotOffsetOf(start)) - value);
 
         for (auto i = start; i < messages.size() && y <= this->height(); i++)
         {
-            const auto &message = messages[i];
-
-            redrawRequired |=
-                message->layout(layoutWidth, this->scale(), flags);
+            bool changed = false;
+            auto layout = this->layoutAt(i, layoutWidth, flags, &changed);
+            redrawRequired |= changed;
+            this->updateLayoutHeight(i, *layout);
 
-            y += message->getHeight();
+            y += layout->getHeight();
+            end = i;
         }
+
+        this->releaseDistantLayouts(start, end);
     }
 
     if (redrawRequired)
@@ -521,8 +562,7 @@ void ChannelView::layoutVisibleMessages(
 }
 
 void ChannelView::updateScrollbar(
-    const LimitedQueueSnapshot<MessageLayoutPtr> &messages,
-    bool causedByScrollbar)
+    const LimitedQueueSnapshot<MessageSlot> &messages, bool causedByScrollbar)
 {
     if (messages.size() == 0)
     {
@@ -530,33 +570,16 @@ void ChannelView::updateScrollbar(
         return;
     }
 
-    /// Layout the messages at the bottom
-    auto h = this->height() - 8;
-    auto flags = this->getFlags();
-    auto layoutWidth = this->getLayoutWidth();
-    auto showScrollbar = false;
-
-    // convert i to int since it checks >= 0
-    for (auto i = int(messages.size()) - 1; i >= 0; i--)
-    {
-        auto *message = messages[i].get();
-
-        message->layout(layoutWidth, this->scale(), flags);
-
-        h -= message->getHeight();
-
-        if (h < 0)  // break condition
-        {
-            this->scrollBar_->setLargeChange(
-                (messages.size() - i) +
-                qreal(h) / std::max<int>(1, message->getHeight()));
-
-            showScrollbar = true;
-            break;
-        }
-    }
+    // Messages that weren't laid out yet count with their estimated height.
+    // The ones at the bottom are laid out once they're scrolled to.
+    auto viewHeight = qreal(this->height() - 8);
+    auto totalHeight = qreal(this->snapshotOffsetOf(messages.size()));
+    auto showScrollbar = totalHeight > viewHeight;
 
     /// Update scrollbar values
+    this->scrollBar_->setLargeChange(viewHeight);
+    // Clicks on the track scroll by about five messages
+    this->scrollBar_->setSmallChange(5 * this->heightIndex_.estimatedHeight());
     this->scrollBar_->setVisible(showScrollbar);
 
     if (!showScrollbar && !causedByScrollbar)
@@ -565,7 +588,7 @@ void ChannelView::updateScrollbar(
     }
     this->showScrollBar_ = showScrollbar;
 
-    this->scrollBar_->setMaximum(messages.size());
+    this->scrollBar_->setMaximum(totalHeight);
 
     // If we were showing the latest messages and the scrollbar now wants to be
     // rendered, scroll to bottom
@@ -582,7 +605,9 @@ void ChannelView::updateScrollbar(
 void ChannelView::clearMessages()
 {
     // Clear all stored messages in this chat widget
+    this->pendingAppends_ = {};
     this->messages_.clear();
+    this->clearLayoutIndex();
     this->scrollBar_->clearHighlights();
     this->queueLayout();
 
@@ -599,7 +624,7 @@ QString ChannelView::getSelectedText()
 {
     QString result = "";
 
-    LimitedQueueSnapshot<MessageLayoutPtr> &messagesSnapshot =
+    LimitedQueueSnapshot<MessageSlot> &messagesSnapshot =
         this->getMessagesSnapshot();
 
     Selection selection = this->selection_;
@@ -619,9 +644,13 @@ QString ChannelView::getSelectedText()
         return result;
     }
 
+    const auto layoutWidth = this->getLayoutWidth();
+    const auto flags = this->getFlags();
     for (auto msg = indexStart; msg <= indexEnd; msg++)
     {
-        MessageLayoutPtr layout = messagesSnapshot[msg];
+        // Messages far away from the visible ones aren't laid out
+        MessageLayoutPtr layout = this->layoutAt(msg, layoutWidth, flags);
+
         auto from = msg == selection.selectionMin.messageIndex
                         ? selection.selectionMin.charIndex
                         : 0;
@@ -672,12 +701,14 @@ const boost::optional<MessageElementFlags> &ChannelView::getOverrideFlags()
     return this->overrideFlags_;
 }
 
-LimitedQueueSnapshot<MessageLayoutPtr> &ChannelView::getMessagesSnapshot()
+LimitedQueueSnapshot<MessageSlot> &ChannelView::getMessagesSnapshot()
 {
     this->snapshotGuard_.guard();
     if (!this->paused() /*|| this->scrollBar_->isVisible()*/)
     {
         this->snapshot_ = this->messages_.getSnapshot();
+        this->snapshotHeadPosition_ = this->heightIndex_.headPosition();
+        this->snapshotHeadOffset_ = this->heightIndex_.headOffset();
     }
 
     return this->snapshot_;
@@ -741,6 +772,35 @@ void ChannelView::setChannel(ChannelPtr underlyingChannel)
             }
         });
 
+    this->channelConnections_.managedConnect(
+        underlyingChannel->messagesAppended,
+        [this](std::vector<MessagePtr> &messages) {
+            std::vector<MessagePtr> filtered;
+            filtered.reserve(messages.size());
+            std::copy_if(messages.begin(), messages.end(),
+                         std::back_inserter(filtered), [this](MessagePtr msg) {
+                             return this->shouldIncludeMessage(msg);
+                         });
+
+            if (filtered.empty())
+            {
+                return;
+            }
+
+            if (this->channel_->lastDate_ != QDate::currentDate())
+            {
+                this->channel_->lastDate_ = QDate::currentDate();
+                auto msg = makeSystemMessage(
+                    QLocale().toString(QDate::currentDate(),
+                                       QLocale::LongFormat),
+                    QTime(0, 0));
+                this->channel_->addMessage(msg);
+            }
+
+            // The messages were already logged by the underlyingChannel
+            this->channel_->addMessages(std::move(filtered), false);
+        });
+
     this->channelConnections_.managedConnect(
         underlyingChannel->messagesAddedAtStart,
         [this](std::vector<MessagePtr> &messages) {
@@ -784,6 +844,12 @@ void ChannelView::setChannel(ChannelPtr underlyingChannel)
             this->messageAppended(message, std::move(overridingFlags));
         });
 
+    this->channelConnections_.managedConnect(
+        this->channel_->messagesAppended,
+        [this](std::vector<MessagePtr> &messages) {
+            this->messagesAppended(messages, boost::none);
+        });
+
     this->channelConnections_.managedConnect(
         this->channel_->messagesAddedAtStart,
         [this](std::vector<MessagePtr> &messages) {
@@ -811,27 +877,55 @@ void ChannelView::setChannel(ChannelPtr underlyingChannel)
 
     auto snapshot = underlyingChannel->getMessageSnapshot();
 
-    for (const auto &msg : snapshot)
+    // Only the newest messages fit into the view, the others would be evicted
+    // right away. Layouts are only made once the messages are about to be
+    // visible, see layoutVisibleMessages.
+    const auto capacity = this->heightIndex_.capacity();
+    const auto first = snapshot.size() - std::min(snapshot.size(), capacity);
+    if (first % 2 == 1)
     {
-        auto messageLayout = std::make_shared<MessageLayout>(msg);
+        this->lastMessageHasAlternateBackground_ =
+            !this->lastMessageHasAlternateBackground_;
+    }
+
+    const bool ignoreHighlights = underlyingChannel->shouldIgnoreHighlights();
+    const bool showHighlights = this->showScrollbarHighlights();
+    std::vector<MessageSlot> slots;
+    std::vector<ScrollbarHighlight> highlights;
+    slots.reserve(snapshot.size() - first);
+    if (showHighlights)
+    {
+        highlights.reserve(snapshot.size() - first);
+    }
+
+    for (auto i = first; i < snapshot.size(); ++i)
+    {
+        const auto &msg = snapshot[i];
+        MessageSlot slot{msg, {}};
 
         if (this->lastMessageHasAlternateBackground_)
         {
-            messageLayout->flags.set(MessageLayoutFlag::AlternateBackground);
+            slot.layoutFlags.set(MessageLayoutFlag::AlternateBackground);
         }
         this->lastMessageHasAlternateBackground_ =
             !this->lastMessageHasAlternateBackground_;
 
-        if (underlyingChannel->shouldIgnoreHighlights())
+        if (ignoreHighlights)
         {
-            messageLayout->flags.set(MessageLayoutFlag::IgnoreHighlights);
+            slot.layoutFlags.set(MessageLayoutFlag::IgnoreHighlights);
         }
 
-        this->messages_.pushBack(messageLayout);
-        if (this->showScrollbarHighlights())
+        if (showHighlights)
         {
-            this->scrollBar_->addHighlight(msg->getScrollBarHighlight());
+            highlights.push_back(msg->getScrollBarHighlight());
         }
+        slots.push_back(std::move(slot));
+    }
+
+    this->pushBackSlots(slots);
+    if (!highlights.empty())
+    {
+        this->scrollBar_->addHighlights(highlights);
     }
 
     this->underlyingChannel_ = underlyingChannel;
@@ -902,106 +996,202 @@ bool ChannelView::hasSourceChannel() const
 void ChannelView::messageAppended(MessagePtr &message,
                                   boost::optional<MessageFlags> overridingFlags)
 {
-    auto *messageFlags = &message->flags;
-    if (overridingFlags)
+    std::vector<MessagePtr> messages{message};
+    this->messagesAppended(messages, std::move(overridingFlags));
+}
+
+void ChannelView::messagesAppended(
+    std::vector<MessagePtr> &messages,
+    boost::optional<MessageFlags> overridingFlags)
+{
+    std::vector<MessageSlot> slots;
+    slots.reserve(messages.size());
+
+    for (const auto &message : messages)
     {
-        messageFlags = overridingFlags.get_ptr();
+        MessageSlot slot{message, {}};
+
+        if (this->lastMessageHasAlternateBackground_)
+        {
+            slot.layoutFlags.set(MessageLayoutFlag::AlternateBackground);
+        }
+        if (this->channel_->shouldIgnoreHighlights())
+        {
+            slot.layoutFlags.set(MessageLayoutFlag::IgnoreHighlights);
+        }
+        this->lastMessageHasAlternateBackground_ =
+            !this->lastMessageHasAlternateBackground_;
+
+        slots.push_back(std::move(slot));
     }
 
-    auto messageRef = std::make_shared<MessageLayout>(message);
+    std::vector<ScrollbarHighlight> highlights;
+    if (this->showScrollbarHighlights())
+    {
+        highlights.reserve(messages.size());
+        for (const auto &message : messages)
+        {
+            highlights.push_back(message->getScrollBarHighlight());
+        }
+    }
 
-    if (this->lastMessageHasAlternateBackground_)
+    // Request a single tab highlight for the whole batch, mentions win
+    boost::optional<HighlightState> tabHighlight;
+    for (const auto &message : messages)
     {
-        messageRef->flags.set(MessageLayoutFlag::AlternateBackground);
+        const auto &messageFlags =
+            overridingFlags ? overridingFlags.get() : message->flags;
+
+        if (messageFlags.has(MessageFlag::DoNotTriggerNotification))
+        {
+            continue;
+        }
+
+        if (messageFlags.has(MessageFlag::Highlighted) &&
+            messageFlags.has(MessageFlag::ShowInMentions) &&
+            !messageFlags.has(MessageFlag::Subscription) &&
+            (getSettings()->highlightMentions ||
+             this->channel_->getType() != Channel::Type::TwitchMentions))
+        {
+            tabHighlight = HighlightState::Highlighted;
+            break;
+        }
+
+        tabHighlight = HighlightState::NewMessage;
     }
-    if (this->channel_->shouldIgnoreHighlights())
+
+    if (tabHighlight)
     {
-        messageRef->flags.set(MessageLayoutFlag::IgnoreHighlights);
+        this->tabHighlightRequested.invoke(tabHighlight.get());
     }
-    this->lastMessageHasAlternateBackground_ =
-        !this->lastMessageHasAlternateBackground_;
 
-    if (!this->scrollBar_->isAtBottom() &&
-        this->scrollBar_->getCurrentValueAnimation().state() ==
-            QPropertyAnimation::Running)
+    if (this->isScrollAnimating())
     {
-        QEventLoop loop;
+        // Adding the messages now would move the content under the running
+        // animation, so they're merged once it finishes
+        auto &pending = this->pendingAppends_;
+        if (pending.slots.empty())
+        {
+            pending.deferredSince.start();
+        }
+        pending.slots.insert(pending.slots.end(), slots.begin(), slots.end());
+        pending.highlights.insert(pending.highlights.end(),
+                                  highlights.begin(), highlights.end());
+        return;
+    }
 
-        connect(&this->scrollBar_->getCurrentValueAnimation(),
-                &QAbstractAnimation::stateChanged, &loop, &QEventLoop::quit);
+    this->mergePendingAppends();
+    this->appendSlots(slots, highlights);
+}
 
-        loop.exec();
-    }
+bool ChannelView::isScrollAnimating() const
+{
+    return !this->scrollBar_->isAtBottom() &&
+           this->scrollBar_->getCurrentValueAnimation().state() ==
+               QPropertyAnimation::Running;
+}
 
-    if (this->messages_.pushBack(messageRef))
+void ChannelView::appendSlots(const std::vector<MessageSlot> &slots,
+                              const std::vector<ScrollbarHighlight> &highlights)
+{
+    auto removedHeight = this->pushBackSlots(slots);
+
+    // Evicting messages from the top moves the content up by their height
+    if (removedHeight > 0)
     {
         if (this->paused())
         {
             if (!this->scrollBar_->isAtBottom())
-                this->pauseScrollOffset_--;
+                this->pauseScrollOffset_ -= int(removedHeight);
         }
         else
         {
             if (this->scrollBar_->isAtBottom())
                 this->scrollBar_->scrollToBottom();
             else
-                this->scrollBar_->offset(-1);
+                this->scrollBar_->offset(-qreal(removedHeight));
         }
     }
 
-    if (!messageFlags->has(MessageFlag::DoNotTriggerNotification))
+    if (!highlights.empty())
     {
-        if (messageFlags->has(MessageFlag::Highlighted) &&
-            messageFlags->has(MessageFlag::ShowInMentions) &&
-            !messageFlags->has(MessageFlag::Subscription) &&
-            (getSettings()->highlightMentions ||
-             this->channel_->getType() != Channel::Type::TwitchMentions))
+        this->scrollBar_->addHighlights(highlights);
+    }
 
-        {
-            this->tabHighlightRequested.invoke(HighlightState::Highlighted);
-        }
-        else
-        {
-            this->tabHighlightRequested.invoke(HighlightState::NewMessage);
-        }
+    this->messageWasAdded_ = true;
+    this->queueLayout();
+}
+
+void ChannelView::mergePendingAppends()
+{
+    auto pending = std::move(this->pendingAppends_);
+    this->pendingAppends_ = {};
+
+    if (pending.removedFromStart > 0)
+    {
+        this->shiftSelection(pending.removedFromStart);
     }
 
-    if (this->showScrollbarHighlights())
+    if (pending.slots.empty())
     {
-        this->scrollBar_->addHighlight(message->getScrollBarHighlight());
+        return;
     }
 
-    this->messageWasAdded_ = true;
-    this->queueLayout();
+    DebugCount::increase("deferred message layouts", pending.slots.size());
+    DebugCount::increase("deferred message layouts (total ms)",
+                         pending.deferredSince.elapsed());
+
+    this->appendSlots(pending.slots, pending.highlights);
+}
+
+void ChannelView::shiftSelection(uint32_t removedFromStart)
+{
+    if (this->paused())
+    {
+        this->pauseSelectionOffset_ += removedFromStart;
+    }
+    else
+    {
+        this->selection_.shiftMessageIndex(removedFromStart);
+    }
 }
 
 void ChannelView::messageAddedAtStart(std::vector<MessagePtr> &messages)
 {
-    std::vector<MessageLayoutPtr> messageRefs;
-    messageRefs.resize(messages.size());
+    this->mergePendingAppends();
 
-    /// Create message layouts
+    std::vector<MessageSlot> slots;
+    slots.resize(messages.size());
+
+    /// Create message slots
     for (size_t i = 0; i < messages.size(); i++)
     {
-        auto message = messages.at(i);
-        auto layout = std::make_shared<MessageLayout>(message);
+        auto &slot = slots.at(i);
+        slot.message = messages.at(i);
 
         // alternate color
         if (!this->lastMessageHasAlternateBackgroundReverse_)
-            layout->flags.set(MessageLayoutFlag::AlternateBackground);
+            slot.layoutFlags.set(MessageLayoutFlag::AlternateBackground);
         this->lastMessageHasAlternateBackgroundReverse_ =
             !this->lastMessageHasAlternateBackgroundReverse_;
-
-        messageRefs.at(i) = std::move(layout);
     }
 
     /// Add the messages at the start
-    if (this->messages_.pushFront(messageRefs).size() > 0)
+    auto headOffset = this->heightIndex_.headOffset();
+    auto pushed = this->messages_.pushFront(slots);
+    for (auto it = pushed.rbegin(); it != pushed.rend(); ++it)
+    {
+        this->indexSlotAtFront(*it);
+    }
+
+    // The content moves down by the height of the new messages
+    if (!pushed.empty())
     {
         if (this->scrollBar_->isAtBottom())
             this->scrollBar_->scrollToBottom();
         else
-            this->scrollBar_->offset(qreal(messages.size()));
+            this->scrollBar_->offset(
+                qreal(headOffset - this->heightIndex_.headOffset()));
     }
 
     if (this->showScrollbarHighlights())
@@ -1022,39 +1212,49 @@ void ChannelView::messageAddedAtStart(std::vector<MessagePtr> &messages)
 
 void ChannelView::messageRemoveFromStart(MessagePtr &message)
 {
-    if (this->paused())
+    if (this->isScrollAnimating())
     {
-        this->pauseSelectionOffset_ += 1;
-    }
-    else
-    {
-        this->selection_.shiftMessageIndex(1);
+        // The message is only removed once the pending ones are merged
+        this->pendingAppends_.removedFromStart++;
+        return;
     }
 
+    this->mergePendingAppends();
+    this->shiftSelection(1);
+
     this->queueLayout();
 }
 
 void ChannelView::messageReplaced(size_t index, MessagePtr &replacement)
 {
-    auto oMessage = this->messages_.get(index);
-    if (!oMessage)
+    this->mergePendingAppends();
+
+    auto oSlot = this->messages_.get(index);
+    if (!oSlot)
     {
         return;
     }
 
-    auto message = *oMessage;
+    auto slot = *oSlot;
 
-    auto newItem = std::make_shared<MessageLayout>(replacement);
+    MessageSlot newSlot{replacement, {}};
 
-    if (message->flags.has(MessageLayoutFlag::AlternateBackground))
+    if (slot.layoutFlags.has(MessageLayoutFlag::AlternateBackground))
     {
-        newItem->flags.set(MessageLayoutFlag::AlternateBackground);
+        newSlot.layoutFlags.set(MessageLayoutFlag::AlternateBackground);
     }
 
     this->scrollBar_->replaceHighlight(index,
                                        replacement->getScrollBarHighlight());
 
-    this->messages_.replaceItem(message, newItem);
+    // The old layout is replaced once the position is laid out again, see
+    // layoutAt
+    this->messages_.replaceItem(index, newSlot);
+
+    this->messagePositions_.erase(slot.message.get());
+    this->messagePositions_[replacement.get()] =
+        this->heightIndex_.headPosition() + int64_t(index);
+
     this->queueLayout();
 }
 
@@ -1062,33 +1262,38 @@ void ChannelView::messagesUpdated()
 {
     auto snapshot = this->channel_->getMessageSnapshot();
 
+    this->pendingAppends_ = {};
     this->messages_.clear();
+    this->clearLayoutIndex();
     this->scrollBar_->clearHighlights();
     this->lastMessageHasAlternateBackground_ = false;
     this->lastMessageHasAlternateBackgroundReverse_ = true;
 
+    std::vector<MessageSlot> slots;
+    slots.reserve(snapshot.size());
     for (const auto &msg : snapshot)
     {
-        auto messageLayout = std::make_shared<MessageLayout>(msg);
+        MessageSlot slot{msg, {}};
 
         if (this->lastMessageHasAlternateBackground_)
         {
-            messageLayout->flags.set(MessageLayoutFlag::AlternateBackground);
+            slot.layoutFlags.set(MessageLayoutFlag::AlternateBackground);
         }
         this->lastMessageHasAlternateBackground_ =
             !this->lastMessageHasAlternateBackground_;
 
         if (this->channel_->shouldIgnoreHighlights())
         {
-            messageLayout->flags.set(MessageLayoutFlag::IgnoreHighlights);
+            slot.layoutFlags.set(MessageLayoutFlag::IgnoreHighlights);
         }
 
-        this->messages_.pushBack(messageLayout);
+        slots.push_back(std::move(slot));
         if (this->showScrollbarHighlights())
         {
             this->scrollBar_->addHighlight(msg->getScrollBarHighlight());
         }
     }
+    this->pushBackSlots(slots);
 
     this->queueLayout();
 }
@@ -1097,7 +1302,7 @@ void ChannelView::updateLastReadMessage()
 {
     if (auto lastMessage = this->messages_.last())
     {
-        this->lastReadMessage_ = *lastMessage;
+        this->lastReadMessage_ = lastMessage->message;
     }
 
     this->update();
@@ -1208,77 +1413,356 @@ bool ChannelView::scrollToMessage(const MessagePtr &message)
         return false;
     }
 
-    auto &messagesSnapshot = this->getMessagesSnapshot();
-    if (messagesSnapshot.size() == 0)
+    this->getMessagesSnapshot();
+    auto messageIdx = this->snapshotIndexOf(message.get());
+    if (!messageIdx)
     {
         return false;
     }
 
-    // TODO: Figure out if we can somehow binary-search here.
-    //       Currently, a message only sometimes stores a QDateTime,
-    //       but always a QTime (inaccurate on midnight).
-    //
-    // We're searching from the bottom since it's more likely for a user
-    // wanting to go to a message that recently scrolled out of view.
-    size_t messageIdx = messagesSnapshot.size() - 1;
-    for (; messageIdx < SIZE_MAX; messageIdx--)
+    this->scrollToMessageLayout(this->layoutAt(*messageIdx).get(),
+                                *messageIdx);
+    getApp()->windows->select(this->split_);
+    return true;
+}
+
+bool ChannelView::scrollToMessageId(const QString &messageId)
+{
+    this->getMessagesSnapshot();
+
+    MessagePtr message;
+    if (this->underlyingChannel_)
     {
-        if (messagesSnapshot[messageIdx]->getMessagePtr() == message)
-        {
-            break;
-        }
+        message = this->underlyingChannel_->findMessage(messageId);
+    }
+    if (!message)
+    {
+        message = this->channel_->findMessage(messageId);
+    }
+    if (!message)
+    {
+        return false;
     }
 
-    if (messageIdx == SIZE_MAX)
+    auto messageIdx = this->snapshotIndexOf(message.get());
+    if (!messageIdx)
     {
         return false;
     }
 
-    this->scrollToMessageLayout(messagesSnapshot[messageIdx].get(), messageIdx);
+    this->scrollToMessageLayout(this->layoutAt(*messageIdx).get(),
+                                *messageIdx);
     getApp()->windows->select(this->split_);
     return true;
 }
 
-bool ChannelView::scrollToMessageId(const QString &messageId)
+void ChannelView::scrollByPages(qreal pages)
 {
-    auto &messagesSnapshot = this->getMessagesSnapshot();
-    if (messagesSnapshot.size() == 0)
+    this->scrollByPixels(pages * qreal(this->height()), false);
+}
+
+void ChannelView::scrollByPixels(qreal pixels, bool animated)
+{
+    auto &snapshot = this->getMessagesSnapshot();
+    if (snapshot.size() == 0 || !this->scrollBar_->isVisible())
     {
-        return false;
+        return;
     }
 
-    // We're searching from the bottom since it's more likely for a user
-    // wanting to go to a message that recently scrolled out of view.
-    size_t messageIdx = messagesSnapshot.size() - 1;
-    for (; messageIdx < SIZE_MAX; messageIdx--)
+    // Lay out the messages we scroll over, so the distance is exact
+    auto value = std::max<qreal>(0, this->scrollBar_->getDesiredValue());
+    auto top = this->snapshotIndexAt(value);
+    auto layoutWidth = this->getLayoutWidth();
+    auto flags = this->getFlags();
+
+    // Messages above the top that change their height move the content
+    // below them, that's made up for by shifting the value
+    int shift = 0;
+    if (pixels < 0)
     {
-        if (messagesSnapshot[messageIdx]->getMessagePtr()->id == messageId)
+        auto covered = value - qreal(this->snapshotOffsetOf(top));
+        for (auto i = top; i-- > 0 && covered < -pixels;)
         {
-            break;
+            auto layout = this->layoutAt(i, layoutWidth, flags);
+            shift += this->updateLayoutHeight(i, *layout);
+            covered += layout->getHeight();
         }
     }
-
-    if (messageIdx == SIZE_MAX)
+    else
     {
-        return false;
+        auto covered = qreal(this->snapshotOffsetOf(top)) - value;
+        for (auto i = top; i < snapshot.size() && covered < pixels; i++)
+        {
+            auto layout = this->layoutAt(i, layoutWidth, flags);
+            this->updateLayoutHeight(i, *layout);
+            covered += layout->getHeight();
+        }
     }
 
-    this->scrollToMessageLayout(messagesSnapshot[messageIdx].get(), messageIdx);
-    getApp()->windows->select(this->split_);
-    return true;
+    if (animated)
+    {
+        if (shift != 0)
+        {
+            this->scrollBar_->offset(shift);
+        }
+        this->scrollBar_->setDesiredValue(
+            this->scrollBar_->getDesiredValue() + pixels, true);
+    }
+    else
+    {
+        this->scrollBar_->offset(shift + pixels);
+    }
 }
 
 void ChannelView::scrollToMessageLayout(MessageLayout *layout,
                                         size_t messageIdx)
 {
-    this->highlightedMessage_ = layout;
+    this->highlightedMessage_ = layout->getMessage();
     this->highlightAnimation_.setCurrentTime(0);
     this->highlightAnimation_.start(QAbstractAnimation::KeepWhenStopped);
 
     if (this->showScrollBar_)
     {
-        this->getScrollBar().setDesiredValue(messageIdx);
+        this->getScrollBar().setDesiredValue(
+            qreal(this->snapshotOffsetOf(messageIdx)));
+    }
+}
+
+MessageLayoutPtr ChannelView::layoutAt(size_t index, int width,
+                                       MessageElementFlags flags,
+                                       bool *changed)
+{
+    const auto &slot = this->snapshot_[index];
+    auto &layout =
+        this->laidOutEntry(this->snapshotHeadPosition_ + int64_t(index));
+
+    // The message at the position is different once it was replaced
+    if (layout == nullptr || layout->getMessage() != slot.message.get())
+    {
+        layout = std::make_shared<MessageLayout>(slot.message);
+        layout->flags = slot.layoutFlags;
+    }
+
+    auto layoutChanged = layout->layout(width, this->scale(), flags);
+    if (changed != nullptr)
+    {
+        *changed = layoutChanged;
+    }
+    return layout;
+}
+
+MessageLayoutPtr ChannelView::layoutAt(size_t index)
+{
+    return this->layoutAt(index, this->getLayoutWidth(), this->getFlags());
+}
+
+MessageLayoutPtr &ChannelView::laidOutEntry(int64_t position)
+{
+    auto &laidOut = this->laidOut_;
+    auto maxGap = int64_t(MAX_LAID_OUT_LAYOUTS);
+    auto end = this->laidOutStart_ + int64_t(laidOut.size());
+
+    // Far away from the laid out messages, e.g. after jumping to the top
+    if (laidOut.empty() || position < this->laidOutStart_ - maxGap ||
+        position >= end + maxGap)
+    {
+        laidOut.clear();
+        this->laidOutStart_ = position;
+    }
+
+    for (; position < this->laidOutStart_; this->laidOutStart_--)
+    {
+        laidOut.emplace_front();
+    }
+    while (position >= this->laidOutStart_ + int64_t(laidOut.size()))
+    {
+        laidOut.emplace_back();
+    }
+
+    return laidOut[size_t(position - this->laidOutStart_)];
+}
+
+void ChannelView::releaseDistantLayouts(size_t first, size_t last)
+{
+    auto &laidOut = this->laidOut_;
+    if (laidOut.size() <= MAX_LAID_OUT_LAYOUTS)
+    {
+        return;
+    }
+
+    auto margin = int64_t(LAID_OUT_MARGIN);
+    auto keepFrom = this->snapshotHeadPosition_ + int64_t(first) - margin;
+    auto keepTo = this->snapshotHeadPosition_ + int64_t(last) + margin;
+
+    // Only the ends of the range are dropped, their layouts release their
+    // buffers. The heights stay in heightIndex_.
+    while (!laidOut.empty() && this->laidOutStart_ < keepFrom)
+    {
+        laidOut.pop_front();
+        this->laidOutStart_++;
+    }
+    while (!laidOut.empty() &&
+           this->laidOutStart_ + int64_t(laidOut.size()) - 1 > keepTo)
+    {
+        laidOut.pop_back();
+    }
+}
+
+int64_t ChannelView::pushBackSlots(const std::vector<MessageSlot> &slots)
+{
+    auto headOffset = this->heightIndex_.headOffset();
+
+    std::vector<MessageSlot> evicted;
+    this->messages_.pushBackItems(slots, evicted);
+    // The index has the same limit, so it evicts the same messages
+    for (const auto &slot : slots)
+    {
+        this->indexSlotAtBack(slot);
+    }
+    for (const auto &slot : evicted)
+    {
+        this->unindexEvictedSlot(slot);
+    }
+
+    // A paused view still shows the evicted messages of its snapshot
+    if (!this->paused())
+    {
+        while (!this->laidOut_.empty() &&
+               this->laidOutStart_ < this->heightIndex_.headPosition())
+        {
+            this->laidOut_.pop_front();
+            this->laidOutStart_++;
+        }
+    }
+
+    return this->heightIndex_.headOffset() - headOffset;
+}
+
+void ChannelView::indexSlotAtBack(const MessageSlot &slot)
+{
+    // Not laid out yet, so the height is estimated
+    this->heightIndex_.pushBack();
+    this->messagePositions_[slot.message.get()] =
+        this->heightIndex_.headPosition() +
+        int64_t(this->heightIndex_.size()) - 1;
+}
+
+void ChannelView::indexSlotAtFront(const MessageSlot &slot)
+{
+    if (!this->heightIndex_.pushFront())
+    {
+        return;
+    }
+
+    // Keep the newer position if the message is in the view twice
+    this->messagePositions_.emplace(slot.message.get(),
+                                    this->heightIndex_.headPosition());
+}
+
+void ChannelView::unindexEvictedSlot(const MessageSlot &slot)
+{
+    // If the message is in the view twice, the position is the newer one
+    auto it = this->messagePositions_.find(slot.message.get());
+    if (it != this->messagePositions_.end() &&
+        it->second < this->heightIndex_.headPosition())
+    {
+        this->messagePositions_.erase(it);
+    }
+}
+
+void ChannelView::clearLayoutIndex()
+{
+    this->heightIndex_.clear();
+    this->messagePositions_.clear();
+    this->laidOut_.clear();
+}
+
+int ChannelView::updateLayoutHeight(size_t snapshotIndex,
+                                    const MessageLayout &layout)
+{
+    auto position = this->snapshotHeadPosition_ + int64_t(snapshotIndex) -
+                    this->heightIndex_.headPosition();
+    if (position < 0 || size_t(position) >= this->heightIndex_.size())
+    {
+        // Already evicted while the view was paused
+        return 0;
+    }
+
+    auto height = layout.getHeight();
+    auto previous = this->heightIndex_.height(size_t(position));
+    if (height <= 0 || previous == height)
+    {
+        return 0;
+    }
+
+    this->heightIndex_.setHeight(size_t(position), height);
+    return height - previous;
+}
+
+boost::optional<size_t> ChannelView::snapshotIndexOf(const Message *message)
+{
+    auto it = this->messagePositions_.find(message);
+    if (it == this->messagePositions_.end())
+    {
+        return boost::none;
+    }
+
+    const auto &snapshot = this->snapshot_;
+    auto index = it->second - this->snapshotHeadPosition_;
+    if (index < 0 || size_t(index) >= snapshot.size() ||
+        snapshot[size_t(index)].message.get() != message)
+    {
+        return boost::none;
+    }
+
+    return size_t(index);
+}
+
+int64_t ChannelView::snapshotOffsetOf(size_t index) const
+{
+    // While the view is paused, the index moves on without the snapshot.
+    // Messages evicted since then are gone from the index, they share the
+    // height they had when they were evicted.
+    auto evicted =
+        this->heightIndex_.headPosition() - this->snapshotHeadPosition_;
+    auto evictedHeight =
+        this->heightIndex_.headOffset() - this->snapshotHeadOffset_;
+
+    auto position = int64_t(index) - evicted;
+    if (position < 0)
+    {
+        return evictedHeight * int64_t(index) / evicted;
+    }
+
+    return evictedHeight + this->heightIndex_.offsetOf(size_t(position));
+}
+
+size_t ChannelView::snapshotIndexAt(qreal offset) const
+{
+    const auto size = this->snapshot_.size();
+    if (size == 0 || offset <= 0)
+    {
+        return 0;
+    }
+
+    // See snapshotOffsetOf
+    auto evicted =
+        this->heightIndex_.headPosition() - this->snapshotHeadPosition_;
+    auto evictedHeight =
+        this->heightIndex_.headOffset() - this->snapshotHeadOffset_;
+
+    int64_t index = 0;
+    if (evicted > 0 && offset < qreal(evictedHeight))
+    {
+        index = int64_t(offset * qreal(evicted) / qreal(evictedHeight));
+    }
+    else
+    {
+        index = evicted + int64_t(this->heightIndex_.indexAt(
+                              int64_t(offset) - evictedHeight));
     }
+
+    return size_t(std::clamp<int64_t>(index, 0, int64_t(size) - 1));
 }
 
 void ChannelView::paintEvent(QPaintEvent * /*event*/)
@@ -1306,38 +1790,47 @@ void ChannelView::paintEvent(QPaintEvent * /*event*/)
 // such as the grey overlay when a message is disabled
 void ChannelView::drawMessages(QPainter &painter)
 {
+    // Everything that's visible is painted again, even if only a part of the
+    // view was updated
+    this->animatedElements_.clear();
+
     auto &messagesSnapshot = this->getMessagesSnapshot();
 
-    size_t start = size_t(this->scrollBar_->getCurrentValue());
+    auto value = this->scrollBar_->getCurrentValue();
+    size_t start = this->snapshotIndexAt(value);
 
     if (start >= messagesSnapshot.size())
     {
         return;
     }
 
-    int y = int(-(messagesSnapshot[start].get()->getHeight() *
-                  (fmod(this->scrollBar_->getCurrentValue(), 1))));
+    int y = int(qreal(this->snapshotOffsetOf(start)) - value);
 
-    MessageLayout *end = nullptr;
+    std::vector<MessageLayoutPtr> onScreen;
     bool windowFocused = this->window() == QApplication::activeWindow();
+    const auto layoutWidth = this->getLayoutWidth();
+    const auto flags = this->getFlags();
 
     auto app = getApp();
     bool isMentions = this->underlyingChannel_ == app->twitch->mentionsChannel;
 
     for (size_t i = start; i < messagesSnapshot.size(); ++i)
     {
-        MessageLayout *layout = messagesSnapshot[i].get();
+        // Laid out by layoutVisibleMessages unless the view was just resized
+        auto layout = this->layoutAt(i, layoutWidth, flags);
 
         bool isLastMessage = false;
         if (getSettings()->showLastMessageIndicator)
         {
-            isLastMessage = this->lastReadMessage_.get() == layout;
+            isLastMessage =
+                this->lastReadMessage_ == messagesSnapshot[i].message;
         }
 
         layout->paint(painter, DRAW_WIDTH, y, i, this->selection_,
-                      isLastMessage, windowFocused, isMentions);
+                      isLastMessage, windowFocused, isMentions,
+                      &this->animatedElements_);
 
-        if (this->highlightedMessage_ == layout)
+        if (this->highlightedMessage_ == layout->getMessage())
         {
             painter.fillRect(
                 0, y, layout->getWidth(), layout->getHeight(),
@@ -1350,27 +1843,28 @@ void ChannelView::drawMessages(QPainter &painter)
 
         y += layout->getHeight();
 
-        end = layout;
+        onScreen.push_back(std::move(layout));
         if (y > this->height())
         {
             break;
         }
     }
 
-    if (end == nullptr)
+    if (onScreen.empty())
     {
         return;
     }
 
+    if (!this->animatedElements_.empty())
+    {
+        getApp()->emotes->gifTimer.wake();
+    }
+
     // remove messages that are on screen
     // the messages that are left at the end get their buffers reset
-    for (size_t i = start; i < messagesSnapshot.size(); ++i)
+    for (const auto &layout : onScreen)
     {
-        auto it = this->messagesOnScreen_.find(messagesSnapshot[i]);
-        if (it != this->messagesOnScreen_.end())
-        {
-            this->messagesOnScreen_.erase(it);
-        }
+        this->messagesOnScreen_.erase(layout);
     }
 
     // delete the message buffers that aren't on screen
@@ -1382,16 +1876,24 @@ void ChannelView::drawMessages(QPainter &painter)
     this->messagesOnScreen_.clear();
 
     // add all messages on screen to the map
-    for (size_t i = start; i < messagesSnapshot.size(); ++i)
+    this->messagesOnScreen_.insert(onScreen.begin(), onScreen.end());
+}
+
+void ChannelView::repaintAnimatedElements()
+{
+    if (!this->isVisible() || this->animatedElements_.empty())
     {
-        const std::shared_ptr<MessageLayout> &layout = messagesSnapshot[i];
+        return;
+    }
 
-        this->messagesOnScreen_.insert(layout);
+    auto &gifTimer = getApp()->emotes->gifTimer;
+    gifTimer.wake();
 
-        if (layout.get() == end)
-        {
-            break;
-        }
+    // The damaged elements are added again when they're painted
+    auto damage = this->animatedElements_.takeDue(gifTimer.position());
+    if (!damage.isEmpty())
+    {
+        this->update(damage);
     }
 }
 
@@ -1411,84 +1913,9 @@ void ChannelView::wheelEvent(QWheelEvent *event)
     if (this->scrollBar_->isVisible())
     {
         float mouseMultiplier = getSettings()->mouseScrollMultiplier;
-
-        // This ensures snapshot won't be indexed out of bounds when scrolling really fast
-        qreal desired = std::max<qreal>(0, this->scrollBar_->getDesiredValue());
         qreal delta = event->angleDelta().y() * qreal(1.5) * mouseMultiplier;
 
-        auto &snapshot = this->getMessagesSnapshot();
-        int snapshotLength = int(snapshot.size());
-        int i = std::min<int>(int(desired), snapshotLength);
-
-        if (delta > 0)
-        {
-            qreal scrollFactor = fmod(desired, 1);
-            qreal currentScrollLeft = std::max<qreal>(
-                0.01, int(scrollFactor * snapshot[i]->getHeight()));
-
-            for (; i >= 0; i--)
-            {
-                if (delta < currentScrollLeft)
-                {
-                    desired -= scrollFactor * (delta / currentScrollLeft);
-                    break;
-                }
-                else
-                {
-                    delta -= currentScrollLeft;
-                    desired -= scrollFactor;
-                }
-
-                if (i == 0)
-                {
-                    desired = 0;
-                }
-                else
-                {
-                    snapshot[i - 1]->layout(this->getLayoutWidth(),
-                                            this->scale(), this->getFlags());
-                    scrollFactor = 1;
-                    currentScrollLeft = snapshot[i - 1]->getHeight();
-                }
-            }
-        }
-        else
-        {
-            delta = -delta;
-            qreal scrollFactor = 1 - fmod(desired, 1);
-            qreal currentScrollLeft = std::max<qreal>(
-                0.01, int(scrollFactor * snapshot[i]->getHeight()));
-
-            for (; i < snapshotLength; i++)
-            {
-                if (delta < currentScrollLeft)
-                {
-                    desired +=
-                        scrollFactor * (qreal(delta) / currentScrollLeft);
-                    break;
-                }
-                else
-                {
-                    delta -= currentScrollLeft;
-                    desired += scrollFactor;
-                }
-
-                if (i == snapshotLength - 1)
-                {
-                    desired = snapshot.size();
-                }
-                else
-                {
-                    snapshot[i + 1]->layout(this->getLayoutWidth(),
-                                            this->scale(), this->getFlags());
-
-                    scrollFactor = 1;
-                    currentScrollLeft = snapshot[i + 1]->getHeight();
-                }
-            }
-        }
-
-        this->scrollBar_->setDesiredValue(desired, true);
+        this->scrollByPixels(-delta, true);
     }
 }
 
@@ -1893,7 +2320,7 @@ void ChannelView::mousePressEvent(QMouseEvent *event)
         if (event->button() == Qt::LeftButton)
         {
             auto lastMessageIndex = messagesSnapshot.size() - 1;
-            auto lastMessage = messagesSnapshot[lastMessageIndex];
+            auto lastMessage = this->layoutAt(lastMessageIndex);
             auto lastCharacterIndex = lastMessage->getLastCharacterIndex();
 
             SelectionItem selectionItem(lastMessageIndex, lastCharacterIndex);
@@ -2077,6 +2504,20 @@ void ChannelView::mouseReleaseEvent(QMouseEvent *event)
         layout->flags.set(MessageLayoutFlag::Expanded);
         layout->flags.set(MessageLayoutFlag::RequiresLayout);
 
+        // The layout is dropped once it's far away, the slot remembers it
+        auto queueIndex = this->snapshotHeadPosition_ + int64_t(messageIndex) -
+                          this->heightIndex_.headPosition();
+        boost::optional<MessageSlot> slot;
+        if (queueIndex >= 0)
+        {
+            slot = this->messages_.get(size_t(queueIndex));
+        }
+        if (slot && slot->message == layout->getMessagePtr())
+        {
+            slot->layoutFlags.set(MessageLayoutFlag::Expanded);
+            this->messages_.replaceItem(size_t(queueIndex), *slot);
+        }
+
         this->queueLayout();
         return;
     }
@@ -2866,19 +3307,21 @@ bool ChannelView::tryGetMessageAt(QPoint p,
 {
     auto &messagesSnapshot = this->getMessagesSnapshot();
 
-    size_t start = this->scrollBar_->getCurrentValue();
+    auto value = this->scrollBar_->getCurrentValue();
+    size_t start = this->snapshotIndexAt(value);
 
     if (start >= messagesSnapshot.size())
     {
         return false;
     }
 
-    int y = -(messagesSnapshot[start]->getHeight() *
-              (fmod(this->scrollBar_->getCurrentValue(), 1)));
+    int y = int(qreal(this->snapshotOffsetOf(start)) - value);
+    const auto layoutWidth = this->getLayoutWidth();
+    const auto flags = this->getFlags();
 
     for (size_t i = start; i < messagesSnapshot.size(); ++i)
     {
-        auto message = messagesSnapshot[i];
+        auto message = this->layoutAt(i, layoutWidth, flags);
 
         if (p.y() < y + message->getHeight())
         {
@@ -2972,9 +3415,11 @@ void ChannelView::scrollUpdateRequested()
         offset = delta + cursorHeight;
     }
 
-    // "Good" feeling multiplier found by trial-and-error
+    // "Good" feeling multiplier found by trial-and-error, in messages per
+    // pixel
     const qreal multiplier = qreal(0.02);
-    this->scrollBar_->offset(multiplier * offset);
+    this->scrollBar_->offset(multiplier * offset *
+                             this->heightIndex_.estimatedHeight());
 }
 
 void ChannelView::setInputReply(const MessagePtr &message)
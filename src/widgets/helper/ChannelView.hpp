@@ -1,13 +1,17 @@
 #pragma once
 
 #include "common/FlagsEnum.hpp"
+#include "messages/layouts/FrameDamageTracker.hpp"
 #include "messages/LimitedQueue.hpp"
 #include "messages/LimitedQueueSnapshot.hpp"
 #include "messages/Selection.hpp"
 #include "util/ThreadGuard.hpp"
 #include "widgets/BaseWidget.hpp"
+#include "widgets/helper/MessageHeightIndex.hpp"
+#include "widgets/helper/ScrollbarHighlight.hpp"
 
 #include <pajlada/signals/signal.hpp>
+#include <QElapsedTimer>
 #include <QMenu>
 #include <QPaintEvent>
 #include <QScroller>
@@ -16,6 +20,7 @@
 #include <QWheelEvent>
 #include <QWidget>
 
+#include <deque>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -33,6 +38,8 @@ using MessageFlags = FlagsEnum<MessageFlag>;
 
 class MessageLayout;
 using MessageLayoutPtr = std::shared_ptr<MessageLayout>;
+enum class MessageLayoutFlag : uint8_t;
+using MessageLayoutFlags = FlagsEnum<MessageLayoutFlag>;
 
 enum class MessageElementFlag : int64_t;
 using MessageElementFlags = FlagsEnum<MessageElementFlag>;
@@ -45,6 +52,15 @@ class Split;
 class FilterSet;
 using FilterSetPtr = std::shared_ptr<FilterSet>;
 
+/// A message in a ChannelView. Its layout is only made while the message is
+/// close to the visible ones, see ChannelView::layoutAt. The height is kept
+/// in the view's MessageHeightIndex.
+struct MessageSlot {
+    MessagePtr message;
+    /// Flags the layout is made with, like its background
+    MessageLayoutFlags layoutFlags;
+};
+
 enum class PauseReason {
     Mouse,
     Selection,
@@ -106,6 +122,11 @@ public:
      * @return <code>true</code> if the message was found and highlighted.
      */
     bool scrollToMessageId(const QString &id);
+    /**
+     * Scrolls by a number of pages, i.e. multiples of the view's height.
+     * Negative values scroll up.
+     */
+    void scrollByPages(qreal pages);
 
     /// Pausing
     bool pausable() const;
@@ -127,7 +148,7 @@ public:
     void setSourceChannel(ChannelPtr sourceChannel);
     bool hasSourceChannel() const;
 
-    LimitedQueueSnapshot<MessageLayoutPtr> &getMessagesSnapshot();
+    LimitedQueueSnapshot<MessageSlot> &getMessagesSnapshot();
     void queueLayout();
 
     void clearMessages();
@@ -195,18 +216,72 @@ private:
 
     void messageAppended(MessagePtr &message,
                          boost::optional<MessageFlags> overridingFlags);
+    void messagesAppended(std::vector<MessagePtr> &messages,
+                          boost::optional<MessageFlags> overridingFlags);
     void messageAddedAtStart(std::vector<MessagePtr> &messages);
+
+    /// Returns true while the scrollbar animates towards a position other
+    /// than the bottom. New layouts are kept pending until it finishes.
+    bool isScrollAnimating() const;
+    void appendSlots(const std::vector<MessageSlot> &slots,
+                     const std::vector<ScrollbarHighlight> &highlights);
+    void mergePendingAppends();
+    void shiftSelection(uint32_t removedFromStart);
+
+    /// Appends slots to messages_ and the index, returns the height of the
+    /// messages that were evicted from the top
+    int64_t pushBackSlots(const std::vector<MessageSlot> &slots);
+    // Keep heightIndex_ and messagePositions_ in sync with messages_
+    void indexSlotAtBack(const MessageSlot &slot);
+    void indexSlotAtFront(const MessageSlot &slot);
+    /// Forgets the position of a message that was evicted from messages_
+    void unindexEvictedSlot(const MessageSlot &slot);
+    /// Clears the index and drops all layouts
+    void clearLayoutIndex();
+    /// Updates the height of a laid out message in heightIndex_, returns by
+    /// how much it changed
+    int updateLayoutHeight(size_t snapshotIndex, const MessageLayout &layout);
+    /// Returns the index of the message in the current snapshot_
+    boost::optional<size_t> snapshotIndexOf(const Message *message);
+    /// Returns the pixel offset of the message at index in the current
+    /// snapshot_, the scrollbar's values are offsets like these
+    int64_t snapshotOffsetOf(size_t index) const;
+    /// Returns the index of the message in the current snapshot_ that
+    /// contains the pixel at offset
+    size_t snapshotIndexAt(qreal offset) const;
+    /// Scrolls by pixels, laying out the messages that are scrolled over
+    void scrollByPixels(qreal pixels, bool animated);
     void messageRemoveFromStart(MessagePtr &message);
     void messageReplaced(size_t index, MessagePtr &replacement);
     void messagesUpdated();
 
     void performLayout(bool causedByScrollbar = false);
+    /**
+     * @brief Returns the laid out layout of the message at index in the
+     * current snapshot_
+     *
+     * The layout is made from its slot if the message isn't in laidOut_ yet.
+     * @param changed set to whether the layout changed, if it's given
+     */
+    MessageLayoutPtr layoutAt(size_t index, int width,
+                              MessageElementFlags flags,
+                              bool *changed = nullptr);
+    /// Same as above, with the view's current width and flags
+    MessageLayoutPtr layoutAt(size_t index);
+    /// The entry of laidOut_ for position, laidOut_ is extended to it
+    MessageLayoutPtr &laidOutEntry(int64_t position);
+    /// Drops the layouts of messages far away from the visible messages
+    /// [first, last] of the snapshot once too many messages are laid out
+    void releaseDistantLayouts(size_t first, size_t last);
     void layoutVisibleMessages(
-        const LimitedQueueSnapshot<MessageLayoutPtr> &messages);
-    void updateScrollbar(const LimitedQueueSnapshot<MessageLayoutPtr> &messages,
+        const LimitedQueueSnapshot<MessageSlot> &messages);
+    void updateScrollbar(const LimitedQueueSnapshot<MessageSlot> &messages,
                          bool causedByScrollbar);
 
     void drawMessages(QPainter &painter);
+    /// Repaints the animated elements whose frame changed, called on every
+    /// tick of the GIF timer
+    void repaintAnimatedElements();
     void setSelection(const SelectionItem &start, const SelectionItem &end);
     void selectWholeMessage(MessageLayout *layout, int &messageIndex);
     void getWordBounds(MessageLayout *layout,
@@ -265,21 +340,32 @@ private:
     bool lastMessageHasAlternateBackground_ = false;
     bool lastMessageHasAlternateBackgroundReverse_ = true;
 
+    /// Messages appended during a scroll animation, see isScrollAnimating
+    struct PendingAppends {
+        std::vector<MessageSlot> slots;
+        std::vector<ScrollbarHighlight> highlights;
+        /// Number of messages removed from the start of channel_ that are
+        /// still in messages_
+        uint32_t removedFromStart = 0;
+        QElapsedTimer deferredSince;
+    } pendingAppends_;
+
     bool pausable_ = false;
     QTimer pauseTimer_;
     std::unordered_map<PauseReason, boost::optional<SteadyClock::time_point>>
         pauses_;
     boost::optional<SteadyClock::time_point> pauseEnd_;
+    // Pixels to scroll by once we're unpaused
     int pauseScrollOffset_ = 0;
     // Keeps track how many message indices we need to offset the selection when we resume scrolling
     uint32_t pauseSelectionOffset_ = 0;
 
     boost::optional<MessageElementFlags> overrideFlags_;
     bool moderationModeUsercard = false;
-    MessageLayoutPtr lastReadMessage_;
+    MessagePtr lastReadMessage_;
 
     ThreadGuard snapshotGuard_;
-    LimitedQueueSnapshot<MessageLayoutPtr> snapshot_;
+    LimitedQueueSnapshot<MessageSlot> snapshot_;
 
     ChannelPtr channel_ = nullptr;
     ChannelPtr underlyingChannel_ = nullptr;
@@ -321,7 +407,7 @@ private:
     QTimer scrollTimer_;
 
     // We're only interested in the pointer, not the contents
-    MessageLayout *highlightedMessage_ = nullptr;
+    const Message *highlightedMessage_ = nullptr;
     QVariantAnimation highlightAnimation_;
     void setupHighlightAnimationColors();
 
@@ -336,7 +422,15 @@ private:
 
     const Context context_;
 
-    LimitedQueue<MessageLayoutPtr> messages_;
+    LimitedQueue<MessageSlot> messages_;
+    /// Heights of the messages in messages_, for pixel based scrolling
+    MessageHeightIndex heightIndex_;
+    /// heightIndex_.headPosition() when snapshot_ was taken
+    int64_t snapshotHeadPosition_ = 0;
+    /// heightIndex_.headOffset() when snapshot_ was taken
+    int64_t snapshotHeadOffset_ = 0;
+    /// Positions of the messages in heightIndex_
+    std::unordered_map<const Message *, int64_t> messagePositions_;
 
     pajlada::Signals::SignalHolder signalHolder_;
 
@@ -344,8 +438,19 @@ private:
     pajlada::Signals::SignalHolder channelConnections_;
 
     std::unordered_set<std::shared_ptr<MessageLayout>> messagesOnScreen_;
+    /// Layouts of the messages at the positions [laidOutStart_,
+    /// laidOutStart_ + laidOut_.size()) in heightIndex_. Entries are null
+    /// until the message is laid out, see layoutAt.
+    std::deque<MessageLayoutPtr> laidOut_;
+    int64_t laidOutStart_ = 0;
+    /// Animated elements painted by the last paintEvent
+    FrameDamageTracker animatedElements_;
 
     static constexpr int leftPadding = 8;
+    /// Size of laidOut_ before releaseDistantLayouts drops some layouts
+    static constexpr size_t MAX_LAID_OUT_LAYOUTS = 1000;
+    /// Messages around the visible ones that stay laid out
+    static constexpr size_t LAID_OUT_MARGIN = 100;
     static constexpr int scrollbarPadding = 8;
 
 private slots:
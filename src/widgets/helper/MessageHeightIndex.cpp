@@ -0,0 +1,282 @@
+#include "widgets/helper/MessageHeightIndex.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace chatterino {
+
+MessageHeightIndex::MessageHeightIndex(size_t capacity, int defaultHeight)
+    : capacity_(std::max<size_t>(1, capacity))
+    , heights_(this->capacity_, 0)
+    , measured_(this->capacity_, false)
+    , tree_(this->capacity_ + 1, 0)
+    , defaultHeight_(std::max(1, defaultHeight))
+{
+}
+
+size_t MessageHeightIndex::size() const
+{
+    return this->size_;
+}
+
+size_t MessageHeightIndex::capacity() const
+{
+    return this->capacity_;
+}
+
+int64_t MessageHeightIndex::headPosition() const
+{
+    return this->headPosition_;
+}
+
+int64_t MessageHeightIndex::headOffset() const
+{
+    return this->headOffset_;
+}
+
+void MessageHeightIndex::clear()
+{
+    // Positions and offsets keep growing so they're never reused
+    this->headPosition_ += int64_t(this->size_);
+    this->headOffset_ += this->totalHeight();
+
+    std::fill(this->heights_.begin(), this->heights_.end(), 0);
+    std::fill(this->measured_.begin(), this->measured_.end(), false);
+    std::fill(this->tree_.begin(), this->tree_.end(), 0);
+    this->measuredSum_ = 0;
+    this->measuredCount_ = 0;
+    this->head_ = 0;
+    this->size_ = 0;
+}
+
+void MessageHeightIndex::pushBack(int height)
+{
+    if (this->size_ == this->capacity_)
+    {
+        this->popFront();
+    }
+
+    ++this->size_;
+    this->setHeight(this->size_ - 1, height);
+}
+
+bool MessageHeightIndex::pushFront(int height)
+{
+    if (this->size_ == this->capacity_)
+    {
+        return false;
+    }
+
+    this->head_ = (this->head_ + this->capacity_ - 1) % this->capacity_;
+    --this->headPosition_;
+    ++this->size_;
+    this->setHeight(0, height);
+    this->headOffset_ -= this->heights_[this->head_];
+    return true;
+}
+
+void MessageHeightIndex::popFront()
+{
+    if (this->size_ == 0)
+    {
+        return;
+    }
+
+    this->headOffset_ += this->heights_[this->head_];
+    this->forgetMeasurement(this->head_);
+    this->setPhysical(this->head_, 0);
+    this->head_ = (this->head_ + 1) % this->capacity_;
+    ++this->headPosition_;
+    --this->size_;
+}
+
+void MessageHeightIndex::setHeight(size_t index, int height)
+{
+    assert(index < this->size_);
+
+    // A message is only measured once, measuring it again replaces the
+    // previous measurement
+    auto slot = this->physical(index);
+    this->forgetMeasurement(slot);
+
+    if (height > 0)
+    {
+        this->measuredSum_ += height;
+        ++this->measuredCount_;
+        this->measured_[slot] = true;
+    }
+    else
+    {
+        height = this->estimatedHeight();
+    }
+
+    this->setPhysical(slot, height);
+}
+
+int MessageHeightIndex::height(size_t index) const
+{
+    assert(index < this->size_);
+
+    return this->heights_[this->physical(index)];
+}
+
+int64_t MessageHeightIndex::offsetOf(size_t index) const
+{
+    index = std::min(index, this->size_);
+
+    auto end = this->head_ + index;
+    if (end <= this->capacity_)
+    {
+        return this->prefixPhysical(end) - this->prefixPhysical(this->head_);
+    }
+
+    // The range wraps around the end of the ring
+    return this->prefixPhysical(this->capacity_) -
+           this->prefixPhysical(this->head_) +
+           this->prefixPhysical(end - this->capacity_);
+}
+
+int64_t MessageHeightIndex::totalHeight() const
+{
+    // Slots that aren't in use are 0
+    return this->prefixPhysical(this->capacity_);
+}
+
+size_t MessageHeightIndex::indexAt(int64_t offset) const
+{
+    if (this->size_ == 0 || offset <= 0)
+    {
+        return 0;
+    }
+
+    auto beforeHead = this->prefixPhysical(this->head_);
+    auto untilEnd = this->prefixPhysical(this->capacity_) - beforeHead;
+
+    size_t index = 0;
+    if (offset < untilEnd)
+    {
+        index = this->lowerBoundPhysical(beforeHead + offset) - this->head_;
+    }
+    else
+    {
+        index = this->capacity_ - this->head_ +
+                this->lowerBoundPhysical(offset - untilEnd);
+    }
+
+    return std::min(index, this->size_ - 1);
+}
+
+double MessageHeightIndex::valueAt(double offset) const
+{
+    if (this->size_ == 0 || offset <= 0)
+    {
+        return 0;
+    }
+    if (offset >= double(this->totalHeight()))
+    {
+        return double(this->size_);
+    }
+
+    auto index = this->indexAt(int64_t(offset));
+    auto fraction = (offset - double(this->offsetOf(index))) /
+                    double(this->height(index));
+
+    return double(index) + std::clamp(fraction, 0.0, 1.0);
+}
+
+double MessageHeightIndex::offsetAt(double value) const
+{
+    if (this->size_ == 0 || value <= 0)
+    {
+        return 0;
+    }
+    if (value >= double(this->size_))
+    {
+        return double(this->totalHeight());
+    }
+
+    auto index = size_t(value);
+    double fraction = value - std::floor(value);
+
+    return double(this->offsetOf(index)) +
+           fraction * double(this->height(index));
+}
+
+int MessageHeightIndex::estimatedHeight() const
+{
+    if (this->measuredCount_ == 0)
+    {
+        return this->defaultHeight_;
+    }
+
+    return std::max(1, int(this->measuredSum_ / this->measuredCount_));
+}
+
+size_t MessageHeightIndex::physical(size_t index) const
+{
+    return (this->head_ + index) % this->capacity_;
+}
+
+void MessageHeightIndex::setPhysical(size_t slot, int height)
+{
+    auto delta = int64_t(height) - this->heights_[slot];
+    this->heights_[slot] = height;
+
+    if (delta == 0)
+    {
+        return;
+    }
+
+    for (auto i = slot + 1; i <= this->capacity_; i += i & (~i + 1))
+    {
+        this->tree_[i] += delta;
+    }
+}
+
+void MessageHeightIndex::forgetMeasurement(size_t slot)
+{
+    if (!this->measured_[slot])
+    {
+        return;
+    }
+
+    this->measuredSum_ -= this->heights_[slot];
+    --this->measuredCount_;
+    this->measured_[slot] = false;
+}
+
+int64_t MessageHeightIndex::prefixPhysical(size_t count) const
+{
+    int64_t sum = 0;
+    for (auto i = count; i > 0; i -= i & (~i + 1))
+    {
+        sum += this->tree_[i];
+    }
+    return sum;
+}
+
+size_t MessageHeightIndex::lowerBoundPhysical(int64_t offset) const
+{
+    // Finds the number of leading slots whose heights add up to at most
+    // offset, that's the slot containing the pixel at offset
+    size_t step = 1;
+    while (step * 2 <= this->capacity_)
+    {
+        step *= 2;
+    }
+
+    size_t pos = 0;
+    for (; step > 0; step /= 2)
+    {
+        if (pos + step <= this->capacity_ && this->tree_[pos + step] <= offset)
+        {
+            pos += step;
+            offset -= this->tree_[pos];
+        }
+    }
+
+    return pos;
+}
+
+}  // namespace chatterino
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace chatterino {
+
+/**
+ * @brief Prefix sums over the heights of the messages in a ChannelView
+ *
+ * Mirrors the view's message queue: messages are pushed to the back, evicted
+ * from the front and prepended like in a LimitedQueue with the same limit.
+ * Heights are kept in a Fenwick tree over a ring buffer, so every update and
+ * every conversion between pixel offsets and message indices is O(log n).
+ *
+ * Messages that haven't been laid out yet use an estimated height, the
+ * average of the measured heights of the messages in the index.
+ *
+ * Each message also has a position that doesn't change while it's in the
+ * index: the position of the first message is headPosition(), and positions
+ * grow towards the back. Likewise, headOffset() is the pixel offset of the
+ * first message, so offsets stay comparable after messages are evicted.
+ */
+class MessageHeightIndex
+{
+public:
+    explicit MessageHeightIndex(size_t capacity, int defaultHeight = 20);
+
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] size_t capacity() const;
+
+    /// Position of the first message, see the class description
+    [[nodiscard]] int64_t headPosition() const;
+    /// Offset of the first message, see the class description
+    [[nodiscard]] int64_t headOffset() const;
+
+    void clear();
+
+    /**
+     * @brief Adds a message at the end, evicting the first one if full
+     *
+     * @param height the height of the message, or 0 if it's not known yet
+     */
+    void pushBack(int height = 0);
+
+    /**
+     * @brief Adds a message at the front
+     *
+     * @param height the height of the message, or 0 if it's not known yet
+     * @return false if the index is full, the message wasn't added then
+     */
+    bool pushFront(int height = 0);
+
+    void popFront();
+
+    /// Sets the measured height of the message at index
+    void setHeight(size_t index, int height);
+    [[nodiscard]] int height(size_t index) const;
+
+    /// Returns the height of all messages before index
+    [[nodiscard]] int64_t offsetOf(size_t index) const;
+    [[nodiscard]] int64_t totalHeight() const;
+
+    /// Returns the index of the message that contains the pixel at offset,
+    /// clamped to the existing messages
+    [[nodiscard]] size_t indexAt(int64_t offset) const;
+
+    /**
+     * @brief Converts a pixel offset to a scroll value
+     *
+     * A scroll value is the index of a message plus the fraction of that
+     * message that's above the offset, like the values of the Scrollbar.
+     */
+    [[nodiscard]] double valueAt(double offset) const;
+
+    /// Converts a scroll value to a pixel offset, see valueAt
+    [[nodiscard]] double offsetAt(double value) const;
+
+    /// Height used for messages whose height isn't known
+    [[nodiscard]] int estimatedHeight() const;
+
+private:
+    size_t physical(size_t index) const;
+    void setPhysical(size_t slot, int height);
+    /// Removes the measurement of slot from the estimate
+    void forgetMeasurement(size_t slot);
+    int64_t prefixPhysical(size_t count) const;
+    size_t lowerBoundPhysical(int64_t offset) const;
+
+    size_t capacity_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+    int64_t headPosition_ = 0;
+    int64_t headOffset_ = 0;
+
+    std::vector<int> heights_;
+    // Whether heights_ holds a measured height or an estimate
+    std::vector<bool> measured_;
+    // 1-based Fenwick tree over heights_
+    std::vector<int64_t> tree_;
+
+    int defaultHeight_;
+    // Sum and number of the measured heights_
+    int64_t measuredSum_ = 0;
+    int64_t measuredCount_ = 0;
+};
+
+}  // namespace chatterino
@@ -916,6 +916,8 @@ void GeneralPage::initLayout(GeneralPageView &layout)
                        s.scrollbackSplitLimit, 100, 100000, 100);
     layout.addIntInput("Usercard scrollback limit (requires restart)",
                        s.scrollbackUsercardLimit, 100, 100000, 100);
+    layout.addIntInput("Memory for drawn messages in MB",
+                       s.messageBufferBudget, 16, 4096, 16);
 
     layout.addCheckbox("Enable experimental IRC support (requires restart)",
                        s.enableExperimentalIrc, false,
@@ -924,6 +926,12 @@ void GeneralPage::initLayout(GeneralPageView &layout)
                        "connect to an IRC server outside of Twitch ");
     layout.addCheckbox("Show unhandled IRC messages",
                        s.showUnhandledIrcMessages);
+    layout.addCheckbox(
+        "Build chat messages in the background (experimental)",
+        s.buildMessagesConcurrently, false,
+        "When enabled, Twitch chat messages are built on background threads "
+        "and only added to the chat on the main thread. This can reduce "
+        "stuttering in very busy channels.");
     layout.addDropdown<int>(
         "Stack timeouts", {"Stack", "Stack until timeout", "Don't stack"},
         s.timeoutStackStyle,
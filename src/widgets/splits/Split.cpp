@@ -504,14 +504,13 @@ void Split::addShortcuts()
              }
              auto direction = arguments.at(0);
 
-             auto &scrollbar = this->getChannelView().getScrollBar();
              if (direction == "up")
              {
-                 scrollbar.offset(-scrollbar.getLargeChange());
+                 this->getChannelView().scrollByPages(-1);
              }
              else if (direction == "down")
              {
-                 scrollbar.offset(scrollbar.getLargeChange());
+                 this->getChannelView().scrollByPages(1);
              }
              else
              {
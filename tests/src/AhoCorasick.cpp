@@ -0,0 +1,108 @@
+#include "util/AhoCorasick.hpp"
+
+#include <gtest/gtest.h>
+#include <QString>
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+using Matches = std::vector<std::pair<size_t, qsizetype>>;
+
+Matches findAll(const AhoCorasick &automaton, const QString &text)
+{
+    Matches matches;
+    automaton.find(text, [&](size_t id, qsizetype end) {
+        matches.emplace_back(id, end);
+    });
+    std::sort(matches.begin(), matches.end());
+    return matches;
+}
+
+}  // namespace
+
+TEST(AhoCorasick, FindsOverlappingPatterns)
+{
+    AhoCorasick automaton;
+    automaton.add(u"he", 0);
+    automaton.add(u"she", 1);
+    automaton.add(u"his", 2);
+    automaton.add(u"hers", 3);
+    automaton.add(u"", 4);
+    automaton.build();
+
+    EXPECT_EQ(findAll(automaton, "ushers"),
+              (Matches{{0, 4}, {1, 4}, {3, 6}}));
+    EXPECT_EQ(findAll(automaton, "this"), (Matches{{2, 4}}));
+    EXPECT_EQ(findAll(automaton, "HE"), Matches{});
+    EXPECT_EQ(findAll(automaton, ""), Matches{});
+}
+
+TEST(AhoCorasick, DuplicatePatterns)
+{
+    AhoCorasick automaton;
+    automaton.add(u"abc", 0);
+    automaton.add(u"abc", 1);
+    automaton.add(u"bc", 2);
+    automaton.build();
+
+    EXPECT_EQ(findAll(automaton, "abcabc"),
+              (Matches{{0, 3}, {0, 6}, {1, 3}, {1, 6}, {2, 3}, {2, 6}}));
+}
+
+TEST(AhoCorasick, CaseInsensitive)
+{
+    AhoCorasick automaton(true);
+    automaton.add(u"Kappa", 0);
+    automaton.add(u"ÄÖÜ", 1);
+    automaton.build();
+
+    EXPECT_EQ(findAll(automaton, "kappa KAPPA"), (Matches{{0, 5}, {0, 11}}));
+    EXPECT_EQ(findAll(automaton, "äöü"), (Matches{{1, 3}}));
+}
+
+TEST(AhoCorasick, MatchesNaiveSearch)
+{
+    std::mt19937 rng(42);
+    auto randomString = [&](int maxLength) {
+        QString result;
+        auto length = std::uniform_int_distribution<int>(1, maxLength)(rng);
+        for (int i = 0; i < length; ++i)
+        {
+            result.append(
+                QChar(std::uniform_int_distribution<int>('a', 'c')(rng)));
+        }
+        return result;
+    };
+
+    for (int round = 0; round < 200; ++round)
+    {
+        std::vector<QString> patterns;
+        AhoCorasick automaton;
+        for (size_t i = 0; i < 20; ++i)
+        {
+            patterns.push_back(randomString(5));
+            automaton.add(patterns.back(), i);
+        }
+        automaton.build();
+
+        auto text = randomString(100);
+        Matches expected;
+        for (size_t i = 0; i < patterns.size(); ++i)
+        {
+            for (auto from = text.indexOf(patterns[i]); from != -1;
+                 from = text.indexOf(patterns[i], from + 1))
+            {
+                expected.emplace_back(i, from + patterns[i].size());
+            }
+        }
+        std::sort(expected.begin(), expected.end());
+
+        ASSERT_EQ(findAll(automaton, text), expected);
+    }
+}
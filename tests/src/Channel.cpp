@@ -0,0 +1,170 @@
+#include "common/Channel.hpp"
+
+#include "messages/Message.hpp"
+#include "singletons/Settings.hpp"
+
+#include <gtest/gtest.h>
+#include <QString>
+
+#include <memory>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+MessagePtr makeMessage(const QString &id, const QString &loginName,
+                       const QString &timeoutUser = {})
+{
+    auto message = std::make_shared<Message>();
+    message->id = id;
+    message->loginName = loginName;
+    message->timeoutUser = timeoutUser;
+    return message;
+}
+
+class ChannelTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        this->previousLimit = getSettings()->scrollbackSplitLimit.getValue();
+        getSettings()->scrollbackSplitLimit.setValue(5);
+        this->channel = std::make_shared<Channel>("test", Channel::Type::Misc);
+    }
+
+    void TearDown() override
+    {
+        this->channel.reset();
+        getSettings()->scrollbackSplitLimit.setValue(this->previousLimit);
+    }
+
+    void add(const MessagePtr &message)
+    {
+        this->channel->addMessage(message, MessageFlags(MessageFlag::DoNotLog));
+    }
+
+    int previousLimit{};
+    std::shared_ptr<Channel> channel;
+};
+
+}  // namespace
+
+TEST_F(ChannelTest, FindMessageById)
+{
+    auto a = makeMessage("a", "forsen");
+    auto b = makeMessage("b", "pajlada");
+    this->add(a);
+    this->add(b);
+
+    EXPECT_EQ(this->channel->findMessage("a"), a);
+    EXPECT_EQ(this->channel->findMessage("b"), b);
+    EXPECT_EQ(this->channel->findMessage("c"), nullptr);
+    EXPECT_EQ(this->channel->findMessage(""), nullptr);
+
+    // evict a and b
+    for (int i = 0; i < 5; ++i)
+    {
+        this->add(makeMessage(QString::number(i), "forsen"));
+    }
+    EXPECT_EQ(this->channel->findMessage("a"), nullptr);
+    EXPECT_EQ(this->channel->findMessage("b"), nullptr);
+    EXPECT_NE(this->channel->findMessage("4"), nullptr);
+
+    auto replacement = makeMessage("r", "forsen");
+    this->channel->replaceMessage(this->channel->findMessage("4"),
+                                  replacement);
+    EXPECT_EQ(this->channel->findMessage("4"), nullptr);
+    EXPECT_EQ(this->channel->findMessage("r"), replacement);
+}
+
+TEST_F(ChannelTest, UserMessages)
+{
+    auto a = makeMessage("a", "forsen");
+    auto b = makeMessage("b", "pajlada");
+    auto c = makeMessage("c", "Forsen");
+    auto timeout = makeMessage("", "", "forsen");
+    this->add(a);
+    this->add(b);
+    this->add(c);
+    this->add(timeout);
+
+    std::vector<MessagePtr> expected{a, c, timeout};
+    EXPECT_EQ(this->channel->getUserMessages("FORSEN"), expected);
+    expected = {c, timeout};
+    EXPECT_EQ(this->channel->getUserMessages("forsen", 2), expected);
+    expected = {timeout};
+    EXPECT_EQ(this->channel->getUserMessages("forsen", 1), expected);
+    EXPECT_TRUE(this->channel->getUserMessages("nobody").empty());
+
+    // Older messages are added in front
+    auto older = makeMessage("o", "forsen");
+    this->channel->addMessagesAtStart({older});
+    expected = {older, a, c, timeout};
+    EXPECT_EQ(this->channel->getUserMessages("forsen"), expected);
+
+    // a and the older message get evicted
+    this->add(makeMessage("d", "pajlada"));
+    this->add(makeMessage("e", "pajlada"));
+    expected = {c, timeout};
+    EXPECT_EQ(this->channel->getUserMessages("forsen"), expected);
+
+    auto replacement = makeMessage("", "", "forsen");
+    this->channel->replaceMessage(timeout, replacement);
+    expected = {c, replacement};
+    EXPECT_EQ(this->channel->getUserMessages("forsen"), expected);
+    expected = {replacement};
+    EXPECT_EQ(this->channel->getUserMessages("forsen", 3), expected);
+}
+
+TEST_F(ChannelTest, AddMessagesBatch)
+{
+    std::vector<std::vector<MessagePtr>> batches;
+    std::vector<MessagePtr> removed;
+    auto appended = this->channel->messagesAppended.connect(
+        [&batches](std::vector<MessagePtr> &messages) {
+            batches.push_back(messages);
+        });
+    auto removedConnection = this->channel->messageRemovedFromStart.connect(
+        [&removed](MessagePtr &message) {
+            removed.push_back(message);
+        });
+
+    auto a = makeMessage("a", "forsen");
+    auto b = makeMessage("b", "pajlada");
+    auto c = makeMessage("c", "forsen");
+    this->channel->addMessages({a, b, c}, false);
+
+    ASSERT_EQ(batches.size(), 1);
+    std::vector<MessagePtr> expected{a, b, c};
+    EXPECT_EQ(batches[0], expected);
+    EXPECT_TRUE(removed.empty());
+    EXPECT_EQ(this->channel->findMessage("b"), b);
+    expected = {a, c};
+    EXPECT_EQ(this->channel->getUserMessages("forsen"), expected);
+
+    // Empty batches aren't signalled
+    this->channel->addMessages({}, false);
+    EXPECT_EQ(batches.size(), 1);
+
+    // a and b get evicted
+    auto d = makeMessage("d", "forsen");
+    auto e = makeMessage("e", "pajlada");
+    auto f = makeMessage("f", "pajlada");
+    auto g = makeMessage("g", "forsen");
+    this->channel->addMessages({d, e, f, g}, false);
+
+    ASSERT_EQ(batches.size(), 2);
+    expected = {a, b};
+    EXPECT_EQ(removed, expected);
+    EXPECT_EQ(this->channel->findMessage("a"), nullptr);
+    EXPECT_EQ(this->channel->findMessage("b"), nullptr);
+    EXPECT_EQ(this->channel->findMessage("g"), g);
+    expected = {c, d, g};
+    EXPECT_EQ(this->channel->getUserMessages("forsen"), expected);
+
+    auto snapshot = this->channel->getMessageSnapshot();
+    ASSERT_EQ(snapshot.size(), 5);
+    EXPECT_EQ(snapshot[0], c);
+    EXPECT_EQ(snapshot[4], g);
+}
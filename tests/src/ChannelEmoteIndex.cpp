@@ -0,0 +1,216 @@
+#include "providers/twitch/ChannelEmoteIndex.hpp"
+
+#include "messages/Emote.hpp"
+#include "messages/MessageElement.hpp"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace chatterino;
+using Source = ChannelEmoteIndex::Source;
+
+namespace {
+
+EmotePtr makeEmote(const QString &name, bool zeroWidth = false)
+{
+    return std::make_shared<const Emote>(
+        Emote{EmoteName{name}, ImageSet{}, Tooltip{}, Url{}, zeroWidth});
+}
+
+std::shared_ptr<const EmoteMap> makeMap(std::vector<EmotePtr> emotes)
+{
+    auto map = std::make_shared<EmoteMap>();
+    for (auto &emote : emotes)
+    {
+        (*map)[emote->name] = emote;
+    }
+    return map;
+}
+
+ChannelEmoteIndex::Sources makeSources(
+    std::vector<std::pair<Source, std::shared_ptr<const EmoteMap>>> maps)
+{
+    ChannelEmoteIndex::Sources sources;
+    for (auto &[source, map] : maps)
+    {
+        sources[static_cast<size_t>(source)] = map;
+    }
+    return sources;
+}
+
+}  // namespace
+
+TEST(ChannelEmoteIndex, Priority)
+{
+    auto ffzChannel = makeEmote("Kappa");
+    auto bttvChannel = makeEmote("Kappa");
+    auto seventvGlobal = makeEmote("Kappa");
+    auto homiesGlobal = makeEmote("PogU");
+
+    ChannelEmoteIndex index(makeSources({
+        {Source::SeventvGlobal, makeMap({seventvGlobal})},
+        {Source::BttvChannel, makeMap({bttvChannel})},
+        {Source::FfzChannel, makeMap({ffzChannel})},
+        {Source::HomiesGlobal, makeMap({homiesGlobal})},
+    }));
+
+    EXPECT_EQ(index.size(), 2);
+
+    const auto *kappa = index.find(EmoteName{"Kappa"});
+    ASSERT_NE(kappa, nullptr);
+    EXPECT_EQ(kappa->emote, ffzChannel);
+    EXPECT_EQ(kappa->flag, MessageElementFlag::FfzEmote);
+
+    const auto *pogU = index.find(EmoteName{"PogU"});
+    ASSERT_NE(pogU, nullptr);
+    EXPECT_EQ(pogU->emote, homiesGlobal);
+    EXPECT_EQ(pogU->flag, MessageElementFlag::HomiesEmote);
+
+    EXPECT_EQ(index.find(EmoteName{"kappa"}), nullptr);
+}
+
+TEST(ChannelEmoteIndex, ZeroWidth)
+{
+    ChannelEmoteIndex index(makeSources({
+        {Source::SeventvChannel, makeMap({makeEmote("RainTime", true)})},
+        {Source::BttvChannel, makeMap({makeEmote("IceCold", true)})},
+        {Source::BttvGlobal,
+         makeMap({makeEmote("SoSnowy"), makeEmote("PepeHands", true)})},
+        {Source::FfzGlobal, makeMap({makeEmote("Wide", true)})},
+    }));
+
+    EXPECT_TRUE(index.find(EmoteName{"RainTime"})->zeroWidth);
+    // BTTV only knows a fixed set of zero-width global emotes
+    EXPECT_FALSE(index.find(EmoteName{"IceCold"})->zeroWidth);
+    EXPECT_TRUE(index.find(EmoteName{"SoSnowy"})->zeroWidth);
+    EXPECT_FALSE(index.find(EmoteName{"PepeHands"})->zeroWidth);
+    EXPECT_FALSE(index.find(EmoteName{"Wide"})->zeroWidth);
+}
+
+TEST(ChannelEmoteIndex, WithSource)
+{
+    auto global = makeEmote("Clap");
+    auto channel = makeEmote("Clap");
+    auto index = std::make_shared<const ChannelEmoteIndex>(
+        makeSources({{Source::SeventvGlobal, makeMap({global})}}));
+
+    auto added = index->withSource(Source::BttvChannel, makeMap({channel}));
+    EXPECT_EQ(added->find(EmoteName{"Clap"})->emote, channel);
+    EXPECT_EQ(added->find(EmoteName{"Clap"})->flag,
+              MessageElementFlag::BttvEmote);
+    // The old index is unchanged
+    EXPECT_EQ(index->find(EmoteName{"Clap"})->emote, global);
+
+    // Removing the channel emote falls back to the global one
+    auto removed = added->withSource(Source::BttvChannel, nullptr);
+    EXPECT_EQ(removed->find(EmoteName{"Clap"})->emote, global);
+    EXPECT_EQ(removed->source(Source::BttvChannel)->size(), 0);
+
+    auto cleared = removed->withSource(Source::SeventvGlobal, EMPTY_EMOTE_MAP);
+    EXPECT_EQ(cleared->find(EmoteName{"Clap"}), nullptr);
+    EXPECT_EQ(cleared->size(), 0);
+}
+
+TEST(ChannelEmoteIndex, WithEmotes)
+{
+    auto global = makeEmote("Clap");
+    auto channel = makeEmote("Clap");
+    auto renamed = makeEmote("ClapAgain");
+    auto index = std::make_shared<const ChannelEmoteIndex>(
+        makeSources({{Source::SeventvGlobal, makeMap({global})}}));
+
+    // Live updates modify a copy of the channel's map
+    auto map = std::make_shared<EmoteMap>();
+    (*map)[channel->name] = channel;
+    auto added =
+        index->withEmotes(Source::SeventvChannel, map, {channel->name});
+    EXPECT_EQ(added->find(EmoteName{"Clap"})->emote, channel);
+    EXPECT_EQ(added->source(Source::SeventvChannel), map);
+    EXPECT_EQ(index->find(EmoteName{"Clap"})->emote, global);
+
+    map = std::make_shared<EmoteMap>(*map);
+    map->erase(channel->name);
+    (*map)[renamed->name] = renamed;
+    auto updated = added->withEmotes(Source::SeventvChannel, map,
+                                     {channel->name, renamed->name});
+    EXPECT_EQ(updated->find(EmoteName{"Clap"})->emote, global);
+    EXPECT_EQ(updated->find(EmoteName{"ClapAgain"})->emote, renamed);
+    EXPECT_EQ(updated->size(), 2);
+    EXPECT_EQ(added->size(), 1);
+
+    map = std::make_shared<EmoteMap>(*map);
+    map->erase(renamed->name);
+    auto removed =
+        updated->withEmotes(Source::SeventvChannel, map, {renamed->name});
+    EXPECT_EQ(removed->find(EmoteName{"ClapAgain"}), nullptr);
+    EXPECT_EQ(removed->find(EmoteName{"Clap"})->emote, global);
+    EXPECT_EQ(removed->size(), 1);
+}
+
+TEST(ChannelEmoteIndex, WithGlobals)
+{
+    auto index = std::make_shared<const ChannelEmoteIndex>();
+    EXPECT_EQ(index->globalsGeneration(), 0);
+    EXPECT_NE(ChannelEmoteIndex::currentGlobalsGeneration(), 0);
+
+    auto generation = ChannelEmoteIndex::currentGlobalsGeneration();
+    ChannelEmoteIndex::globalEmotesChanged();
+    EXPECT_EQ(ChannelEmoteIndex::currentGlobalsGeneration(), generation + 1);
+
+    auto updated = index->withGlobals(makeMap({makeEmote("ZreknarF")}),
+                                      nullptr, makeMap({makeEmote("EZ")}),
+                                      nullptr, generation + 1);
+    EXPECT_EQ(updated->globalsGeneration(), generation + 1);
+    EXPECT_EQ(updated->size(), 2);
+    EXPECT_EQ(updated->find(EmoteName{"EZ"})->flag,
+              MessageElementFlag::SevenTVEmote);
+}
+
+TEST(ChannelEmoteIndex, MatchesResolve)
+{
+    std::mt19937 rng(1234);
+
+    std::vector<EmotePtr> pool;
+    for (int i = 0; i < 40; ++i)
+    {
+        pool.push_back(makeEmote(QString("emote%1").arg(i % 20), i % 3 == 0));
+    }
+
+    auto randomMap = [&] {
+        std::vector<EmotePtr> emotes;
+        for (const auto &emote : pool)
+        {
+            if (rng() % 4 == 0)
+            {
+                emotes.push_back(emote);
+            }
+        }
+        return makeMap(emotes);
+    };
+
+    auto index = std::make_shared<const ChannelEmoteIndex>();
+    ChannelEmoteIndex::Sources sources;
+    for (int step = 0; step < 500; ++step)
+    {
+        auto i = rng() % ChannelEmoteIndex::SOURCE_COUNT;
+        sources[i] = randomMap();
+        index = index->withSource(static_cast<Source>(i), sources[i]);
+
+        ChannelEmoteIndex fresh(sources);
+        ASSERT_EQ(index->size(), fresh.size()) << "step " << step;
+        for (int n = 0; n < 20; ++n)
+        {
+            EmoteName name{QString("emote%1").arg(n)};
+            auto expected = ChannelEmoteIndex::resolve(sources, name);
+            const auto *actual = index->find(name);
+            ASSERT_EQ(actual != nullptr, bool(expected)) << "step " << step;
+            if (actual)
+            {
+                ASSERT_EQ(actual->emote, expected->emote) << "step " << step;
+                ASSERT_EQ(actual->flag, expected->flag) << "step " << step;
+                ASSERT_EQ(actual->zeroWidth, expected->zeroWidth);
+            }
+        }
+    }
+}
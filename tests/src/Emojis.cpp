@@ -1,5 +1,7 @@
 #include "providers/emoji/Emojis.hpp"
 
+#include "messages/Emote.hpp"
+
 #include <gtest/gtest.h>
 #include <QDebug>
 #include <QString>
@@ -53,3 +55,52 @@ TEST(Emojis, ShortcodeParsing)
             << "Input " << test.input.toStdString() << " failed";
     }
 }
+
+TEST(Emojis, Parse)
+{
+    Emojis emojis;
+
+    emojis.load();
+
+    struct TestCase {
+        QString input;
+        // Text parts are kept as they are, emojis are written as their value
+        std::vector<QString> expectedOutput;
+    };
+
+    std::vector<TestCase> tests{
+        {"", {}},
+        {"foo bar", {"foo bar"}},
+        {"🐧", {"🐧"}},
+        {"foo 🐧 bar", {"foo ", "🐧", " bar"}},
+        {"🐧🐧", {"🐧", "🐧"}},
+        // The longest emoji wins over its prefixes, the emoji is stored
+        // without its variation selector
+        {"👨‍⚕️", {"👨‍⚕", QString(QChar(0xFE0F))}},
+        {"👍🏽x", {"👍🏽", "x"}},
+        // A zero width joiner on its own isn't an emoji
+        {"a‍b", {"a‍b"}},
+        {"привет", {"привет"}},
+    };
+
+    for (const auto &test : tests)
+    {
+        std::vector<QString> output;
+        for (const auto &part : emojis.parse(test.input))
+        {
+            if (const auto *text = boost::get<QString>(&part))
+            {
+                output.push_back(*text);
+            }
+            else
+            {
+                const auto &emote = boost::get<EmotePtr>(part);
+                ASSERT_NE(emote, nullptr);
+                output.push_back(emote->name.string);
+            }
+        }
+
+        EXPECT_EQ(output, test.expectedOutput)
+            << "Input " << test.input.toStdString() << " failed";
+    }
+}
@@ -0,0 +1,108 @@
+#include "messages/Emote.hpp"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+
+using namespace chatterino;
+
+namespace {
+
+EmotePtr makeEmote(const QString &name, int id)
+{
+    return std::make_shared<const Emote>(Emote{
+        EmoteName{name}, ImageSet{}, Tooltip{}, Url{}, false,
+        EmoteId{QString::number(id)}});
+}
+
+std::map<QString, EmotePtr> contentsOf(const EmoteMap &map)
+{
+    std::map<QString, EmotePtr> contents;
+    for (const auto &[name, emote] : map)
+    {
+        EXPECT_NE(emote, nullptr);
+        contents[name.string] = emote;
+    }
+    EXPECT_EQ(contents.size(), map.size());
+    return contents;
+}
+
+}  // namespace
+
+TEST(EmoteMap, CopiesAreIndependent)
+{
+    EmoteMap map;
+    map[EmoteName{"Kappa"}] = makeEmote("Kappa", 1);
+    map[EmoteName{"PogU"}] = makeEmote("PogU", 2);
+
+    auto copy = map;
+    copy[EmoteName{"Clap"}] = makeEmote("Clap", 3);
+    copy.erase(EmoteName{"Kappa"});
+    copy[EmoteName{"PogU"}] = makeEmote("PogU", 4);
+
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_NE(map.find(EmoteName{"Kappa"}), map.end());
+    EXPECT_EQ(map.find(EmoteName{"Clap"}), map.end());
+    EXPECT_EQ(map.find(EmoteName{"PogU"})->second->id.string, "2");
+
+    EXPECT_EQ(copy.size(), 2);
+    EXPECT_EQ(copy.find(EmoteName{"Kappa"}), copy.end());
+    EXPECT_EQ(copy.count(EmoteName{"Clap"}), 1);
+    EXPECT_EQ(copy.find(EmoteName{"PogU"})->second->id.string, "4");
+    EXPECT_EQ(copy.findEmote("", "3")->first.string, "Clap");
+
+    EXPECT_EQ(contentsOf(copy).size(), 2);
+}
+
+TEST(EmoteMap, LiveUpdates)
+{
+    std::mt19937 rng(1234);
+
+    for (int size : {0, 10, 1000})
+    {
+        EmoteMap initial;
+        for (int i = 0; i < size; ++i)
+        {
+            auto name = QString("emote%1").arg(i);
+            initial[EmoteName{name}] = makeEmote(name, i);
+        }
+        auto current = std::make_shared<const EmoteMap>(std::move(initial));
+        auto reference = contentsOf(*current);
+
+        std::vector<std::pair<std::shared_ptr<const EmoteMap>,
+                              std::map<QString, EmotePtr>>>
+            snapshots;
+        for (int step = 0; step < 1000; ++step)
+        {
+            // Updates are made on a copy of the current map like
+            // SeventvEmotes::addEmote does
+            EmoteMap updated = *current;
+            auto name = QString("emote%1").arg(rng() % (size + 20));
+            if (rng() % 2 == 0)
+            {
+                auto emote = makeEmote(name, step);
+                updated[EmoteName{name}] = emote;
+                reference[name] = emote;
+            }
+            else
+            {
+                ASSERT_EQ(updated.erase(EmoteName{name}),
+                          reference.erase(name));
+            }
+            ASSERT_EQ(updated.size(), reference.size());
+
+            current = std::make_shared<const EmoteMap>(std::move(updated));
+            if (step % 50 == 0)
+            {
+                ASSERT_EQ(contentsOf(*current), reference);
+                snapshots.emplace_back(current, reference);
+            }
+        }
+
+        for (const auto &[snapshot, expected] : snapshots)
+        {
+            ASSERT_EQ(contentsOf(*snapshot), expected);
+        }
+    }
+}
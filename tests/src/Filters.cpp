@@ -1,5 +1,7 @@
 #include "controllers/filters/lang/Filter.hpp"
 #include "controllers/filters/lang/Types.hpp"
+#include "messages/Message.hpp"
+#include "providers/twitch/TwitchBadge.hpp"
 
 #include <gtest/gtest.h>
 #include <QColor>
@@ -170,3 +172,94 @@ TEST(Filters, Evaluation)
             << qUtf8Printable(filter.debugString(typingContext));
     }
 }
+
+TEST(Filters, CompiledMatchesInterpreted)
+{
+    // author.subbed and flags.reply are missing on purpose
+    ContextMap contextMap = {
+        {"author.name", QVariant("icelys")},
+        {"author.color", QVariant(QColor("#ff0000"))},
+        {"author.sub_length", QVariant(12)},
+        {"message.content", QVariant("hey there :) 2038-01-19 123 456")},
+        {"channel.name", QVariant("forsen")},
+        {"flags.highlighted", QVariant(true)},
+        {"author.badges", QVariant(QStringList({"moderator", "staff"}))}};
+
+    // clang-format off
+    std::vector<QString> tests{
+        R".(1 + 2 * 3).",
+        R".(!(1 == 1)).",
+        R".("abc" + 123 == "ABC123").",
+        R".(author.name == "ICELYS").",
+        R".(author.name + "!" startswith "ice").",
+        R".(author.color == "#ff0000").",
+        R".(author.sub_length >= 6 && author.sub_length < 24).",
+        R".(author.sub_length % 5 + 1).",
+        R".(flags.highlighted || flags.reply).",
+        R".(flags.reply || flags.highlighted).",
+        R".(flags.highlighted && author.subbed).",
+        R".(!author.subbed).",
+        R".(author.badges contains "MODERATOR").",
+        R".({author.name, "forsen"} contains "forsen").",
+        R".({author.name, 1} contains "icelys").",
+        R".(channel.name endswith "sen").",
+        R".(message.content match r"\d{4}").",
+        R".(message.content match ri"HEY THERE").",
+        R".(message.content match {r"(\d\d\d\d)\-(\d\d)\-(\d\d)", 2}).",
+        R".(message.content match {r"nothing", 0}).",
+        R".(message.content contains "THERE" && !(message.content contains "bye")).",
+    };
+    // clang-format on
+
+    for (const auto &input : tests)
+    {
+        auto filterResult = Filter::fromString(input);
+        ASSERT_TRUE(std::holds_alternative<Filter>(filterResult))
+            << "Filter::fromString( " << qUtf8Printable(input)
+            << " ) is invalid";
+
+        auto filter = std::move(std::get<Filter>(filterResult));
+        MessageContext context(contextMap);
+
+        EXPECT_EQ(filter.execute(context), filter.execute(contextMap))
+            << "Filter{ " << qUtf8Printable(input)
+            << " } evaluates differently when compiled";
+    }
+}
+
+TEST(Filters, MessageContext)
+{
+    Message message;
+    message.messageText = "hello chat";
+    message.displayName = "pajlada";
+    message.channelName = "forsen";
+    message.badges = {{"subscriber", "12"}, {"founder", "0"}};
+    message.badgeInfos = {{"subscriber", "24"}, {"founder", "3"}};
+    message.flags.set(MessageFlag::Highlighted);
+
+    MessageContext context(message, nullptr);
+    EXPECT_TRUE(context.isComplete());
+
+    EXPECT_EQ(context.value(Identifier::AuthorBadges),
+              QVariant(QStringList({"subscriber", "founder"})));
+    EXPECT_EQ(context.value(Identifier::AuthorName), QVariant("pajlada"));
+    EXPECT_EQ(context.value(Identifier::AuthorNoColor), QVariant(true));
+    EXPECT_EQ(context.value(Identifier::AuthorSubbed), QVariant(true));
+    // The founder badge wins
+    EXPECT_EQ(context.value(Identifier::AuthorSubLength), QVariant(3));
+    EXPECT_EQ(context.value(Identifier::ChannelLive), QVariant(false));
+    EXPECT_EQ(context.value(Identifier::FlagsHighlighted), QVariant(true));
+    EXPECT_EQ(context.value(Identifier::FlagsReply), QVariant(false));
+    EXPECT_EQ(context.value(Identifier::MessageLength),
+              QVariant(message.messageText.length()));
+
+    for (size_t i = 0; i < IDENTIFIER_COUNT; ++i)
+    {
+        auto identifier = static_cast<Identifier>(i);
+        const auto &name = identifierName(identifier);
+        EXPECT_EQ(identifierFromName(name), identifier);
+        EXPECT_TRUE(MESSAGE_TYPING_CONTEXT.contains(name))
+            << qUtf8Printable(name);
+    }
+    EXPECT_FALSE(identifierFromName("unknown.identifier").has_value());
+}
@@ -0,0 +1,53 @@
+#include "messages/layouts/FrameDamageTracker.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace chatterino;
+
+TEST(FrameDamageTracker, Empty)
+{
+    FrameDamageTracker tracker;
+    EXPECT_TRUE(tracker.empty());
+    EXPECT_EQ(tracker.nextDeadline(), ULONG_MAX);
+    EXPECT_TRUE(tracker.takeDue(1000).isEmpty());
+
+    // Elements with an empty area can't be repainted
+    tracker.add(QRect(0, 0, 0, 10), 20);
+    EXPECT_TRUE(tracker.empty());
+}
+
+TEST(FrameDamageTracker, TakeDue)
+{
+    FrameDamageTracker tracker;
+    tracker.add(QRect(0, 0, 10, 10), 40);
+    tracker.add(QRect(20, 0, 10, 10), 60);
+    tracker.add(QRect(40, 0, 10, 10), 40);
+    EXPECT_EQ(tracker.size(), 3);
+    EXPECT_EQ(tracker.nextDeadline(), 40);
+
+    EXPECT_TRUE(tracker.takeDue(20).isEmpty());
+    EXPECT_EQ(tracker.size(), 3);
+
+    auto damage = tracker.takeDue(40);
+    EXPECT_EQ(damage, QRegion(QRect(0, 0, 10, 10)) + QRect(40, 0, 10, 10));
+    EXPECT_EQ(tracker.size(), 1);
+    EXPECT_EQ(tracker.nextDeadline(), 60);
+
+    // Already taken
+    EXPECT_TRUE(tracker.takeDue(40).isEmpty());
+
+    // Ticks can be late
+    EXPECT_EQ(tracker.takeDue(100), QRegion(QRect(20, 0, 10, 10)));
+    EXPECT_TRUE(tracker.empty());
+    EXPECT_EQ(tracker.nextDeadline(), ULONG_MAX);
+}
+
+TEST(FrameDamageTracker, Clear)
+{
+    FrameDamageTracker tracker;
+    tracker.add(QRect(0, 0, 10, 10), 40);
+    tracker.clear();
+
+    EXPECT_TRUE(tracker.empty());
+    EXPECT_TRUE(tracker.takeDue(40).isEmpty());
+}
@@ -0,0 +1,166 @@
+#include "controllers/highlights/HighlightMatcher.hpp"
+
+#include "providers/twitch/TwitchBadge.hpp"
+
+#include <gtest/gtest.h>
+#include <QString>
+
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+HighlightPhrase buildHighlightPhrase(const QString &phrase, bool isRegex,
+                                     bool isCaseSensitive)
+{
+    return HighlightPhrase(phrase,           // pattern
+                           false,            // showInMentions
+                           false,            // hasAlert
+                           false,            // hasSound
+                           isRegex,          // isRegex
+                           isCaseSensitive,  // isCaseSensitive
+                           "",               // soundURL
+                           QColor()          // color
+    );
+}
+
+HighlightBadge buildHighlightBadge(const QString &name)
+{
+    return HighlightBadge(name, name, false, false, false, "", QColor());
+}
+
+// The phrases which match subject when matched one by one
+std::vector<size_t> matchOneByOne(const std::vector<HighlightPhrase> &phrases,
+                                  const QString &subject)
+{
+    std::vector<size_t> matches;
+    for (size_t i = 0; i < phrases.size(); ++i)
+    {
+        if (phrases[i].isMatch(subject))
+        {
+            matches.push_back(i);
+        }
+    }
+    return matches;
+}
+
+const std::vector<HighlightPhrase> PHRASES{
+    buildHighlightPhrase("test", false, false),
+    buildHighlightPhrase("Test", false, true),
+    buildHighlightPhrase("!command", false, false),
+    buildHighlightPhrase("two words", false, false),
+    buildHighlightPhrase("ÄÖÜ", false, false),
+    buildHighlightPhrase("😂", false, false),
+    buildHighlightPhrase("", false, false),
+    buildHighlightPhrase("test", false, false),
+    buildHighlightPhrase("fo+bar", true, false),
+    buildHighlightPhrase("^hello", true, false),
+    buildHighlightPhrase("(a|b)c\\d", true, true),
+    buildHighlightPhrase("(w)\\1", true, false),
+    buildHighlightPhrase("(?i)case", true, true),
+    buildHighlightPhrase("(?<name>named)", true, false),
+    buildHighlightPhrase("[unclosed", true, false),
+    buildHighlightPhrase("end$", true, false),
+};
+
+const std::vector<QString> SUBJECTS{
+    "",
+    "test",
+    "TEST this",
+    "this is a Test!",
+    "testing",
+    "run !COMMAND now",
+    "a!command",
+    "two  words, two words",
+    "äöü",
+    "lol 😂",
+    "fooooBAR",
+    "hello there",
+    "oh hello",
+    "bc1 ac2",
+    "BC1",
+    "ww",
+    "CASE",
+    "NAMED",
+    "[unclosed",
+    "the end",
+    "end of it",
+};
+
+}  // namespace
+
+TEST(HighlightMatcher, PhrasesMatchLikeOneByOne)
+{
+    HighlightPhraseMatcher matcher(PHRASES);
+
+    for (const auto &subject : SUBJECTS)
+    {
+        EXPECT_EQ(matcher.match(subject), matchOneByOne(PHRASES, subject))
+            << qUtf8Printable(subject);
+    }
+}
+
+TEST(HighlightMatcher, UsersMatchLikeOneByOne)
+{
+    const std::vector<HighlightPhrase> phrases{
+        buildHighlightPhrase("pajlada", false, false),
+        buildHighlightPhrase("Forsen", false, true),
+        buildHighlightPhrase("nymn", false, false),
+        buildHighlightPhrase("PAJLADA", false, false),
+        buildHighlightPhrase("^bot_", true, false),
+        buildHighlightPhrase("b-c", false, false),
+    };
+    const std::vector<QString> userNames{
+        "pajlada", "PajLada", "pajlada2", "forsen",  "Forsen",
+        "nymn",    "a-nymn",  "bot_1",    "nymnbot", "a-b-c",
+    };
+
+    HighlightUserMatcher matcher(phrases);
+
+    for (const auto &userName : userNames)
+    {
+        EXPECT_EQ(matcher.match(userName), matchOneByOne(phrases, userName))
+            << qUtf8Printable(userName);
+    }
+}
+
+TEST(HighlightMatcher, BadgesMatchLikeOneByOne)
+{
+    const std::vector<HighlightBadge> highlights{
+        buildHighlightBadge("subscriber"),
+        buildHighlightBadge("subscriber/12"),
+        buildHighlightBadge("vip,moderator"),
+        buildHighlightBadge("Broadcaster"),
+        buildHighlightBadge("founder/0,vip"),
+    };
+    const std::vector<std::vector<Badge>> messages{
+        {},
+        {{"subscriber", "12"}},
+        {{"subscriber", "6"}},
+        {{"VIP", "1"}},
+        {{"moderator", "1"}, {"broadcaster", "1"}},
+        {{"founder", "0"}, {"subscriber", "0"}},
+        {{"vip", ""}},
+    };
+
+    HighlightBadgeMatcher matcher(highlights);
+
+    for (const auto &badges : messages)
+    {
+        std::vector<size_t> expected;
+        for (size_t i = 0; i < highlights.size(); ++i)
+        {
+            for (const auto &badge : badges)
+            {
+                if (highlights[i].isMatch(badge))
+                {
+                    expected.push_back(i);
+                    break;
+                }
+            }
+        }
+
+        EXPECT_EQ(matcher.match(badges), expected);
+    }
+}
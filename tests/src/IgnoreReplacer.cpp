@@ -0,0 +1,141 @@
+#include "controllers/ignores/IgnoreReplacer.hpp"
+
+#include <gtest/gtest.h>
+#include <QString>
+
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+IgnorePhrase buildIgnorePhrase(const QString &pattern, bool isRegex,
+                               const QString &replace, bool isCaseSensitive)
+{
+    return IgnorePhrase(pattern,          // pattern
+                        isRegex,          // isRegex
+                        false,            // isBlock
+                        replace,          // replace
+                        isCaseSensitive   // isCaseSensitive
+    );
+}
+
+QString replaceAll(const std::vector<IgnorePhrase> &phrases,
+                   const QString &message)
+{
+    IgnoreReplacer replacer(phrases);
+    auto replaced = message;
+    replacer.replace(replaced);
+    return replaced;
+}
+
+}  // namespace
+
+TEST(IgnoreReplacer, ReplacesLiterals)
+{
+    const std::vector<IgnorePhrase> phrases{
+        buildIgnorePhrase("forsen", false, "xD", false),
+        buildIgnorePhrase("Kappa", false, "Keepo", true),
+        buildIgnorePhrase("😂", false, ":)", false),
+    };
+
+    EXPECT_EQ(replaceAll(phrases, "FORSEN forsen"), "xD xD");
+    EXPECT_EQ(replaceAll(phrases, "Kappa kappa"), "Keepo kappa");
+    EXPECT_EQ(replaceAll(phrases, "lol 😂😂"), "lol :):)");
+    EXPECT_EQ(replaceAll(phrases, "nothing here"), "nothing here");
+    EXPECT_EQ(replaceAll(phrases, ""), "");
+}
+
+TEST(IgnoreReplacer, ReplacesRegexes)
+{
+    const std::vector<IgnorePhrase> phrases{
+        buildIgnorePhrase("(\\w+)@(\\w+)", true, "\\2 at \\1", false),
+        buildIgnorePhrase("a+", true, "a", true),
+        buildIgnorePhrase("(x)\\1", true, "y", false),
+        buildIgnorePhrase("z*", true, "never", false),
+        buildIgnorePhrase("[unclosed", true, "never", false),
+    };
+
+    EXPECT_EQ(replaceAll(phrases, "me@home"), "home at me");
+    EXPECT_EQ(replaceAll(phrases, "baaah AAA"), "bah AAA");
+    EXPECT_EQ(replaceAll(phrases, "XX x"), "y x");
+    EXPECT_EQ(replaceAll(phrases, "[unclosed"), "[unclosed");
+}
+
+TEST(IgnoreReplacer, ReferencesSeeWholeMessage)
+{
+    const std::vector<IgnorePhrase> phrases{
+        buildIgnorePhrase("(?<=@)(\\w+)(?= says)", true, "<\\1>", true),
+        buildIgnorePhrase("(?<!\\w)(x+)\\b", true, "\\1\\1\\2\\", true),
+        buildIgnorePhrase("^(hi)", true, "\\1!", true),
+    };
+
+    EXPECT_EQ(replaceAll(phrases, "@forsen says hi"), "@<forsen> says hi");
+    EXPECT_EQ(replaceAll(phrases, "@forsen said hi"), "@forsen said hi");
+    // Groups that don't exist and trailing backslashes are kept
+    EXPECT_EQ(replaceAll(phrases, "ax xx"), "ax xxxx\\2\\");
+    EXPECT_EQ(replaceAll(phrases, "hi hi"), "hi! hi");
+}
+
+TEST(IgnoreReplacer, LeftmostThenFirstPhraseWins)
+{
+    const std::vector<IgnorePhrase> phrases{
+        buildIgnorePhrase("bc", false, "1", true),
+        buildIgnorePhrase("abc", false, "2", true),
+        buildIgnorePhrase("b.", true, "3", true),
+        buildIgnorePhrase("cd", false, "4", true),
+    };
+
+    // "abc" starts first, "cd" overlaps it
+    EXPECT_EQ(replaceAll(phrases, "abcd"), "2d");
+    // "bc" and "b." both start at 0
+    EXPECT_EQ(replaceAll(phrases, "bcd bx"), "1d 3");
+    // Replacements aren't replaced again
+    EXPECT_EQ(replaceAll({buildIgnorePhrase("a", false, "aa", true)}, "aa"),
+              "aaaa");
+}
+
+TEST(IgnoreReplacer, ReportsOffsets)
+{
+    const std::vector<IgnorePhrase> phrases{
+        buildIgnorePhrase("long", false, "s", true),
+        buildIgnorePhrase("x", false, "yyy", true),
+        buildIgnorePhrase("block", false, "", true),
+    };
+    IgnoreReplacer replacer(phrases);
+
+    QString message = "a long x block";
+    auto replacements = replacer.replace(message);
+
+    EXPECT_EQ(message, "a s yyy ");
+    ASSERT_EQ(replacements.size(), 3);
+
+    EXPECT_EQ(replacements[0].start, 2);
+    EXPECT_EQ(replacements[0].length, 4);
+    EXPECT_EQ(replacements[0].newStart, 2);
+    EXPECT_EQ(replacements[0].newLength, 1);
+    EXPECT_EQ(replacements[0].phrase->getPattern(), "long");
+
+    EXPECT_EQ(replacements[1].start, 7);
+    EXPECT_EQ(replacements[1].length, 1);
+    EXPECT_EQ(replacements[1].newStart, 4);
+    EXPECT_EQ(replacements[1].newLength, 3);
+
+    EXPECT_EQ(replacements[2].start, 9);
+    EXPECT_EQ(replacements[2].length, 5);
+    EXPECT_EQ(replacements[2].newStart, 8);
+    EXPECT_EQ(replacements[2].newLength, 0);
+}
+
+TEST(IgnoreReplacer, SkipsBlockingPhrases)
+{
+    IgnoreReplacer replacer({
+        IgnorePhrase("spam", false, true, "", false),
+        buildIgnorePhrase("", false, "never", false),
+    });
+    EXPECT_TRUE(replacer.empty());
+
+    QString message = "spam";
+    EXPECT_TRUE(replacer.replace(message).empty());
+    EXPECT_EQ(message, "spam");
+}
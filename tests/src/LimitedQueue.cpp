@@ -2,6 +2,7 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <vector>
 
 using namespace chatterino;
@@ -95,6 +96,30 @@ TEST(LimitedQueue, PushBack)
     SNAPSHOT_EQUALS(snapshot1, {1, 2}, "first snapshot same 3");
 }
 
+TEST(LimitedQueue, PushBackItems)
+{
+    LimitedQueue<int> queue(5);
+    std::vector<int> deleted;
+
+    EXPECT_EQ(queue.pushBackItems({1, 2, 3}, deleted), 0);
+    EXPECT_TRUE(deleted.empty());
+
+    auto snapshot1 = queue.getSnapshot();
+    SNAPSHOT_EQUALS(snapshot1, {1, 2, 3}, "first snapshot");
+
+    EXPECT_EQ(queue.pushBackItems({4, 5, 6, 7}, deleted), 2);
+    std::vector<int> expectedDeleted = {1, 2};
+    EXPECT_EQ(deleted, expectedDeleted);
+
+    SNAPSHOT_EQUALS(queue.getSnapshot(), {3, 4, 5, 6, 7}, "second snapshot");
+    SNAPSHOT_EQUALS(snapshot1, {1, 2, 3}, "first snapshot same");
+
+    // More items than the limit only keeps the last ones
+    EXPECT_EQ(queue.pushBackItems({8, 9, 10, 11, 12, 13}), 6);
+    SNAPSHOT_EQUALS(queue.getSnapshot(), {9, 10, 11, 12, 13},
+                    "third snapshot");
+}
+
 TEST(LimitedQueue, PushFront)
 {
     LimitedQueue<int> queue(5);
@@ -131,3 +156,93 @@ TEST(LimitedQueue, ReplaceItem)
 
     SNAPSHOT_EQUALS(queue.getSnapshot(), {9, 10, 3}, "first snapshot");
 }
+
+TEST(LimitedQueue, SnapshotIsStableAcrossModifications)
+{
+    LimitedQueue<int> queue(300);
+    std::vector<int> expected;
+    for (int i = 0; i < 250; ++i)
+    {
+        queue.pushBack(i);
+        expected.push_back(i);
+    }
+
+    auto snapshot = queue.getSnapshot();
+    SNAPSHOT_EQUALS(snapshot, expected, "initial snapshot");
+
+    // fill up and evict across several chunks
+    for (int i = 250; i < 700; ++i)
+    {
+        queue.pushBack(i);
+    }
+    queue.replaceItem(std::size_t(0), -1);
+    queue.replaceItem(699, -2);
+    queue.insertBefore(500, -3);
+    queue.insertAfter(600, -4);
+
+    SNAPSHOT_EQUALS(snapshot, expected, "snapshot after modifications");
+
+    auto snapshot2 = queue.getSnapshot();
+    ASSERT_EQ(snapshot2.size(), 300);
+    EXPECT_EQ(snapshot2[0], 402);
+    EXPECT_EQ(snapshot2[299], -2);
+    EXPECT_EQ(*queue.first(), 402);
+    EXPECT_EQ(*queue.last(), -2);
+}
+
+TEST(LimitedQueue, MatchesReference)
+{
+    // Model the queue with a vector and compare after every operation,
+    // crossing chunk boundaries in both directions
+    const size_t limit = 333;
+    LimitedQueue<int> queue(limit);
+    std::vector<int> model;
+
+    std::vector<int> front;
+    for (int i = 0; i < 200; ++i)
+    {
+        front.push_back(-i - 1);
+    }
+
+    queue.pushBack(0);
+    model.push_back(0);
+    queue.pushFront(front);
+    model.insert(model.begin(), front.begin(), front.end());
+    SNAPSHOT_EQUALS(queue.getSnapshot(), model, "after pushFront");
+
+    std::vector<LimitedQueueSnapshot<int>> snapshots;
+    std::vector<std::vector<int>> models;
+    for (int i = 1; i < 1000; ++i)
+    {
+        int deleted = 0;
+        bool full = queue.pushBack(i, deleted);
+        EXPECT_EQ(full, model.size() == limit);
+        if (model.size() == limit)
+        {
+            EXPECT_EQ(deleted, model.front());
+            model.erase(model.begin());
+        }
+        model.push_back(i);
+
+        if (i % 97 == 0)
+        {
+            queue.replaceItem(std::size_t(i % model.size()), i * 10);
+            model[i % model.size()] = i * 10;
+            snapshots.push_back(queue.getSnapshot());
+            models.push_back(model);
+        }
+    }
+
+    SNAPSHOT_EQUALS(queue.getSnapshot(), model, "final snapshot");
+    for (size_t i = 0; i < snapshots.size(); ++i)
+    {
+        SNAPSHOT_EQUALS(snapshots[i], models[i], "intermediate snapshot");
+    }
+
+    auto snapshot = queue.getSnapshot();
+    std::vector<int> iterated(snapshot.begin(), snapshot.end());
+    EXPECT_EQ(iterated, model);
+    std::vector<int> reversed(snapshot.rbegin(), snapshot.rend());
+    std::reverse(reversed.begin(), reversed.end());
+    EXPECT_EQ(reversed, model);
+}
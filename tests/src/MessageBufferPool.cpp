@@ -0,0 +1,115 @@
+#include "messages/layouts/MessageBufferPool.hpp"
+
+#include <gtest/gtest.h>
+#include <QPixmap>
+#include <QSize>
+
+#include <chrono>
+#include <memory>
+
+using namespace chatterino;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Null pixmaps, they don't need a window system
+std::shared_ptr<QPixmap> makeNullPixmap(QSize /*size*/)
+{
+    return std::make_shared<QPixmap>();
+}
+
+// A 64x32 buffer, the smallest size class
+constexpr size_t SMALL_BYTES = 64 * 32 * 4;
+const QSize SMALL(50, 20);
+// A 128x32 buffer
+constexpr size_t LARGE_BYTES = 128 * 32 * 4;
+const QSize LARGE(100, 20);
+
+}  // namespace
+
+TEST(MessageBufferPool, ReusesReleasedBuffers)
+{
+    MessageBufferPool pool(SMALL_BYTES * 10, 1h, makeNullPixmap);
+
+    auto *first = pool.acquire(SMALL, 1).get();
+    EXPECT_EQ(pool.bytes(), SMALL_BYTES);
+
+    pool.release(first);
+    EXPECT_EQ(pool.acquire(QSize(60, 30), 1).get(), first);
+    EXPECT_EQ(pool.size(), 1);
+
+    // Buffers in use aren't handed out twice
+    EXPECT_NE(pool.acquire(SMALL, 1).get(), first);
+    EXPECT_EQ(pool.size(), 2);
+
+    // Nor are buffers of a different size class
+    pool.release(first);
+    EXPECT_NE(pool.acquire(LARGE, 1).get(), first);
+    EXPECT_EQ(pool.size(), 3);
+}
+
+TEST(MessageBufferPool, EvictsReleasedBuffersFirst)
+{
+    MessageBufferPool pool(SMALL_BYTES * 2, 1h, makeNullPixmap);
+
+    std::weak_ptr<QPixmap> released = pool.acquire(SMALL, 1);
+    std::weak_ptr<QPixmap> inUse = pool.acquire(SMALL, 1);
+    pool.release(released.lock().get());
+
+    // Over budget: the released buffer is dropped, the ones in use are kept
+    // even though they don't fit
+    std::weak_ptr<QPixmap> large = pool.acquire(LARGE, 1);
+    EXPECT_TRUE(released.expired());
+    EXPECT_FALSE(inUse.expired());
+    EXPECT_FALSE(large.expired());
+    EXPECT_EQ(pool.size(), 2);
+    EXPECT_EQ(pool.bytes(), SMALL_BYTES + LARGE_BYTES);
+
+    // Once they're released, they're dropped
+    pool.release(inUse.lock().get());
+    pool.setBudget(LARGE_BYTES);
+    EXPECT_TRUE(inUse.expired());
+    EXPECT_FALSE(large.expired());
+    EXPECT_EQ(pool.bytes(), LARGE_BYTES);
+}
+
+TEST(MessageBufferPool, EvictsOffScreenBuffers)
+{
+    // Every buffer that's in use is off screen as soon as it was made
+    MessageBufferPool pool(SMALL_BYTES * 2, 0ms, makeNullPixmap);
+
+    std::weak_ptr<QPixmap> first = pool.acquire(SMALL, 1);
+    std::weak_ptr<QPixmap> second = pool.acquire(SMALL, 1);
+    std::weak_ptr<QPixmap> released = pool.acquire(SMALL, 1);
+    EXPECT_TRUE(first.expired());
+    EXPECT_FALSE(second.expired());
+    EXPECT_FALSE(released.expired());
+
+    // Released buffers go before the off screen ones
+    pool.release(released.lock().get());
+    std::weak_ptr<QPixmap> third = pool.acquire(LARGE, 1);
+    EXPECT_TRUE(released.expired());
+    EXPECT_TRUE(second.expired());
+    EXPECT_FALSE(third.expired());
+
+    // The buffer that was just made is kept even if it doesn't fit
+    pool.setBudget(SMALL_BYTES);
+    std::weak_ptr<QPixmap> fourth = pool.acquire(LARGE, 1);
+    EXPECT_TRUE(third.expired());
+    EXPECT_FALSE(fourth.expired());
+    EXPECT_EQ(pool.size(), 1);
+}
+
+TEST(MessageBufferPool, EvictsLeastRecentlyPaintedFirst)
+{
+    MessageBufferPool pool(SMALL_BYTES * 2, 0ms, makeNullPixmap);
+
+    std::weak_ptr<QPixmap> first = pool.acquire(SMALL, 1);
+    std::weak_ptr<QPixmap> second = pool.acquire(SMALL, 1);
+
+    // Painting the first buffer again makes the second one the oldest
+    pool.touch(first.lock().get());
+    pool.acquire(SMALL, 1);
+    EXPECT_FALSE(first.expired());
+    EXPECT_TRUE(second.expired());
+}
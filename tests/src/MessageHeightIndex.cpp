@@ -0,0 +1,194 @@
+#include "widgets/helper/MessageHeightIndex.hpp"
+
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <random>
+
+using namespace chatterino;
+
+TEST(MessageHeightIndex, Offsets)
+{
+    MessageHeightIndex index(4);
+    index.pushBack(10);
+    index.pushBack(20);
+    index.pushBack(30);
+
+    EXPECT_EQ(index.size(), 3);
+    EXPECT_EQ(index.totalHeight(), 60);
+    EXPECT_EQ(index.offsetOf(0), 0);
+    EXPECT_EQ(index.offsetOf(1), 10);
+    EXPECT_EQ(index.offsetOf(2), 30);
+    EXPECT_EQ(index.offsetOf(3), 60);
+
+    EXPECT_EQ(index.indexAt(0), 0);
+    EXPECT_EQ(index.indexAt(9), 0);
+    EXPECT_EQ(index.indexAt(10), 1);
+    EXPECT_EQ(index.indexAt(59), 2);
+    EXPECT_EQ(index.indexAt(1000), 2);
+
+    EXPECT_DOUBLE_EQ(index.valueAt(20), 1.5);
+    EXPECT_DOUBLE_EQ(index.offsetAt(1.5), 20);
+    EXPECT_DOUBLE_EQ(index.valueAt(60), 3);
+    EXPECT_DOUBLE_EQ(index.offsetAt(3), 60);
+
+    index.setHeight(1, 40);
+    EXPECT_EQ(index.totalHeight(), 80);
+    EXPECT_EQ(index.offsetOf(2), 50);
+}
+
+TEST(MessageHeightIndex, Ring)
+{
+    MessageHeightIndex index(3);
+    index.pushBack(10);
+    index.pushBack(20);
+    index.pushBack(30);
+    EXPECT_EQ(index.headPosition(), 0);
+
+    // evicts 10
+    index.pushBack(40);
+    EXPECT_EQ(index.size(), 3);
+    EXPECT_EQ(index.headPosition(), 1);
+    EXPECT_EQ(index.totalHeight(), 90);
+    EXPECT_EQ(index.offsetOf(2), 50);
+    EXPECT_EQ(index.indexAt(50), 2);
+    EXPECT_EQ(index.height(2), 40);
+
+    EXPECT_FALSE(index.pushFront(5));
+
+    index.popFront();
+    EXPECT_TRUE(index.pushFront(5));
+    EXPECT_EQ(index.headPosition(), 1);
+    EXPECT_EQ(index.height(0), 5);
+    EXPECT_EQ(index.offsetOf(2), 35);
+    EXPECT_EQ(index.indexAt(4), 0);
+    EXPECT_EQ(index.indexAt(5), 1);
+}
+
+TEST(MessageHeightIndex, EstimatedHeights)
+{
+    MessageHeightIndex index(10, 15);
+    index.pushBack();
+    EXPECT_EQ(index.height(0), 15);
+
+    index.pushBack(10);
+    index.pushBack(30);
+    EXPECT_EQ(index.estimatedHeight(), 20);
+
+    index.pushBack();
+    EXPECT_EQ(index.height(3), 20);
+}
+
+TEST(MessageHeightIndex, OneMeasurementPerMessage)
+{
+    MessageHeightIndex index(3, 15);
+    index.pushBack(10);
+
+    // Measuring a message again replaces its measurement
+    for (int i = 0; i < 10; ++i)
+    {
+        index.setHeight(0, 30);
+    }
+    EXPECT_EQ(index.estimatedHeight(), 30);
+
+    index.pushBack(10);
+    EXPECT_EQ(index.estimatedHeight(), 20);
+
+    // Estimated heights aren't measurements
+    index.pushBack();
+    index.setHeight(2, 0);
+    EXPECT_EQ(index.estimatedHeight(), 20);
+
+    // Evicted messages don't count anymore
+    index.popFront();
+    EXPECT_EQ(index.estimatedHeight(), 10);
+    index.pushBack(40);
+    index.pushBack(40);
+    EXPECT_EQ(index.estimatedHeight(), 40);
+
+    index.clear();
+    EXPECT_EQ(index.estimatedHeight(), 15);
+}
+
+TEST(MessageHeightIndex, HeadOffset)
+{
+    MessageHeightIndex index(3);
+    index.pushBack(10);
+    index.pushBack(20);
+    index.pushBack(30);
+    EXPECT_EQ(index.headOffset(), 0);
+
+    // evicts 10
+    index.pushBack(40);
+    EXPECT_EQ(index.headOffset(), 10);
+
+    index.popFront();
+    EXPECT_EQ(index.headOffset(), 30);
+
+    index.pushFront(5);
+    EXPECT_EQ(index.headOffset(), 25);
+
+    index.clear();
+    EXPECT_EQ(index.headOffset(), 100);
+}
+
+TEST(MessageHeightIndex, MatchesReference)
+{
+    std::mt19937 rng(1234);
+    MessageHeightIndex index(37);
+    std::deque<int> reference;
+    int64_t headOffset = 0;
+
+    for (int step = 0; step < 5000; ++step)
+    {
+        auto op = rng() % 10;
+        int height = int(rng() % 50) + 1;
+        if (op < 6)
+        {
+            index.pushBack(height);
+            if (reference.size() == 37)
+            {
+                headOffset += reference.front();
+                reference.pop_front();
+            }
+            reference.push_back(height);
+        }
+        else if (op < 7)
+        {
+            if (index.pushFront(height))
+            {
+                headOffset -= height;
+                reference.push_front(height);
+            }
+        }
+        else if (op < 8)
+        {
+            index.popFront();
+            if (!reference.empty())
+            {
+                headOffset += reference.front();
+                reference.pop_front();
+            }
+        }
+        else if (!reference.empty())
+        {
+            auto i = rng() % reference.size();
+            index.setHeight(i, height);
+            reference[i] = height;
+        }
+
+        ASSERT_EQ(index.size(), reference.size());
+
+        int64_t offset = 0;
+        for (size_t i = 0; i < reference.size(); ++i)
+        {
+            ASSERT_EQ(index.offsetOf(i), offset) << "step " << step;
+            ASSERT_EQ(index.indexAt(offset), i) << "step " << step;
+            ASSERT_EQ(index.indexAt(offset + reference[i] - 1), i)
+                << "step " << step;
+            offset += reference[i];
+        }
+        ASSERT_EQ(index.totalHeight(), offset);
+        ASSERT_EQ(index.headOffset(), headOffset) << "step " << step;
+    }
+}
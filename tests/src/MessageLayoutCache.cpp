@@ -0,0 +1,107 @@
+#include "messages/layouts/MessageLayoutCache.hpp"
+
+#include "messages/layouts/MessageLayoutContainer.hpp"
+#include "messages/Message.hpp"
+#include "messages/MessageElement.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+using namespace chatterino;
+
+namespace {
+
+MessageLayoutKey makeKey(const MessagePtr &message, int width = 300)
+{
+    return {
+        message.get(),
+        width,
+        1.F,
+        MessageElementFlag::Text,
+        message->flags,
+        false,
+        0,
+    };
+}
+
+}  // namespace
+
+TEST(MessageLayoutCache, SharesContainers)
+{
+    MessageLayoutCache cache(16);
+    auto message = std::make_shared<const Message>();
+    auto container = std::make_shared<const MessageLayoutContainer>();
+
+    EXPECT_EQ(cache.get(makeKey(message)), nullptr);
+    cache.put(makeKey(message), message, container);
+    EXPECT_EQ(cache.get(makeKey(message)), container);
+
+    // Anything that changes the layout is a different entry
+    EXPECT_EQ(cache.get(makeKey(message, 301)), nullptr);
+
+    auto key = makeKey(message);
+    key.scale = 1.5F;
+    EXPECT_EQ(cache.get(key), nullptr);
+
+    key = makeKey(message);
+    key.elementFlags.set(MessageElementFlag::Timestamp);
+    EXPECT_EQ(cache.get(key), nullptr);
+
+    key = makeKey(message);
+    key.messageFlags.set(MessageFlag::Collapsed);
+    EXPECT_EQ(cache.get(key), nullptr);
+
+    key = makeKey(message);
+    key.hidden = true;
+    EXPECT_EQ(cache.get(key), nullptr);
+
+    key = makeKey(message);
+    key.generation = 1;
+    EXPECT_EQ(cache.get(key), nullptr);
+
+    auto other = std::make_shared<const Message>();
+    EXPECT_EQ(cache.get(makeKey(other)), nullptr);
+}
+
+TEST(MessageLayoutCache, EvictsLeastRecentlyUsed)
+{
+    MessageLayoutCache cache(2);
+    auto first = std::make_shared<const Message>();
+    auto second = std::make_shared<const Message>();
+    auto third = std::make_shared<const Message>();
+
+    cache.put(makeKey(first), first,
+              std::make_shared<const MessageLayoutContainer>());
+    cache.put(makeKey(second), second,
+              std::make_shared<const MessageLayoutContainer>());
+
+    // Using the first entry keeps it around
+    EXPECT_NE(cache.get(makeKey(first)), nullptr);
+    cache.put(makeKey(third), third,
+              std::make_shared<const MessageLayoutContainer>());
+
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_NE(cache.get(makeKey(first)), nullptr);
+    EXPECT_EQ(cache.get(makeKey(second)), nullptr);
+    EXPECT_NE(cache.get(makeKey(third)), nullptr);
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0);
+}
+
+TEST(MessageLayoutCache, KeepsMessagesAlive)
+{
+    MessageLayoutCache cache(16);
+    auto message = std::make_shared<const Message>();
+    std::weak_ptr<const Message> weak = message;
+    auto key = makeKey(message);
+
+    cache.put(key, message, std::make_shared<const MessageLayoutContainer>());
+    message.reset();
+
+    // The address in the key can't be reused while the entry exists
+    EXPECT_FALSE(weak.expired());
+    cache.clear();
+    EXPECT_TRUE(weak.expired());
+}
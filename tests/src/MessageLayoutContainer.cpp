@@ -0,0 +1,103 @@
+#include "messages/layouts/MessageLayoutContainer.hpp"
+
+#include "Application.hpp"
+#include "messages/layouts/MessageLayoutElement.hpp"
+#include "messages/Message.hpp"
+#include "messages/MessageElement.hpp"
+#include "mocks/EmptyApplication.hpp"
+#include "singletons/Fonts.hpp"
+
+#include <gtest/gtest.h>
+#include <QString>
+
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+class MockApplication : mock::EmptyApplication
+{
+public:
+    Fonts *getFonts() override
+    {
+        return &this->fonts;
+    }
+
+    Fonts fonts;
+};
+
+class MessageLayoutContainerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        this->container.begin(200, 1.F, MessageFlags());
+        for (int i = 0; i < 20; ++i)
+        {
+            QString word = QString("word%1").arg(i);
+            auto *element = this->container.makeElement<TextLayoutElement>(
+                this->creator, word, QSize(word.size() * 10, 20), QColor(),
+                FontStyle::ChatMedium, 1.F);
+            this->container.addElement(element);
+            this->elements.push_back(element);
+        }
+        this->container.end();
+    }
+
+    MockApplication mockApplication;
+    TextElement creator{"", MessageElementFlag::Text};
+    MessageLayoutContainer container;
+    std::vector<MessageLayoutElement *> elements;
+};
+
+}  // namespace
+
+TEST_F(MessageLayoutContainerTest, GetElementAt)
+{
+    for (auto *element : this->elements)
+    {
+        EXPECT_EQ(this->container.getElementAt(element->getRect().center()),
+                  element);
+    }
+
+    // Right of all elements
+    auto rect = this->elements.front()->getRect();
+    EXPECT_EQ(this->container.getElementAt(QPoint(1000, rect.center().y())),
+              nullptr);
+}
+
+TEST_F(MessageLayoutContainerTest, GetSelectionIndex)
+{
+    ASSERT_GT(this->elements.back()->getLine(), 1);
+
+    int index = 0;
+    for (auto *element : this->elements)
+    {
+        auto rect = element->getRect();
+        EXPECT_EQ(this->container.getSelectionIndex(
+                      QPoint(rect.left(), rect.center().y())),
+                  index);
+        index += element->getSelectionIndexCount();
+    }
+    EXPECT_EQ(this->container.getLastCharacterIndex(), index);
+
+    // Above the first line and below the last one
+    EXPECT_EQ(this->container.getSelectionIndex(QPoint(-1, -50)), 0);
+    EXPECT_EQ(this->container.getSelectionIndex(QPoint(1000, 10000)), index);
+
+    // Right of a line is its end
+    auto *first = this->elements.front();
+    int lineEnd = 0;
+    for (auto *element : this->elements)
+    {
+        if (element->getLine() != first->getLine())
+        {
+            break;
+        }
+        lineEnd += element->getSelectionIndexCount();
+    }
+    EXPECT_EQ(this->container.getSelectionIndex(
+                  QPoint(1000, first->getRect().center().y())),
+              lineEnd);
+}
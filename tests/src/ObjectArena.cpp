@@ -0,0 +1,162 @@
+#include "util/ObjectArena.hpp"
+
+#include <gtest/gtest.h>
+#include <QString>
+
+#include <cstdint>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+struct Tracked {
+    Tracked(std::vector<int> &destroyed, int id)
+        : destroyed(destroyed)
+        , id(id)
+    {
+    }
+
+    ~Tracked()
+    {
+        this->destroyed.push_back(this->id);
+    }
+
+    std::vector<int> &destroyed;
+    int id;
+};
+
+}  // namespace
+
+TEST(ObjectArena, MakesObjects)
+{
+    ObjectArena arena(64);
+
+    auto *text = arena.make<QString>("forsen");
+    auto *number = arena.make<int64_t>(42);
+    auto *character = arena.make<char>('x');
+    auto *other = arena.make<int64_t>(7);
+
+    EXPECT_EQ(*text, "forsen");
+    EXPECT_EQ(*number, 42);
+    EXPECT_EQ(*character, 'x');
+    EXPECT_EQ(*other, 7);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(other) % alignof(int64_t), 0);
+    EXPECT_EQ(arena.size(), 4);
+}
+
+TEST(ObjectArena, GrowsAndHandlesLargeObjects)
+{
+    ObjectArena arena(64);
+
+    std::vector<int64_t *> numbers;
+    for (int i = 0; i < 100; ++i)
+    {
+        numbers.push_back(arena.make<int64_t>(i));
+    }
+    struct Large {
+        char data[1000];
+    };
+    auto *large = arena.make<Large>();
+    large->data[999] = 'x';
+
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(*numbers[i], i);
+    }
+    EXPECT_EQ(large->data[999], 'x');
+    EXPECT_GE(arena.capacity(), 100 * sizeof(int64_t) + sizeof(Large));
+}
+
+TEST(ObjectArena, DestroysInReverseOrder)
+{
+    std::vector<int> destroyed;
+    {
+        ObjectArena arena;
+        arena.make<Tracked>(destroyed, 1);
+        arena.make<Tracked>(destroyed, 2);
+        arena.make<Tracked>(destroyed, 3);
+        EXPECT_TRUE(destroyed.empty());
+    }
+    EXPECT_EQ(destroyed, (std::vector<int>{3, 2, 1}));
+
+    destroyed.clear();
+    ObjectArena arena;
+    arena.make<Tracked>(destroyed, 1);
+    arena.clear();
+    EXPECT_EQ(destroyed, (std::vector<int>{1}));
+    EXPECT_EQ(arena.size(), 0);
+
+    // The arena can be used again after clearing it
+    arena.make<Tracked>(destroyed, 2);
+    EXPECT_EQ(arena.size(), 1);
+}
+
+TEST(ObjectArena, DestroyLast)
+{
+    std::vector<int> destroyed;
+    ObjectArena arena;
+
+    auto *first = arena.make<Tracked>(destroyed, 1);
+    auto *second = arena.make<Tracked>(destroyed, 2);
+
+    EXPECT_FALSE(arena.destroyLast(first));
+    EXPECT_TRUE(destroyed.empty());
+
+    EXPECT_TRUE(arena.destroyLast(second));
+    EXPECT_EQ(destroyed, (std::vector<int>{2}));
+    EXPECT_EQ(arena.size(), 1);
+
+    // Its memory is reused
+    auto *third = arena.make<Tracked>(destroyed, 3);
+    EXPECT_EQ(static_cast<void *>(third), static_cast<void *>(second));
+
+    EXPECT_TRUE(arena.destroyLast(third));
+    EXPECT_TRUE(arena.destroyLast(first));
+    EXPECT_EQ(destroyed, (std::vector<int>{2, 3, 1}));
+    EXPECT_EQ(arena.size(), 0);
+}
+
+TEST(ObjectArena, StartsSmallAndGrowsGeometrically)
+{
+    ObjectArena arena(64);
+    arena.make<int64_t>(1);
+    EXPECT_EQ(arena.capacity(), 64);
+
+    // 64 + 128 + 256 + 512 bytes
+    for (int i = 0; i < 100; ++i)
+    {
+        arena.make<int64_t>(i);
+    }
+    EXPECT_EQ(arena.capacity(), 960);
+
+    // Blocks stop growing at some point
+    for (int i = 0; i < 10000; ++i)
+    {
+        arena.make<int64_t>(i);
+    }
+    EXPECT_LT(arena.capacity(), 10101 * sizeof(int64_t) +
+                                    2 * ObjectArena::MAX_BLOCK_SIZE);
+
+    // The largest block is kept
+    arena.clear();
+    EXPECT_EQ(arena.capacity(), ObjectArena::MAX_BLOCK_SIZE);
+}
+
+TEST(ObjectArena, Reserve)
+{
+    ObjectArena arena(64);
+    arena.reserve(100 * sizeof(int64_t));
+    EXPECT_EQ(arena.capacity(), 100 * sizeof(int64_t));
+
+    for (int i = 0; i < 100; ++i)
+    {
+        arena.make<int64_t>(i);
+    }
+    EXPECT_EQ(arena.capacity(), 100 * sizeof(int64_t));
+
+    // Enough space left
+    arena.clear();
+    arena.reserve(10 * sizeof(int64_t));
+    EXPECT_EQ(arena.capacity(), 100 * sizeof(int64_t));
+}
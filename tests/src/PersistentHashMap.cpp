@@ -0,0 +1,119 @@
+#include "util/PersistentHashMap.hpp"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+// Every key ends up in one of three buckets, so the map has to store the
+// colliding keys in lists
+struct CollidingHash {
+    size_t operator()(const std::string &key) const
+    {
+        return key.size() % 3;
+    }
+};
+
+template <typename THash>
+void checkAgainstReference(unsigned seed)
+{
+    using Map = PersistentHashMap<std::string, int, THash>;
+
+    std::mt19937 rng(seed);
+    Map map;
+    std::unordered_map<std::string, int> reference;
+    std::vector<std::pair<Map, std::map<std::string, int>>> snapshots;
+
+    for (int step = 0; step < 5000; ++step)
+    {
+        auto key = std::to_string(rng() % 1000);
+        auto op = rng() % 10;
+        if (op < 5)
+        {
+            map[key] = step;
+            reference[key] = step;
+        }
+        else if (op < 8)
+        {
+            ASSERT_EQ(map.erase(key), reference.erase(key));
+        }
+        else
+        {
+            auto inserted = map.emplace(key, -step);
+            auto expected = reference.emplace(key, -step);
+            ASSERT_EQ(inserted.second, expected.second);
+            ASSERT_EQ(inserted.first->second, expected.first->second);
+        }
+        ASSERT_EQ(map.size(), reference.size());
+
+        if (step % 250 == 0)
+        {
+            snapshots.emplace_back(
+                map, std::map<std::string, int>(reference.begin(),
+                                                reference.end()));
+        }
+    }
+
+    for (const auto &[key, value] : reference)
+    {
+        ASSERT_EQ(map.at(key), value);
+    }
+
+    // Snapshots aren't changed by modifications of the map they were
+    // copied from
+    for (const auto &[snapshot, expected] : snapshots)
+    {
+        std::map<std::string, int> actual(snapshot.begin(), snapshot.end());
+        ASSERT_EQ(actual, expected);
+        ASSERT_EQ(snapshot.size(), expected.size());
+    }
+}
+
+}  // namespace
+
+TEST(PersistentHashMap, Basic)
+{
+    PersistentHashMap<std::string, int> map{{"a", 1}, {"b", 2}};
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_EQ(map.at("a"), 1);
+    EXPECT_EQ(map.count("c"), 0);
+    EXPECT_THROW(map.at("c"), std::out_of_range);
+
+    EXPECT_FALSE(map.insert({"a", 3}).second);
+    EXPECT_EQ(map.at("a"), 1);
+
+    EXPECT_FALSE(map.insert_or_assign("a", 3).second);
+    EXPECT_EQ(map.at("a"), 3);
+
+    auto copy = map;
+    copy["c"] = 4;
+    EXPECT_EQ(copy.size(), 3);
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_EQ(map.find("c"), map.end());
+
+    size_t erased = 0;
+    for (auto it = copy.begin(); it != copy.end(); ++erased)
+    {
+        it = copy.erase(it);
+    }
+    EXPECT_EQ(erased, 3);
+    EXPECT_TRUE(copy.empty());
+    EXPECT_EQ(map.size(), 2);
+}
+
+TEST(PersistentHashMap, MatchesReference)
+{
+    checkAgainstReference<std::hash<std::string>>(1234);
+}
+
+TEST(PersistentHashMap, Collisions)
+{
+    checkAgainstReference<CollidingHash>(4321);
+}
@@ -0,0 +1,121 @@
+#include "util/Similarity.hpp"
+
+#include <gtest/gtest.h>
+#include <QString>
+#include <QTime>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+// Longest common substring with the full table
+float naiveSimilarity(const QString &a, const QString &b)
+{
+    std::vector<std::vector<int>> table(a.size() + 1,
+                                        std::vector<int>(b.size() + 1, 0));
+    int longest = 0;
+    for (int i = 1; i <= a.size(); ++i)
+    {
+        for (int j = 1; j <= b.size(); ++j)
+        {
+            if (a[i - 1] == b[j - 1])
+            {
+                table[i][j] = table[i - 1][j - 1] + 1;
+                longest = std::max(longest, table[i][j]);
+            }
+        }
+    }
+
+    if (longest == 0)
+    {
+        return 0.F;
+    }
+    return static_cast<float>(longest) /
+           static_cast<float>(std::max(a.size(), b.size()));
+}
+
+}  // namespace
+
+TEST(Similarity, RelativeSimilarity)
+{
+    EXPECT_EQ(relativeSimilarity(u"", u""), 0.F);
+    EXPECT_EQ(relativeSimilarity(u"abc", u""), 0.F);
+    EXPECT_EQ(relativeSimilarity(u"abc", u"xyz"), 0.F);
+    EXPECT_EQ(relativeSimilarity(u"abc", u"abc"), 1.F);
+    EXPECT_EQ(relativeSimilarity(u"abcd", u"bc"), 0.5F);
+    EXPECT_EQ(relativeSimilarity(u"bc", u"abcd"), 0.5F);
+    EXPECT_EQ(relativeSimilarity(u"xxabcdyy", u"abcd"), 0.5F);
+    EXPECT_EQ(relativeSimilarity(u"Kappa 123", u"Kappa 124"), 8.F / 9.F);
+}
+
+TEST(Similarity, MatchesNaiveImplementation)
+{
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> length(0, 40);
+    // A small alphabet gives many partial matches
+    std::uniform_int_distribution<int> character('a', 'd');
+
+    auto randomString = [&] {
+        QString result;
+        auto size = length(rng);
+        for (int i = 0; i < size; ++i)
+        {
+            result.append(QChar(character(rng)));
+        }
+        return result;
+    };
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        auto a = randomString();
+        auto b = randomString();
+        ASSERT_EQ(relativeSimilarity(a, b), naiveSimilarity(a, b))
+            << a.toStdString() << " " << b.toStdString();
+    }
+}
+
+TEST(Similarity, HistoryLimits)
+{
+    SimilarityHistory history;
+    QTime now(12, 0, 0);
+
+    EXPECT_EQ(history.similarity("spam", "a", now, 10, 60, false), 0.F);
+
+    history.add("spam", "a", now.addSecs(-30));
+    history.add("hello", "b", now.addSecs(-2));
+    history.add("unrelated", "c", now.addSecs(-1));
+
+    EXPECT_EQ(history.similarity("spam", "d", now, 10, 60, false), 1.F);
+    // Only the two newest messages are checked
+    EXPECT_LT(history.similarity("spam", "d", now, 2, 60, false), 1.F);
+    // The spam message is too old
+    EXPECT_LT(history.similarity("spam", "d", now, 10, 10, false), 1.F);
+
+    // Messages by other users don't count towards the limit
+    EXPECT_EQ(history.similarity("spam", "a", now, 1, 60, true), 1.F);
+    EXPECT_EQ(history.similarity("hello", "a", now, 10, 60, true), 0.F);
+}
+
+TEST(Similarity, HistoryWrapsAround)
+{
+    SimilarityHistory history;
+    QTime now(12, 0, 0);
+
+    history.add("first", "a", now);
+    for (size_t i = 0; i < SimilarityHistory::CAPACITY; ++i)
+    {
+        history.add(QString::number(i), "b", now);
+    }
+    EXPECT_EQ(history.size(), SimilarityHistory::CAPACITY);
+
+    // The first message was overwritten
+    EXPECT_EQ(history.similarity("first", "a", now, 1000, 60, true), 0.F);
+    EXPECT_EQ(history.similarity(QString::number(SimilarityHistory::CAPACITY -
+                                                 1),
+                                 "c", now, 1, 60, false),
+              1.F);
+}
@@ -345,3 +345,88 @@ TEST_F(TestTwitchMessageBuilder, ParseTwitchEmotes)
             << " failed";
     }
 }
+
+TEST(TwitchMessageBuilder, TokenizeMessage)
+{
+    struct ExpectedToken {
+        int start;
+        QString text;
+        // Index into the test's emotes, -1 for text
+        int emote;
+        bool trailingSpace;
+    };
+
+    struct TestCase {
+        QString message;
+        std::vector<TwitchEmoteOccurrence> emotes;
+        std::vector<ExpectedToken> expectedTokens;
+    };
+
+    std::vector<TestCase> testCases{
+        {
+            "",
+            {},
+            {},
+        },
+        {
+            "foo  bar ",
+            {},
+            {
+                {0, "foo", -1, true},
+                {5, "bar", -1, true},
+            },
+        },
+        {
+            "Kappa Keepo",
+            {
+                {0, 4, nullptr, EmoteName{"Kappa"}},
+                {6, 10, nullptr, EmoteName{"Keepo"}},
+            },
+            {
+                {0, "Kappa", 0, true},
+                {6, "Keepo", 1, true},
+            },
+        },
+        {
+            // emotes inside of a word
+            "abcKappaKeepo! foo",
+            {
+                {3, 7, nullptr, EmoteName{"Kappa"}},
+                {8, 12, nullptr, EmoteName{"Keepo"}},
+            },
+            {
+                {0, "abc", -1, true},
+                {3, "Kappa", 0, false},
+                {8, "Keepo", 1, false},
+                {13, "!", -1, true},
+                {15, "foo", -1, true},
+            },
+        },
+    };
+
+    for (const auto &test : testCases)
+    {
+        auto tokens =
+            TwitchMessageBuilder::tokenizeMessage(test.message, test.emotes);
+
+        ASSERT_EQ(tokens.size(), test.expectedTokens.size())
+            << "Input " << test.message.toStdString() << " failed";
+        for (size_t i = 0; i < tokens.size(); i++)
+        {
+            const auto &token = tokens[i];
+            const auto &expected = test.expectedTokens[i];
+
+            EXPECT_EQ(token.start, expected.start);
+            EXPECT_EQ(token.text.toString(), expected.text);
+            EXPECT_EQ(token.trailingSpace, expected.trailingSpace);
+            if (expected.emote == -1)
+            {
+                EXPECT_EQ(token.twitchEmote, nullptr);
+            }
+            else
+            {
+                EXPECT_EQ(token.twitchEmote, &test.emotes[expected.emote]);
+            }
+        }
+    }
+}
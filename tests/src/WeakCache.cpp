@@ -0,0 +1,126 @@
+#include "util/WeakCache.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace chatterino;
+
+TEST(WeakCache, SharesLivingValues)
+{
+    WeakCache<int, const int> cache("test weak cache");
+    int made = 0;
+    auto make = [&] {
+        made++;
+        return std::make_shared<const int>(42);
+    };
+
+    auto first = cache.getOrCreate(1, make);
+    auto second = cache.getOrCreate(1, make);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(made, 1);
+    EXPECT_EQ(cache.get(1), first);
+    EXPECT_EQ(cache.get(2), nullptr);
+
+    // Once nobody holds the value, it's created again
+    first.reset();
+    second.reset();
+    EXPECT_EQ(cache.get(1), nullptr);
+    auto third = cache.getOrCreate(1, make);
+    EXPECT_EQ(made, 2);
+    EXPECT_EQ(cache.size(), 1);
+}
+
+TEST(WeakCache, CanReuse)
+{
+    WeakCache<int, const int> cache("test weak cache");
+
+    auto first = cache.getOrCreate(1, [] {
+        return std::make_shared<const int>(1);
+    });
+    auto kept = cache.getOrCreate(
+        1,
+        [] {
+            return std::make_shared<const int>(2);
+        },
+        [](int value) {
+            return value == 1;
+        });
+    EXPECT_EQ(kept, first);
+
+    auto replaced = cache.getOrCreate(
+        1,
+        [] {
+            return std::make_shared<const int>(2);
+        },
+        [](int value) {
+            return value == 2;
+        });
+    EXPECT_NE(replaced, first);
+    EXPECT_EQ(*replaced, 2);
+    EXPECT_EQ(cache.get(1), replaced);
+}
+
+TEST(WeakCache, SweepsExpiredEntries)
+{
+    WeakCache<int, const int> cache("test weak cache");
+
+    std::vector<std::shared_ptr<const int>> alive;
+    for (int i = 0; i < 100000; i++)
+    {
+        auto value = cache.getOrCreate(i, [i] {
+            return std::make_shared<const int>(i);
+        });
+        if (i % 100 == 0)
+        {
+            alive.push_back(value);
+        }
+    }
+
+    // Expired entries are swept while inserting, so the cache stays within
+    // a small factor of the living values
+    EXPECT_LT(cache.size(), 10000);
+
+    cache.sweep();
+    EXPECT_EQ(cache.size(), alive.size());
+    for (const auto &value : alive)
+    {
+        EXPECT_EQ(cache.get(*value), value);
+    }
+}
+
+TEST(WeakCache, Concurrent)
+{
+    WeakCache<int, const int> cache("test weak cache");
+    std::vector<std::shared_ptr<const int>> results(8);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < results.size(); t++)
+    {
+        threads.emplace_back([&cache, &results, t] {
+            for (int i = 0; i < 1000; i++)
+            {
+                auto value = cache.getOrCreate(i % 50, [i] {
+                    return std::make_shared<const int>(i % 50);
+                });
+                ASSERT_EQ(*value, i % 50);
+                if (i % 50 == 7)
+                {
+                    results[t] = value;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    // Every thread held on to key 7, so they all share one value
+    for (const auto &result : results)
+    {
+        EXPECT_EQ(result, results[0]);
+    }
+}